@@ -1,7 +1,16 @@
 #pragma once
 #include "noncopyable.hpp"
+#include "utils/CRC16.hpp"
+#include <algorithm>
 #include <chrono>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 namespace Astra::datastructures {
     //使用CRTP，我们的缓存见不得虚函数表开销的，所以尽量做零成本抽象
@@ -20,12 +29,12 @@ namespace Astra::datastructures {
             return static_cast<Derived *>(this)->Get(key);
         }
         //必备Put,插入和更新缓存接口
-        void Put(const Key &key, const Value &value, std::chrono::seconds ttl = std::chrono::seconds::zero()) {
+        void Put(const Key &key, const Value &value, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
             static_cast<Derived *>(this)->Put(key, value, ttl);
         }
 
         //批量插入缓存接口
-        void batchPut(const std::vector<std::pair<Key, Value>> &kvs, std::chrono::seconds ttl = std::chrono::seconds::zero()) {
+        void batchPut(const std::vector<std::pair<Key, Value>> &kvs, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
             static_cast<Derived *>(this)->BatchPut(kvs, ttl);
         }
 
@@ -76,6 +85,11 @@ namespace Astra::datastructures {
         }
     };
 
+    // 分区数量，用于构造按键哈希切分的缓存（见 AstraCache 的分区构造函数）
+    struct CachePartitions {
+        size_t count;
+    };
+
     /**
      * @author       : caomengxuan
      * @brief        : 这个类调用具体的缓存策略类，每个具体的缓存类都提供一个接口，直接在这里调用。
@@ -88,67 +102,267 @@ namespace Astra::datastructures {
     class AstraCache {
     public:
         template<typename... Args>
-        AstraCache(Args &&...args)
-            : strategy_(std::forward<Args>(args)...) {}
+            requires(!(std::is_same_v<std::decay_t<Args>, CachePartitions> || ...))
+        AstraCache(Args &&...args) {
+            partitions_.push_back(std::make_unique<Partition>(std::forward<Args>(args)...));
+        }
+
+        // 分区构造：键按哈希槽（支持 {tag}）分到 partitions.count 个互相独立的策略实例，
+        // 容量均分，其余参数原样交给每个分区。每个分区有自己的锁，单键操作只锁所属分区
+        template<typename... Args>
+        AstraCache(CachePartitions partitions, size_t capacity, const Args &...args) {
+            size_t count = std::max<size_t>(partitions.count, 1);
+            for (size_t i = 0; i < count; ++i) {
+                size_t share = capacity / count + (i < capacity % count ? 1 : 0);
+                partitions_.push_back(std::make_unique<Partition>(share, args...));
+            }
+        }
+
+        // 单键操作只持有键所属分区的锁；未分区时只有一个分区，行为与共享一把锁相同。
+        // 读改写类命令应使用 Update，避免 Get + Put 之间被其他线程插入写入而丢失更新
+
+        size_t PartitionCount() const {
+            return partitions_.size();
+        }
+
+        size_t PartitionOf(const Key &key) const {
+            if (partitions_.size() == 1) return 0;
+            if constexpr (std::is_same_v<Key, std::string>) {
+                return utils::CRC16::getKeyHashSlot(key) % partitions_.size();
+            } else {
+                return std::hash<Key>{}(key) % partitions_.size();
+            }
+        }
 
         std::optional<Value> Get(const Key &key) {
-            return strategy_.Get(key);
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return partition.strategy.Get(key);
         }
 
         std::vector<std::optional<Value>> BatchGet(const std::vector<Key> &keys) {
-            return strategy_.BatchGet(keys);
+            if (partitions_.size() == 1) {
+                std::lock_guard<std::mutex> lock(partitions_[0]->mutex);
+                return partitions_[0]->strategy.BatchGet(keys);
+            }
+            std::vector<std::optional<Value>> result;
+            result.reserve(keys.size());
+            for (const auto &key: keys) {
+                result.push_back(Get(key));
+            }
+            return result;
         }
 
-        void Put(const Key &key, const Value &value, std::chrono::seconds ttl = std::chrono::seconds::zero()) {
-            strategy_.Put(key, value, ttl);
+        void Put(const Key &key, const Value &value, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            partition.strategy.Put(key, value, ttl);
         }
 
         void BatchPut(const std::vector<Key> &keys, const std::vector<Value> &values,
-                      std::chrono::seconds ttl = std::chrono::seconds::zero()) {
-            strategy_.BatchPut(keys, values, ttl);
+                      std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
+            if (partitions_.size() == 1) {
+                std::lock_guard<std::mutex> lock(partitions_[0]->mutex);
+                partitions_[0]->strategy.BatchPut(keys, values, ttl);
+                return;
+            }
+            if (keys.size() != values.size()) {
+                throw std::invalid_argument("keys and values must have the same size");
+            }
+            std::vector<std::vector<Key>> grouped_keys(partitions_.size());
+            std::vector<std::vector<Value>> grouped_values(partitions_.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                size_t index = PartitionOf(keys[i]);
+                grouped_keys[index].push_back(keys[i]);
+                grouped_values[index].push_back(values[i]);
+            }
+            for (size_t i = 0; i < partitions_.size(); ++i) {
+                if (grouped_keys[i].empty()) continue;
+                std::lock_guard<std::mutex> lock(partitions_[i]->mutex);
+                partitions_[i]->strategy.BatchPut(grouped_keys[i], grouped_values[i], ttl);
+            }
+        }
+
+        // 在锁内原地修改一个值，fn(Value &value, bool existed) 的返回值原样返回
+        // fn 运行时持有缓存锁，不能再调用本缓存的任何接口
+        template<typename Fn>
+        auto Update(const Key &key, Fn &&fn) {
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return partition.strategy.Update(key, std::forward<Fn>(fn));
+        }
+
+        // 在锁内只读访问一个值，fn(const Value *value) 的返回值原样返回，约束同 Update
+        template<typename Fn>
+        auto Visit(const Key &key, Fn &&fn) {
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return partition.strategy.Visit(key, std::forward<Fn>(fn));
         }
 
-        std::optional<std::chrono::seconds> GetExpiryTime(const Key &key) const {
-            return strategy_.GetExpiryTime(key);
+        // 在锁内对底层策略执行一组操作，用于需要"先判断再写"的复合命令（MSETNX 等）
+        // fn(auto &strategy) 的返回值原样返回，约束同 Update。
+        // 多分区时按下标顺序锁住全部分区，strategy 是把每个键转给所属分区的视图
+        template<typename Fn>
+        auto Atomically(Fn &&fn) {
+            if (partitions_.size() == 1) {
+                std::lock_guard<std::mutex> lock(partitions_[0]->mutex);
+                return std::forward<Fn>(fn)(partitions_[0]->strategy);
+            }
+            std::vector<std::unique_lock<std::mutex>> locks;
+            locks.reserve(partitions_.size());
+            for (auto &partition: partitions_) {
+                locks.emplace_back(partition->mutex);
+            }
+            PartitionedView view(*this);
+            return std::forward<Fn>(fn)(view);
         }
 
+        // 只涉及 key 一个键的 Atomically（SET NX/XX/GET、GETDEL、GETEX），只锁该键所属的分区
+        template<typename Fn>
+        auto Atomically(const Key &key, Fn &&fn) {
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return std::forward<Fn>(fn)(partition.strategy);
+        }
+
+        // 每个分区共用同一个删除回调（见 LRUCache::SetRemovalListener），回调在分区锁内执行
+        void SetRemovalListener(const std::function<void(const Key &, const Value &)> &listener) {
+            for (auto &partition: partitions_) {
+                std::lock_guard<std::mutex> lock(partition->mutex);
+                partition->strategy.SetRemovalListener(listener);
+            }
+        }
+
+        std::optional<std::chrono::milliseconds> GetExpiryTime(const Key &key) const {
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return partition.strategy.GetExpiryTime(key);
+        }
+
+        // 以下遍历类接口逐个分区加锁汇总，不是跨分区的一致快照
+
         std::vector<Key> GetKeys() const {
-            return strategy_.GetKeys();
+            return Collect([](const auto &strategy) { return strategy.GetKeys(); });
         }
 
         std::vector<Value> GetValues() const {
-            return strategy_.GetValues();
+            return Collect([](const auto &strategy) { return strategy.GetValues(); });
         }
 
         void Clear() {
-            strategy_.Clear();
+            for (auto &partition: partitions_) {
+                std::lock_guard<std::mutex> lock(partition->mutex);
+                partition->strategy.Clear();
+            }
         }
 
         bool Remove(const Key &key) {
-            return strategy_.Remove(key);
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return partition.strategy.Remove(key);
         }
 
         size_t BatchRemove(const std::vector<Key> &keys) {
-            return strategy_.BatchRemove(keys);
+            if (partitions_.size() == 1) {
+                std::lock_guard<std::mutex> lock(partitions_[0]->mutex);
+                return partitions_[0]->strategy.BatchRemove(keys);
+            }
+            size_t removed = 0;
+            for (const auto &key: keys) {
+                if (Remove(key)) ++removed;
+            }
+            return removed;
         }
 
         bool Contains(const Key &key) const {
-            return strategy_.Contains(key);
+            auto &partition = PartitionFor(key);
+            std::lock_guard<std::mutex> lock(partition.mutex);
+            return partition.strategy.Contains(key);
         }
 
         size_t Size() const {
-            return strategy_.Size();
+            size_t total = 0;
+            for (const auto &partition: partitions_) {
+                std::lock_guard<std::mutex> lock(partition->mutex);
+                total += partition->strategy.Size();
+            }
+            return total;
         }
 
         size_t Capacity() const {
-            return strategy_.Capacity();
+            size_t total = 0;
+            for (const auto &partition: partitions_) {
+                std::lock_guard<std::mutex> lock(partition->mutex);
+                total += partition->strategy.Capacity();
+            }
+            return total;
         }
 
         std::vector<std::pair<Key, Value>> GetAllEntries() const {
-            return strategy_.GetAllEntries();
+            return Collect([](const auto &strategy) { return strategy.GetAllEntries(); });
         }
 
     private:
-        Strategy<Key, Value> strategy_;
+        // 分区独占缓存行，相邻分区的锁不会伪共享
+        struct alignas(64) Partition {
+            template<typename... Args>
+            explicit Partition(Args &&...args) : strategy(std::forward<Args>(args)...) {}
+
+            mutable std::mutex mutex;
+            Strategy<Key, Value> strategy;
+        };
+
+        // 多分区 Atomically 交给回调的策略视图：调用方已持有全部分区的锁
+        class PartitionedView {
+        public:
+            explicit PartitionedView(AstraCache &cache) : cache_(cache) {}
+
+            std::optional<Value> Get(const Key &key) { return At(key).Get(key); }
+
+            void Put(const Key &key, const Value &value, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
+                At(key).Put(key, value, ttl);
+            }
+
+            template<typename Fn>
+            auto Update(const Key &key, Fn &&fn) { return At(key).Update(key, std::forward<Fn>(fn)); }
+
+            template<typename Fn>
+            auto Visit(const Key &key, Fn &&fn) { return At(key).Visit(key, std::forward<Fn>(fn)); }
+
+            bool Remove(const Key &key) { return At(key).Remove(key); }
+
+            bool HasKey(const Key &key) { return At(key).HasKey(key); }
+
+            bool Expire(const Key &key, std::chrono::milliseconds ttl) { return At(key).Expire(key, ttl); }
+
+            bool Persist(const Key &key) { return At(key).Persist(key); }
+
+        private:
+            Strategy<Key, Value> &At(const Key &key) { return cache_.PartitionFor(key).strategy; }
+
+            AstraCache &cache_;
+        };
+
+        Partition &PartitionFor(const Key &key) const {
+            return *partitions_[PartitionOf(key)];
+        }
+
+        template<typename Fn>
+        auto Collect(Fn &&fn) const {
+            decltype(fn(partitions_[0]->strategy)) result;
+            for (const auto &partition: partitions_) {
+                std::lock_guard<std::mutex> lock(partition->mutex);
+                auto part = fn(partition->strategy);
+                if (result.empty()) {
+                    result = std::move(part);
+                } else {
+                    result.insert(result.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+                }
+            }
+            return result;
+        }
+
+        std::vector<std::unique_ptr<Partition>> partitions_;
     };
-}// namespace Astra::datastructures
+}// namespace Astra::datastructures
\ No newline at end of file
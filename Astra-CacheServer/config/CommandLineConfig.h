@@ -18,7 +18,11 @@ namespace Astra::apps {
               enable_cluster_(false),
               cluster_port_(16380),
               persistence_type_("leveldb"),
-              leveldb_path_("./astra_leveldb") {}
+              leveldb_path_("./astra_leveldb"),
+              shard_count_(0),
+              io_thread_count_(0),
+              io_backend_("auto"),
+              proto_max_bulk_len_(512ULL * 1024 * 1024) {}
 
         // 基础初始化方法（供普通模式使用）
         bool initialize(int argc, char *argv[]) override {
@@ -105,6 +109,30 @@ namespace Astra::apps {
             return leveldb_path_;
         }
 
+        // 分片（thread-per-core）模式的核心数，0 表示不启用
+        size_t getShardCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return shard_count_;
+        }
+
+        // 处理客户端连接的 IO 线程数，0 表示按 CPU 核数
+        size_t getIOThreadCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return io_thread_count_;
+        }
+
+        // 要求的套接字后端（auto/epoll/io_uring），须与构建时选定的后端一致
+        std::string getIOBackend() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return io_backend_;
+        }
+
+        // 单个请求参数的长度上限（字节），超过时按协议错误断开连接
+        size_t getProtoMaxBulkLen() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return proto_max_bulk_len_;
+        }
+
     private:
         // 实际参数解析逻辑
         bool parseArguments(int argc, char *argv[]) {
@@ -121,6 +149,13 @@ namespace Astra::apps {
             // 持久化相关参数
             args::ValueFlag<std::string> persistence_type_arg(parser, "type", "Persistence type (file/leveldb)", {"persistence-type"}, "leveldb");
             args::ValueFlag<std::string> leveldb_path_arg(parser, "path", "LevelDB path", {"leveldb-path"}, "./astra_leveldb");
+            // 分片模式参数
+            args::ValueFlag<size_t> shards(parser, "count", "Shared-nothing mode: number of cores, each owning one keyspace partition (0 = disabled)", {"shards"}, 0);
+            // IO 线程参数
+            args::ValueFlag<size_t> io_threads(parser, "count", "Number of IO threads accepting and serving connections (0 = CPU cores)", {"io-threads"}, 0);
+            args::ValueFlag<std::string> io_backend(parser, "backend", "Socket I/O backend (auto/epoll/io_uring), must match the build", {"io-backend"}, "auto");
+            // 协议限制参数
+            args::ValueFlag<size_t> proto_max_bulk_len(parser, "bytes", "Max size of a single request argument", {"proto-max-bulk-len"}, 512ULL * 1024 * 1024);
 
             try {
                 parser.ParseCLI(argc, argv);
@@ -142,6 +177,10 @@ namespace Astra::apps {
             cluster_port_ = static_cast<uint16_t>(args::get(cluster_port));
             persistence_type_ = args::get(persistence_type_arg);
             leveldb_path_ = args::get(leveldb_path_arg);
+            shard_count_ = args::get(shards);
+            io_thread_count_ = args::get(io_threads);
+            io_backend_ = args::get(io_backend);
+            proto_max_bulk_len_ = args::get(proto_max_bulk_len);
             return true;
         }
 
@@ -170,6 +209,10 @@ namespace Astra::apps {
         uint16_t cluster_port_;
         std::string persistence_type_;
         std::string leveldb_path_;
+        size_t shard_count_;
+        size_t io_thread_count_;
+        std::string io_backend_;
+        size_t proto_max_bulk_len_;
         mutable std::mutex mutex_;
     };
 
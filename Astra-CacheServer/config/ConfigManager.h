@@ -108,6 +108,42 @@ namespace Astra::apps {
             return "";
         }
 
+        size_t getShardCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto cmd_config = dynamic_cast<const CommandLineConfig *>(getLatestConfig());
+            if (cmd_config) {
+                return cmd_config->getShardCount();
+            }
+            return 0;
+        }
+
+        size_t getIOThreadCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto cmd_config = dynamic_cast<const CommandLineConfig *>(getLatestConfig());
+            if (cmd_config) {
+                return cmd_config->getIOThreadCount();
+            }
+            return 0;
+        }
+
+        std::string getIOBackend() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto cmd_config = dynamic_cast<const CommandLineConfig *>(getLatestConfig());
+            if (cmd_config) {
+                return cmd_config->getIOBackend();
+            }
+            return "auto";
+        }
+
+        size_t getProtoMaxBulkLen() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto cmd_config = dynamic_cast<const CommandLineConfig *>(getLatestConfig());
+            if (cmd_config) {
+                return cmd_config->getProtoMaxBulkLen();
+            }
+            return 512ULL * 1024 * 1024;
+        }
+
         // 动态更新配置（同步到所有配置源）
         void setListeningPort(uint16_t port) {
             std::lock_guard<std::mutex> lock(mutex_);
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "datastructures/stream_log.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -13,6 +19,40 @@
 namespace Astra {
     namespace data {
 
+        // hash、set 与流/有序集合快照的编码都由 "长度:内容" 块顺序组成；从 pos 读取一块，成功后 pos 指向下一块
+        inline bool ReadChunk(std::string_view data, size_t &pos, std::string_view &chunk) {
+            size_t colon = data.find(':', pos);
+            if (colon == std::string_view::npos) return false;
+
+            size_t len;
+            auto [ptr, ec] = std::from_chars(data.data() + pos, data.data() + colon, len);
+            if (ec != std::errc() || ptr != data.data() + colon || len > data.size() - colon - 1) return false;
+
+            chunk = data.substr(colon + 1, len);
+            pos = colon + 1 + len;
+            return true;
+        }
+
+        inline void WriteChunk(std::string &out, std::string_view chunk) {
+            out += std::to_string(chunk.size());
+            out += ':';
+            out.append(chunk.data(), chunk.size());
+        }
+
+        template<typename Integer>
+        inline void WriteIntegerChunk(std::string &out, Integer value) {
+            WriteChunk(out, std::to_string(value));
+        }
+
+        // 读取一块并整块解析为整数
+        template<typename Integer>
+        inline bool ReadIntegerChunk(std::string_view data, size_t &pos, Integer &value) {
+            std::string_view chunk;
+            if (!ReadChunk(data, pos, chunk)) return false;
+            auto [ptr, ec] = std::from_chars(chunk.data(), chunk.data() + chunk.size(), value);
+            return ec == std::errc() && ptr == chunk.data() + chunk.size();
+        }
+
         // Hash类型实现
         class AstraHash {
         public:
@@ -117,6 +157,65 @@ namespace Astra {
                 return hash;
             }
 
+            // 以下静态方法直接在编码后的字符串上工作，不构造 map，供只涉及少数字段的命令原地读写：
+            // 编码为 "hash:" 后接若干 "字段长度:字段值长度:值"，记录按字段名有序
+            static constexpr std::string_view kPrefix = "hash:";
+
+            static bool IsEncoded(std::string_view data) {
+                return data.substr(0, kPrefix.size()) == kPrefix;
+            }
+
+            // 依次回调 fn(field, value, record_begin)，fn 返回 false 时停止；遇到损坏的记录直接结束
+            template<typename Fn>
+            static void ForEachField(std::string_view data, Fn &&fn) {
+                size_t pos = kPrefix.size();
+                while (pos < data.size()) {
+                    size_t record = pos;
+                    std::string_view field, value;
+                    if (!ReadChunk(data, pos, field) || !ReadChunk(data, pos, value)) break;
+                    if (!fn(field, value, record)) return;
+                }
+            }
+
+            static std::optional<std::string_view> FindField(std::string_view data, std::string_view field) {
+                std::optional<std::string_view> found;
+                ForEachField(data, [&](std::string_view name, std::string_view value, size_t) {
+                    if (name == field) found = value;
+                    return !found && name < field;
+                });
+                return found;
+            }
+
+            // 原地设置字段：已有字段只改写值那一段，新字段按序插入；返回是否为新字段
+            static bool SetField(std::string &data, std::string_view field, std::string_view value) {
+                size_t insert_at = data.size();
+                size_t replace_begin = std::string::npos, replace_end = 0;
+                ForEachField(data, [&](std::string_view name, std::string_view current, size_t record) {
+                    if (name == field) {
+                        replace_begin = static_cast<size_t>(name.data() - data.data()) + name.size();
+                        replace_end = static_cast<size_t>(current.data() - data.data()) + current.size();
+                        return false;
+                    }
+                    if (name > field) {
+                        insert_at = record;
+                        return false;
+                    }
+                    return true;
+                });
+
+                std::string chunk = std::to_string(value.size()) + ":";
+                chunk.append(value);
+                if (replace_begin != std::string::npos) {
+                    data.replace(replace_begin, replace_end - replace_begin, chunk);
+                    return false;
+                }
+
+                std::string record = std::to_string(field.size()) + ":";
+                record.append(field).append(chunk);
+                data.insert(insert_at, record);
+                return true;
+            }
+
         private:
             std::map<std::string, std::string> data_;
         };
@@ -203,6 +302,39 @@ namespace Astra {
                 return *it;
             }
 
+            std::string Serialize() const {
+                std::string out = "list:";
+                for (const auto &value: list_) {
+                    out += std::to_string(value.length());
+                    out += ':';
+                    out += value;
+                }
+                return out;
+            }
+
+            static AstraList Deserialize(const std::string &data) {
+                AstraList list;
+                if (data.compare(0, 5, "list:") != 0) {
+                    return list;
+                }
+
+                size_t pos = 5;// Skip "list:" prefix
+                while (pos < data.length()) {
+                    size_t len_end = data.find(':', pos);
+                    if (len_end == std::string::npos) break;
+
+                    size_t len = 0;
+                    auto [ptr, ec] = std::from_chars(data.data() + pos, data.data() + len_end, len);
+                    if (ec != std::errc() || ptr != data.data() + len_end) break;
+                    pos = len_end + 1;
+
+                    if (pos + len > data.length()) break;
+                    list.list_.emplace_back(data, pos, len);
+                    pos += len;
+                }
+                return list;
+            }
+
         private:
             std::list<std::string> list_;
         };
@@ -264,6 +396,61 @@ namespace Astra {
                 return member;
             }
 
+            std::string Serialize() const {
+                return SerializeMembers(set_);
+            }
+
+            static AstraSet Deserialize(const std::string &data) {
+                AstraSet set;
+                for (auto member: ParseMembers(data)) {
+                    set.set_.emplace(member);
+                }
+                return set;
+            }
+
+            // 零拷贝解析 "set:" 编码，返回指向 data 内部的升序成员视图
+            // 调用方需保证 data 在视图使用期间有效
+            static std::vector<std::string_view> ParseMembers(std::string_view data) {
+                std::vector<std::string_view> members;
+                if (data.substr(0, 4) != "set:") {
+                    return members;
+                }
+
+                size_t pos = 4;// Skip "set:" prefix
+                while (pos < data.length()) {
+                    size_t len_end = data.find(':', pos);
+                    if (len_end == std::string_view::npos) break;
+
+                    size_t len = 0;
+                    auto [ptr, ec] = std::from_chars(data.data() + pos, data.data() + len_end, len);
+                    if (ec != std::errc() || ptr != data.data() + len_end) break;
+                    pos = len_end + 1;
+
+                    if (pos + len > data.length()) break;
+                    members.push_back(data.substr(pos, len));
+                    pos += len;
+                }
+
+                // std::set 序列化出来的本就是升序，这里只对异常数据兜底
+                if (!std::is_sorted(members.begin(), members.end())) {
+                    std::sort(members.begin(), members.end());
+                    members.erase(std::unique(members.begin(), members.end()), members.end());
+                }
+                return members;
+            }
+
+            // 由已排序且去重的成员直接构造编码，供集合代数的 *STORE 写回
+            template<typename Range>
+            static std::string SerializeMembers(const Range &members) {
+                std::string out = "set:";
+                for (const auto &member: members) {
+                    out += std::to_string(member.length());
+                    out += ':';
+                    out.append(member.data(), member.length());
+                }
+                return out;
+            }
+
         private:
             std::set<std::string> set_;// 使用有序set便于实现SMEMBERS的稳定输出
         };
@@ -272,6 +459,11 @@ namespace Astra {
         class AstraZSet {
         public:
             AstraZSet() = default;
+            // scan_order_ 指向 member_to_score_ 的节点，移动保留节点，复制则会悬空
+            AstraZSet(const AstraZSet &) = delete;
+            AstraZSet &operator=(const AstraZSet &) = delete;
+            AstraZSet(AstraZSet &&) = default;
+            AstraZSet &operator=(AstraZSet &&) = default;
 
             // ZADD命令：向有序集合添加元素
             int ZAdd(const std::map<std::string, double> &members) {
@@ -284,9 +476,9 @@ namespace Astra {
                     auto member_it = member_to_score_.find(member);
                     if (member_it != member_to_score_.end()) {
                         // 如果分数不同，需要更新
-                        if (member_it->second != score) {
+                        if (member_it->second.score != score) {
                             // 从旧分数中移除
-                            auto range = score_to_members_.equal_range(member_it->second);
+                            auto range = score_to_members_.equal_range(member_it->second.score);
                             for (auto it = range.first; it != range.second; ++it) {
                                 if (it->second == member) {
                                     score_to_members_.erase(it);
@@ -294,15 +486,16 @@ namespace Astra {
                                 }
                             }
 
-                            // 更新分数
-                            member_it->second = score;
+                            // 更新分数（ZSCAN 序号不变）
+                            member_it->second.score = score;
 
                             // 添加到新分数
                             score_to_members_.emplace(score, member);
                         }
                     } else {
                         // 新成员
-                        member_to_score_[member] = score;
+                        auto inserted = member_to_score_.emplace(member, Entry{score, next_stamp_++}).first;
+                        scan_order_.emplace(inserted->second.stamp, &*inserted);
                         score_to_members_.emplace(score, member);
                         added++;
                     }
@@ -316,7 +509,7 @@ namespace Astra {
                 for (const auto &member: members) {
                     auto member_it = member_to_score_.find(member);
                     if (member_it != member_to_score_.end()) {
-                        double score = member_it->second;
+                        double score = member_it->second.score;
 
                         // 从分数映射中移除
                         auto range = score_to_members_.equal_range(score);
@@ -328,6 +521,7 @@ namespace Astra {
                         }
 
                         // 从成员映射中移除
+                        scan_order_.erase(member_it->second.stamp);
                         member_to_score_.erase(member_it);
                         removed++;
                     }
@@ -376,18 +570,227 @@ namespace Astra {
                 return result;
             }
 
+            // 按分数区间 [min, max] 从小到大回调 fn(score, member)，fn 返回 false 时停止；O(log N + M)
+            template<typename Fn>
+            void ForEachByScore(double min, double max, Fn &&fn) const {
+                for (auto it = score_to_members_.lower_bound(min); it != score_to_members_.end() && it->first <= max; ++it) {
+                    if (!fn(it->first, it->second)) return;
+                }
+            }
+
             // ZSCORE命令：获取成员的分数
             std::pair<bool, double> ZScore(const std::string &member) const {
                 auto it = member_to_score_.find(member);
                 if (it != member_to_score_.end()) {
-                    return {true, it->second};
+                    return {true, it->second.score};
                 }
                 return {false, 0.0};
             }
 
+            // ZSCAN：按成员加入的先后遍历，游标是下一个成员的序号（0 表示从头开始）。
+            // 对至多 count 个成员回调 fn(member, score)，返回下一次调用的游标，0 表示遍历结束。
+            // 序号只增不减且改分数时不变，遍历期间一直存在的成员不会漏掉也不会重复；O(log N + count)
+            template<typename Fn>
+            uint64_t Scan(uint64_t cursor, size_t count, Fn &&fn) const {
+                auto it = scan_order_.lower_bound(cursor);
+                for (size_t visited = 0; it != scan_order_.end() && visited < count; ++it, ++visited) {
+                    fn(it->second->first, it->second->second.score);
+                }
+                return it == scan_order_.end() ? 0 : it->first;
+            }
+
+            // 快照编码："zset:" 后按分数顺序排列 "长度:成员" "长度:分数" 块，分数取能精确还原的最短十进制
+            static constexpr std::string_view kPrefix = "zset:";
+
+            std::string Serialize() const {
+                std::string out(kPrefix);
+                char buf[32];
+                for (const auto &[score, member]: score_to_members_) {
+                    WriteChunk(out, member);
+                    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), score);
+                    WriteChunk(out, std::string_view(buf, static_cast<size_t>(end - buf)));
+                }
+                return out;
+            }
+
+            // 编码损坏时返回 nullopt
+            static std::optional<AstraZSet> Deserialize(std::string_view data) {
+                if (!data.starts_with(kPrefix)) return std::nullopt;
+                AstraZSet zset;
+                size_t pos = kPrefix.size();
+                while (pos < data.size()) {
+                    std::string_view member, text;
+                    if (!ReadChunk(data, pos, member) || !ReadChunk(data, pos, text)) return std::nullopt;
+                    double score;
+                    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), score);
+                    if (ec != std::errc() || ptr != text.data() + text.size() || std::isnan(score)) return std::nullopt;
+                    auto [it, inserted] = zset.member_to_score_.emplace(member, Entry{score, zset.next_stamp_++});
+                    if (!inserted) return std::nullopt;
+                    zset.scan_order_.emplace(it->second.stamp, &*it);
+                    zset.score_to_members_.emplace(score, it->first);
+                }
+                return zset;
+            }
+
+        private:
+            struct Entry {
+                double score;
+                uint64_t stamp;// 加入时分配的 ZSCAN 序号
+            };
+            using Member = std::pair<const std::string, Entry>;
+
+            std::unordered_map<std::string, Entry> member_to_score_;// 成员到分数的映射
+            std::multimap<double, std::string> score_to_members_;   // 分数到成员的映射（支持相同分数的多个成员）
+            std::map<uint64_t, const Member *> scan_order_;         // ZSCAN 的遍历顺序，节点地址在重哈希时不变
+            uint64_t next_stamp_ = 1;
+        };
+
+
+        // Stream类型实现：条目存放在紧凑的 StreamLog 中，另外维护消费组状态
+        class AstraStream {
+        public:
+            using StreamID = datastructures::StreamID;
+
+            // 已投递但尚未 XACK 的条目
+            struct PendingEntry {
+                std::string consumer;
+                int64_t delivery_time_ms = 0;
+                uint64_t delivery_count = 0;
+            };
+
+            struct ConsumerGroup {
+                StreamID last_delivered;
+                std::map<StreamID, PendingEntry> pending;     // PEL，按 ID 有序
+                std::map<std::string, int64_t> consumers;     // 消费者 -> 最近活跃时间
+            };
+
+            datastructures::StreamLog &Log() { return log_; }
+            const datastructures::StreamLog &Log() const { return log_; }
+
+            bool CreateGroup(const std::string &name, const StreamID &last_delivered) {
+                return groups_.emplace(name, ConsumerGroup{last_delivered, {}, {}}).second;
+            }
+
+            bool DestroyGroup(const std::string &name) {
+                return groups_.erase(name) > 0;
+            }
+
+            ConsumerGroup *FindGroup(const std::string &name) {
+                auto it = groups_.find(name);
+                return it == groups_.end() ? nullptr : &it->second;
+            }
+
+            size_t GroupCount() const {
+                return groups_.size();
+            }
+
+            // 快照编码："stream:" 后接 "长度:内容" 块：最后 ID、条目数、每条的 ID/字段数/字段与值，
+            // 然后是消费组数、每组的名字/last_delivered/PEL/消费者。条目已被裁剪时最后 ID 仍原样保留
+            static constexpr std::string_view kPrefix = "stream:";
+
+            std::string Serialize() const {
+                std::string out(kPrefix);
+                WriteChunk(out, log_.LastID().ToString());
+                auto entries = log_.Range(StreamID::Min(), StreamID::Max());
+                WriteIntegerChunk(out, entries.size());
+                for (const auto &entry: entries) {
+                    WriteChunk(out, entry.id.ToString());
+                    WriteIntegerChunk(out, entry.fields.size());
+                    for (const auto &[field, value]: entry.fields) {
+                        WriteChunk(out, field);
+                        WriteChunk(out, value);
+                    }
+                }
+                WriteIntegerChunk(out, groups_.size());
+                for (const auto &[name, group]: groups_) {
+                    WriteChunk(out, name);
+                    WriteChunk(out, group.last_delivered.ToString());
+                    WriteIntegerChunk(out, group.pending.size());
+                    for (const auto &[id, pending]: group.pending) {
+                        WriteChunk(out, id.ToString());
+                        WriteChunk(out, pending.consumer);
+                        WriteIntegerChunk(out, pending.delivery_time_ms);
+                        WriteIntegerChunk(out, pending.delivery_count);
+                    }
+                    WriteIntegerChunk(out, group.consumers.size());
+                    for (const auto &[consumer, seen_ms]: group.consumers) {
+                        WriteChunk(out, consumer);
+                        WriteIntegerChunk(out, seen_ms);
+                    }
+                }
+                return out;
+            }
+
+            // 编码损坏（含多余数据）时返回 nullopt
+            static std::optional<AstraStream> Deserialize(std::string_view data) {
+                if (!data.starts_with(kPrefix)) return std::nullopt;
+                size_t pos = kPrefix.size();
+                auto read_id = [&](StreamID &id) {
+                    std::string_view chunk;
+                    if (!ReadChunk(data, pos, chunk)) return false;
+                    auto parsed = StreamID::Parse(chunk);
+                    if (!parsed) return false;
+                    id = *parsed;
+                    return true;
+                };
+
+                AstraStream stream;
+                StreamID last_id;
+                size_t entry_count = 0;
+                if (!read_id(last_id) || !ReadIntegerChunk(data, pos, entry_count)) return std::nullopt;
+                for (size_t i = 0; i < entry_count; ++i) {
+                    StreamID id;
+                    size_t field_count = 0;
+                    if (!read_id(id) || !ReadIntegerChunk(data, pos, field_count)) return std::nullopt;
+                    datastructures::StreamFields fields;
+                    for (size_t j = 0; j < field_count; ++j) {
+                        std::string_view field, value;
+                        if (!ReadChunk(data, pos, field) || !ReadChunk(data, pos, value)) return std::nullopt;
+                        fields.emplace_back(field, value);
+                    }
+                    if (!stream.log_.Append(id, fields)) return std::nullopt;
+                }
+                stream.log_.RestoreLastID(last_id);
+
+                size_t group_count = 0;
+                if (!ReadIntegerChunk(data, pos, group_count)) return std::nullopt;
+                for (size_t i = 0; i < group_count; ++i) {
+                    std::string_view name;
+                    ConsumerGroup group;
+                    size_t pending_count = 0;
+                    if (!ReadChunk(data, pos, name) || !read_id(group.last_delivered) ||
+                        !ReadIntegerChunk(data, pos, pending_count)) {
+                        return std::nullopt;
+                    }
+                    for (size_t j = 0; j < pending_count; ++j) {
+                        StreamID id;
+                        std::string_view consumer;
+                        PendingEntry pending;
+                        if (!read_id(id) || !ReadChunk(data, pos, consumer) ||
+                            !ReadIntegerChunk(data, pos, pending.delivery_time_ms) ||
+                            !ReadIntegerChunk(data, pos, pending.delivery_count)) {
+                            return std::nullopt;
+                        }
+                        pending.consumer = consumer;
+                        group.pending.emplace(id, std::move(pending));
+                    }
+                    size_t consumer_count = 0;
+                    if (!ReadIntegerChunk(data, pos, consumer_count)) return std::nullopt;
+                    for (size_t j = 0; j < consumer_count; ++j) {
+                        std::string_view consumer;
+                        int64_t seen_ms = 0;
+                        if (!ReadChunk(data, pos, consumer) || !ReadIntegerChunk(data, pos, seen_ms)) return std::nullopt;
+                        group.consumers.emplace(consumer, seen_ms);
+                    }
+                    stream.groups_.emplace(name, std::move(group));
+                }
+                if (pos != data.size()) return std::nullopt;
+                return stream;
+            }
+
         private:
-            std::unordered_map<std::string, double> member_to_score_;// 成员到分数的映射
-            std::multimap<double, std::string> score_to_members_;    // 分数到成员的映射（支持相同分数的多个成员）
+            datastructures::StreamLog log_;
+            std::map<std::string, ConsumerGroup> groups_;
         };
 
     }// namespace data
@@ -0,0 +1,24 @@
+#pragma once
+#include <asio/detail/config.hpp>
+
+namespace Astra::network {
+
+    // asio 的套接字后端在编译期选定：Linux 默认 epoll，
+    // 以 -DASTRA_ENABLE_IO_URING=ON 构建时改为 io_uring（需要 liburing），运行时无法切换
+    inline constexpr const char *IOBackendName() {
+#if defined(ASIO_HAS_IO_URING_AS_DEFAULT)
+        return "io_uring";
+#elif defined(ASIO_HAS_IOCP)
+        return "iocp";
+#elif defined(ASIO_HAS_EPOLL)
+        return "epoll";
+#elif defined(ASIO_HAS_KQUEUE)
+        return "kqueue";
+#elif defined(ASIO_HAS_DEV_POLL)
+        return "/dev/poll";
+#else
+        return "select";
+#endif
+    }
+
+}// namespace Astra::network
@@ -16,14 +16,29 @@ public:
     AsioIOServicePool &operator=(const AsioIOServicePool &) = delete;
 
     asio::io_context &GetIOService();
+    asio::io_context &GetIOService(std::size_t index) { return _ioServices[index]; }
+    std::size_t Size() const { return _ioServices.size(); }
     void Stop();
 
+    // 在第一次 GetInstance 之前设置 IO 线程数，0 表示按 CPU 核数
+    static void SetPoolSize(std::size_t size) { ConfiguredSize() = size; }
+
     static std::shared_ptr<AsioIOServicePool> GetInstance() {
         return Singleton<AsioIOServicePool>::GetInstance();
     }
 
 private:
-    AsioIOServicePool(std::size_t size = 2 /*std::thread::hardware_concurrency()*/);
+    AsioIOServicePool(std::size_t size = ConfiguredSize());
+
+    static std::size_t &ConfiguredSize() {
+        static std::size_t size = 0;
+        return size;
+    }
+
+    static std::size_t ResolveSize(std::size_t size) {
+        if (size == 0) size = std::thread::hardware_concurrency();
+        return size == 0 ? 2 : size;
+    }
 
     std::vector<IOService> _ioServices;
     std::vector<WorkPtr> _works;
@@ -31,9 +46,9 @@ private:
     std::size_t _nextIOService;
 };
 
-inline AsioIOServicePool::AsioIOServicePool(std::size_t size) : _ioServices(size),
-                                                                _works(size), _nextIOService(0) {
-    for (std::size_t i = 0; i < size; ++i) {
+inline AsioIOServicePool::AsioIOServicePool(std::size_t size) : _ioServices(ResolveSize(size)),
+                                                                _works(_ioServices.size()), _nextIOService(0) {
+    for (std::size_t i = 0; i < _ioServices.size(); ++i) {
         _works[i] = std::make_unique<Work>(asio::make_work_guard(_ioServices[i]));
     }
 
@@ -14,6 +14,9 @@
 #include <chrono>
 #include <datastructures/lru_cache.hpp>
 #include <filesystem>
+#include <functional>
+#include <optional>
+#include <type_traits>
 
 // 检查LevelDB是否可用
 #if __has_include(<leveldb/db.h>)
@@ -35,10 +38,12 @@ namespace Astra::Persistence {
      * @tparam Value 值类型
      * @param cache 要保存的缓存实例
      * @param db_path LevelDB数据库路径
+     * @param encode 可选，把缓存中的值转换成保存的形式，返回 nullopt 时跳过该项
      * @return 保存成功返回true，否则返回false
      */
     template<template<typename, typename> class CacheStrategy, typename Key, typename Value>
-    bool SaveCacheToLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path) {
+    bool SaveCacheToLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path,
+                            const std::type_identity_t<std::function<std::optional<Value>(const Key &, const Value &)>> &encode = {}) {
         // 确保目录存在
         if (!utils::ensureDirectoryExists(db_path)) {
             ZEN_LOG_ERROR("Cannot create directory for LevelDB: {}", db_path);
@@ -61,14 +66,19 @@ namespace Astra::Persistence {
         try {
             for (const auto &entry: cache.GetAllEntries()) {
                 const Key &key = entry.first;
-                const Value &value = entry.second;
+                std::optional<Value> encoded;
+                if (encode) {
+                    encoded = encode(key, entry.second);
+                    if (!encoded) continue;
+                }
+                const Value &value = encoded ? *encoded : entry.second;
 
                 // 序列化键值对和过期时间
                 auto expire_time_opt = cache.GetExpiryTime(key);
                 int64_t expire_time = 0;
                 if (expire_time_opt.has_value()) {
-                    // GetExpiryTime返回的是std::chrono::seconds类型
-                    expire_time = expire_time_opt.value().count() * 1000;// 转换为毫秒
+                    // GetExpiryTime返回的是剩余毫秒数
+                    expire_time = expire_time_opt.value().count();
                 }
 
                 // 构造存储值：value + expire_time
@@ -104,10 +114,12 @@ namespace Astra::Persistence {
      * @tparam Value 值类型
      * @param cache 要加载的缓存实例
      * @param db_path LevelDB数据库路径
+     * @param decode 可选，转换读到的值，返回 nullopt 时跳过该项
      * @return 加载成功返回true，否则返回false
      */
     template<template<typename, typename> class CacheStrategy, typename Key, typename Value>
-    bool LoadCacheFromLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path) {
+    bool LoadCacheFromLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path,
+                              const std::type_identity_t<std::function<std::optional<Value>(const Key &, const Value &)>> &decode = {}) {
         ZEN_LOG_INFO("Loading cache from LevelDB: {}", db_path);
 
         if (!std::filesystem::exists(db_path)) {
@@ -137,11 +149,15 @@ namespace Astra::Persistence {
                 if (pos != std::string::npos) {
                     std::string value = stored_value.substr(0, pos);
                     int64_t expire_time = std::stoll(stored_value.substr(pos + 1));
+                    if (decode) {
+                        auto decoded = decode(key, value);
+                        if (!decoded) continue;
+                        value = std::move(*decoded);
+                    }
 
                     // 恢复缓存项
                     if (expire_time > 0) {
-                        // 使用std::chrono::seconds而不是time_point
-                        cache.Put(key, value, std::chrono::seconds(expire_time / 1000));
+                        cache.Put(key, value, std::chrono::milliseconds(expire_time));
                     } else {
                         cache.Put(key, value);
                     }
@@ -170,13 +186,15 @@ namespace Astra::Persistence {
 #else
     // 如果LevelDB不可用，提供空实现
     template<template<typename, typename> class CacheStrategy, typename Key, typename Value>
-    bool SaveCacheToLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path) {
+    bool SaveCacheToLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path,
+                            const std::type_identity_t<std::function<std::optional<Value>(const Key &, const Value &)>> & = {}) {
         ZEN_LOG_WARN("LevelDB support not available. Cannot save cache to LevelDB: {}", db_path);
         return false;
     }
 
     template<template<typename, typename> class CacheStrategy, typename Key, typename Value>
-    bool LoadCacheFromLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path) {
+    bool LoadCacheFromLevelDB(Astra::datastructures::AstraCache<CacheStrategy, Key, Value> &cache, const std::string &db_path,
+                              const std::type_identity_t<std::function<std::optional<Value>(const Key &, const Value &)>> & = {}) {
         ZEN_LOG_WARN("LevelDB support not available. Cannot load cache from LevelDB: {}", db_path);
         return false;
     }
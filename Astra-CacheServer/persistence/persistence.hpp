@@ -10,8 +10,13 @@
 #include "util_path.hpp"
 #include <chrono>
 #include <datastructures/lru_cache.hpp>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <functional>
+#include <optional>
+#include <type_traits>
 #include <sstream>
 namespace Astra::Persistence {
     namespace fs = std::filesystem;
@@ -19,8 +24,58 @@ namespace Astra::Persistence {
     using namespace utils;
     using namespace std::chrono_literals;
 
+    // 快照文件第一行；之后每项一行："键长度:键 值长度:值 过期毫秒"，键和值可以包含空格、换行等任意字节。
+    // 没有这一行的旧文件按 "键 值 过期毫秒" 逐行读取
+    inline constexpr std::string_view kSnapshotHeader = "ASTRA-SNAPSHOT 2";
+
+    namespace detail {
+        // 从 pos 读取 "长度:内容"，成功后 pos 指向内容之后
+        inline bool ReadSized(const std::string &data, size_t &pos, std::string &out) {
+            size_t colon = data.find(':', pos);
+            if (colon == std::string::npos) return false;
+            size_t len = 0;
+            auto [ptr, ec] = std::from_chars(data.data() + pos, data.data() + colon, len);
+            if (ec != std::errc() || ptr != data.data() + colon || len > data.size() - colon - 1) return false;
+            out.assign(data, colon + 1, len);
+            pos = colon + 1 + len;
+            return true;
+        }
+
+        // 读取一项记录，格式见 kSnapshotHeader；失败时 pos 跳到下一行
+        inline bool ReadRecord(const std::string &data, size_t &pos, std::string &key, std::string &value, int64_t &expire_ms) {
+            size_t start = pos;
+            if (ReadSized(data, pos, key) && pos < data.size() && data[pos] == ' ' &&
+                ReadSized(data, ++pos, value) && pos < data.size() && data[pos] == ' ') {
+                size_t end = data.find('\n', ++pos);
+                if (end == std::string::npos) end = data.size();
+                auto [ptr, ec] = std::from_chars(data.data() + pos, data.data() + end, expire_ms);
+                if (ec == std::errc() && ptr == data.data() + end) {
+                    pos = end + 1;
+                    return true;
+                }
+            }
+            size_t next = data.find('\n', start);
+            pos = next == std::string::npos ? data.size() : next + 1;
+            return false;
+        }
+
+        // 旧格式的一行，值中可能有空格，取首尾两个空格之间的部分
+        inline bool ReadLegacyLine(const std::string &line, std::string &key, std::string &value, int64_t &expire_ms) {
+            size_t key_end = line.find(' ');
+            size_t expire_begin = line.rfind(' ');
+            if (key_end == std::string::npos || expire_begin == key_end) return false;
+            auto [ptr, ec] = std::from_chars(line.data() + expire_begin + 1, line.data() + line.size(), expire_ms);
+            if (ec != std::errc() || ptr != line.data() + line.size()) return false;
+            key = line.substr(0, key_end);
+            value = line.substr(key_end + 1, expire_begin - key_end - 1);
+            return true;
+        }
+    }// namespace detail
+
+    // encode 可选：把缓存中的值转换成写入文件的形式（如句柄换成本体的编码），返回 nullopt 时跳过该项
     template<template<typename, typename> class CacheStrategy, typename Key, typename Value>
-    bool SaveCacheToFile(AstraCache<CacheStrategy, Key, Value> &cache, const std::string &filename) {
+    bool SaveCacheToFile(AstraCache<CacheStrategy, Key, Value> &cache, const std::string &filename,
+                         const std::type_identity_t<std::function<std::optional<Value>(const Key &, const Value &)>> &encode = {}) {
         // 确保目录存在
         if (!ensureDirectoryExists(filename)) {
             ZEN_LOG_ERROR("Cannot create directory for file: {}", filename);
@@ -38,22 +93,26 @@ namespace Astra::Persistence {
         }
 
         try {
+            out << kSnapshotHeader << "\n";
             for (const auto &entry: cache.GetAllEntries()) {
                 const Key &key = entry.first;
-                const Value &value = entry.second;
+                std::optional<Value> encoded;
+                if (encode) {
+                    encoded = encode(key, entry.second);
+                    if (!encoded) continue;
+                }
+                const Value &value = encoded ? *encoded : entry.second;
 
                 // 获取过期时间
                 auto expire_time_opt = cache.GetExpiryTime(key);
                 int64_t expire_time = 0;
 
                 if (expire_time_opt.has_value()) {
-                    expire_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                          expire_time_opt.value())
-                                          .count();
+                    expire_time = expire_time_opt.value().count();
                 }
 
                 // 写入键值对和过期时间
-                out << key << " " << value << " " << expire_time << "\n";
+                out << key.size() << ":" << key << " " << value.size() << ":" << value << " " << expire_time << "\n";
                 ZEN_LOG_DEBUG("KEY: {} VALUE: {} EXPIRE_TIME: {}", key, value, expire_time);
             }
 
@@ -76,9 +135,10 @@ namespace Astra::Persistence {
         }
     }
 
-    // 从文件恢复缓存
+    // 从文件恢复缓存；decode 可选：转换读到的值，返回 nullopt 时跳过该项
     template<template<typename, typename> class CacheStrategy, typename Key, typename Value>
-    bool LoadCacheFromFile(AstraCache<CacheStrategy, Key, Value> &cache, const std::string &filename) {
+    bool LoadCacheFromFile(AstraCache<CacheStrategy, Key, Value> &cache, const std::string &filename,
+                           const std::type_identity_t<std::function<std::optional<Value>(const Key &, const Value &)>> &decode = {}) {
         ZEN_LOG_INFO("Loading cache from file: {}", filename);
 
         // 检查文件是否存在
@@ -95,25 +155,42 @@ namespace Astra::Persistence {
         }
 
         try {
-            std::string line;
+            std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            size_t pos = 0;
+            bool sized = data.starts_with(kSnapshotHeader) && data.size() > kSnapshotHeader.size() &&
+                         data[kSnapshotHeader.size()] == '\n';
+            if (sized) pos = kSnapshotHeader.size() + 1;
+
             size_t loaded_count = 0;
             size_t error_count = 0;
 
-            while (std::getline(in, line)) {
-                std::istringstream iss(line);
+            while (pos < data.size()) {
                 Key key;
                 Value value;
-                int64_t expire_s = 0;
-
-                if (!(iss >> key >> value >> expire_s)) {
-                    ZEN_LOG_WARN("Failed to parse line: {}", line);
+                int64_t expire_ms = 0;
+                bool parsed;
+                if (sized) {
+                    parsed = detail::ReadRecord(data, pos, key, value, expire_ms);
+                } else {
+                    size_t end = data.find('\n', pos);
+                    if (end == std::string::npos) end = data.size();
+                    parsed = detail::ReadLegacyLine(data.substr(pos, end - pos), key, value, expire_ms);
+                    pos = end + 1;
+                }
+                if (!parsed) {
+                    ZEN_LOG_WARN("Failed to parse snapshot record in {}", filename);
                     error_count++;
                     continue;
                 }
+                if (decode) {
+                    auto decoded = decode(key, value);
+                    if (!decoded) continue;
+                    value = std::move(*decoded);
+                }
 
                 // 使用 Put 方法保证 LRU 正确性
-                if (expire_s > 0) {
-                    cache.Put(key, value, std::chrono::seconds(expire_s));
+                if (expire_ms > 0) {
+                    cache.Put(key, value, std::chrono::milliseconds(expire_ms));
                 } else {
                     cache.Put(key, value);
                 }
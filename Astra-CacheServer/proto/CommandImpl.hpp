@@ -2,50 +2,129 @@
  * ┌───────────────────────────────────────────────────────────────────────────────────┐
  * │ 📚 Astra Redis 命令索引（Command Index）                                                 │
  * ├───────────────────────────────────────────────────────────────────────────────────┤
- * │  1. COMMAND   → CommandCommand::Execute                                          │
- * │  2. DECR      → DecrCommand::Execute                                             │
- * │  3. DECRBY    → DecrByCommand::Execute                                           │
- * │  4. DEL       → DelCommand::Execute                                              │
- * │  5. EVAL      → EvalCommand::Execute                                             │
- * │  6. EVALSHA   → EvalShaCommand::Execute                                          │
- * │  7. EXISTS    → ExistsCommand::Execute                                           │
- * │  8. GET       → GetCommand::Execute                                              │
- * │  9. HDEL      → HDelCommand::Execute                                             │
- * │ 10. HEXISTS   → HExistsCommand::Execute                                          │
- * │ 11. HGET      → HGetCommand::Execute                                             │
- * │ 12. HGETALL   → HGetAllCommand::Execute                                          │
- * │ 13. HKEYS     → HKeysCommand::Execute                                            │
- * │ 14. HLEN      → HLenCommand::Execute                                             │
- * │ 15. HSET      → HSetCommand::Execute                                             │
- * │ 16. HVALS     → HValsCommand::Execute                                            │
- * │ 17. INCR      → IncrCommand::Execute                                             │
- * │ 18. INCRBY    → IncrByCommand::Execute                                           │
- * │ 19. INFO      → InfoCommand::Execute                                             │
- * │ 20. KEYS      → KeysCommand::Execute                                             │
- * │ 21. LINDEX    → LIndexCommand::Execute                                           │
- * │ 22. LLEN      → LLenCommand::Execute                                             │
- * │ 23. LPOP      → LPopCommand::Execute                                             │
- * │ 24. LPUSH     → LPushCommand::Execute                                            │
- * │ 25. LRANGE    → LRangeCommand::Execute                                           │
- * │ 26. MGET      → MGetCommand::Execute                                             │
- * │ 27. MSET      → MSetCommand::Execute                                             │
- * │ 28. PING      → PingCommand::Execute                                             │
- * │ 29. RPOP      → RPopCommand::Execute                                             │
- * │ 30. RPUSH     → RPushCommand::Execute                                            │
- * │ 31. SADD      → SAddCommand::Execute                                             │
- * │ 32. SCARD     → SCardCommand::Execute                                            │
- * │ 33. SET       → SetCommand::Execute                                              │
- * │ 34. SISMEMBER → SIsMemberCommand::Execute                                        │
- * │ 35. SMEMBERS  → SMembersCommand::Execute                                         │
- * │ 36. SPOP      → SPopCommand::Execute                                             │
- * │ 37. SREM      → SRemCommand::Execute                                             │
- * │ 38. TTL       → TtlCommand::Execute                                              │
- * │ 39. ZADD      → ZAddCommand::Execute                                             │
- * │ 40. ZCARD     → ZCardCommand::Execute                                            │
- * │ 41. ZRANGE    → ZRangeCommand::Execute                                           │
- * │ 42. ZRANGEBYSCORE→ ZRangeByScoreCommand::Execute                                 │
- * │ 43. ZREM      → ZRemCommand::Execute                                             │
- * │ 44. ZSCORE    → ZScoreCommand::Execute                                           │
+ * │  1. APPEND    → AppendCommand::Execute                                           │
+ * │  2. BF.ADD    → BfAddCommand::Execute                                            │
+ * │  3. BF.EXISTS → BfExistsCommand::Execute                                         │
+ * │  4. BF.INFO   → BfInfoCommand::Execute                                           │
+ * │  5. BF.MADD   → BfMAddCommand::Execute                                           │
+ * │  6. BF.MEXISTS→ BfMExistsCommand::Execute                                        │
+ * │  7. BF.RESERVE→ BfReserveCommand::Execute                                        │
+ * │  8. BITCOUNT  → BitCountCommand::Execute                                         │
+ * │  9. BITFIELD  → BitFieldCommand::Execute                                         │
+ * │ 10. BITOP     → BitOpCommand::Execute                                            │
+ * │ 11. BITPOS    → BitPosCommand::Execute                                           │
+ * │ 12. BLMOVE    → BLMoveCommand::Execute                                           │
+ * │ 13. BLPOP     → BLPopCommand::Execute                                            │
+ * │ 14. BRPOP     → BRPopCommand::Execute                                            │
+ * │ 15. CAPACITY  → UnknownCommand::Execute                                          │
+ * │ 16. CMS.INCRBY→ CmsIncrByCommand::Execute                                        │
+ * │ 17. CMS.INFO  → CmsInfoCommand::Execute                                          │
+ * │ 18. CMS.INITBYDIM→ CmsInitByDimCommand::Execute                                  │
+ * │ 19. CMS.INITBYPROB→ CmsInitByProbCommand::Execute                                │
+ * │ 20. CMS.QUERY → CmsQueryCommand::Execute                                         │
+ * │ 21. COMMAND   → CommandCommand::Execute                                          │
+ * │ 22. COUNTER.CREATE→ CounterCreateCommand::Execute                                │
+ * │ 23. COUNTER.DROP→ CounterDropCommand::Execute                                    │
+ * │ 24. COUNTER.GET→ CounterGetCommand::Execute                                      │
+ * │ 25. DECR      → DecrCommand::Execute                                             │
+ * │ 26. DECRBY    → DecrByCommand::Execute                                           │
+ * │ 27. DEL       → DelCommand::Execute                                              │
+ * │ 28. EVAL      → EvalCommand::Execute                                             │
+ * │ 29. EVALSHA   → EvalShaCommand::Execute                                          │
+ * │ 30. EXISTS    → ExistsCommand::Execute                                           │
+ * │ 31. GEOADD    → GeoAddCommand::Execute                                           │
+ * │ 32. GEODIST   → GeoDistCommand::Execute                                          │
+ * │ 33. GEOPOS    → GeoPosCommand::Execute                                           │
+ * │ 34. GEOSEARCH → GeoSearchCommand::Execute                                        │
+ * │ 35. GET       → GetCommand::Execute                                              │
+ * │ 36. GETBIT    → GetBitCommand::Execute                                           │
+ * │ 37. GETDEL    → GetDelCommand::Execute                                           │
+ * │ 38. GETEX     → GetExCommand::Execute                                            │
+ * │ 39. GETRANGE  → GetRangeCommand::Execute                                         │
+ * │ 40. HDEL      → HDelCommand::Execute                                             │
+ * │ 41. HEXISTS   → HExistsCommand::Execute                                          │
+ * │ 42. HGET      → HGetCommand::Execute                                             │
+ * │ 43. HGETALL   → HGetAllCommand::Execute                                          │
+ * │ 44. HINCRBY   → HIncrByCommand::Execute                                          │
+ * │ 45. HINCRBYFLOAT→ HIncrByFloatCommand::Execute                                   │
+ * │ 46. HKEYS     → HKeysCommand::Execute                                            │
+ * │ 47. HLEN      → HLenCommand::Execute                                             │
+ * │ 48. HMGET     → HMGetCommand::Execute                                            │
+ * │ 49. HMSET     → UnknownCommand::Execute                                          │
+ * │ 50. HSCAN     → HScanCommand::Execute                                            │
+ * │ 51. HSET      → HSetCommand::Execute                                             │
+ * │ 52. HSETNX    → HSetNxCommand::Execute                                           │
+ * │ 53. HSTRLEN   → HStrLenCommand::Execute                                          │
+ * │ 54. HVALS     → HValsCommand::Execute                                            │
+ * │ 55. INCR      → IncrCommand::Execute                                             │
+ * │ 56. INCRBY    → IncrByCommand::Execute                                           │
+ * │ 57. INCRBYFLOAT→ IncrByFloatCommand::Execute                                     │
+ * │ 58. INFO      → InfoCommand::Execute                                             │
+ * │ 59. JSON.ARRAPPEND→ JsonArrAppendCommand::Execute                                │
+ * │ 60. JSON.DEL  → JsonDelCommand::Execute                                          │
+ * │ 61. JSON.GET  → JsonGetCommand::Execute                                          │
+ * │ 62. JSON.NUMINCRBY→ JsonNumIncrByCommand::Execute                                │
+ * │ 63. JSON.SET  → JsonSetCommand::Execute                                          │
+ * │ 64. KEYS      → KeysCommand::Execute                                             │
+ * │ 65. LINDEX    → LIndexCommand::Execute                                           │
+ * │ 66. LLEN      → LLenCommand::Execute                                             │
+ * │ 67. LPOP      → LPopCommand::Execute                                             │
+ * │ 68. LPUSH     → LPushCommand::Execute                                            │
+ * │ 69. LRANGE    → LRangeCommand::Execute                                           │
+ * │ 70. MGET      → MGetCommand::Execute                                             │
+ * │ 71. MSET      → MSetCommand::Execute                                             │
+ * │ 72. MSETNX    → MSetNxCommand::Execute                                           │
+ * │ 73. PFADD     → PfAddCommand::Execute                                            │
+ * │ 74. PFCOUNT   → PfCountCommand::Execute                                          │
+ * │ 75. PFMERGE   → PfMergeCommand::Execute                                          │
+ * │ 76. PING      → PingCommand::Execute                                             │
+ * │ 77. PSETEX    → UnknownCommand::Execute                                          │
+ * │ 78. PTTL      → UnknownCommand::Execute                                          │
+ * │ 79. RPOP      → RPopCommand::Execute                                             │
+ * │ 80. RPUSH     → RPushCommand::Execute                                            │
+ * │ 81. SADD      → SAddCommand::Execute                                             │
+ * │ 82. SCARD     → SCardCommand::Execute                                            │
+ * │ 83. SDIFF     → SDiffCommand::Execute                                            │
+ * │ 84. SDIFFSTORE→ SDiffStoreCommand::Execute                                       │
+ * │ 85. SET       → SetCommand::Execute                                              │
+ * │ 86. SETBIT    → SetBitCommand::Execute                                           │
+ * │ 87. SETEX     → SetExCommand::Execute                                            │
+ * │ 88. SETNX     → SetNxCommand::Execute                                            │
+ * │ 89. SETRANGE  → SetRangeCommand::Execute                                         │
+ * │ 90. SINTER    → SInterCommand::Execute                                           │
+ * │ 91. SINTERCARD→ SInterCardCommand::Execute                                       │
+ * │ 92. SINTERSTORE→ SInterStoreCommand::Execute                                     │
+ * │ 93. SISMEMBER → SIsMemberCommand::Execute                                        │
+ * │ 94. SMEMBERS  → SMembersCommand::Execute                                         │
+ * │ 95. SPOP      → SPopCommand::Execute                                             │
+ * │ 96. SREM      → SRemCommand::Execute                                             │
+ * │ 97. SSCAN     → SScanCommand::Execute                                            │
+ * │ 98. STRLEN    → StrLenCommand::Execute                                           │
+ * │ 99. SUNION    → SUnionCommand::Execute                                           │
+ * │ 100. SUNIONSTORE→ SUnionStoreCommand::Execute                                    │
+ * │ 101. TOPK.ADD  → TopKAddCommand::Execute                                         │
+ * │ 102. TOPK.INCRBY→ UnknownCommand::Execute                                        │
+ * │ 103. TOPK.INFO → TopKInfoCommand::Execute                                        │
+ * │ 104. TOPK.LIST → TopKListCommand::Execute                                        │
+ * │ 105. TOPK.QUERY→ TopKQueryCommand::Execute                                       │
+ * │ 106. TOPK.RESERVE→ TopKReserveCommand::Execute                                   │
+ * │ 107. TTL       → TtlCommand::Execute                                             │
+ * │ 108. XACK      → XAckCommand::Execute                                            │
+ * │ 109. XADD      → XAddCommand::Execute                                            │
+ * │ 110. XGROUP    → XGroupCommand::Execute                                          │
+ * │ 111. XLEN      → XLenCommand::Execute                                            │
+ * │ 112. XPENDING  → XPendingCommand::Execute                                        │
+ * │ 113. XRANGE    → XRangeCommand::Execute                                          │
+ * │ 114. XREAD     → XReadCommand::Execute                                           │
+ * │ 115. XREADGROUP→ XReadGroupCommand::Execute                                      │
+ * │ 116. XREVRANGE → XRevRangeCommand::Execute                                       │
+ * │ 117. ZADD      → ZAddCommand::Execute                                            │
+ * │ 118. ZCARD     → ZCardCommand::Execute                                           │
+ * │ 119. ZRANGE    → ZRangeCommand::Execute                                          │
+ * │ 120. ZRANGEBYSCORE→ ZRangeByScoreCommand::Execute                                │
+ * │ 121. ZREM      → ZRemCommand::Execute                                            │
+ * │ 122. ZSCAN     → ZScanCommand::Execute                                           │
+ * │ 123. ZSCORE    → ZScoreCommand::Execute                                          │
  * └───────────────────────────────────────────────────────────────────────────────────┘
  */
 
@@ -56,13 +135,35 @@
 #include "caching/AstraCacheStrategy.hpp"
 #include "command_parser.hpp"
 #include "data/redis_types.hpp"
+#include "hello.hpp"
+#include "network/io_backend.hpp"
 #include "resp_builder.hpp"
+#include "scan_cursor.hpp"
+#include "server/BlockingManager.hpp"
 #include "server/ChannelManager.hpp"
+#include "server/CounterManager.hpp"
+#include "server/JsonManager.hpp"
+#include "server/StreamManager.hpp"
+#include "server/ZSetManager.hpp"
 #include "server/server_status.h"
 #include "server/session.hpp"
+#include <array>
+#include <bit>
 #include <chrono>
+#include <datastructures/bloom_filter.hpp>
+#include <datastructures/hyperloglog.hpp>
+#include <datastructures/json_document.hpp>
 #include <datastructures/lru_cache.hpp>
+#include <datastructures/set_algebra.hpp>
+#include <datastructures/sketch.hpp>
+#include <datastructures/stream_log.hpp>
+#include <deque>
+#include <limits>
 #include <memory>
+#include <sstream>
+#include <utils/bitops.hpp>
+#include <utils/geohash.hpp>
+#include <utils/glob.hpp>
 
 namespace Astra::proto {
     using namespace datastructures;
@@ -141,6 +242,12 @@ namespace Astra::proto {
             if (argv.size() < 2) {
                 return RespBuilder::Error("wrong number of arguments for 'GET'");
             }
+            // SPLIT 模式计数器的缓存值只在折叠时更新，读取时汇总各计数单元得到精确值
+            static const auto counters = apps::CounterManager::GetInstance();
+            if (auto *counter = counters->Find(argv[1]); counter && cache_->Contains(argv[1])) {
+                return RespBuilder::BulkString(std::to_string(counter->Read()));
+            }
+
             auto val = cache_->Get(argv[1]);
             if (!val) {
                 return RespBuilder::Nil();
@@ -152,29 +259,287 @@ namespace Astra::proto {
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
+    // SET 系列命令（SET/SETNX/SETEX/PSETEX/MSETNX/GETEX/GETDEL）
+    // 过期时间统一换算成相对的毫秒数；"先判断再写"的组合在一次 Atomically 内完成，NX/XX/GET 不会与并发写交错。
+
+    // EX/PX 为相对时长，EXAT/PXAT 为 Unix 时间戳
+    enum class ExpireUnit { Seconds,
+                            Milliseconds,
+                            UnixSeconds,
+                            UnixMilliseconds };
+
+    inline bool ParseExpireUnit(const std::string &arg, ExpireUnit &unit) {
+        if (ICaseCmp(arg, "EX")) {
+            unit = ExpireUnit::Seconds;
+        } else if (ICaseCmp(arg, "PX")) {
+            unit = ExpireUnit::Milliseconds;
+        } else if (ICaseCmp(arg, "EXAT")) {
+            unit = ExpireUnit::UnixSeconds;
+        } else if (ICaseCmp(arg, "PXAT")) {
+            unit = ExpireUnit::UnixMilliseconds;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // 解析过期参数并换算为相对毫秒数；参数必须为正，绝对时间已经过去时 ttl <= 0
+    inline bool ParseExpire(const std::string &arg, ExpireUnit unit, std::chrono::milliseconds &ttl) {
+        // 上限取 steady_clock 可表示范围的一半，now() + ttl 不会溢出
+        constexpr int64_t kMaxTtlMs =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::duration::max()).count() / 2;
+
+        int64_t value;
+        if (!ParseInt64(arg, value) || value <= 0) return false;
+
+        bool seconds = unit == ExpireUnit::Seconds || unit == ExpireUnit::UnixSeconds;
+        if (seconds && value > INT64_MAX / 1000) return false;
+        int64_t ms = seconds ? value * 1000 : value;
+
+        if (unit == ExpireUnit::UnixSeconds || unit == ExpireUnit::UnixMilliseconds) {
+            ms -= std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+        }
+        if (ms > kMaxTtlMs) return false;
+        ttl = std::chrono::milliseconds(ms);
+        return true;
+    }
+
+    struct SetOptions {
+        bool nx = false;
+        bool xx = false;
+        bool get = false;
+        bool keep_ttl = false;
+        bool has_expire = false;
+        std::chrono::milliseconds ttl{0};
+    };
+
+    // 解析 SET key value 之后的选项，出错时返回错误回复
+    inline std::optional<std::string> ParseSetOptions(const std::vector<std::string> &argv, SetOptions &opts) {
+        for (size_t i = 3; i < argv.size(); ++i) {
+            const std::string &arg = argv[i];
+            ExpireUnit unit;
+            if (ICaseCmp(arg, "NX") && !opts.xx) {
+                opts.nx = true;
+            } else if (ICaseCmp(arg, "XX") && !opts.nx) {
+                opts.xx = true;
+            } else if (ICaseCmp(arg, "GET")) {
+                opts.get = true;
+            } else if (ICaseCmp(arg, "KEEPTTL") && !opts.has_expire) {
+                opts.keep_ttl = true;
+            } else if (ParseExpireUnit(arg, unit) && !opts.keep_ttl && !opts.has_expire && i + 1 < argv.size()) {
+                if (!ParseExpire(argv[++i], unit, opts.ttl)) {
+                    return RespBuilder::Error("ERR invalid expire time in 'set' command");
+                }
+                opts.has_expire = true;
+            } else {
+                return RespBuilder::Error("ERR syntax error");
+            }
+        }
+        return std::nullopt;
+    }
+
+    struct SetOutcome {
+        bool written = false;
+        std::optional<std::string> old;// 仅在 opts.get 时填充
+    };
+
+    // 按 SET 语义写入一个键：NX/XX 条件、GET 取旧值、KEEPTTL 保留过期时间，全部在一次加锁内完成
+    inline SetOutcome SetString(AstraCache<LRUCache, std::string, std::string> &cache,
+                                const std::string &key, const std::string &value, const SetOptions &opts) {
+        return cache.Atomically(key, [&](auto &strategy) {
+            SetOutcome outcome;
+            bool exists = strategy.Visit(key, [&](const std::string *current) {
+                if (current && opts.get) outcome.old = *current;
+                return current != nullptr;
+            });
+            if ((opts.nx && exists) || (opts.xx && !exists)) return outcome;
+
+            outcome.written = true;
+            if (opts.has_expire && opts.ttl.count() <= 0) {
+                // EXAT/PXAT 已经过去：写入后立即过期，等同于删除
+                strategy.Remove(key);
+            } else if (opts.keep_ttl && exists) {
+                strategy.Update(key, [&](std::string &current, bool) {
+                    current = value;
+                    return 0;
+                });
+            } else {
+                strategy.Put(key, value, opts.has_expire ? opts.ttl : std::chrono::milliseconds::zero());
+            }
+            return outcome;
+        });
+    }
+
+    // SET key value [NX|XX] [GET] [EX s|PX ms|EXAT ts|PXAT ts-ms|KEEPTTL]
     class SetCommand : public ICommand {
     public:
         explicit SetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache) : cache_(std::move(cache)) {}
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 3) return RespBuilder::Error("wrong number of arguments for 'SET'");
 
-            std::chrono::seconds ttl(0);
+            SetOptions opts;
+            if (auto error = ParseSetOptions(argv, opts)) return *error;
 
-            if (argv.size() >= 5 && (argv[3] == "EX" || argv[3] == "ex")) {
-                try {
-                    ttl = std::chrono::seconds(std::stoi(argv[4]));
-                } catch (...) {
-                    return RespBuilder::Error("invalid expire time");
-                }
-                cache_->Put(argv[1], argv[2], ttl);
-            } else if (argv.size() == 3) {
-                cache_->Put(argv[1], argv[2], ttl);
-            } else {
-                return RespBuilder::Error("syntax error");
+            auto outcome = SetString(*cache_, argv[1], argv[2], opts);
+            if (opts.get) {
+                return outcome.old ? RespBuilder::BulkString(*outcome.old) : RespBuilder::Nil();
+            }
+            return outcome.written ? RespBuilder::SimpleString("OK") : RespBuilder::Nil();
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // SETNX key value
+    class SetNxCommand : public ICommand {
+    public:
+        explicit SetNxCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'setnx' command");
+            }
+            SetOptions opts;
+            opts.nx = true;
+            return RespBuilder::Integer(SetString(*cache_, argv[1], argv[2], opts).written ? 1 : 0);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // SETEX key seconds value / PSETEX key milliseconds value
+    class SetExCommand : public ICommand {
+    public:
+        explicit SetExCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache,
+                              ExpireUnit unit = ExpireUnit::Seconds)
+            : cache_(std::move(cache)), unit_(unit) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            const char *name = unit_ == ExpireUnit::Seconds ? "setex" : "psetex";
+            if (argv.size() != 4) {
+                return RespBuilder::Error(std::string("ERR wrong number of arguments for '") + name + "' command");
+            }
+
+            SetOptions opts;
+            if (!ParseExpire(argv[2], unit_, opts.ttl)) {
+                return RespBuilder::Error(std::string("ERR invalid expire time in '") + name + "' command");
             }
+            opts.has_expire = true;
+            SetString(*cache_, argv[1], argv[3], opts);
             return RespBuilder::SimpleString("OK");
         }
 
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+        ExpireUnit unit_;
+    };
+
+    class PSetExCommand : public SetExCommand {
+    public:
+        explicit PSetExCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : SetExCommand(std::move(cache), ExpireUnit::Milliseconds) {}
+    };
+
+    // MSETNX key value [key value ...]：只有所有键都不存在时才全部写入
+    class MSetNxCommand : public ICommand {
+    public:
+        explicit MSetNxCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3 || argv.size() % 2 == 0) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'msetnx' command");
+            }
+
+            bool written = cache_->Atomically([&](auto &strategy) {
+                for (size_t i = 1; i < argv.size(); i += 2) {
+                    if (strategy.HasKey(argv[i])) return false;
+                }
+                for (size_t i = 1; i < argv.size(); i += 2) {
+                    strategy.Put(argv[i], argv[i + 1]);
+                }
+                return true;
+            });
+            return RespBuilder::Integer(written ? 1 : 0);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // GETDEL key
+    class GetDelCommand : public ICommand {
+    public:
+        explicit GetDelCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'getdel' command");
+            }
+
+            // SPLIT 模式的计数器先折叠并退出，返回的是精确值，之后的 INCR 走普通路径
+            static const auto counters = apps::CounterManager::GetInstance();
+            if (!counters->Empty()) counters->Drop(*cache_, argv[1]);
+
+            auto value = cache_->Atomically(argv[1], [&](auto &strategy) {
+                auto current = strategy.Get(argv[1]);
+                if (current) strategy.Remove(argv[1]);
+                return current;
+            });
+            return value ? RespBuilder::BulkString(*value) : RespBuilder::Nil();
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // GETEX key [EX s|PX ms|EXAT ts|PXAT ts-ms|PERSIST]
+    class GetExCommand : public ICommand {
+    public:
+        explicit GetExCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'getex' command");
+            }
+
+            bool persist = false;
+            bool has_expire = false;
+            std::chrono::milliseconds ttl{0};
+            ExpireUnit unit;
+            if (argv.size() == 3 && ICaseCmp(argv[2], "PERSIST")) {
+                persist = true;
+            } else if (argv.size() == 4 && ParseExpireUnit(argv[2], unit)) {
+                if (!ParseExpire(argv[3], unit, ttl)) {
+                    return RespBuilder::Error("ERR invalid expire time in 'getex' command");
+                }
+                has_expire = true;
+            } else if (argv.size() != 2) {
+                return RespBuilder::Error("ERR syntax error");
+            }
+
+            auto value = cache_->Atomically(argv[1], [&](auto &strategy) {
+                auto current = strategy.Get(argv[1]);
+                if (!current) return current;
+                if (persist) {
+                    strategy.Persist(argv[1]);
+                } else if (has_expire && ttl.count() <= 0) {
+                    strategy.Remove(argv[1]);
+                } else if (has_expire) {
+                    strategy.Expire(argv[1], ttl);
+                }
+                return current;
+            });
+            return value ? RespBuilder::BulkString(*value) : RespBuilder::Nil();
+        }
+
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
@@ -185,8 +550,12 @@ namespace Astra::proto {
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 2) return RespBuilder::Error("wrong number of arguments for 'DEL'");
 
+            // 删除前让 SPLIT 模式的计数器同步退出：DEL 返回后的 INCR 会走普通路径重新建键，
+            // 不会落进稍后折叠时才发现键已删除的计数器里
+            static const auto counters = apps::CounterManager::GetInstance();
             size_t count = 0;
             for (size_t i = 1; i < argv.size(); ++i) {
+                if (!counters->Empty()) counters->Drop(*cache_, argv[i]);
                 if (cache_->Remove(argv[i])) ++count;
             }
             return RespBuilder::Integer(count);
@@ -215,20 +584,42 @@ namespace Astra::proto {
         CommandCommand() = default;
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            std::vector<CommandInfo> commands = {
+            const auto &commands = Table();
+            if (IsSubCommand(argv, "DOCS")) {
+                std::vector<std::string> requestedCommands;
+                for (size_t i = 2; i < argv.size(); ++i) {
+                    requestedCommands.push_back(argv[i]);
+                }
+                return CommandResponseBuilder::BuildCommandDocsResponse(commands, requestedCommands);
+            } else {
+                return CommandResponseBuilder::BuildCommandListResponse(commands);
+            }
+        }
+
+        // 命令元数据表：COMMAND 的回复和分片模式下按键路由（first_key/last_key/key_step）共用
+        static const std::vector<CommandInfo> &Table() {
+            static const std::vector<CommandInfo> commands = {
                     {"GET", 2, {"readonly", "fast"}, 1, 1, 1, 0, "string", "Get the value of a key", "1.0.0", "O(1)", {}, {}, {}},
 
                     {"SET", -3, {"write"}, 1, 1, 1, 0, "string", "Set the string value of a key", "1.0.0", "O(1)", {}, {}, {}},
+                    {"SETNX", 3, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "string", "Set the value of a key, only if the key does not exist", "1.0.0", "O(1)", {}, {}, {}},
+                    {"SETEX", 4, {"write", "denyoom"}, 1, 1, 1, 0, "string", "Set the value and expiration of a key", "2.0.0", "O(1)", {}, {}, {}},
+                    {"PSETEX", 4, {"write", "denyoom"}, 1, 1, 1, 0, "string", "Set the value and expiration in milliseconds of a key", "2.6.0", "O(1)", {}, {}, {}},
+                    {"MSETNX", -3, {"write", "denyoom"}, 1, -1, 2, 0, "string", "Set multiple keys to multiple values, only if none of the keys exist", "1.0.1", "O(N)", {}, {}, {}},
+                    {"GETDEL", 2, {"write", "fast"}, 1, 1, 1, 0, "string", "Get the value of a key and delete the key", "6.2.0", "O(1)", {}, {}, {}},
+                    {"GETEX", -2, {"write", "fast"}, 1, 1, 1, 0, "string", "Get the value of a key and optionally set its expiration", "6.2.0", "O(1)", {}, {}, {}},
 
-                    {"DEL", -2, {"write"}, 1, 1, 1, 0, "keyspace", "Delete a key", "1.0.0", "O(N)", {}, {}, {}},
+                    {"DEL", -2, {"write"}, 1, -1, 1, 0, "keyspace", "Delete a key", "1.0.0", "O(N)", {}, {}, {}},
 
                     {"PING", 1, {"readonly", "fast"}, 0, 0, 0, 0, "connection", "Ping the server", "1.0.0", "O(1)", {}, {}, {}},
+                    {"HELLO", -1, {"noscript", "fast"}, 0, 0, 0, 0, "connection", "Handshake with the server and select the protocol version", "6.0.0", "O(1)", {}, {}, {}},
 
                     {"INFO", -1, {"readonly"}, 0, 0, 0, 0, "server", "Get information and statistics about the server", "1.0.0", "O(1)", {}, {}, {}},
 
-                    {"KEYS", -2, {"readonly"}, 1, 1, 1, 0, "keyspace", "Find all keys matching the given pattern", "1.0.0", "O(N)", {}, {}, {}},
+                    {"KEYS", -2, {"readonly"}, 0, 0, 0, 0, "keyspace", "Find all keys matching the given pattern", "1.0.0", "O(N)", {}, {}, {}},
 
                     {"TTL", 2, {"readonly"}, 1, 1, 1, 0, "keyspace", "Get the time to live for a key", "1.0.0", "O(1)", {}, {}, {}},
+                    {"PTTL", 2, {"readonly", "fast"}, 1, 1, 1, 0, "keyspace", "Get the time to live for a key in milliseconds", "2.6.0", "O(1)", {}, {}, {}},
 
                     {"INCR", 2, {"write"}, 1, 1, 1, 0, "string", "Increment the integer value of a key by one", "1.0.0", "O(1)", {}, {}, {}},
 
@@ -238,15 +629,71 @@ namespace Astra::proto {
 
                     {"DECRBY", 3, {"write"}, 1, 1, 1, 0, "string", "Decrement the integer value of a key by the given amount", "1.0.0", "O(1)", {}, {}, {}},
 
+                    {"INCRBYFLOAT", 3, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "string", "Increment the float value of a key by the given amount", "2.6.0", "O(1)", {}, {}, {}},
+                    {"APPEND", 3, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "string", "Append a value to a key", "2.0.0", "O(1)", {}, {}, {}},
+                    {"SETRANGE", 4, {"write", "denyoom"}, 1, 1, 1, 0, "string", "Overwrite part of a string at key starting at the specified offset", "2.2.0", "O(1)", {}, {}, {}},
+                    {"GETRANGE", 4, {"readonly"}, 1, 1, 1, 0, "string", "Get a substring of the string stored at a key", "2.4.0", "O(N)", {}, {}, {}},
+                    {"STRLEN", 2, {"readonly", "fast"}, 1, 1, 1, 0, "string", "Get the length of the value stored in a key", "2.2.0", "O(1)", {}, {}, {}},
+
+                    {"COUNTER.CREATE", 3, {"write", "denyoom"}, 1, 1, 1, 0, "string", "Switch an integer key to split-counter mode for contention-free increments", "1.0.0", "O(1)", {}, {}, {}},
+
+                    {"COUNTER.GET", 2, {"readonly", "fast"}, 1, 1, 1, 0, "string", "Return the exact value of a counter, aggregating split-counter cells", "1.0.0", "O(1)", {}, {}, {}},
+
+                    {"COUNTER.DROP", 2, {"write"}, 1, 1, 1, 0, "string", "Fold a split counter back into a plain integer key", "1.0.0", "O(1)", {}, {}, {}},
+
                     {"EXISTS", 2, {"readonly"}, 1, 1, 1, 0, "keyspace", "Determine if a key exists", "1.0.0", "O(1)", {}, {}, {}},
 
                     {"MGET", -2, {"readonly", "fast"}, 1, -1, 1, 0, "string", "Get the values of multiple keys", "1.0.0", "O(N)", {}, {}, {}},
 
-                    {"MSET", -3, {"write"}, 1, 1, 1, 0, "string", "Set multiple keys to multiple values", "1.0.1", "O(N)", {}, {}, {}},
+                    {"MSET", -3, {"write"}, 1, -1, 2, 0, "string", "Set multiple keys to multiple values", "1.0.1", "O(N)", {}, {}, {}},
+
+                    {"SETBIT", 4, {"write", "denyoom"}, 1, 1, 1, 0, "bitmap", "Sets or clears the bit at offset in the string value stored at key", "2.2.0", "O(1)", {}, {}, {}},
+
+                    {"GETBIT", 3, {"readonly", "fast"}, 1, 1, 1, 0, "bitmap", "Returns the bit value at offset in the string value stored at key", "2.2.0", "O(1)", {}, {}, {}},
+
+                    {"BITCOUNT", -2, {"readonly"}, 1, 1, 1, 0, "bitmap", "Count set bits in a string", "2.6.0", "O(N)", {}, {}, {}},
+
+                    {"BITPOS", -3, {"readonly"}, 1, 1, 1, 0, "bitmap", "Find first bit set or clear in a string", "2.8.7", "O(N)", {}, {}, {}},
+
+                    {"BITOP", -4, {"write", "denyoom"}, 2, -1, 1, 0, "bitmap", "Perform bitwise operations between strings", "2.6.0", "O(N)", {}, {}, {}},
+
+                    {"BITFIELD", -2, {"write", "denyoom"}, 1, 1, 1, 0, "bitmap", "Perform arbitrary bitfield integer operations on strings", "3.2.0", "O(1)", {}, {}, {}},
+
+                    {"PFADD", -2, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "hyperloglog", "Adds the specified elements to the specified HyperLogLog", "2.8.9", "O(1)", {}, {}, {}},
+
+                    {"PFCOUNT", -2, {"readonly"}, 1, -1, 1, 0, "hyperloglog", "Return the approximated cardinality of the set(s) observed by the HyperLogLog at key(s)", "2.8.9", "O(1)", {}, {}, {}},
+
+                    {"PFMERGE", -2, {"write", "denyoom"}, 1, -1, 1, 0, "hyperloglog", "Merge N different HyperLogLogs into a single one", "2.8.9", "O(N)", {}, {}, {}},
+
+                    {"BF.RESERVE", -4, {"write", "denyoom"}, 1, 1, 1, 0, "bloom", "Creates a new Bloom filter", "1.0.0", "O(1)", {}, {}, {}},
+                    {"BF.ADD", 3, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "bloom", "Adds an item to a Bloom filter", "1.0.0", "O(k)", {}, {}, {}},
+                    {"BF.MADD", -3, {"write", "denyoom"}, 1, 1, 1, 0, "bloom", "Adds one or more items to a Bloom filter", "1.0.0", "O(k * n)", {}, {}, {}},
+                    {"BF.EXISTS", 3, {"readonly", "fast"}, 1, 1, 1, 0, "bloom", "Checks whether an item exists in a Bloom filter", "1.0.0", "O(k)", {}, {}, {}},
+                    {"BF.MEXISTS", -3, {"readonly"}, 1, 1, 1, 0, "bloom", "Checks whether one or more items exist in a Bloom filter", "1.0.0", "O(k * n)", {}, {}, {}},
+                    {"BF.INFO", -2, {"readonly", "fast"}, 1, 1, 1, 0, "bloom", "Returns information about a Bloom filter", "1.0.0", "O(1)", {}, {}, {}},
+
+                    {"CMS.INITBYDIM", 4, {"write", "denyoom"}, 1, 1, 1, 0, "cms", "Initializes a Count-Min Sketch to dimensions specified by user", "2.0.0", "O(1)", {}, {}, {}},
+                    {"CMS.INITBYPROB", 4, {"write", "denyoom"}, 1, 1, 1, 0, "cms", "Initializes a Count-Min Sketch to accommodate requested tolerances", "2.0.0", "O(1)", {}, {}, {}},
+                    {"CMS.INCRBY", -4, {"write", "denyoom"}, 1, 1, 1, 0, "cms", "Increases the count of one or more items by increment", "2.0.0", "O(n)", {}, {}, {}},
+                    {"CMS.QUERY", -3, {"readonly"}, 1, 1, 1, 0, "cms", "Returns the count for one or more items in a sketch", "2.0.0", "O(n)", {}, {}, {}},
+                    {"CMS.INFO", 2, {"readonly", "fast"}, 1, 1, 1, 0, "cms", "Returns information about a sketch", "2.0.0", "O(1)", {}, {}, {}},
+                    {"TOPK.RESERVE", -3, {"write", "denyoom"}, 1, 1, 1, 0, "topk", "Initializes a Top-K sketch with specified parameters", "2.0.0", "O(1)", {}, {}, {}},
+                    {"TOPK.ADD", -3, {"write", "denyoom"}, 1, 1, 1, 0, "topk", "Increases the count of one or more items by increment", "2.0.0", "O(n * k)", {}, {}, {}},
+                    {"TOPK.INCRBY", -4, {"write", "denyoom"}, 1, 1, 1, 0, "topk", "Increases the count of one or more items by increment", "2.0.0", "O(n * k * incr)", {}, {}, {}},
+                    {"TOPK.QUERY", -3, {"readonly"}, 1, 1, 1, 0, "topk", "Checks whether one or more items are in a sketch", "2.0.0", "O(n)", {}, {}, {}},
+                    {"TOPK.LIST", -2, {"readonly"}, 1, 1, 1, 0, "topk", "Return full list of items in Top K list", "2.0.0", "O(k*log(k))", {}, {}, {}},
+                    {"TOPK.INFO", 2, {"readonly", "fast"}, 1, 1, 1, 0, "topk", "Returns information about a sketch", "2.0.0", "O(1)", {}, {}, {}},
 
                     {"HSET", -4, {"write", "fast"}, 1, 1, 1, 0, "hash", "Set the string value of a hash field", "2.0.0", "O(1)", {}, {}, {}},
 
                     {"HGET", 3, {"readonly", "fast"}, 1, 1, 1, 0, "hash", "Get the value of a hash field", "2.0.0", "O(1)", {}, {}, {}},
+                    {"HMSET", -4, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "hash", "Set multiple hash fields to multiple values", "2.0.0", "O(N)", {}, {}, {}},
+                    {"HMGET", -3, {"readonly", "fast"}, 1, 1, 1, 0, "hash", "Get the values of all the given hash fields", "2.0.0", "O(N)", {}, {}, {}},
+                    {"HSETNX", 4, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "hash", "Set the value of a hash field, only if the field does not exist", "2.0.0", "O(1)", {}, {}, {}},
+                    {"HSTRLEN", 3, {"readonly", "fast"}, 1, 1, 1, 0, "hash", "Get the length of the value of a hash field", "3.2.0", "O(1)", {}, {}, {}},
+                    {"HINCRBY", 4, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "hash", "Increment the integer value of a hash field by the given number", "2.0.0", "O(1)", {}, {}, {}},
+                    {"HINCRBYFLOAT", 4, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "hash", "Increment the float value of a hash field by the given amount", "2.6.0", "O(1)", {}, {}, {}},
+                    {"HSCAN", -3, {"readonly"}, 1, 1, 1, 0, "hash", "Incrementally iterate hash fields and associated values", "2.8.0", "O(1)", {}, {}, {}},
 
                     {"HGETALL", 2, {"readonly", "fast"}, 1, 1, 1, 0, "hash", "Get all the fields and values in a hash", "2.0.0", "O(N)", {}, {}, {}},
 
@@ -268,6 +715,12 @@ namespace Astra::proto {
 
                     {"RPOP", -2, {"write", "fast"}, 1, 1, 1, 0, "list", "Remove and get the last element in a list", "1.0.0", "O(N)", {}, {}, {}},
 
+                    {"BLPOP", -3, {"write", "blocking"}, 1, -2, 1, 0, "list", "Remove and get the first element in a list, or block until one is available", "2.0.0", "O(N)", {}, {}, {}},
+
+                    {"BRPOP", -3, {"write", "blocking"}, 1, -2, 1, 0, "list", "Remove and get the last element in a list, or block until one is available", "2.0.0", "O(N)", {}, {}, {}},
+
+                    {"BLMOVE", 6, {"write", "denyoom", "blocking"}, 1, 2, 1, 0, "list", "Pop an element from a list, push it to another list and return it; or block until one is available", "6.2.0", "O(1)", {}, {}, {}},
+
                     {"LLEN", 2, {"readonly", "fast"}, 1, 1, 1, 0, "list", "Get the length of a list", "1.0.0", "O(1)", {}, {}, {}},
 
                     {"LRANGE", 4, {"readonly"}, 1, 1, 1, 0, "list", "Get a range of elements from a list", "1.0.0", "O(S+N)", {}, {}, {}},
@@ -281,11 +734,26 @@ namespace Astra::proto {
                     {"SCARD", 2, {"readonly", "fast"}, 1, 1, 1, 0, "set", "Get the number of members in a set", "1.0.0", "O(1)", {}, {}, {}},
 
                     {"SMEMBERS", 2, {"readonly", "fast"}, 1, 1, 1, 0, "set", "Get all the members in a set", "1.0.0", "O(N)", {}, {}, {}},
+                    {"SSCAN", -3, {"readonly"}, 1, 1, 1, 0, "set", "Incrementally iterate Set elements", "2.8.0", "O(1)", {}, {}, {}},
 
                     {"SISMEMBER", 3, {"readonly", "fast"}, 1, 1, 1, 0, "set", "Determine if a given value is a member of a set", "1.0.0", "O(1)", {}, {}, {}},
 
                     {"SPOP", 2, {"write", "fast"}, 1, 1, 1, 0, "set", "Remove and return one or multiple random members from a set", "1.0.0", "O(1)", {}, {}, {}},
 
+                    {"SINTER", -2, {"readonly"}, 1, -1, 1, 0, "set", "Intersect multiple sets", "1.0.0", "O(N*M)", {}, {}, {}},
+
+                    {"SUNION", -2, {"readonly"}, 1, -1, 1, 0, "set", "Add multiple sets", "1.0.0", "O(N)", {}, {}, {}},
+
+                    {"SDIFF", -2, {"readonly"}, 1, -1, 1, 0, "set", "Subtract multiple sets", "1.0.0", "O(N)", {}, {}, {}},
+
+                    {"SINTERSTORE", -3, {"write"}, 1, -1, 1, 0, "set", "Intersect multiple sets and store the resulting set in a key", "1.0.0", "O(N*M)", {}, {}, {}},
+
+                    {"SUNIONSTORE", -3, {"write"}, 1, -1, 1, 0, "set", "Add multiple sets and store the resulting set in a key", "1.0.0", "O(N)", {}, {}, {}},
+
+                    {"SDIFFSTORE", -3, {"write"}, 1, -1, 1, 0, "set", "Subtract multiple sets and store the resulting set in a key", "1.0.0", "O(N)", {}, {}, {}},
+
+                    {"SINTERCARD", -3, {"readonly", "movablekeys"}, 2, -1, 1, 0, "set", "Intersect multiple sets and return the cardinality of the result", "7.0.0", "O(N*M)", {}, {}, {}},
+
                     {"ZADD", -4, {"write", "fast"}, 1, 1, 1, 0, "zset", "Add one or more members to a sorted set, or update its score if it already exists", "1.2.0", "O(log(N))", {}, {}, {}},
 
                     {"ZREM", -3, {"write", "fast"}, 1, 1, 1, 0, "zset", "Remove one or more members from a sorted set", "1.2.0", "O(log(N))", {}, {}, {}},
@@ -296,23 +764,43 @@ namespace Astra::proto {
 
                     {"ZRANGEBYSCORE", -4, {"readonly"}, 1, 1, 1, 0, "zset", "Return a range of members in a sorted set, by score", "1.2.0", "O(log(N)+M)", {}, {}, {}},
 
+                    {"ZSCAN", -3, {"readonly"}, 1, 1, 1, 0, "zset", "Incrementally iterate sorted sets elements and associated scores", "2.8.0", "O(1)", {}, {}, {}},
                     {"ZSCORE", 3, {"readonly", "fast"}, 1, 1, 1, 0, "zset", "Get the score associated with the given member in a sorted set", "1.2.0", "O(1)", {}, {}, {}},
 
+                    {"GEOADD", -5, {"write", "denyoom"}, 1, 1, 1, 0, "geo", "Add one or more geospatial items in the geospatial index represented using a sorted set", "3.2.0", "O(log(N))", {}, {}, {}},
+                    {"GEOPOS", -2, {"readonly"}, 1, 1, 1, 0, "geo", "Returns longitude and latitude of members of a geospatial index", "3.2.0", "O(N)", {}, {}, {}},
+                    {"GEODIST", -4, {"readonly"}, 1, 1, 1, 0, "geo", "Returns the distance between two members of a geospatial index", "3.2.0", "O(log(N))", {}, {}, {}},
+                    {"GEOSEARCH", -7, {"readonly"}, 1, 1, 1, 0, "geo", "Query a sorted set representing a geospatial index to fetch members inside an area of a box or a circle", "6.2.0", "O(N+log(M))", {}, {}, {}},
+                    {"JSON.SET", -4, {"write", "denyoom"}, 1, 1, 1, 0, "json", "Sets or updates the JSON value at a path", "1.0.0", "O(M+N)", {}, {}, {}},
+                    {"JSON.GET", -2, {"readonly"}, 1, 1, 1, 0, "json", "Gets the value at one or more paths in JSON serialized form", "1.0.0", "O(N)", {}, {}, {}},
+                    {"JSON.NUMINCRBY", 4, {"write", "denyoom"}, 1, 1, 1, 0, "json", "Increments the numeric value at a path by a value", "1.0.0", "O(1)", {}, {}, {}},
+                    {"JSON.ARRAPPEND", -4, {"write", "denyoom"}, 1, 1, 1, 0, "json", "Appends one or more values to the array at a path", "1.0.0", "O(1)", {}, {}, {}},
+                    {"JSON.DEL", -2, {"write"}, 1, 1, 1, 0, "json", "Deletes a value at a path", "1.0.0", "O(N)", {}, {}, {}},
+
+                    {"XADD", -5, {"write", "denyoom", "fast"}, 1, 1, 1, 0, "stream", "Appends a new entry to a stream", "5.0.0", "O(1)", {}, {}, {}},
+
+                    {"XLEN", 2, {"readonly", "fast"}, 1, 1, 1, 0, "stream", "Return the number of entries in a stream", "5.0.0", "O(1)", {}, {}, {}},
+
+                    {"XRANGE", -4, {"readonly"}, 1, 1, 1, 0, "stream", "Return a range of elements in a stream, with IDs matching the specified IDs interval", "5.0.0", "O(N)", {}, {}, {}},
+
+                    {"XREVRANGE", -4, {"readonly"}, 1, 1, 1, 0, "stream", "Return a range of elements in a stream, with IDs matching the specified IDs interval, in reverse order", "5.0.0", "O(N)", {}, {}, {}},
+
+                    {"XREAD", -4, {"readonly", "blocking"}, 0, 0, 0, 0, "stream", "Return never seen elements in multiple streams, with IDs greater than the ones reported by the caller for each stream", "5.0.0", "O(N)", {}, {}, {}},
+
+                    {"XREADGROUP", -7, {"write", "blocking"}, 0, 0, 0, 0, "stream", "Return new entries from a stream using a consumer group, or access the history of the pending entries for a given consumer", "5.0.0", "O(M)", {}, {}, {}},
+
+                    {"XGROUP", -2, {"write"}, 2, 2, 1, 0, "stream", "Create or destroy consumer groups", "5.0.0", "O(1)", {}, {}, {}},
+
+                    {"XACK", -4, {"write", "fast"}, 1, 1, 1, 0, "stream", "Marks a pending message as correctly processed, effectively removing it from the pending entries list of the consumer group", "5.0.0", "O(1)", {}, {}, {}},
+
+                    {"XPENDING", -3, {"readonly"}, 1, 1, 1, 0, "stream", "Return information and entries from a stream consumer group pending entries list", "5.0.0", "O(N)", {}, {}, {}},
+
                     {"EVAL", -3, {"write", "scripting"}, 0, 0, 0, 0, "scripting", "Execute a Lua script server side", "2.6.0", "O(N)", {}, {}, {}},
 
                     {"EVALSHA", -3, {"write", "scripting"}, 0, 0, 0, 0, "scripting", "Execute a Lua script server side by SHA1", "2.6.0", "O(N)", {}, {}, {}},
 
                     {"COMMAND", 0, {"readonly", "admin"}, 0, 0, 0, 0, "server", "Get array of Redis command details", "2.8.13", "O(N)", {}, {}, {}}};
-
-            if (IsSubCommand(argv, "DOCS")) {
-                std::vector<std::string> requestedCommands;
-                for (size_t i = 2; i < argv.size(); ++i) {
-                    requestedCommands.push_back(argv[i]);
-                }
-                return CommandResponseBuilder::BuildCommandDocsResponse(commands, requestedCommands);
-            } else {
-                return CommandResponseBuilder::BuildCommandListResponse(commands);
-            }
+            return commands;
         }
     };
 
@@ -348,6 +836,9 @@ namespace Astra::proto {
             info += "arch_bits:";
             info += status.toCsr(status.arch_bits);
             info += "\r\n";
+            info += "multiplexing_api:";
+            info += network::IOBackendName();
+            info += "\r\n";
             info += "process_id:";
             info += status.toCsr(status.process_id);
             info += "\r\n";
@@ -442,14 +933,16 @@ namespace Astra::proto {
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
+    // TTL 返回四舍五入后的秒数，PTTL 返回毫秒数
     class TtlCommand : public ICommand {
     public:
-        explicit TtlCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
-            : cache_(std::move(cache)) {}
+        explicit TtlCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache, bool milliseconds = false)
+            : cache_(std::move(cache)), milliseconds_(milliseconds) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'TTL'");
+                return RespBuilder::Error(milliseconds_ ? "ERR wrong number of arguments for 'PTTL'"
+                                                        : "ERR wrong number of arguments for 'TTL'");
             }
 
             const std::string &key = argv[1];
@@ -469,13 +962,87 @@ namespace Astra::proto {
                 return RespBuilder::Integer(-2);
             }
 
-            return RespBuilder::Integer(remaining.count());
+            return RespBuilder::Integer(milliseconds_ ? remaining.count() : (remaining.count() + 500) / 1000);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+        bool milliseconds_;
+    };
+
+    class PTtlCommand : public TtlCommand {
+    public:
+        explicit PTtlCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : TtlCommand(std::move(cache), true) {}
     };
 
+    // 整数计数类命令（INCR/INCRBY/DECR/DECRBY/INCRBYFLOAT）
+    // 读、算、写在一次 Update 中完成：只查找一次，并发 INCR 不会丢失更新，键上的 TTL 也保持不变。
+    // 结果用 to_chars 直接写回原值的缓冲区，计数器这类短值全程不分配内存。
+
+    inline std::string IncrementInteger(AstraCache<LRUCache, std::string, std::string> &cache,
+                                        const std::string &key, int64_t delta) {
+        // SPLIT 模式的计数器只写本线程的计数单元，回复为近似值（见 COUNTER.CREATE）
+        static const auto counters = apps::CounterManager::GetInstance();
+        if (auto *counter = counters->Find(key)) {
+            return RespBuilder::Integer(counter->Add(delta));
+        }
+
+        enum class Outcome { Ok,
+                             NotInteger,
+                             Overflow };
+        int64_t result = 0;
+        auto outcome = cache.Update(key, [&](std::string &value, bool existed) {
+            int64_t current = 0;
+            if (existed && !ParseInt64(value, current)) return Outcome::NotInteger;
+            if ((delta > 0 && current > INT64_MAX - delta) || (delta < 0 && current < INT64_MIN - delta)) {
+                return Outcome::Overflow;
+            }
+
+            result = current + delta;
+            char buf[24];
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), result);
+            value.assign(buf, end);
+            return Outcome::Ok;
+        });
+
+        switch (outcome) {
+            case Outcome::NotInteger:
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            case Outcome::Overflow:
+                return RespBuilder::Error("ERR increment or decrement would overflow");
+            default:
+                return RespBuilder::Integer(result);
+        }
+    }
+
+    inline bool ParseLongDouble(const std::string &text, long double &value) {
+        if (text.empty() || std::isspace(static_cast<unsigned char>(text.front())) ||
+            std::isspace(static_cast<unsigned char>(text.back()))) {
+            return false;
+        }
+        char *end;
+        errno = 0;
+        value = std::strtold(text.c_str(), &end);
+        return *end == '\0' && errno != ERANGE && !std::isnan(value);
+    }
+
+    // 与 Redis 相同的人类可读格式：定点 17 位小数，去掉末尾的 0 和小数点
+    inline void FormatLongDouble(long double value, std::string &out) {
+        char buf[5120];
+        int len = std::snprintf(buf, sizeof(buf), "%.17Lf", value);
+        if (len <= 0 || static_cast<size_t>(len) >= sizeof(buf)) {
+            len = std::snprintf(buf, sizeof(buf), "%.17Lg", value);
+        }
+        std::string_view text(buf, static_cast<size_t>(len));
+        if (text.find('.') != std::string_view::npos) {
+            while (text.back() == '0') text.remove_suffix(1);
+            if (text.back() == '.') text.remove_suffix(1);
+        }
+        if (text == "-0") text = "0";
+        out.assign(text.data(), text.size());
+    }
+
     class IncrCommand : public ICommand {
     public:
         explicit IncrCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
@@ -485,30 +1052,7 @@ namespace Astra::proto {
             if (argv.size() != 2) {
                 return RespBuilder::Error("ERR wrong number of arguments for 'INCR'");
             }
-
-            const std::string &key = argv[1];
-            auto val = cache_->Get(key);
-
-            long long current = 0;
-            if (!val) {
-                // 键不存在，设置为 0 后加 1
-                cache_->Put(key, "1");
-                return RespBuilder::Integer(1);
-            }
-
-            char *end;
-            errno = 0;
-            current = std::strtoll(val->c_str(), &end, 10);
-            if (errno == ERANGE || current < LLONG_MIN || current > LLONG_MAX) {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-            if (*end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-
-            current += 1;
-            cache_->Put(key, std::to_string(current));
-            return RespBuilder::Integer(current);
+            return IncrementInteger(*cache_, argv[1], 1);
         }
 
     private:
@@ -525,47 +1069,11 @@ namespace Astra::proto {
                 return RespBuilder::Error("ERR wrong number of arguments for 'INCRBY'");
             }
 
-            const std::string &key = argv[1];
-            const std::string &increment_str = argv[2];
-
-            // 解析增量值
-            char *end;
-            errno = 0;
-            long long increment = std::strtoll(increment_str.c_str(), &end, 10);
-            if (errno == ERANGE || increment < LLONG_MIN || increment > LLONG_MAX) {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-            if (*end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-
-            auto val = cache_->Get(key);
-            long long current = 0;
-            if (!val) {
-                // 键不存在，设置为增量值
-                cache_->Put(key, std::to_string(increment));
-                return RespBuilder::Integer(increment);
-            }
-
-            // 解析当前值
-            errno = 0;
-            current = std::strtoll(val->c_str(), &end, 10);
-            if (errno == ERANGE || current < LLONG_MIN || current > LLONG_MAX) {
+            int64_t increment;
+            if (!ParseInt64(argv[2], increment)) {
                 return RespBuilder::Error("ERR value is not an integer or out of range");
             }
-            if (*end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-
-            // 检查加法溢出
-            if ((increment > 0 && current > LLONG_MAX - increment) ||
-                (increment < 0 && current < LLONG_MIN - increment)) {
-                return RespBuilder::Error("ERR increment or decrement would overflow");
-            }
-
-            current += increment;
-            cache_->Put(key, std::to_string(current));
-            return RespBuilder::Integer(current);
+            return IncrementInteger(*cache_, argv[1], increment);
         }
 
     private:
@@ -581,30 +1089,7 @@ namespace Astra::proto {
             if (argv.size() != 2) {
                 return RespBuilder::Error("ERR wrong number of arguments for 'DECR'");
             }
-
-            const std::string &key = argv[1];
-            auto val = cache_->Get(key);
-
-            long long current = 0;
-            if (!val) {
-                // 键不存在，设置为 0 后减 1
-                cache_->Put(key, "-1");
-                return RespBuilder::Integer(-1);
-            }
-
-            char *end;
-            errno = 0;
-            current = std::strtoll(val->c_str(), &end, 10);
-            if (errno == ERANGE || current < LLONG_MIN || current > LLONG_MAX) {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-            if (*end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-
-            current -= 1;
-            cache_->Put(key, std::to_string(current));
-            return RespBuilder::Integer(current);
+            return IncrementInteger(*cache_, argv[1], -1);
         }
 
     private:
@@ -621,87 +1106,183 @@ namespace Astra::proto {
                 return RespBuilder::Error("ERR wrong number of arguments for 'DECRBY'");
             }
 
-            const std::string &key = argv[1];
-            const std::string &decrement_str = argv[2];
-
-            // 解析减量值
-            char *end;
-            errno = 0;
-            long long decrement = std::strtoll(decrement_str.c_str(), &end, 10);
-            if (errno == ERANGE || decrement < LLONG_MIN || decrement > LLONG_MAX) {
+            int64_t decrement;
+            if (!ParseInt64(argv[2], decrement)) {
                 return RespBuilder::Error("ERR value is not an integer or out of range");
             }
-            if (*end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
+            if (decrement == INT64_MIN) {
+                return RespBuilder::Error("ERR decrement would overflow");
             }
+            return IncrementInteger(*cache_, argv[1], -decrement);
+        }
 
-            auto val = cache_->Get(key);
-            long long current = 0;
-            if (!val) {
-                // 键不存在，设置为负的减量值
-                cache_->Put(key, std::to_string(-decrement));
-                return RespBuilder::Integer(-decrement);
-            }
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-            // 解析当前值
-            errno = 0;
-            current = std::strtoll(val->c_str(), &end, 10);
-            if (errno == ERANGE || current < LLONG_MIN || current > LLONG_MAX) {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
-            if (*end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
+    // INCRBYFLOAT key increment
+    class IncrByFloatCommand : public ICommand {
+    public:
+        explicit IncrByFloatCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'incrbyfloat' command");
             }
 
-            // 检查减法溢出
-            if ((decrement > 0 && current < LLONG_MIN + decrement) ||
-                (decrement < 0 && current > LLONG_MAX + decrement)) {
-                return RespBuilder::Error("ERR increment or decrement would overflow");
+            long double increment;
+            if (!ParseLongDouble(argv[2], increment)) {
+                return RespBuilder::Error("ERR value is not a valid float");
             }
 
-            current -= decrement;
-            cache_->Put(key, std::to_string(current));
-            return RespBuilder::Integer(current);
+            enum class Outcome { Ok,
+                                 NotFloat,
+                                 NotFinite };
+            std::string result;
+            auto outcome = cache_->Update(argv[1], [&](std::string &value, bool existed) {
+                long double current = 0;
+                if (existed && !ParseLongDouble(value, current)) return Outcome::NotFloat;
+
+                long double sum = current + increment;
+                if (std::isnan(sum) || std::isinf(sum)) return Outcome::NotFinite;
+                FormatLongDouble(sum, value);
+                result = value;
+                return Outcome::Ok;
+            });
+
+            switch (outcome) {
+                case Outcome::NotFloat:
+                    return RespBuilder::Error("ERR value is not a valid float");
+                case Outcome::NotFinite:
+                    return RespBuilder::Error("ERR increment would produce NaN or Infinity");
+                default:
+                    return RespBuilder::BulkString(result);
+            }
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class ExistsCommand : public ICommand {
+    // COUNTER.CREATE key SPLIT
+    // 把整数键切换为分片计数：INCR/INCRBY/DECR/DECRBY 只累加当前工作线程的计数单元，不再争用缓存锁，
+    // 回复的是 基准值 + 本线程未折叠增量 的近似值；增量每 100ms 折叠回缓存，GET/COUNTER.GET 返回精确值。
+    // 适用于写远多于读的热点计数；SPLIT 模式下不做溢出检查。
+    class CounterCreateCommand : public ICommand {
     public:
-        explicit ExistsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit CounterCreateCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'EXISTS'");
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'counter.create' command");
+            }
+            if (!ICaseCmp(argv[2], "SPLIT")) {
+                return RespBuilder::Error("ERR syntax error");
             }
 
-            const std::string &key = argv[1];
+            // 在缓存锁内确认当前值是整数，键不存在时以 0 创建
+            int64_t initial = 0;
+            bool is_integer = cache_->Update(argv[1], [&](std::string &value, bool existed) {
+                if (!existed) {
+                    value = "0";
+                    return true;
+                }
+                return ParseInt64(value, initial);
+            });
+            if (!is_integer) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
 
-            bool exists = cache_->Contains(key);
-            return RespBuilder::Integer(exists ? 1 : 0);
+            apps::CounterManager::GetInstance()->Create(argv[1], initial);
+            return RespBuilder::SimpleString("OK");
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class MGetCommand : public ICommand {
+    // COUNTER.GET key：SPLIT 模式下汇总所有计数单元，普通键等同于 GET
+    class CounterGetCommand : public ICommand {
     public:
-        explicit MGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit CounterGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            // 1. 校验参数格式
-            if (argv.size() < 2) {
-                ZEN_LOG_WARN("MGET invalid arguments: expected at least 1 key, got {}", argv.size() - 1);
-                return RespBuilder::Error("ERR wrong number of arguments for 'MGET' command");
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'counter.get' command");
             }
 
-            // 2. 提取输入键并记录数量
-            const size_t key_count = argv.size() - 1;
+            if (auto *counter = apps::CounterManager::GetInstance()->Find(argv[1]);
+                counter && cache_->Contains(argv[1])) {
+                return RespBuilder::Integer(counter->Read());
+            }
+
+            auto value = cache_->Get(argv[1]);
+            if (!value) return RespBuilder::Nil();
+            int64_t current;
+            if (!ParseInt64(*value, current)) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+            return RespBuilder::Integer(current);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // COUNTER.DROP key：折叠剩余增量并退回普通计数，返回键之前是否处于 SPLIT 模式
+    class CounterDropCommand : public ICommand {
+    public:
+        explicit CounterDropCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'counter.drop' command");
+            }
+            return RespBuilder::Integer(apps::CounterManager::GetInstance()->Drop(*cache_, argv[1]) ? 1 : 0);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class ExistsCommand : public ICommand {
+    public:
+        explicit ExistsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'EXISTS'");
+            }
+
+            const std::string &key = argv[1];
+
+            bool exists = cache_->Contains(key);
+            return RespBuilder::Integer(exists ? 1 : 0);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class MGetCommand : public ICommand {
+    public:
+        explicit MGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            // 1. 校验参数格式
+            if (argv.size() < 2) {
+                ZEN_LOG_WARN("MGET invalid arguments: expected at least 1 key, got {}", argv.size() - 1);
+                return RespBuilder::Error("ERR wrong number of arguments for 'MGET' command");
+            }
+
+            // 2. 提取输入键并记录数量
+            const size_t key_count = argv.size() - 1;
             std::vector<std::string> keys;
             keys.reserve(key_count);
             for (size_t i = 1; i < argv.size(); ++i) {
@@ -782,999 +1363,3618 @@ namespace Astra::proto {
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class SubscribeCommand : public ICommand {
-    public:
-        explicit SubscribeCommand(std::shared_ptr<ChannelManager> channel_manager)
-            : channel_manager_(std::move(channel_manager)) {}
+    // 字符串追加/区间类命令（APPEND/SETRANGE/GETRANGE/STRLEN）
+    // 写命令在 Update 内原地修改缓存中的值，容量不足时按翻倍扩展，APPEND 的均摊代价只与追加的字节数有关；
+    // 读命令经 Visit 直接读缓存中的值，只复制需要回复的那一段。
 
-        std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 2) {
-                return RespBuilder::Error("SUBSCRIBE requires at least one channel");
-            }
+    // 字符串长度上限，与 Redis 的 proto-max-bulk-len 默认值一致
+    inline constexpr size_t kMaxStringLength = 512ULL * 1024 * 1024;
 
-            // 记录本次订阅的频道（需要结合 Session 存储订阅关系，这里返回响应格式）
-            std::unordered_set<std::string> channels;
-            for (size_t i = 1; i < argv.size(); ++i) {
-                channels.insert(argv[i]);
-            }
+    inline std::string StringTooLongReply() {
+        return RespBuilder::Error("ERR string exceeds maximum allowed size (proto-max-bulk-len)");
+    }
 
-            // 构建订阅响应（实际使用时需结合 Session 的 subscribed_channels_）
-            return RespBuilder::SubscribeResponse(channels);
+    // 保证 value 至少能容纳 size 字节，扩容时至少翻倍，避免反复追加时每次都重新分配
+    inline void ReserveString(std::string &value, size_t size) {
+        if (value.capacity() < size) {
+            value.reserve(std::max(size, value.capacity() * 2));
+        }
+    }
+
+    // APPEND key value
+    class AppendCommand : public ICommand {
+    public:
+        explicit AppendCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'append' command");
+            }
+
+            const std::string &suffix = argv[2];
+            auto length = cache_->Update(argv[1], [&](std::string &value, bool) -> std::optional<size_t> {
+                if (suffix.size() > kMaxStringLength - value.size()) return std::nullopt;
+                ReserveString(value, value.size() + suffix.size());
+                value.append(suffix);
+                return value.size();
+            });
+            if (!length) return StringTooLongReply();
+            return RespBuilder::Integer(static_cast<int64_t>(*length));
         }
 
     private:
-        std::shared_ptr<ChannelManager> channel_manager_;// 频道管理器
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // 取消订阅命令：UNSUBSCRIBE [channel [channel ...]]
-    class UnsubscribeCommand : public ICommand {
+    // SETRANGE key offset value
+    class SetRangeCommand : public ICommand {
     public:
-        // 构造函数：需要频道管理器和当前会话（关键）
-        explicit UnsubscribeCommand(
-                std::shared_ptr<apps::ChannelManager> channel_manager,
-                std::weak_ptr<apps::Session> session// 必须包含session参数
-                ) : channel_manager_(std::move(channel_manager)),
-                    session_(std::move(session)) {}
+        explicit SetRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            // 锁定会话（确保会话未过期）
-            auto session = session_.lock();
-            if (!session) {
-                return RespBuilder::Error("Session expired");
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'setrange' command");
             }
 
-            std::unordered_set<std::string> unsubscribed;
-            const auto &subscribed_channels = session->GetSubscribedChannels();
+            int64_t offset;
+            if (!ParseInt64(argv[2], offset)) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+            if (offset < 0) {
+                return RespBuilder::Error("ERR offset is out of range");
+            }
 
-            if (argv.size() < 2) {
-                // 无参数：取消所有订阅
-                unsubscribed = subscribed_channels;
-                for (const auto &channel: subscribed_channels) {
-                    channel_manager_->Unsubscribe(channel, session);
-                }
-            } else {
-                // 有参数：取消指定频道
-                for (size_t i = 1; i < argv.size(); ++i) {
-                    const std::string &channel = argv[i];
-                    if (subscribed_channels.count(channel)) {
-                        unsubscribed.insert(channel);
-                        channel_manager_->Unsubscribe(channel, session);
-                    }
-                }
+            const std::string &patch = argv[3];
+            if (!patch.empty() && static_cast<uint64_t>(offset) > kMaxStringLength - patch.size()) {
+                return StringTooLongReply();
             }
 
-            // 构建响应（包含实际取消的频道）
-            return RespBuilder::UnsubscribeResponse(unsubscribed);
+            // 空补丁不创建键也不改值，只返回当前长度（键不存在时 Update 会撤销插入）
+            size_t length = cache_->Update(argv[1], [&](std::string &value, bool) {
+                if (patch.empty()) return value.size();
+                size_t end = static_cast<size_t>(offset) + patch.size();
+                if (value.size() < end) {
+                    ReserveString(value, end);
+                    value.resize(end, '\0');
+                }
+                value.replace(static_cast<size_t>(offset), patch.size(), patch);
+                return value.size();
+            });
+            return RespBuilder::Integer(static_cast<int64_t>(length));
         }
 
     private:
-        std::shared_ptr<apps::ChannelManager> channel_manager_;// 频道管理器
-        std::weak_ptr<apps::Session> session_;                 // 当前会话（弱指针）
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // 发布命令：PUBLISH channel message
-    class PublishCommand : public ICommand {
+    // GETRANGE key start end（闭区间，支持负数下标）
+    class GetRangeCommand : public ICommand {
     public:
-        explicit PublishCommand(std::shared_ptr<ChannelManager> channel_manager)
-            : channel_manager_(std::move(channel_manager)) {}
+        explicit GetRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 3) {
-                return RespBuilder::Error("PUBLISH requires channel and message");
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'getrange' command");
             }
 
-            const std::string &channel = argv[1];
-            const std::string &message = argv[2];
-            size_t subscribers = channel_manager_->Publish(channel, message);// 发布消息并返回订阅者数量
+            int64_t start, end;
+            if (!ParseInt64(argv[2], start) || !ParseInt64(argv[3], end)) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
 
-            return RespBuilder::Integer(subscribers);// 返回接收消息的订阅者数量
+            return cache_->Visit(argv[1], [&](const std::string *value) {
+                if (!value) return RespBuilder::BulkString("");
+
+                auto total = static_cast<int64_t>(value->size());
+                if (start < 0) start = std::max<int64_t>(start + total, 0);
+                if (end < 0) end = std::max<int64_t>(end + total, 0);
+                end = std::min(end, total - 1);
+                if (total == 0 || start > end) return RespBuilder::BulkString("");
+
+                return RespBuilder::BulkString(std::string_view(*value).substr(
+                        static_cast<size_t>(start), static_cast<size_t>(end - start + 1)));
+            });
         }
 
     private:
-        std::shared_ptr<ChannelManager> channel_manager_;
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // 模式订阅命令：PSUBSCRIBE pattern [pattern ...]
-    class PSubscribeCommand : public ICommand {
+    // STRLEN key
+    class StrLenCommand : public ICommand {
     public:
-        explicit PSubscribeCommand(
-                std::shared_ptr<apps::ChannelManager> channel_manager,
-                std::weak_ptr<apps::Session> session) : channel_manager_(std::move(channel_manager)),
-                                                        session_(std::move(session)) {}
+        explicit StrLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            auto session = session_.lock();
-            if (!session) {
-                return RespBuilder::Error("Session expired");
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'strlen' command");
             }
+            size_t length = cache_->Visit(argv[1], [](const std::string *value) {
+                return value ? value->size() : 0;
+            });
+            return RespBuilder::Integer(static_cast<int64_t>(length));
+        }
 
-            if (argv.size() < 2) {
-                return RespBuilder::Error("PSUBSCRIBE requires at least one pattern");
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // Bitmap相关命令实现
+    // 位图就是普通字符串值，第 0 位是首字节的最高位；计数与按位运算走 utils/bitops 的运行时分派内核
+
+    // 位偏移上限与 Redis 一致：值最多 512MB
+    inline constexpr uint64_t kMaxBitOffset = kMaxStringLength * 8 - 1;
+
+    inline bool ParseBitInteger(const std::string &arg, long long &value) {
+        if (arg.empty()) return false;
+        char *end;
+        errno = 0;
+        value = std::strtoll(arg.c_str(), &end, 10);
+        return errno != ERANGE && *end == '\0';
+    }
+
+    inline bool ParseBitOffset(const std::string &arg, uint64_t &offset) {
+        long long value;
+        if (!ParseBitInteger(arg, value) || value < 0 || static_cast<uint64_t>(value) > kMaxBitOffset) {
+            return false;
+        }
+        offset = static_cast<uint64_t>(value);
+        return true;
+    }
+
+    inline const uint8_t *BitmapData(const std::string &value) {
+        return reinterpret_cast<const uint8_t *>(value.data());
+    }
+
+    // 位图只作用于普通字符串，带复合类型前缀的值（hash/set/list/stream/zset/json）报 WRONGTYPE
+    inline bool IsTypedValue(std::string_view value) {
+        static constexpr std::array<std::string_view, 6> kPrefixes = {"hash:", "set:", "list:", "stream:", "zset:", "json:"};
+        return std::any_of(kPrefixes.begin(), kPrefixes.end(),
+                           [value](std::string_view prefix) { return value.starts_with(prefix); });
+    }
+
+    inline std::string BitmapWrongTypeReply() {
+        return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+    }
+
+    // 按 Redis 规则归一化 [start, end]（支持负数下标），区间为空时返回 false
+    inline bool NormalizeBitRange(long long &start, long long &end, long long total) {
+        if (start < 0) start += total;
+        if (end < 0) end += total;
+        if (start < 0) start = 0;
+        if (end < 0) end = 0;
+        if (end >= total) end = total - 1;
+        return total > 0 && start <= end;
+    }
+
+    // 解析可选的 BYTE|BIT 单位参数
+    inline bool ParseBitUnit(const std::vector<std::string> &argv, size_t index, bool &bit_unit) {
+        bit_unit = false;
+        if (index >= argv.size()) return true;
+        if (index + 1 != argv.size()) return false;
+        if (ICaseCmp(argv[index], "BIT")) {
+            bit_unit = true;
+            return true;
+        }
+        return ICaseCmp(argv[index], "BYTE");
+    }
+
+    // SETBIT key offset value
+    class SetBitCommand : public ICommand {
+    public:
+        explicit SetBitCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'setbit' command");
             }
 
-            std::unordered_set<std::string> subscribed_patterns;
-            for (size_t i = 1; i < argv.size(); ++i) {
-                const std::string &pattern = argv[i];
-                session->AddSubscribedPattern(pattern);
-                channel_manager_->PSubscribe(pattern, session);
-                subscribed_patterns.insert(pattern);
+            uint64_t offset;
+            if (!ParseBitOffset(argv[2], offset)) {
+                return RespBuilder::Error("ERR bit offset is not an integer or out of range");
+            }
+            if (argv[3] != "0" && argv[3] != "1") {
+                return RespBuilder::Error("ERR bit is not an integer or out of range");
             }
 
-            // 关键修复：在返回响应前切换到PubSub模式
-            session->SwitchMode(SessionMode::PubSubMode);// 添加这一行
+            size_t byte = offset / 8;
+            uint8_t mask = static_cast<uint8_t>(0x80 >> (offset % 8));
+            bool set = argv[3] == "1";
 
-            // 构建并返回响应
-            return RespBuilder::PSubscribeResponse(
-                    subscribed_patterns,
-                    session->GetSubscribedPatterns().size());
-        }
+            // 原地修改：不复制整个位图，也保留键上的过期时间
+            return cache_->Update(argv[1], [&](std::string &value, bool) {
+                if (IsTypedValue(value)) return BitmapWrongTypeReply();
+                if (value.size() <= byte) value.resize(byte + 1, '\0');
 
+                auto &target = reinterpret_cast<uint8_t &>(value[byte]);
+                int old_bit = (target & mask) ? 1 : 0;
+                if (set) {
+                    target |= mask;
+                } else {
+                    target &= static_cast<uint8_t>(~mask);
+                }
+                return RespBuilder::Integer(old_bit);
+            });
+        }
 
     private:
-        std::shared_ptr<apps::ChannelManager> channel_manager_;
-        std::weak_ptr<apps::Session> session_;
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // 取消模式订阅命令：PUNSUBSCRIBE [pattern [pattern ...]]
-    class PUnsubscribeCommand : public ICommand {
+    // GETBIT key offset
+    class GetBitCommand : public ICommand {
     public:
-        explicit PUnsubscribeCommand(
-                std::shared_ptr<apps::ChannelManager> channel_manager,
-                std::weak_ptr<apps::Session> session) : channel_manager_(std::move(channel_manager)),
-                                                        session_(std::move(session)) {}
+        explicit GetBitCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            auto session = session_.lock();
-            if (!session) {
-                return RespBuilder::Error("Session expired");
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'getbit' command");
             }
 
-            std::unordered_set<std::string> unsubscribed_patterns;
-            const auto &subscribed_patterns = session->GetSubscribedPatterns();// 调用接口获取
+            uint64_t offset;
+            if (!ParseBitOffset(argv[2], offset)) {
+                return RespBuilder::Error("ERR bit offset is not an integer or out of range");
+            }
 
-            if (argv.size() < 2) {
-                // 无参数：取消所有模式订阅
-                unsubscribed_patterns = subscribed_patterns;
-                for (const auto &pattern: subscribed_patterns) {
-                    channel_manager_->PUnsubscribe(pattern, session);
+            auto value = cache_->Get(argv[1]);
+            if (value && IsTypedValue(*value)) return BitmapWrongTypeReply();
+            size_t byte = offset / 8;
+            if (!value || value->size() <= byte) return RespBuilder::Integer(0);
+            return RespBuilder::Integer((BitmapData(*value)[byte] >> (7 - offset % 8)) & 1);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // BITCOUNT key [start end [BYTE|BIT]]
+    class BitCountCommand : public ICommand {
+    public:
+        explicit BitCountCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2 && argv.size() != 4 && argv.size() != 5) {
+                return argv.size() < 2 ? RespBuilder::Error("ERR wrong number of arguments for 'bitcount' command")
+                                       : RespBuilder::Error("ERR syntax error");
+            }
+
+            long long start = 0, end = -1;
+            bool bit_unit = false;
+            if (argv.size() >= 4) {
+                if (!ParseBitInteger(argv[2], start) || !ParseBitInteger(argv[3], end)) {
+                    return RespBuilder::Error("ERR value is not an integer or out of range");
                 }
-                session->ClearSubscribedPatterns();// 调用接口清空
-            } else {
-                // 取消指定模式
-                for (size_t i = 1; i < argv.size(); ++i) {
-                    const std::string &pattern = argv[i];
-                    if (subscribed_patterns.count(pattern)) {
-                        unsubscribed_patterns.insert(pattern);
-                        session->RemoveSubscribedPattern(pattern);// 调用接口移除
-                        channel_manager_->PUnsubscribe(pattern, session);
-                    }
+                if (!ParseBitUnit(argv, 4, bit_unit)) {
+                    return RespBuilder::Error("ERR syntax error");
                 }
             }
-            if (session->GetSubscribedPatterns().empty() && session->GetSubscribedChannels().empty()) {
-                session->SwitchMode(SessionMode::CacheMode);
+
+            auto value = cache_->Get(argv[1]);
+            if (!value) return RespBuilder::Integer(0);
+            if (IsTypedValue(*value)) return BitmapWrongTypeReply();
+
+            const uint8_t *data = BitmapData(*value);
+            long long total = static_cast<long long>(value->size()) * (bit_unit ? 8 : 1);
+            if (!NormalizeBitRange(start, end, total)) return RespBuilder::Integer(0);
+
+            if (!bit_unit) {
+                return RespBuilder::Integer(static_cast<int64_t>(
+                        utils::bitops::PopCount(data + start, static_cast<size_t>(end - start + 1))));
             }
-            // 调用接口获取剩余订阅数
-            return RespBuilder::PUnsubscribeResponse(
-                    unsubscribed_patterns,
-                    session->GetSubscribedPatterns().size());
+
+            // 按位区间：整字节计数后扣掉首尾字节中落在区间外的位
+            size_t first = static_cast<size_t>(start / 8);
+            size_t last = static_cast<size_t>(end / 8);
+            size_t count = utils::bitops::PopCount(data + first, last - first + 1);
+            if (start % 8) {
+                count -= std::popcount(static_cast<uint8_t>(data[first] & (0xFF << (8 - start % 8))));
+            }
+            if (end % 8 != 7) {
+                count -= std::popcount(static_cast<uint8_t>(data[last] & ((1 << (7 - end % 8)) - 1)));
+            }
+            return RespBuilder::Integer(static_cast<int64_t>(count));
         }
 
     private:
-        std::shared_ptr<apps::ChannelManager> channel_manager_;
-        std::weak_ptr<apps::Session> session_;
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class PubSubCommand : public ICommand {
+    // BITPOS key bit [start [end [BYTE|BIT]]]
+    class BitPosCommand : public ICommand {
     public:
-        explicit PubSubCommand(std::shared_ptr<apps::ChannelManager> channel_manager)
-            : channel_manager_(std::move(channel_manager)) {}
+        explicit BitPosCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 2) {
-                return RespBuilder::Error("PUBSUB requires a subcommand (CHANNELS, NUMSUB, NUMPAT, PATTERNS)");
+            if (argv.size() < 3 || argv.size() > 6) {
+                return argv.size() < 3 ? RespBuilder::Error("ERR wrong number of arguments for 'bitpos' command")
+                                       : RespBuilder::Error("ERR syntax error");
             }
-            const std::string &subcmd = argv[1];// 获取子命令 (e.g., "channels", "CHANNELS")
+            if (argv[2] != "0" && argv[2] != "1") {
+                return RespBuilder::Error("ERR The bit argument must be 1 or 0.");
+            }
+            bool bit = argv[2] == "1";
 
-            if (ICaseCmp(subcmd, "CHANNELS")) {
-                return HandleChannels(argv);
-            } else if (ICaseCmp(subcmd, "NUMSUB")) {
-                return HandleNumSub(argv);
-            } else if (ICaseCmp(subcmd, "NUMPAT")) {
-                return HandleNumPat();
-            } else if (ICaseCmp(subcmd, "PATTERNS")) {
-                return HandlePatterns();
-            } else {
-                // 使用原始的 argv[1] 以便在错误信息中显示用户实际输入的内容
-                return RespBuilder::Error("Unknown PUBSUB subcommand: " + argv[1]);
+            long long start = 0, end = -1;
+            bool end_given = argv.size() >= 5;
+            bool bit_unit = false;
+            if (argv.size() >= 4 && !ParseBitInteger(argv[3], start)) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
             }
+            if (end_given && !ParseBitInteger(argv[4], end)) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+            if (!ParseBitUnit(argv, 5, bit_unit)) {
+                return RespBuilder::Error("ERR syntax error");
+            }
+
+            auto value = cache_->Get(argv[1]);
+            if (!value) return RespBuilder::Integer(bit ? -1 : 0);
+            if (IsTypedValue(*value)) return BitmapWrongTypeReply();
+
+            long long total = static_cast<long long>(value->size()) * (bit_unit ? 8 : 1);
+            if (!NormalizeBitRange(start, end, total)) return RespBuilder::Integer(-1);
+
+            uint64_t begin_bit = bit_unit ? start : start * 8;
+            uint64_t end_bit = bit_unit ? end + 1 : (end + 1) * 8;
+            int64_t pos = utils::bitops::FindBit(BitmapData(*value), value->size(), bit, begin_bit, end_bit);
+
+            // 找 0 且未指定 end 时，字符串右侧视为无限个 0
+            if (pos < 0 && !bit && !end_given) return RespBuilder::Integer(static_cast<int64_t>(end_bit));
+            return RespBuilder::Integer(pos);
         }
 
     private:
-        // 处理 PUBSUB CHANNELS [pattern]
-        std::string HandleChannels(const std::vector<std::string> &argv) {
-            std::string pattern = "*";// 默认匹配所有频道
-            if (argv.size() >= 3) {
-                pattern = argv[2];
-            }
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-            auto channels = channel_manager_->GetChannelsByPattern(pattern);
-            std::vector<std::string> elements;
-            for (const auto &channel: channels) {
-                elements.push_back(RespBuilder::BulkString(channel));
+    // BITOP AND|OR|XOR|NOT destkey key [key ...]
+    class BitOpCommand : public ICommand {
+    public:
+        explicit BitOpCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bitop' command");
+            }
+
+            utils::bitops::BitOp op;
+            if (ICaseCmp(argv[1], "AND")) {
+                op = utils::bitops::BitOp::And;
+            } else if (ICaseCmp(argv[1], "OR")) {
+                op = utils::bitops::BitOp::Or;
+            } else if (ICaseCmp(argv[1], "XOR")) {
+                op = utils::bitops::BitOp::Xor;
+            } else if (ICaseCmp(argv[1], "NOT")) {
+                op = utils::bitops::BitOp::Not;
+                if (argv.size() != 4) {
+                    return RespBuilder::Error("ERR BITOP NOT must be called with a single source key.");
+                }
+            } else {
+                return RespBuilder::Error("ERR syntax error");
             }
-            return RespBuilder::Array(elements);
-        }
 
-        // 处理 PUBSUB NUMSUB channel1 [channel2 ...]
-        std::string HandleNumSub(const std::vector<std::string> &argv) {
-            if (argv.size() < 3) {
-                return RespBuilder::Array({});// 无参数时返回空数组
+            std::vector<std::string> keys(argv.begin() + 3, argv.end());
+            auto payloads = cache_->BatchGet(keys);
+
+            size_t max_len = 0;
+            std::vector<std::span<const uint8_t>> sources;
+            sources.reserve(payloads.size());
+            for (const auto &payload: payloads) {
+                if (payload && IsTypedValue(*payload)) return BitmapWrongTypeReply();
+                if (payload) {
+                    sources.emplace_back(BitmapData(*payload), payload->size());
+                    max_len = std::max(max_len, payload->size());
+                } else {
+                    sources.emplace_back();// 不存在的键视为空串
+                }
             }
 
-            std::vector<std::string> elements;
-            for (size_t i = 2; i < argv.size(); ++i) {
-                const std::string &channel = argv[i];
-                size_t count = channel_manager_->GetChannelSubscriberCount(channel);
-                elements.push_back(RespBuilder::BulkString(channel));
-                elements.push_back(RespBuilder::Integer(count));
+            if (max_len == 0) {
+                cache_->Remove(argv[2]);
+                return RespBuilder::Integer(0);
             }
-            return RespBuilder::Array(elements);
-        }
 
-        // 处理 PUBSUB NUMPAT
-        std::string HandleNumPat() {
-            size_t count = channel_manager_->GetPatternSubscriberCount();
-            return RespBuilder::Integer(count);
+            std::string result(max_len, '\0');
+            utils::bitops::Combine(op, {reinterpret_cast<uint8_t *>(result.data()), result.size()}, sources);
+            cache_->Put(argv[2], result);
+            return RespBuilder::Integer(static_cast<int64_t>(max_len));
         }
 
-        // 新增：处理 PUBSUB PATTERNS
-        std::string HandlePatterns() {
-            // 从ChannelManager获取所有活跃模式及订阅数
-            auto active_patterns = channel_manager_->GetActivePatterns();
-            std::vector<std::string> elements;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-            for (const auto &[pattern, count]: active_patterns) {
-                // 每个模式返回一个子数组：[模式名, 订阅数]
-                std::vector<std::string> sub_elements;
-                sub_elements.push_back(RespBuilder::BulkString(pattern));
-                sub_elements.push_back(RespBuilder::Integer(count));
-                elements.push_back(RespBuilder::Array(sub_elements));
+    // BITFIELD 的字段类型：i1..i64 或 u1..u63
+    struct BitFieldType {
+        bool is_signed = false;
+        int bits = 0;
+    };
+
+    inline bool ParseBitFieldType(const std::string &arg, BitFieldType &type) {
+        if (arg.size() < 2 || (arg[0] != 'i' && arg[0] != 'I' && arg[0] != 'u' && arg[0] != 'U')) return false;
+        long long bits;
+        if (!ParseBitInteger(arg.substr(1), bits)) return false;
+        type.is_signed = arg[0] == 'i' || arg[0] == 'I';
+        if (bits < 1 || bits > (type.is_signed ? 64 : 63)) return false;
+        type.bits = static_cast<int>(bits);
+        return true;
+    }
+
+    // 偏移可以写成 "#N"，表示第 N 个该类型宽度的字段
+    inline bool ParseBitFieldOffset(const std::string &arg, const BitFieldType &type, uint64_t &offset) {
+        bool multiply = !arg.empty() && arg[0] == '#';
+        long long value;
+        if (!ParseBitInteger(multiply ? arg.substr(1) : arg, value) || value < 0) return false;
+        uint64_t bits = static_cast<uint64_t>(value);
+        if (multiply) {
+            if (bits > kMaxBitOffset / type.bits) return false;
+            bits *= type.bits;
+        }
+        if (bits + type.bits - 1 > kMaxBitOffset) return false;
+        offset = bits;
+        return true;
+    }
+
+    inline uint64_t ReadBitField(const std::string &value, uint64_t offset, int bits) {
+        const uint8_t *data = BitmapData(value);
+        uint64_t result = 0;
+        for (int i = 0; i < bits; ++i) {
+            uint64_t pos = offset + i;
+            uint64_t bit = pos / 8 < value.size() ? (data[pos / 8] >> (7 - pos % 8)) & 1 : 0;
+            result = (result << 1) | bit;
+        }
+        return result;
+    }
+
+    // 调用方需保证 value 已扩展到足够长度
+    inline void WriteBitField(std::string &value, uint64_t offset, int bits, uint64_t field) {
+        auto *data = reinterpret_cast<uint8_t *>(value.data());
+        for (int i = 0; i < bits; ++i) {
+            uint64_t pos = offset + i;
+            uint8_t mask = static_cast<uint8_t>(0x80 >> (pos % 8));
+            if ((field >> (bits - 1 - i)) & 1) {
+                data[pos / 8] |= mask;
+            } else {
+                data[pos / 8] &= static_cast<uint8_t>(~mask);
             }
+        }
+    }
+
+    inline int64_t SignExtend(uint64_t field, int bits) {
+        if (bits == 64) return static_cast<int64_t>(field);
+        uint64_t sign = 1ULL << (bits - 1);
+        return static_cast<int64_t>((field ^ sign) - sign);
+    }
+
+    enum class BitFieldOverflow {
+        Wrap,
+        Sat,
+        Fail
+    };
 
-            return RespBuilder::Array(elements);
+    // 计算 old + delta 在目标类型下的结果（SET 以 old = 0 调用），FAIL 溢出时返回 nullopt
+    inline std::optional<int64_t> BitFieldAdd(const BitFieldType &type, int64_t old, int64_t delta,
+                                              BitFieldOverflow overflow) {
+        const uint64_t mask = type.bits == 64 ? ~0ULL : (1ULL << type.bits) - 1;
+        const int64_t max = type.is_signed ? static_cast<int64_t>(mask >> 1) : static_cast<int64_t>(mask);
+        const int64_t min = type.is_signed ? -max - 1 : 0;
+
+        // 先判断是否越过 int64 本身，再判断是否越过字段范围
+        int direction = 0;
+        if (delta > 0 && old > INT64_MAX - delta) {
+            direction = 1;
+        } else if (delta < 0 && old < INT64_MIN - delta) {
+            direction = -1;
+        } else if (old + delta > max) {
+            direction = 1;
+        } else if (old + delta < min) {
+            direction = -1;
         }
 
-    private:
-        std::shared_ptr<apps::ChannelManager> channel_manager_;
-    };
+        if (direction == 0) return old + delta;
+        switch (overflow) {
+            case BitFieldOverflow::Sat:
+                return direction > 0 ? max : min;
+            case BitFieldOverflow::Fail:
+                return std::nullopt;
+            default: {
+                uint64_t wrapped = (static_cast<uint64_t>(old) + static_cast<uint64_t>(delta)) & mask;
+                return type.is_signed ? SignExtend(wrapped, type.bits) : static_cast<int64_t>(wrapped);
+            }
+        }
+    }
 
-    class HSetCommand : public ICommand {
+    // BITFIELD key [GET type offset] [SET type offset value] [INCRBY type offset increment]
+    //              [OVERFLOW WRAP|SAT|FAIL] ...
+    class BitFieldCommand : public ICommand {
     public:
-        explicit HSetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit BitFieldCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 4 || argv.size() % 2 != 0) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hset' command");
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bitfield' command");
+            }
+
+            struct Operation {
+                enum Kind { Get,
+                            Set,
+                            IncrBy } kind;
+                BitFieldType type;
+                uint64_t offset;
+                int64_t argument;
+                BitFieldOverflow overflow;
+            };
+
+            // 先完整解析，任何错误都不修改数据
+            std::vector<Operation> ops;
+            BitFieldOverflow overflow = BitFieldOverflow::Wrap;
+            bool writes = false;
+            uint64_t needed_bits = 0;
+            for (size_t i = 2; i < argv.size(); ++i) {
+                if (ICaseCmp(argv[i], "OVERFLOW")) {
+                    if (i + 1 >= argv.size()) return RespBuilder::Error("ERR syntax error");
+                    const std::string &mode = argv[++i];
+                    if (ICaseCmp(mode, "WRAP")) {
+                        overflow = BitFieldOverflow::Wrap;
+                    } else if (ICaseCmp(mode, "SAT")) {
+                        overflow = BitFieldOverflow::Sat;
+                    } else if (ICaseCmp(mode, "FAIL")) {
+                        overflow = BitFieldOverflow::Fail;
+                    } else {
+                        return RespBuilder::Error("ERR Invalid OVERFLOW type specified");
+                    }
+                    continue;
+                }
+
+                Operation op{};
+                size_t arity;
+                if (ICaseCmp(argv[i], "GET")) {
+                    op.kind = Operation::Get;
+                    arity = 2;
+                } else if (ICaseCmp(argv[i], "SET")) {
+                    op.kind = Operation::Set;
+                    arity = 3;
+                } else if (ICaseCmp(argv[i], "INCRBY")) {
+                    op.kind = Operation::IncrBy;
+                    arity = 3;
+                } else {
+                    return RespBuilder::Error("ERR syntax error");
+                }
+                if (i + arity >= argv.size()) return RespBuilder::Error("ERR syntax error");
+
+                if (!ParseBitFieldType(argv[i + 1], op.type)) {
+                    return RespBuilder::Error("ERR Invalid bitfield type. Use something like i16 u8. Note that u64 is not supported but i64 is.");
+                }
+                if (!ParseBitFieldOffset(argv[i + 2], op.type, op.offset)) {
+                    return RespBuilder::Error("ERR bit offset is not an integer or out of range");
+                }
+                if (arity == 3) {
+                    long long argument;
+                    if (!ParseBitInteger(argv[i + 3], argument)) {
+                        return RespBuilder::Error("ERR value is not an integer or out of range");
+                    }
+                    op.argument = argument;
+                    writes = true;
+                    needed_bits = std::max<uint64_t>(needed_bits, op.offset + op.type.bits);
+                }
+                op.overflow = overflow;
+                ops.push_back(op);
+                i += arity;
+            }
+
+            auto read_field = [](const std::string &value, const Operation &op) {
+                uint64_t raw = ReadBitField(value, op.offset, op.type.bits);
+                return op.type.is_signed ? SignExtend(raw, op.type.bits) : static_cast<int64_t>(raw);
+            };
+
+            if (!writes) {
+                return cache_->Visit(argv[1], [&](const std::string *value) {
+                    static const std::string empty;
+                    if (value && IsTypedValue(*value)) return BitmapWrongTypeReply();
+                    std::vector<std::string> results;
+                    results.reserve(ops.size());
+                    for (const auto &op: ops) {
+                        results.push_back(RespBuilder::Integer(read_field(value ? *value : empty, op)));
+                    }
+                    return RespBuilder::Array(results);
+                });
             }
 
-            std::string key = argv[1];
-            // 构造hash对象的序列化表示
-            std::ostringstream oss;
-            oss << "hash:";
+            // 原地修改：不复制整个位图，也保留键上的过期时间
+            return cache_->Update(argv[1], [&](std::string &value, bool) {
+                if (IsTypedValue(value)) return BitmapWrongTypeReply();
+                size_t original_size = value.size();
+                if (value.size() < (needed_bits + 7) / 8) {
+                    value.resize((needed_bits + 7) / 8, '\0');
+                }
 
-            // 从缓存中获取现有hash数据（如果存在）
-            auto existing = cache_->Get(key);
-            AstraHash hash;
-            if (existing.has_value()) {
-                // 解析现有hash数据
-                std::string data = existing.value();
-                if (data.substr(0, 5) == "hash:") {
-                    // 解析现有字段
-                    size_t pos = 5;// 跳过"hash:"前缀
-                    while (pos < data.length()) {
-                        // 解析字段名长度
-                        size_t field_len_end = data.find(':', pos);
-                        if (field_len_end == std::string::npos) break;
+                std::vector<std::string> results;
+                results.reserve(ops.size());
+                bool modified = false;
+                for (const auto &op: ops) {
+                    int64_t old = read_field(value, op);
+                    if (op.kind == Operation::Get) {
+                        results.push_back(RespBuilder::Integer(old));
+                        continue;
+                    }
 
-                        size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                        pos = field_len_end + 1;
+                    auto next = op.kind == Operation::Set ? BitFieldAdd(op.type, 0, op.argument, op.overflow)
+                                                          : BitFieldAdd(op.type, old, op.argument, op.overflow);
+                    if (!next) {
+                        results.push_back(RespBuilder::Nil());
+                        continue;
+                    }
+                    WriteBitField(value, op.offset, op.type.bits, static_cast<uint64_t>(*next));
+                    modified = true;
+                    results.push_back(RespBuilder::Integer(op.kind == Operation::Set ? old : *next));
+                }
 
-                        if (pos + field_len > data.length()) break;
-                        std::string field = data.substr(pos, field_len);
-                        pos += field_len;
+                // 所有写入都因 FAIL 溢出而跳过时不改变值（新键也不会被创建）
+                if (!modified) value.resize(original_size);
+                return RespBuilder::Array(results);
+            });
+        }
 
-                        // 解析值长度
-                        size_t value_len_end = data.find(':', pos);
-                        if (value_len_end == std::string::npos) break;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                        size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                        pos = value_len_end + 1;
+    // HyperLogLog相关命令实现
+    // 值即 Redis 兼容的 "HYLL" 字符串，读写都经由 HyperLogLog 解析；PFCOUNT 会把算出的基数缓存回值头部
+    // 写入在 Update 内把缓存值移入 HyperLogLog、改完再移回，不复制寄存器，也保留键的过期时间
+
+    // 两个编码除头部缓存的基数（第 8~15 字节）外是否完全一致
+    inline bool SameHyperLogLogRegisters(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && a.substr(0, 8) == b.substr(0, 8) &&
+               a.substr(HyperLogLog::kHeaderBytes) == b.substr(HyperLogLog::kHeaderBytes);
+    }
+
+    inline std::string InvalidHyperLogLogReply() {
+        return RespBuilder::Error("WRONGTYPE Key is not a valid HyperLogLog string value.");
+    }
+
+    // 把多个键的寄存器按最大值合并，不存在的键视为空 HLL
+    inline bool MergeHyperLogLogs(AstraCache<LRUCache, std::string, std::string> &cache,
+                                  const std::vector<std::string> &keys, HyperLogLog::Registers &registers) {
+        auto payloads = cache.BatchGet(keys);
+        for (auto &payload: payloads) {
+            if (!payload) continue;
+            auto hll = HyperLogLog::FromBytes(std::move(*payload));
+            if (!hll) return false;
+            hll->MergeInto(registers);
+        }
+        return true;
+    }
 
-                        if (pos + value_len > data.length()) break;
-                        std::string value = data.substr(pos, value_len);
-                        pos += value_len;
+    // PFADD key [element [element ...]]
+    class PfAddCommand : public ICommand {
+    public:
+        explicit PfAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                        hash.HSet(field, value);
-                    }
-                }
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'pfadd' command");
             }
 
-            // 设置新字段
-            int fields_set = 0;
-            for (size_t i = 2; i < argv.size(); i += 2) {
-                std::string field = argv[i];
-                std::string value = argv[i + 1];
-                bool is_new = hash.HSet(field, value);
-                if (is_new) fields_set++;
+            std::vector<std::pair<size_t, uint8_t>> hashes;
+            hashes.reserve(argv.size() - 2);
+            for (size_t i = 2; i < argv.size(); ++i) {
+                hashes.push_back(HyperLogLog::HashElement(argv[i]));
             }
 
-            // 序列化hash对象并存储到缓存
-            std::ostringstream serialized;
-            serialized << "hash:";
-            auto all_fields = hash.HGetAll();
-            for (const auto &pair: all_fields) {
-                const std::string &field = pair.first;
-                const std::string &value = pair.second;
-                serialized << field.length() << ":" << field << value.length() << ":" << value;
-            }
-            cache_->Put(key, serialized.str());
+            return cache_->Update(argv[1], [&](std::string &value, bool existed) {
+                if (existed && !HyperLogLog::IsValid(value)) return InvalidHyperLogLogReply();
 
-            return RespBuilder::Integer(fields_set);
+                auto hll = existed ? HyperLogLog::FromBytes(std::move(value)) : std::optional<HyperLogLog>(std::in_place);
+                bool updated = !existed;
+                for (const auto &[index, rank]: hashes) {
+                    if (hll->AddHash(index, rank)) updated = true;
+                }
+                value = hll->Release();
+                return RespBuilder::Integer(updated ? 1 : 0);
+            });
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class HGetCommand : public ICommand {
+    // PFCOUNT key [key ...]
+    class PfCountCommand : public ICommand {
     public:
-        explicit HGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit PfCountCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hget' command");
-            }
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'pfcount' command");
+            }
+
+            if (argv.size() > 2) {
+                // 多键：合并寄存器后估计，结果不缓存
+                HyperLogLog::Registers registers{};
+                std::vector<std::string> keys(argv.begin() + 1, argv.end());
+                if (!MergeHyperLogLogs(*cache_, keys, registers)) return InvalidHyperLogLogReply();
+                return RespBuilder::Integer(static_cast<int64_t>(HyperLogLog::Estimate(registers)));
+            }
+
+            // 缓存的基数有效时在锁内直接读出；否则复制一份到锁外估计
+            std::optional<HyperLogLog> hll;
+            std::optional<uint64_t> cached;
+            bool valid = cache_->Visit(argv[1], [&](const std::string *value) {
+                if (!value) return true;
+                if (!HyperLogLog::IsValid(*value)) return false;
+                hll = HyperLogLog::FromBytes(*value);
+                if (hll->HasCachedCount()) {
+                    cached = hll->Count();
+                    hll.reset();
+                }
+                return true;
+            });
+            if (!valid) return InvalidHyperLogLogReply();
+            if (cached) return RespBuilder::Integer(static_cast<int64_t>(*cached));
+            if (!hll) return RespBuilder::Integer(0);
+
+            uint64_t count = hll->Count();
+            const std::string &counted = hll->Bytes();
+            // 只有估计期间寄存器未被改动时才写回缓存的基数；原地改写头部 8 字节
+            cache_->Update(argv[1], [&](std::string &value, bool existed) {
+                if (!existed || !SameHyperLogLogRegisters(value, counted)) return false;
+                std::copy(counted.begin() + 8, counted.begin() + HyperLogLog::kHeaderBytes, value.begin() + 8);
+                return true;
+            });
+            return RespBuilder::Integer(static_cast<int64_t>(count));
+        }
 
-            std::string key = argv[1];
-            std::string field = argv[2];
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-            auto value = cache_->Get(key);
-            if (!value.has_value()) {
-                return RespBuilder::Nil();
-            }
+    // PFMERGE destkey [sourcekey [sourcekey ...]]
+    class PfMergeCommand : public ICommand {
+    public:
+        explicit PfMergeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-            std::string data = value.value();
-            if (data.substr(0, 5) != "hash:") {
-                return RespBuilder::Nil();// 键存在但不是hash类型
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'pfmerge' command");
             }
 
-            // 解析hash数据
-            AstraHash hash;
-            size_t pos = 5;// 跳过"hash:"前缀
-            while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
+            // 源键在锁外合并；目标键本身也参与合并，在 Update 内完成，保留其过期时间
+            HyperLogLog::Registers registers{};
+            std::vector<std::string> sources(argv.begin() + 2, argv.end());
+            if (!MergeHyperLogLogs(*cache_, sources, registers)) return InvalidHyperLogLogReply();
 
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
+            return cache_->Update(argv[1], [&](std::string &value, bool existed) {
+                if (existed) {
+                    if (!HyperLogLog::IsValid(value)) return InvalidHyperLogLogReply();
+                    HyperLogLog::FromBytes(std::move(value))->MergeInto(registers);
+                }
+                value = HyperLogLog::FromRegisters(registers).Release();
+                return RespBuilder::SimpleString("OK");
+            });
+        }
 
-                if (pos + field_len > data.length()) break;
-                std::string field_name = data.substr(pos, field_len);
-                pos += field_len;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
+    // ---------------- Bloom 过滤器（BF.*） ----------------
+    // 值为 BloomFilter 的编码串，所有读写都在 Update / Visit 中原地完成；元素哈希在加锁前算好，缩短临界区
+
+    inline std::string InvalidBloomReply() {
+        return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+    }
+
+    // 向过滤器逐个加入元素（键不存在时按默认参数创建），每个元素的回复依次放入 replies
+    inline std::string AddToBloom(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key,
+                                  const std::vector<uint64_t> &hashes, std::vector<std::string> &replies) {
+        return cache.Update(key, [&](std::string &value, bool existed) {
+            if (!existed) {
+                value = BloomFilter::Create({});
+            } else if (!BloomFilter::IsValid(value)) {
+                return InvalidBloomReply();
+            }
+
+            for (uint64_t hash: hashes) {
+                switch (BloomFilter::Add(value, hash)) {
+                    case BloomFilter::AddResult::Added:
+                        replies.push_back(RespBuilder::Integer(1));
+                        break;
+                    case BloomFilter::AddResult::Exists:
+                        replies.push_back(RespBuilder::Integer(0));
+                        break;
+                    default:
+                        replies.push_back(RespBuilder::Error("ERR non scaling filter is full"));
+                }
+            }
+            return std::string();
+        });
+    }
 
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+    inline std::vector<uint64_t> HashBloomItems(const std::vector<std::string> &argv, size_t first) {
+        std::vector<uint64_t> hashes;
+        hashes.reserve(argv.size() - first);
+        for (size_t i = first; i < argv.size(); ++i) hashes.push_back(BloomFilter::Hash(argv[i]));
+        return hashes;
+    }
 
-                if (pos + value_len > data.length()) break;
-                std::string field_value = data.substr(pos, value_len);
-                pos += value_len;
+    // BF.RESERVE key error_rate capacity [EXPANSION expansion] [NONSCALING]
+    class BfReserveCommand : public ICommand {
+    public:
+        explicit BfReserveCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                hash.HSet(field_name, field_value);
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bf.reserve' command");
             }
 
-            auto result = hash.HGet(field);
-            if (!result.has_value()) {
-                return RespBuilder::Nil();
+            BloomFilter::Options options;
+            long double error_rate;
+            if (!ParseLongDouble(argv[2], error_rate) || error_rate <= 0 || error_rate >= 1) {
+                return RespBuilder::Error("ERR bad error rate");
+            }
+            options.error_rate = static_cast<double>(error_rate);
+
+            int64_t capacity;
+            if (!ParseInt64(argv[3], capacity) || capacity <= 0) {
+                return RespBuilder::Error("ERR bad capacity");
+            }
+            options.capacity = static_cast<uint64_t>(capacity);
+
+            for (size_t i = 4; i < argv.size(); ++i) {
+                int64_t expansion;
+                if (ICaseCmp(argv[i], "NONSCALING")) {
+                    options.scaling = false;
+                } else if (ICaseCmp(argv[i], "EXPANSION") && i + 1 < argv.size()) {
+                    if (!ParseInt64(argv[++i], expansion) || expansion < 1 || expansion > 32768) {
+                        return RespBuilder::Error("ERR bad expansion");
+                    }
+                    options.expansion = static_cast<uint32_t>(expansion);
+                } else {
+                    return RespBuilder::Error("ERR syntax error");
+                }
             }
-            return RespBuilder::BulkString(result.value());
+
+            return cache_->Update(argv[1], [&](std::string &value, bool existed) {
+                if (existed) return RespBuilder::Error("ERR item exists");
+                value = BloomFilter::Create(options);
+                // 超出大小上限时 value 为空，Update 会撤销插入
+                if (value.empty()) return RespBuilder::Error("ERR filter exceeds maximum size");
+                return RespBuilder::SimpleString("OK");
+            });
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class HGetAllCommand : public ICommand {
+    // BF.ADD key item
+    class BfAddCommand : public ICommand {
     public:
-        explicit HGetAllCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit BfAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hgetall' command");
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bf.add' command");
             }
 
-            std::string key = argv[1];
-
-            auto value = cache_->Get(key);
-            if (!value.has_value()) {
-                return RespBuilder::Array({});// 返回空数组而不是nil
-            }
+            std::vector<std::string> replies;
+            std::string error = AddToBloom(*cache_, argv[1], HashBloomItems(argv, 2), replies);
+            return error.empty() ? replies.front() : error;
+        }
 
-            std::string data = value.value();
-            if (data.substr(0, 5) != "hash:") {
-                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
-            }
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-            // 解析hash数据
-            std::vector<std::string> result;
-            size_t pos = 5;// 跳过"hash:"前缀
-            while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
+    // BF.MADD key item [item ...]
+    class BfMAddCommand : public ICommand {
+    public:
+        explicit BfMAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bf.madd' command");
+            }
 
-                if (pos + field_len > data.length()) break;
-                std::string field = data.substr(pos, field_len);
-                pos += field_len;
-                result.push_back(field);
+            std::vector<std::string> replies;
+            replies.reserve(argv.size() - 2);
+            std::string error = AddToBloom(*cache_, argv[1], HashBloomItems(argv, 2), replies);
+            return error.empty() ? RespBuilder::Array(replies) : error;
+        }
 
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+    // BF.EXISTS key item
+    class BfExistsCommand : public ICommand {
+    public:
+        explicit BfExistsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                if (pos + value_len > data.length()) break;
-                std::string value = data.substr(pos, value_len);
-                pos += value_len;
-                result.push_back(value);
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bf.exists' command");
             }
 
-            return RespBuilder::Array(result);
+            uint64_t hash = BloomFilter::Hash(argv[2]);
+            return cache_->Visit(argv[1], [&](const std::string *value) {
+                if (!value) return RespBuilder::Integer(0);
+                if (!BloomFilter::IsValid(*value)) return InvalidBloomReply();
+                return RespBuilder::Integer(BloomFilter::Contains(*value, hash) ? 1 : 0);
+            });
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // Hash相关命令实现
-    class HDelCommand : public ICommand {
+    // BF.MEXISTS key item [item ...]：批量探测，块地址先预取再比较
+    class BfMExistsCommand : public ICommand {
     public:
-        explicit HDelCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit BfMExistsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hdel'");
+                return RespBuilder::Error("ERR wrong number of arguments for 'bf.mexists' command");
+            }
+
+            auto hashes = HashBloomItems(argv, 2);
+            std::vector<uint8_t> found(hashes.size(), 0);
+            std::string error = cache_->Visit(argv[1], [&](const std::string *value) {
+                if (!value) return std::string();
+                if (!BloomFilter::IsValid(*value)) return InvalidBloomReply();
+                BloomFilter::ContainsMany(*value, hashes, found);
+                return std::string();
+            });
+            if (!error.empty()) return error;
+
+            std::vector<std::string> replies;
+            replies.reserve(found.size());
+            for (uint8_t hit: found) replies.push_back(RespBuilder::Integer(hit));
+            return RespBuilder::Array(replies);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // BF.INFO key [CAPACITY | SIZE | FILTERS | ITEMS | EXPANSION]
+    class BfInfoCommand : public ICommand {
+    public:
+        explicit BfInfoCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2 && argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'bf.info' command");
+            }
+
+            std::optional<BloomFilter::Info> info;
+            std::string error = cache_->Visit(argv[1], [&](const std::string *value) {
+                if (!value) return RespBuilder::Error("ERR not found");
+                if (!BloomFilter::IsValid(*value)) return InvalidBloomReply();
+                info = BloomFilter::GetInfo(*value);
+                return std::string();
+            });
+            if (!info) return error;
+
+            const std::pair<const char *, uint64_t> fields[] = {
+                    {"Capacity", info->capacity},
+                    {"Size", info->bytes},
+                    {"Number of filters", info->layers},
+                    {"Number of items inserted", info->items},
+                    {"Expansion rate", info->expansion},
+            };
+            const char *selectors[] = {"CAPACITY", "SIZE", "FILTERS", "ITEMS", "EXPANSION"};
+
+            if (argv.size() == 3) {
+                for (size_t i = 0; i < std::size(selectors); ++i) {
+                    if (ICaseCmp(argv[2], selectors[i])) {
+                        return RespBuilder::Integer(static_cast<int64_t>(fields[i].second));
+                    }
+                }
+                return RespBuilder::Error("ERR invalid information value");
             }
 
-            std::string key = argv[1];
-            auto value = cache_->Get(key);
-            if (!value.has_value() || value->substr(0, 5) != "hash:") {
-                return RespBuilder::Integer(0);
+            std::vector<std::string> replies;
+            for (const auto &[name, number]: fields) {
+                replies.push_back(RespBuilder::BulkString(name));
+                replies.push_back(RespBuilder::Integer(static_cast<int64_t>(number)));
+            }
+            return RespBuilder::Array(replies);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // ---------------- Count-Min Sketch / Top-K（CMS.* / TOPK.*） ----------------
+    // 多元素命令整批在一次 Update / Visit 内完成，每个键每条命令只加一次锁；元素哈希在加锁前算好
+
+    // 在已存在的草图上原地读写，fn(std::string &data) 返回回复；Sketch 为 CountMinSketch 或 TopK
+    template<typename Sketch, typename Fn>
+    std::string UpdateSketch(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key, Fn &&fn) {
+        return cache.Update(key, [&](std::string &value, bool existed) {
+            if (!existed) return RespBuilder::Error("ERR key does not exist");
+            if (!Sketch::IsValid(value)) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            return fn(value);
+        });
+    }
+
+    template<typename Sketch, typename Fn>
+    std::string VisitSketch(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key, Fn &&fn) {
+        return cache.Visit(key, [&](const std::string *value) {
+            if (!value) return RespBuilder::Error("ERR key does not exist");
+            if (!Sketch::IsValid(*value)) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            return fn(std::string_view(*value));
+        });
+    }
+
+    // 创建草图：键已存在时报错，编码为空（参数超出上限）时 Update 撤销插入
+    template<typename Create>
+    std::string CreateSketch(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key, Create &&create) {
+        return cache.Update(key, [&](std::string &value, bool existed) {
+            if (existed) return RespBuilder::Error("ERR item exists");
+            value = create();
+            if (value.empty()) return RespBuilder::Error("ERR sketch exceeds maximum size");
+            return RespBuilder::SimpleString("OK");
+        });
+    }
+
+    inline bool ParseSketchDimension(const std::string &text, uint32_t &value) {
+        int64_t parsed;
+        if (!ParseInt64(text, parsed) || parsed <= 0 || parsed > UINT32_MAX) return false;
+        value = static_cast<uint32_t>(parsed);
+        return true;
+    }
+
+    // CMS.INITBYDIM key width depth
+    class CmsInitByDimCommand : public ICommand {
+    public:
+        explicit CmsInitByDimCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'cms.initbydim' command");
+            }
+
+            uint32_t width, depth;
+            if (!ParseSketchDimension(argv[2], width)) return RespBuilder::Error("ERR invalid width");
+            if (!ParseSketchDimension(argv[3], depth)) return RespBuilder::Error("ERR invalid depth");
+            return CreateSketch(*cache_, argv[1], [&] { return CountMinSketch::Create(width, depth); });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // CMS.INITBYPROB key error probability
+    class CmsInitByProbCommand : public ICommand {
+    public:
+        explicit CmsInitByProbCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'cms.initbyprob' command");
+            }
+
+            long double error, probability;
+            if (!ParseLongDouble(argv[2], error) || error <= 0 || error >= 1) {
+                return RespBuilder::Error("ERR invalid overestimation value");
+            }
+            if (!ParseLongDouble(argv[3], probability) || probability <= 0 || probability >= 1) {
+                return RespBuilder::Error("ERR invalid prob value");
+            }
+            return CreateSketch(*cache_, argv[1], [&] {
+                return CountMinSketch::CreateByProbability(static_cast<double>(error), static_cast<double>(probability));
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // CMS.INCRBY key item increment [item increment ...]
+    class CmsIncrByCommand : public ICommand {
+    public:
+        explicit CmsIncrByCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 4 || argv.size() % 2 != 0) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'cms.incrby' command");
+            }
+
+            std::vector<std::pair<uint64_t, uint32_t>> increments;
+            increments.reserve((argv.size() - 2) / 2);
+            for (size_t i = 2; i < argv.size(); i += 2) {
+                uint32_t increment;
+                if (!ParseSketchDimension(argv[i + 1], increment)) return RespBuilder::Error("ERR cannot parse number");
+                increments.emplace_back(sketch::Hash(argv[i]), increment);
+            }
+
+            return UpdateSketch<CountMinSketch>(*cache_, argv[1], [&](std::string &data) {
+                std::vector<std::string> replies;
+                replies.reserve(increments.size());
+                for (const auto &[hash, increment]: increments) {
+                    auto estimate = CountMinSketch::IncrBy(data, hash, increment);
+                    replies.push_back(estimate ? RespBuilder::Integer(*estimate) : RespBuilder::Error("ERR CMS: INCRBY overflow"));
+                }
+                return RespBuilder::Array(replies);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // CMS.QUERY key item [item ...]
+    class CmsQueryCommand : public ICommand {
+    public:
+        explicit CmsQueryCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'cms.query' command");
+            }
+
+            std::vector<uint64_t> hashes;
+            hashes.reserve(argv.size() - 2);
+            for (size_t i = 2; i < argv.size(); ++i) hashes.push_back(sketch::Hash(argv[i]));
+
+            return VisitSketch<CountMinSketch>(*cache_, argv[1], [&](std::string_view data) {
+                std::vector<std::string> replies;
+                replies.reserve(hashes.size());
+                for (uint64_t hash: hashes) replies.push_back(RespBuilder::Integer(CountMinSketch::Query(data, hash)));
+                return RespBuilder::Array(replies);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // CMS.INFO key
+    class CmsInfoCommand : public ICommand {
+    public:
+        explicit CmsInfoCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'cms.info' command");
+            }
+
+            return VisitSketch<CountMinSketch>(*cache_, argv[1], [&](std::string_view data) {
+                auto info = CountMinSketch::GetInfo(data);
+                return RespBuilder::Array({RespBuilder::BulkString("width"), RespBuilder::Integer(info.width),
+                                           RespBuilder::BulkString("depth"), RespBuilder::Integer(info.depth),
+                                           RespBuilder::BulkString("count"), RespBuilder::Integer(static_cast<int64_t>(info.count))});
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // TOPK.RESERVE key topk [width depth]
+    // 未指定尺寸时 width = 8k、depth = 5
+    class TopKReserveCommand : public ICommand {
+    public:
+        explicit TopKReserveCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3 && argv.size() != 5) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'topk.reserve' command");
+            }
+
+            uint32_t k, width, depth = 5;
+            if (!ParseSketchDimension(argv[2], k) || k > TopK::kMaxK) return RespBuilder::Error("ERR invalid k");
+            width = k * 8;
+            if (argv.size() == 5) {
+                if (!ParseSketchDimension(argv[3], width)) return RespBuilder::Error("ERR invalid width");
+                if (!ParseSketchDimension(argv[4], depth)) return RespBuilder::Error("ERR invalid depth");
+            }
+            return CreateSketch(*cache_, argv[1], [&] { return TopK::Create(k, width, depth); });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // TOPK.ADD key item [item ...] / TOPK.INCRBY key item increment [item increment ...]
+    // 每个元素回复被它挤出候选列表的元素，没有则为 nil
+    class TopKAddCommand : public ICommand {
+    public:
+        explicit TopKAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache, bool with_increment = false)
+            : cache_(std::move(cache)), with_increment_(with_increment) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3 || (with_increment_ && argv.size() % 2 != 0)) {
+                return RespBuilder::Error(with_increment_ ? "ERR wrong number of arguments for 'topk.incrby' command"
+                                                          : "ERR wrong number of arguments for 'topk.add' command");
+            }
+
+            std::vector<std::pair<std::string_view, uint32_t>> items;
+            size_t stride = with_increment_ ? 2 : 1;
+            items.reserve((argv.size() - 2) / stride);
+            for (size_t i = 2; i < argv.size(); i += stride) {
+                uint32_t increment = 1;
+                if (with_increment_ && !ParseSketchDimension(argv[i + 1], increment)) {
+                    return RespBuilder::Error("ERR cannot parse number");
+                }
+                items.emplace_back(argv[i], increment);
+            }
+
+            return UpdateSketch<TopK>(*cache_, argv[1], [&](std::string &data) {
+                std::vector<std::optional<std::string>> expelled;
+                TopK::IncrBy(data, items, expelled);
+
+                std::vector<std::string> replies;
+                replies.reserve(expelled.size());
+                for (const auto &item: expelled) replies.push_back(item ? RespBuilder::BulkString(*item) : RespBuilder::Nil());
+                return RespBuilder::Array(replies);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+        bool with_increment_;
+    };
+
+    class TopKIncrByCommand : public TopKAddCommand {
+    public:
+        explicit TopKIncrByCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : TopKAddCommand(std::move(cache), true) {}
+    };
+
+    // TOPK.QUERY key item [item ...]
+    class TopKQueryCommand : public ICommand {
+    public:
+        explicit TopKQueryCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'topk.query' command");
+            }
+
+            return VisitSketch<TopK>(*cache_, argv[1], [&](std::string_view data) {
+                std::vector<std::string> replies;
+                replies.reserve(argv.size() - 2);
+                for (size_t i = 2; i < argv.size(); ++i) replies.push_back(RespBuilder::Integer(TopK::Contains(data, argv[i]) ? 1 : 0));
+                return RespBuilder::Array(replies);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // TOPK.LIST key [WITHCOUNT]：按估计值从高到低
+    class TopKListCommand : public ICommand {
+    public:
+        explicit TopKListCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2 && argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'topk.list' command");
+            }
+            bool with_count = argv.size() == 3;
+            if (with_count && !ICaseCmp(argv[2], "WITHCOUNT")) return RespBuilder::Error("ERR syntax error");
+
+            return VisitSketch<TopK>(*cache_, argv[1], [&](std::string_view data) {
+                std::vector<std::string> replies;
+                for (const auto &candidate: TopK::List(data)) {
+                    replies.push_back(RespBuilder::BulkString(candidate.item));
+                    if (with_count) replies.push_back(RespBuilder::Integer(static_cast<int64_t>(candidate.count)));
+                }
+                return RespBuilder::Array(replies);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // TOPK.INFO key
+    class TopKInfoCommand : public ICommand {
+    public:
+        explicit TopKInfoCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'topk.info' command");
+            }
+
+            return VisitSketch<TopK>(*cache_, argv[1], [&](std::string_view data) {
+                auto info = TopK::GetInfo(data);
+                return RespBuilder::Array({RespBuilder::BulkString("k"), RespBuilder::Integer(info.k),
+                                           RespBuilder::BulkString("width"), RespBuilder::Integer(info.width),
+                                           RespBuilder::BulkString("depth"), RespBuilder::Integer(info.depth)});
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class SubscribeCommand : public ICommand {
+    public:
+        explicit SubscribeCommand(std::shared_ptr<ChannelManager> channel_manager)
+            : channel_manager_(std::move(channel_manager)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("SUBSCRIBE requires at least one channel");
+            }
+
+            // 记录本次订阅的频道（需要结合 Session 存储订阅关系，这里返回响应格式）
+            std::unordered_set<std::string> channels;
+            for (size_t i = 1; i < argv.size(); ++i) {
+                channels.insert(argv[i]);
+            }
+
+            // 构建订阅响应（实际使用时需结合 Session 的 subscribed_channels_）
+            return RespBuilder::SubscribeResponse(channels);
+        }
+
+    private:
+        std::shared_ptr<ChannelManager> channel_manager_;// 频道管理器
+    };
+
+    // 取消订阅命令：UNSUBSCRIBE [channel [channel ...]]
+    class UnsubscribeCommand : public ICommand {
+    public:
+        // 构造函数：需要频道管理器和当前会话（关键）
+        explicit UnsubscribeCommand(
+                std::shared_ptr<apps::ChannelManager> channel_manager,
+                std::weak_ptr<apps::Session> session// 必须包含session参数
+                ) : channel_manager_(std::move(channel_manager)),
+                    session_(std::move(session)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            // 锁定会话（确保会话未过期）
+            auto session = session_.lock();
+            if (!session) {
+                return RespBuilder::Error("Session expired");
+            }
+
+            std::unordered_set<std::string> unsubscribed;
+            const auto &subscribed_channels = session->GetSubscribedChannels();
+
+            if (argv.size() < 2) {
+                // 无参数：取消所有订阅
+                unsubscribed = subscribed_channels;
+                for (const auto &channel: subscribed_channels) {
+                    channel_manager_->Unsubscribe(channel, session);
+                }
+            } else {
+                // 有参数：取消指定频道
+                for (size_t i = 1; i < argv.size(); ++i) {
+                    const std::string &channel = argv[i];
+                    if (subscribed_channels.count(channel)) {
+                        unsubscribed.insert(channel);
+                        channel_manager_->Unsubscribe(channel, session);
+                    }
+                }
+            }
+
+            // 构建响应（包含实际取消的频道）
+            return RespBuilder::UnsubscribeResponse(unsubscribed);
+        }
+
+    private:
+        std::shared_ptr<apps::ChannelManager> channel_manager_;// 频道管理器
+        std::weak_ptr<apps::Session> session_;                 // 当前会话（弱指针）
+    };
+
+    // 发布命令：PUBLISH channel message
+    class PublishCommand : public ICommand {
+    public:
+        explicit PublishCommand(std::shared_ptr<ChannelManager> channel_manager)
+            : channel_manager_(std::move(channel_manager)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("PUBLISH requires channel and message");
+            }
+
+            const std::string &channel = argv[1];
+            const std::string &message = argv[2];
+            size_t subscribers = channel_manager_->Publish(channel, message);// 发布消息并返回订阅者数量
+
+            return RespBuilder::Integer(subscribers);// 返回接收消息的订阅者数量
+        }
+
+    private:
+        std::shared_ptr<ChannelManager> channel_manager_;
+    };
+
+    // 模式订阅命令：PSUBSCRIBE pattern [pattern ...]
+    class PSubscribeCommand : public ICommand {
+    public:
+        explicit PSubscribeCommand(
+                std::shared_ptr<apps::ChannelManager> channel_manager,
+                std::weak_ptr<apps::Session> session) : channel_manager_(std::move(channel_manager)),
+                                                        session_(std::move(session)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            auto session = session_.lock();
+            if (!session) {
+                return RespBuilder::Error("Session expired");
+            }
+
+            if (argv.size() < 2) {
+                return RespBuilder::Error("PSUBSCRIBE requires at least one pattern");
+            }
+
+            std::unordered_set<std::string> subscribed_patterns;
+            for (size_t i = 1; i < argv.size(); ++i) {
+                const std::string &pattern = argv[i];
+                session->AddSubscribedPattern(pattern);
+                channel_manager_->PSubscribe(pattern, session);
+                subscribed_patterns.insert(pattern);
+            }
+
+            // 关键修复：在返回响应前切换到PubSub模式
+            session->SwitchMode(SessionMode::PubSubMode);// 添加这一行
+
+            // 构建并返回响应
+            return RespBuilder::PSubscribeResponse(
+                    subscribed_patterns,
+                    session->GetSubscribedPatterns().size());
+        }
+
+
+    private:
+        std::shared_ptr<apps::ChannelManager> channel_manager_;
+        std::weak_ptr<apps::Session> session_;
+    };
+
+    // 取消模式订阅命令：PUNSUBSCRIBE [pattern [pattern ...]]
+    class PUnsubscribeCommand : public ICommand {
+    public:
+        explicit PUnsubscribeCommand(
+                std::shared_ptr<apps::ChannelManager> channel_manager,
+                std::weak_ptr<apps::Session> session) : channel_manager_(std::move(channel_manager)),
+                                                        session_(std::move(session)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            auto session = session_.lock();
+            if (!session) {
+                return RespBuilder::Error("Session expired");
+            }
+
+            std::unordered_set<std::string> unsubscribed_patterns;
+            const auto &subscribed_patterns = session->GetSubscribedPatterns();// 调用接口获取
+
+            if (argv.size() < 2) {
+                // 无参数：取消所有模式订阅
+                unsubscribed_patterns = subscribed_patterns;
+                for (const auto &pattern: subscribed_patterns) {
+                    channel_manager_->PUnsubscribe(pattern, session);
+                }
+                session->ClearSubscribedPatterns();// 调用接口清空
+            } else {
+                // 取消指定模式
+                for (size_t i = 1; i < argv.size(); ++i) {
+                    const std::string &pattern = argv[i];
+                    if (subscribed_patterns.count(pattern)) {
+                        unsubscribed_patterns.insert(pattern);
+                        session->RemoveSubscribedPattern(pattern);// 调用接口移除
+                        channel_manager_->PUnsubscribe(pattern, session);
+                    }
+                }
+            }
+            if (session->GetSubscribedPatterns().empty() && session->GetSubscribedChannels().empty()) {
+                session->SwitchMode(SessionMode::CacheMode);
+            }
+            // 调用接口获取剩余订阅数
+            return RespBuilder::PUnsubscribeResponse(
+                    unsubscribed_patterns,
+                    session->GetSubscribedPatterns().size());
+        }
+
+    private:
+        std::shared_ptr<apps::ChannelManager> channel_manager_;
+        std::weak_ptr<apps::Session> session_;
+    };
+
+    class PubSubCommand : public ICommand {
+    public:
+        explicit PubSubCommand(std::shared_ptr<apps::ChannelManager> channel_manager)
+            : channel_manager_(std::move(channel_manager)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("PUBSUB requires a subcommand (CHANNELS, NUMSUB, NUMPAT, PATTERNS)");
+            }
+            const std::string &subcmd = argv[1];// 获取子命令 (e.g., "channels", "CHANNELS")
+
+            if (ICaseCmp(subcmd, "CHANNELS")) {
+                return HandleChannels(argv);
+            } else if (ICaseCmp(subcmd, "NUMSUB")) {
+                return HandleNumSub(argv);
+            } else if (ICaseCmp(subcmd, "NUMPAT")) {
+                return HandleNumPat();
+            } else if (ICaseCmp(subcmd, "PATTERNS")) {
+                return HandlePatterns();
+            } else {
+                // 使用原始的 argv[1] 以便在错误信息中显示用户实际输入的内容
+                return RespBuilder::Error("Unknown PUBSUB subcommand: " + argv[1]);
+            }
+        }
+
+    private:
+        // 处理 PUBSUB CHANNELS [pattern]
+        std::string HandleChannels(const std::vector<std::string> &argv) {
+            std::string pattern = "*";// 默认匹配所有频道
+            if (argv.size() >= 3) {
+                pattern = argv[2];
+            }
+
+            auto channels = channel_manager_->GetChannelsByPattern(pattern);
+            std::vector<std::string> elements;
+            for (const auto &channel: channels) {
+                elements.push_back(RespBuilder::BulkString(channel));
+            }
+            return RespBuilder::Array(elements);
+        }
+
+        // 处理 PUBSUB NUMSUB channel1 [channel2 ...]
+        std::string HandleNumSub(const std::vector<std::string> &argv) {
+            if (argv.size() < 3) {
+                return RespBuilder::Array({});// 无参数时返回空数组
+            }
+
+            std::vector<std::string> elements;
+            for (size_t i = 2; i < argv.size(); ++i) {
+                const std::string &channel = argv[i];
+                size_t count = channel_manager_->GetChannelSubscriberCount(channel);
+                elements.push_back(RespBuilder::BulkString(channel));
+                elements.push_back(RespBuilder::Integer(count));
+            }
+            return RespBuilder::Array(elements);
+        }
+
+        // 处理 PUBSUB NUMPAT
+        std::string HandleNumPat() {
+            size_t count = channel_manager_->GetPatternSubscriberCount();
+            return RespBuilder::Integer(count);
+        }
+
+        // 新增：处理 PUBSUB PATTERNS
+        std::string HandlePatterns() {
+            // 从ChannelManager获取所有活跃模式及订阅数
+            auto active_patterns = channel_manager_->GetActivePatterns();
+            std::vector<std::string> elements;
+
+            for (const auto &[pattern, count]: active_patterns) {
+                // 每个模式返回一个子数组：[模式名, 订阅数]
+                std::vector<std::string> sub_elements;
+                sub_elements.push_back(RespBuilder::BulkString(pattern));
+                sub_elements.push_back(RespBuilder::Integer(count));
+                elements.push_back(RespBuilder::Array(sub_elements));
+            }
+
+            return RespBuilder::Array(elements);
+        }
+
+    private:
+        std::shared_ptr<apps::ChannelManager> channel_manager_;
+    };
+
+    // hash 的读写直接在 "hash:" 编码上进行（见 AstraHash::FindField/SetField）：
+    // 每条命令只查找一次键，只解析到需要的字段为止，写命令通过 Update 原地改写值中对应的那一段。
+
+    // 在 hash 编码上原地读改写，fn(std::string &encoded) 返回回复；键不存在时从空 hash 开始
+    template<typename Fn>
+    std::string UpdateHash(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key, Fn &&fn) {
+        return cache.Update(key, [&](std::string &value, bool existed) {
+            if (!existed) {
+                value.assign(AstraHash::kPrefix);
+            } else if (!AstraHash::IsEncoded(value)) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            std::string reply = fn(value);
+            // 没有写入任何字段时清空，由 Update 撤销新插入的键
+            if (!existed && value.size() == AstraHash::kPrefix.size()) value.clear();
+            return reply;
+        });
+    }
+
+    // 只读访问 hash 编码而不复制整个值，fn(const std::string *encoded) 在键不存在时收到 nullptr
+    template<typename Fn>
+    std::string VisitHash(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key, Fn &&fn) {
+        return cache.Visit(key, [&](const std::string *value) {
+            if (value && !AstraHash::IsEncoded(*value)) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            return fn(value);
+        });
+    }
+
+    // HSET key field value [field value ...] / HMSET（回复 OK）
+    class HSetCommand : public ICommand {
+    public:
+        explicit HSetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache, bool reply_ok = false)
+            : cache_(std::move(cache)), reply_ok_(reply_ok) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 4 || argv.size() % 2 != 0) {
+                return RespBuilder::Error(reply_ok_ ? "ERR wrong number of arguments for 'hmset' command"
+                                                    : "ERR wrong number of arguments for 'hset' command");
+            }
+
+            return UpdateHash(*cache_, argv[1], [&](std::string &encoded) {
+                int64_t fields_set = 0;
+                for (size_t i = 2; i < argv.size(); i += 2) {
+                    if (AstraHash::SetField(encoded, argv[i], argv[i + 1])) fields_set++;
+                }
+                return reply_ok_ ? RespBuilder::SimpleString("OK") : RespBuilder::Integer(fields_set);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+        bool reply_ok_;
+    };
+
+    class HMSetCommand : public HSetCommand {
+    public:
+        explicit HMSetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : HSetCommand(std::move(cache), true) {}
+    };
+
+    class HGetCommand : public ICommand {
+    public:
+        explicit HGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hget' command");
+            }
+
+            return VisitHash(*cache_, argv[1], [&](const std::string *encoded) {
+                auto value = encoded ? AstraHash::FindField(*encoded, argv[2]) : std::nullopt;
+                return value ? RespBuilder::BulkString(*value) : RespBuilder::Nil();
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // HMGET key field [field ...]
+    class HMGetCommand : public ICommand {
+    public:
+        explicit HMGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hmget' command");
+            }
+
+            return VisitHash(*cache_, argv[1], [&](const std::string *encoded) {
+                std::vector<std::string> replies;
+                replies.reserve(argv.size() - 2);
+                for (size_t i = 2; i < argv.size(); ++i) {
+                    auto value = encoded ? AstraHash::FindField(*encoded, argv[i]) : std::nullopt;
+                    replies.push_back(value ? RespBuilder::BulkString(*value) : RespBuilder::Nil());
+                }
+                return RespBuilder::Array(replies);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // HSETNX key field value
+    class HSetNxCommand : public ICommand {
+    public:
+        explicit HSetNxCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hsetnx' command");
+            }
+
+            return UpdateHash(*cache_, argv[1], [&](std::string &encoded) {
+                if (AstraHash::FindField(encoded, argv[2])) return RespBuilder::Integer(0);
+                AstraHash::SetField(encoded, argv[2], argv[3]);
+                return RespBuilder::Integer(1);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // HSTRLEN key field
+    class HStrLenCommand : public ICommand {
+    public:
+        explicit HStrLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hstrlen' command");
+            }
+
+            return VisitHash(*cache_, argv[1], [&](const std::string *encoded) {
+                auto value = encoded ? AstraHash::FindField(*encoded, argv[2]) : std::nullopt;
+                return RespBuilder::Integer(value ? static_cast<int64_t>(value->size()) : 0);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // HINCRBY key field increment
+    class HIncrByCommand : public ICommand {
+    public:
+        explicit HIncrByCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hincrby' command");
+            }
+
+            int64_t delta;
+            if (!ParseInt64(argv[3], delta)) {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+
+            return UpdateHash(*cache_, argv[1], [&](std::string &encoded) {
+                int64_t current = 0;
+                if (auto value = AstraHash::FindField(encoded, argv[2]); value && !ParseInt64(*value, current)) {
+                    return RespBuilder::Error("ERR hash value is not an integer");
+                }
+                if ((delta > 0 && current > INT64_MAX - delta) || (delta < 0 && current < INT64_MIN - delta)) {
+                    return RespBuilder::Error("ERR increment or decrement would overflow");
+                }
+
+                char buf[24];
+                auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), current + delta);
+                AstraHash::SetField(encoded, argv[2], std::string_view(buf, static_cast<size_t>(end - buf)));
+                return RespBuilder::Integer(current + delta);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // HINCRBYFLOAT key field increment
+    class HIncrByFloatCommand : public ICommand {
+    public:
+        explicit HIncrByFloatCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hincrbyfloat' command");
+            }
+
+            long double delta;
+            if (!ParseLongDouble(argv[3], delta) || std::isinf(delta)) {
+                return RespBuilder::Error("ERR value is not a valid float");
+            }
+
+            return UpdateHash(*cache_, argv[1], [&](std::string &encoded) {
+                long double current = 0;
+                if (auto value = AstraHash::FindField(encoded, argv[2]);
+                    value && !ParseLongDouble(std::string(*value), current)) {
+                    return RespBuilder::Error("ERR hash value is not a float");
+                }
+
+                long double result = current + delta;
+                if (std::isnan(result) || std::isinf(result)) {
+                    return RespBuilder::Error("ERR increment would produce NaN or Infinity");
+                }
+
+                std::string formatted;
+                FormatLongDouble(result, formatted);
+                AstraHash::SetField(encoded, argv[2], formatted);
+                return RespBuilder::BulkString(formatted);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class HGetAllCommand : public ICommand {
+    public:
+        explicit HGetAllCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hgetall' command");
+            }
+
+            return VisitHash(*cache_, argv[1], [&](const std::string *encoded) {
+                std::vector<std::string> result;// 键不存在时返回空 map 而不是nil
+                if (encoded) {
+                    AstraHash::ForEachField(*encoded, [&](std::string_view field, std::string_view value, size_t) {
+                        result.push_back(RespBuilder::BulkString(field));
+                        result.push_back(RespBuilder::BulkString(value));
+                        return true;
+                    });
+                }
+                return RespBuilder::Map(result);
+            });
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // Hash相关命令实现
+    class HDelCommand : public ICommand {
+    public:
+        explicit HDelCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hdel'");
+            }
+
+            std::string key = argv[1];
+            auto value = cache_->Get(key);
+            if (!value.has_value() || value->substr(0, 5) != "hash:") {
+                return RespBuilder::Integer(0);
+            }
+
+            std::string data = value.value();
+            AstraHash hash;
+            size_t pos = 5;// 跳过"hash:"前缀
+            while (pos < data.length()) {
+                // 解析字段名长度
+                size_t field_len_end = data.find(':', pos);
+                if (field_len_end == std::string::npos) break;
+
+                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
+                pos = field_len_end + 1;
+
+                if (pos + field_len > data.length()) break;
+                std::string field_name = data.substr(pos, field_len);
+                pos += field_len;
+
+                // 解析值长度
+                size_t value_len_end = data.find(':', pos);
+                if (value_len_end == std::string::npos) break;
+
+                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
+                pos = value_len_end + 1;
+
+                if (pos + value_len > data.length()) break;
+                std::string field_value = data.substr(pos, value_len);
+                pos += value_len;
+
+                hash.HSet(field_name, field_value);
+            }
+
+            int deleted = 0;
+            for (size_t i = 2; i < argv.size(); i++) {
+                if (hash.HDelete(argv[i])) {
+                    deleted++;
+                }
+            }
+
+            if (hash.HLen() == 0) {
+                cache_->Remove(key);
+            } else {
+                std::ostringstream serialized;
+                serialized << "hash:";
+                auto all_fields = hash.HGetAll();
+                for (const auto &pair: all_fields) {
+                    const std::string &field = pair.first;
+                    const std::string &value = pair.second;
+                    serialized << field.length() << ":" << field << value.length() << ":" << value;
+                }
+                cache_->Put(key, serialized.str());
+            }
+
+            return RespBuilder::Integer(deleted);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class HLenCommand : public ICommand {
+    public:
+        explicit HLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hlen'");
+            }
+
+            std::string key = argv[1];
+
+            auto value = cache_->Get(key);
+            if (!value.has_value() || value->substr(0, 5) != "hash:") {
+                return RespBuilder::Integer(0);
+            }
+
+            std::string data = value.value();
+            AstraHash hash;
+            size_t pos = 5;// 跳过"hash:"前缀
+            while (pos < data.length()) {
+                // 解析字段名长度
+                size_t field_len_end = data.find(':', pos);
+                if (field_len_end == std::string::npos) break;
+
+                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
+                pos = field_len_end + 1;
+
+                if (pos + field_len > data.length()) break;
+                std::string field_name = data.substr(pos, field_len);
+                pos += field_len;
+
+                // 解析值长度
+                size_t value_len_end = data.find(':', pos);
+                if (value_len_end == std::string::npos) break;
+
+                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
+                pos = value_len_end + 1;
+
+                if (pos + value_len > data.length()) break;
+                std::string field_value = data.substr(pos, value_len);
+                pos += value_len;
+
+                hash.HSet(field_name, field_value);
+            }
+
+            return RespBuilder::Integer(hash.HLen());
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class HExistsCommand : public ICommand {
+    public:
+        explicit HExistsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hexists'");
+            }
+
+            std::string key = argv[1];
+            std::string field = argv[2];
+
+            auto value = cache_->Get(key);
+            if (!value.has_value() || value->substr(0, 5) != "hash:") {
+                return RespBuilder::Integer(0);
+            }
+
+            std::string data = value.value();
+            AstraHash hash;
+            size_t pos = 5;// 跳过"hash:"前缀
+            while (pos < data.length()) {
+                // 解析字段名长度
+                size_t field_len_end = data.find(':', pos);
+                if (field_len_end == std::string::npos) break;
+
+                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
+                pos = field_len_end + 1;
+
+                if (pos + field_len > data.length()) break;
+                std::string field_name = data.substr(pos, field_len);
+                pos += field_len;
+
+                // 解析值长度
+                size_t value_len_end = data.find(':', pos);
+                if (value_len_end == std::string::npos) break;
+
+                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
+                pos = value_len_end + 1;
+
+                if (pos + value_len > data.length()) break;
+                std::string field_value = data.substr(pos, value_len);
+                pos += value_len;
+
+                hash.HSet(field_name, field_value);
+            }
+
+            return RespBuilder::Integer(hash.HExists(field) ? 1 : 0);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class HKeysCommand : public ICommand {
+    public:
+        explicit HKeysCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hkeys'");
+            }
+
+            std::string key = argv[1];
+
+            auto value = cache_->Get(key);
+            if (!value.has_value() || value->substr(0, 5) != "hash:") {
+                return RespBuilder::Array({});
+            }
+
+            std::string data = value.value();
+            AstraHash hash;
+            size_t pos = 5;// 跳过"hash:"前缀
+            while (pos < data.length()) {
+                // 解析字段名长度
+                size_t field_len_end = data.find(':', pos);
+                if (field_len_end == std::string::npos) break;
+
+                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
+                pos = field_len_end + 1;
+
+                if (pos + field_len > data.length()) break;
+                std::string field_name = data.substr(pos, field_len);
+                pos += field_len;
+
+                // 解析值长度
+                size_t value_len_end = data.find(':', pos);
+                if (value_len_end == std::string::npos) break;
+
+                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
+                pos = value_len_end + 1;
+
+                if (pos + value_len > data.length()) break;
+                std::string field_value = data.substr(pos, value_len);
+                pos += value_len;
+
+                hash.HSet(field_name, field_value);
+            }
+
+            std::vector<std::string> result;
+            auto all_fields = hash.HGetAll();
+            for (const auto &pair: all_fields) {
+                result.push_back(RespBuilder::BulkString(pair.first));
+            }
+
+            return RespBuilder::Array(result);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class HValsCommand : public ICommand {
+    public:
+        explicit HValsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'hvals'");
+            }
+
+            std::string key = argv[1];
+
+            auto value = cache_->Get(key);
+            if (!value.has_value() || value->substr(0, 5) != "hash:") {
+                return RespBuilder::Array({});
             }
 
             std::string data = value.value();
             AstraHash hash;
             size_t pos = 5;// 跳过"hash:"前缀
             while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
+                // 解析字段名长度
+                size_t field_len_end = data.find(':', pos);
+                if (field_len_end == std::string::npos) break;
+
+                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
+                pos = field_len_end + 1;
+
+                if (pos + field_len > data.length()) break;
+                std::string field_name = data.substr(pos, field_len);
+                pos += field_len;
+
+                // 解析值长度
+                size_t value_len_end = data.find(':', pos);
+                if (value_len_end == std::string::npos) break;
+
+                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
+                pos = value_len_end + 1;
+
+                if (pos + value_len > data.length()) break;
+                std::string field_value = data.substr(pos, value_len);
+                pos += value_len;
+
+                hash.HSet(field_name, field_value);
+            }
+
+            std::vector<std::string> result;
+            auto all_fields = hash.HGetAll();
+            for (const auto &pair: all_fields) {
+                result.push_back(RespBuilder::BulkString(pair.second));
+            }
+
+            return RespBuilder::Array(result);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // List相关命令实现
+    // 列表的读改写都在 BlockingManager 的键分片锁内完成；登记等待与唤醒等待者另需 Mutex()，
+    // 保证推入与阻塞等待者之间不丢失唤醒
+
+    enum class ListEnd {
+        Left,
+        Right
+    };
+
+    enum class ListLoadResult {
+        Ok,
+        Missing,
+        WrongType
+    };
+
+    inline ListLoadResult LoadList(AstraCache<LRUCache, std::string, std::string> &cache,
+                                   const std::string &key, AstraList &list) {
+        auto existing = cache.Get(key);
+        if (!existing.has_value()) {
+            return ListLoadResult::Missing;
+        }
+        if (existing->compare(0, 5, "list:") != 0) {
+            return ListLoadResult::WrongType;
+        }
+        list = AstraList::Deserialize(*existing);
+        return ListLoadResult::Ok;
+    }
+
+    // 写回列表，空列表直接删除键；原地更新，保留键上已有的过期时间
+    inline void StoreList(AstraCache<LRUCache, std::string, std::string> &cache,
+                          const std::string &key, const AstraList &list) {
+        if (list.LLen() == 0) {
+            cache.Remove(key);
+        } else {
+            cache.Update(key, [&list](std::string &value, bool) {
+                value = list.Serialize();
+                return true;
+            });
+        }
+    }
+
+    // 推入后的写回：先把元素直接交给该键上的阻塞等待者，剩余部分再落入缓存
+    // 分片上有等待者时调用方经 LockKeyForWake 已持有 Mutex()；没有时跳过 Serve，不去碰 Mutex()
+    inline void ServeAndStoreList(AstraCache<LRUCache, std::string, std::string> &cache,
+                                  const std::string &key, AstraList &list) {
+        auto manager = apps::BlockingManager::GetInstance();
+        if (manager->HasWaiters(key)) {
+            manager->Serve(key, list);
+        }
+        StoreList(cache, key, list);
+    }
+
+    inline std::string PopListEnd(AstraList &list, ListEnd end) {
+        return end == ListEnd::Left ? list.LPop() : list.RPop();
+    }
+
+    inline void PushListEnd(AstraList &list, ListEnd end, const std::string &value) {
+        if (end == ListEnd::Left) {
+            list.LPush({value});
+        } else {
+            list.RPush({value});
+        }
+    }
+
+    inline bool ParseListEnd(const std::string &arg, ListEnd &end) {
+        if (ICaseCmp(arg, "LEFT")) {
+            end = ListEnd::Left;
+            return true;
+        }
+        if (ICaseCmp(arg, "RIGHT")) {
+            end = ListEnd::Right;
+            return true;
+        }
+        return false;
+    }
+
+    // 从 source 的 from 端取出一个元素推入 destination 的 to 端，返回回复
+    // source 的写回由调用方负责；目标键类型错误时不弹出元素
+    // 调用方已持有 Mutex()（BLMOVE 的立即尝试或推入方唤醒），因此可以再取目标键的分片
+    inline std::string MoveListElement(AstraCache<LRUCache, std::string, std::string> &cache,
+                                       const std::string &source_key, AstraList &source, ListEnd from,
+                                       const std::string &dest_key, ListEnd to) {
+        if (dest_key == source_key) {
+            std::string value = PopListEnd(source, from);
+            PushListEnd(source, to, value);
+            return RespBuilder::BulkString(value);
+        }
+
+        auto dest_lock = apps::BlockingManager::GetInstance()->LockKey(dest_key);
+        AstraList dest;
+        if (LoadList(cache, dest_key, dest) == ListLoadResult::WrongType) {
+            return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+        }
+        std::string value = PopListEnd(source, from);
+        PushListEnd(dest, to, value);
+        ServeAndStoreList(cache, dest_key, dest);
+        return RespBuilder::BulkString(value);
+    }
+
+    // 阻塞超时的上限（毫秒）：再大换算成定时器的纳秒时会溢出
+    inline constexpr int64_t kMaxBlockTimeoutMs = std::numeric_limits<int64_t>::max() / 1'000'000;
+
+    // 阻塞列表命令（BLPOP/BRPOP/BLMOVE）的参数
+    struct BlockingListRequest {
+        std::string command;
+        std::vector<std::string> keys;
+        double timeout = 0;// 秒，0 表示无限等待
+        ListEnd from = ListEnd::Left;
+        bool move = false;
+        std::string destination;
+        ListEnd to = ListEnd::Left;
+
+        // 超时后的回复
+        std::string TimeoutReply() const {
+            return move ? RespBuilder::Nil() : RespBuilder::NullArray();
+        }
+    };
+
+    // 解析阻塞列表命令，出错时返回错误回复
+    inline std::optional<std::string> ParseBlockingListRequest(const std::vector<std::string> &argv,
+                                                               BlockingListRequest &request) {
+        std::string cmd = argv.empty() ? std::string() : argv[0];
+        std::transform(cmd.begin(), cmd.end(), cmd.begin(), [](unsigned char c) { return std::toupper(c); });
+        request.command = cmd;
+
+        std::string timeout_arg;
+        if (cmd == "BLMOVE") {
+            if (argv.size() != 6) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'blmove' command");
+            }
+            if (!ParseListEnd(argv[3], request.from) || !ParseListEnd(argv[4], request.to)) {
+                return RespBuilder::Error("ERR syntax error");
+            }
+            request.move = true;
+            request.keys = {argv[1]};
+            request.destination = argv[2];
+            timeout_arg = argv[5];
+        } else {
+            if (argv.size() < 3) {
+                std::string name = cmd;
+                std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+                return RespBuilder::Error("ERR wrong number of arguments for '" + name + "' command");
+            }
+            request.from = cmd == "BRPOP" ? ListEnd::Right : ListEnd::Left;
+            request.keys.assign(argv.begin() + 1, argv.end() - 1);
+            timeout_arg = argv.back();
+        }
+
+        char *end;
+        errno = 0;
+        request.timeout = std::strtod(timeout_arg.c_str(), &end);
+        if (errno == ERANGE || *end != '\0' || timeout_arg.empty() || !std::isfinite(request.timeout)) {
+            return RespBuilder::Error("ERR timeout is not a float or out of range");
+        }
+        if (request.timeout < 0) {
+            return RespBuilder::Error("ERR timeout is negative");
+        }
+        if (request.timeout * 1000 > static_cast<double>(kMaxBlockTimeoutMs)) {
+            return RespBuilder::Error("ERR timeout is out of range");
+        }
+        return std::nullopt;
+    }
+
+    // 不阻塞地尝试服务一次；所有键都为空时返回 nullopt，调用方需持有 LockKeys(request.keys)
+    inline std::optional<std::string> TryServeBlockingList(AstraCache<LRUCache, std::string, std::string> &cache,
+                                                           const BlockingListRequest &request) {
+        for (const auto &key: request.keys) {
+            AstraList list;
+            auto loaded = LoadList(cache, key, list);
+            if (loaded == ListLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ListLoadResult::Missing || list.LLen() == 0) {
+                continue;
+            }
+
+            std::string response;
+            if (request.move) {
+                response = MoveListElement(cache, key, list, request.from, request.destination, request.to);
+            } else {
+                response = RespBuilder::Array({RespBuilder::BulkString(key),
+                                               RespBuilder::BulkString(PopListEnd(list, request.from))});
+            }
+            StoreList(cache, key, list);
+            return response;
+        }
+        return std::nullopt;
+    }
+
+    // 推入方唤醒等待者时调用：key 对应的列表已由推入方加载，直接在其上取元素，写回由推入方完成
+    inline std::string ServeBlockedListClient(AstraCache<LRUCache, std::string, std::string> &cache,
+                                              const BlockingListRequest &request,
+                                              const std::string &key, AstraList &list) {
+        if (request.move) {
+            return MoveListElement(cache, key, list, request.from, request.destination, request.to);
+        }
+        return RespBuilder::Array({RespBuilder::BulkString(key),
+                                   RespBuilder::BulkString(PopListEnd(list, request.from))});
+    }
+
+    class LPushCommand : public ICommand {
+    public:
+        explicit LPushCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'lpush' command");
+            }
+
+            std::string key = argv[1];
+            std::vector<std::string> values(argv.begin() + 2, argv.end());
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKeyForWake(key);
+            AstraList list;
+            if (LoadList(*cache_, key, list) == ListLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            // LPUSH a b c 的结果是 c b a，与 Redis 一致
+            for (const auto &value: values) {
+                list.LPush({value});
+            }
+            size_t new_length = list.LLen();
+            ServeAndStoreList(*cache_, key, list);
+
+            return RespBuilder::Integer(new_length);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class RPushCommand : public ICommand {
+    public:
+        explicit RPushCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'rpush' command");
+            }
+
+            std::string key = argv[1];
+            std::vector<std::string> values(argv.begin() + 2, argv.end());
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKeyForWake(key);
+            AstraList list;
+            if (LoadList(*cache_, key, list) == ListLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            size_t new_length = list.RPush(values);
+            ServeAndStoreList(*cache_, key, list);
+
+            return RespBuilder::Integer(new_length);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class LPopCommand : public ICommand {
+    public:
+        explicit LPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'lpop' command");
+            }
+
+            std::string key = argv[1];
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            AstraList list;
+            auto loaded = LoadList(*cache_, key, list);
+            if (loaded == ListLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ListLoadResult::Missing || list.LLen() == 0) {
+                return RespBuilder::Nil();
+            }
+
+            std::string value = list.LPop();
+            StoreList(*cache_, key, list);// 列表为空时删除键
+
+            return RespBuilder::BulkString(value);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class RPopCommand : public ICommand {
+    public:
+        explicit RPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'rpop' command");
+            }
+
+            std::string key = argv[1];
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            AstraList list;
+            auto loaded = LoadList(*cache_, key, list);
+            if (loaded == ListLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ListLoadResult::Missing || list.LLen() == 0) {
+                return RespBuilder::Nil();
+            }
+
+            std::string value = list.RPop();
+            StoreList(*cache_, key, list);// 列表为空时删除键
+
+            return RespBuilder::BulkString(value);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // BLPOP key [key ...] timeout
+    // 经由 Session 执行时会真正阻塞；在 Lua 等非阻塞上下文中执行时退化为一次立即尝试
+    class BLPopCommand : public ICommand {
+    public:
+        explicit BLPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            BlockingListRequest request;
+            if (auto error = ParseBlockingListRequest(argv, request)) {
+                return *error;
+            }
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKeys(request.keys);
+            return TryServeBlockingList(*cache_, request).value_or(request.TimeoutReply());
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // BRPOP key [key ...] timeout
+    class BRPopCommand : public ICommand {
+    public:
+        explicit BRPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            BlockingListRequest request;
+            if (auto error = ParseBlockingListRequest(argv, request)) {
+                return *error;
+            }
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKeys(request.keys);
+            return TryServeBlockingList(*cache_, request).value_or(request.TimeoutReply());
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // BLMOVE source destination LEFT|RIGHT LEFT|RIGHT timeout
+    class BLMoveCommand : public ICommand {
+    public:
+        explicit BLMoveCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            BlockingListRequest request;
+            if (auto error = ParseBlockingListRequest(argv, request)) {
+                return *error;
+            }
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKeys(request.keys);
+            return TryServeBlockingList(*cache_, request).value_or(request.TimeoutReply());
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class LLenCommand : public ICommand {
+    public:
+        explicit LLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'llen' command");
+            }
+
+            std::string key = argv[1];
+
+            AstraList list;
+            if (LoadList(*cache_, key, list) == ListLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            return RespBuilder::Integer(list.LLen());
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class LRangeCommand : public ICommand {
+    public:
+        explicit LRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'lrange' command");
+            }
+
+            std::string key = argv[1];
+
+            // 解析起始和结束索引
+            char *end;
+            errno = 0;
+            long long start = std::strtoll(argv[2].c_str(), &end, 10);
+            if (errno == ERANGE || *end != '\0') {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+
+            errno = 0;
+            long long stop = std::strtoll(argv[3].c_str(), &end, 10);
+            if (errno == ERANGE || *end != '\0') {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
+                return RespBuilder::Array({});
+            }
+
+            std::string data = existing.value();
+            if (data.substr(0, 5) != "list:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            // 解析list数据
+            std::vector<std::string> elements;
+            size_t pos = 5;// 跳过"list:"前缀
+            while (pos < data.length()) {
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
+
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
+
+                if (pos + len > data.length()) break;
+                std::string value = data.substr(pos, len);
+                pos += len;
+
+                elements.push_back(value);
+            }
+
+            // 处理负数索引
+            size_t list_size = elements.size();
+            size_t start_idx = (start >= 0) ? start : (list_size + start);
+            size_t stop_idx = (stop >= 0) ? stop : (list_size + stop);
+
+            // 确保索引在有效范围内
+            start_idx = std::max(start_idx, static_cast<size_t>(0));
+            stop_idx = std::min(stop_idx, static_cast<size_t>(list_size - 1));
+
+            // 如果范围无效，返回空数组
+            if (start_idx > stop_idx || start_idx >= list_size) {
+                return RespBuilder::Array({});
+            }
+
+            // 构建结果数组
+            std::vector<std::string> result;
+            for (size_t i = start_idx; i <= stop_idx && i < list_size; ++i) {
+                result.push_back(RespBuilder::BulkString(elements[i]));
+            }
+
+            return RespBuilder::Array(result);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class LIndexCommand : public ICommand {
+    public:
+        explicit LIndexCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'lindex' command");
+            }
+
+            std::string key = argv[1];
+
+            // 解析索引
+            char *end;
+            errno = 0;
+            long long index = std::strtoll(argv[2].c_str(), &end, 10);
+            if (errno == ERANGE || *end != '\0') {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
+            }
+
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
+                return RespBuilder::Nil();
+            }
+
+            std::string data = existing.value();
+            if (data.substr(0, 5) != "list:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            // 解析list数据
+            std::vector<std::string> elements;
+            size_t pos = 5;// 跳过"list:"前缀
+            while (pos < data.length()) {
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
+
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
+
+                if (pos + len > data.length()) break;
+                std::string value = data.substr(pos, len);
+                pos += len;
+
+                elements.push_back(value);
+            }
+
+            // 处理负数索引
+            size_t list_size = elements.size();
+            size_t actual_index;
+            if (index >= 0) {
+                actual_index = index;
+            } else {
+                actual_index = list_size + index;
+            }
+
+            // 检查索引是否在有效范围内
+            if (actual_index >= list_size) {
+                return RespBuilder::Nil();
+            }
+
+            return RespBuilder::BulkString(elements[actual_index]);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // Set相关命令实现
+    class SAddCommand : public ICommand {
+    public:
+        explicit SAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sadd' command");
+            }
+
+            std::string key = argv[1];
+            std::vector<std::string> members(argv.begin() + 2, argv.end());
+
+            AstraSet set;
+            auto existing = cache_->Get(key);
+            if (existing.has_value()) {
+                std::string data = existing.value();
+                if (data.substr(0, 4) == "set:") {
+                    // 解析现有set数据
+                    size_t pos = 4;// 跳过"set:"前缀
+                    while (pos < data.length()) {
+                        size_t len_end = data.find(':', pos);
+                        if (len_end == std::string::npos) break;
+
+                        size_t len = std::stoull(data.substr(pos, len_end - pos));
+                        pos = len_end + 1;
+
+                        if (pos + len > data.length()) break;
+                        std::string member = data.substr(pos, len);
+                        pos += len;
+
+                        set.SAdd({member});
+                    }
+                }
+            }
+
+            int added = set.SAdd(members);
+
+            // 序列化set对象并存储到缓存
+            std::ostringstream serialized;
+            serialized << "set:";
+            auto all_members = set.SMembers();
+            for (const auto &member: all_members) {
+                serialized << member.length() << ":" << member;
+            }
+            cache_->Put(key, serialized.str());
+
+            return RespBuilder::Integer(added);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class SRemCommand : public ICommand {
+    public:
+        explicit SRemCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'srem' command");
+            }
+
+            std::string key = argv[1];
+            std::vector<std::string> members(argv.begin() + 2, argv.end());
+
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
+                return RespBuilder::Integer(0);
+            }
+
+            std::string data = existing.value();
+            if (data.substr(0, 4) != "set:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            AstraSet set;
+            size_t pos = 4;// 跳过"set:"前缀
+            while (pos < data.length()) {
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
+
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
+
+                if (pos + len > data.length()) break;
+                std::string member = data.substr(pos, len);
+                pos += len;
+
+                set.SAdd({member});
+            }
+
+            int removed = 0;
+            for (const auto &member: members) {
+                if (set.SRem({member})) {
+                    removed++;
+                }
+            }
+
+            // 如果集合为空，删除键
+            if (set.SCard() == 0) {
+                cache_->Remove(key);
+                return RespBuilder::Integer(removed);
+            }
+
+            // 序列化set对象并存储到缓存
+            std::ostringstream serialized;
+            serialized << "set:";
+            auto all_members = set.SMembers();
+            for (const auto &member: all_members) {
+                serialized << member.length() << ":" << member;
+            }
+            cache_->Put(key, serialized.str());
 
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
+            return RespBuilder::Integer(removed);
+        }
 
-                if (pos + field_len > data.length()) break;
-                std::string field_name = data.substr(pos, field_len);
-                pos += field_len;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
+    class SCardCommand : public ICommand {
+    public:
+        explicit SCardCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'scard' command");
+            }
 
-                if (pos + value_len > data.length()) break;
-                std::string field_value = data.substr(pos, value_len);
-                pos += value_len;
+            std::string key = argv[1];
 
-                hash.HSet(field_name, field_value);
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
+                return RespBuilder::Integer(0);
             }
 
-            int deleted = 0;
-            for (size_t i = 2; i < argv.size(); i++) {
-                if (hash.HDelete(argv[i])) {
-                    deleted++;
-                }
+            std::string data = existing.value();
+            if (data.substr(0, 4) != "set:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
 
-            if (hash.HLen() == 0) {
-                cache_->Remove(key);
-            } else {
-                std::ostringstream serialized;
-                serialized << "hash:";
-                auto all_fields = hash.HGetAll();
-                for (const auto &pair: all_fields) {
-                    const std::string &field = pair.first;
-                    const std::string &value = pair.second;
-                    serialized << field.length() << ":" << field << value.length() << ":" << value;
-                }
-                cache_->Put(key, serialized.str());
+            AstraSet set;
+            size_t pos = 4;// 跳过"set:"前缀
+            while (pos < data.length()) {
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
+
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
+
+                if (pos + len > data.length()) break;
+                std::string member = data.substr(pos, len);
+                pos += len;
+
+                set.SAdd({member});
             }
 
-            return RespBuilder::Integer(deleted);
+            return RespBuilder::Integer(set.SCard());
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class HLenCommand : public ICommand {
+    class SMembersCommand : public ICommand {
     public:
-        explicit HLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit SMembersCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hlen'");
+                return RespBuilder::Error("ERR wrong number of arguments for 'smembers' command");
             }
 
             std::string key = argv[1];
 
-            auto value = cache_->Get(key);
-            if (!value.has_value() || value->substr(0, 5) != "hash:") {
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
+                return RespBuilder::Set({});
+            }
+
+            std::string data = existing.value();
+            if (data.substr(0, 4) != "set:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            std::vector<std::string> members;
+            size_t pos = 4;// 跳过"set:"前缀
+            while (pos < data.length()) {
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
+
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
+
+                if (pos + len > data.length()) break;
+                std::string member = data.substr(pos, len);
+                pos += len;
+                members.push_back(member);
+            }
+
+            std::vector<std::string> result;
+            for (const auto &member: members) {
+                result.push_back(RespBuilder::BulkString(member));
+            }
+
+            return RespBuilder::Set(result);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    class SIsMemberCommand : public ICommand {
+    public:
+        explicit SIsMemberCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sismember' command");
+            }
+
+            std::string key = argv[1];
+            std::string member = argv[2];
+
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
                 return RespBuilder::Integer(0);
             }
 
-            std::string data = value.value();
-            AstraHash hash;
-            size_t pos = 5;// 跳过"hash:"前缀
+            std::string data = existing.value();
+            if (data.substr(0, 4) != "set:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            AstraSet set;
+            size_t pos = 4;// 跳过"set:"前缀
             while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
 
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
 
-                if (pos + field_len > data.length()) break;
-                std::string field_name = data.substr(pos, field_len);
-                pos += field_len;
+                if (pos + len > data.length()) break;
+                std::string set_member = data.substr(pos, len);
+                pos += len;
 
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
+                set.SAdd({set_member});
+            }
 
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+            return RespBuilder::Integer(set.SIsMember(member) ? 1 : 0);
+        }
 
-                if (pos + value_len > data.length()) break;
-                std::string field_value = data.substr(pos, value_len);
-                pos += value_len;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                hash.HSet(field_name, field_value);
+    class SPopCommand : public ICommand {
+    public:
+        explicit SPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'spop' command");
+            }
+
+            std::string key = argv[1];
+
+            auto existing = cache_->Get(key);
+            if (!existing.has_value()) {
+                return RespBuilder::Nil();
+            }
+
+            std::string data = existing.value();
+            if (data.substr(0, 4) != "set:") {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+
+            AstraSet set;
+            size_t pos = 4;// 跳过"set:"前缀
+            std::vector<std::string> members_vector;
+            while (pos < data.length()) {
+                size_t len_end = data.find(':', pos);
+                if (len_end == std::string::npos) break;
+
+                size_t len = std::stoull(data.substr(pos, len_end - pos));
+                pos = len_end + 1;
+
+                if (pos + len > data.length()) break;
+                std::string member = data.substr(pos, len);
+                pos += len;
+
+                set.SAdd({member});
+                members_vector.push_back(member);
+            }
+
+            if (members_vector.empty()) {
+                cache_->Remove(key);
+                return RespBuilder::Nil();
+            }
+
+            // 随机选择一个元素
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::uniform_int_distribution<> dis(0, members_vector.size() - 1);
+            std::string popped_member = members_vector[dis(gen)];
+
+            // 从集合中移除该元素
+            set.SRem({popped_member});
+
+            // 如果集合为空，删除键
+            if (set.SCard() == 0) {
+                cache_->Remove(key);
+            } else {
+                // 序列化set对象并存储到缓存
+                std::ostringstream serialized;
+                serialized << "set:";
+                auto all_members = set.SMembers();
+                for (const auto &member: all_members) {
+                    serialized << member.length() << ":" << member;
+                }
+                cache_->Put(key, serialized.str());
+            }
+
+            return RespBuilder::BulkString(popped_member);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // 集合代数命令的公共部分：一次 BatchGet 读取所有键，并零拷贝解码为有序成员视图
+    struct SetOperands {
+        std::vector<std::optional<std::string>> payloads;// 持有缓存值，members 中的视图指向这里
+        std::vector<std::vector<std::string_view>> members;
+        bool wrong_type = false;
+
+        std::vector<set_algebra::Range<std::string_view>> Ranges() const {
+            std::vector<set_algebra::Range<std::string_view>> ranges;
+            ranges.reserve(members.size());
+            for (const auto &m: members) {
+                ranges.emplace_back(m);
+            }
+            return ranges;
+        }
+    };
+
+    inline SetOperands LoadSetOperands(AstraCache<LRUCache, std::string, std::string> &cache,
+                                       const std::vector<std::string> &argv, size_t first) {
+        SetOperands operands;
+        std::vector<std::string> keys(argv.begin() + first, argv.end());
+        operands.payloads = cache.BatchGet(keys);
+        operands.members.reserve(operands.payloads.size());
+        for (const auto &payload: operands.payloads) {
+            if (!payload.has_value()) {
+                operands.members.emplace_back();// 不存在的键视为空集
+                continue;
+            }
+            if (payload->compare(0, 4, "set:") != 0) {
+                operands.wrong_type = true;
+                break;
+            }
+            operands.members.push_back(AstraSet::ParseMembers(*payload));
+        }
+        return operands;
+    }
+
+    inline std::string SetMembersReply(const std::vector<std::string_view> &members) {
+        std::vector<std::string> result;
+        result.reserve(members.size());
+        for (const auto &member: members) {
+            result.push_back(RespBuilder::BulkString(std::string(member)));
+        }
+        return RespBuilder::Set(result);
+    }
+
+    // *STORE 系列：结果为空时删除目标键，返回结果集大小
+    inline std::string StoreSetResult(AstraCache<LRUCache, std::string, std::string> &cache,
+                                      const std::string &dest, const std::vector<std::string_view> &members) {
+        if (members.empty()) {
+            cache.Remove(dest);
+        } else {
+            cache.Put(dest, AstraSet::SerializeMembers(members));
+        }
+        return RespBuilder::Integer(static_cast<int64_t>(members.size()));
+    }
+
+    // SINTER key [key ...]
+    class SInterCommand : public ICommand {
+    public:
+        explicit SInterCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sinter' command");
             }
 
-            return RespBuilder::Integer(hash.HLen());
+            auto operands = LoadSetOperands(*cache_, argv, 1);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            return SetMembersReply(set_algebra::IntersectParallel(operands.Ranges()));
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class HExistsCommand : public ICommand {
+    // SUNION key [key ...]
+    class SUnionCommand : public ICommand {
     public:
-        explicit HExistsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit SUnionCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hexists'");
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sunion' command");
             }
 
-            std::string key = argv[1];
-            std::string field = argv[2];
-
-            auto value = cache_->Get(key);
-            if (!value.has_value() || value->substr(0, 5) != "hash:") {
-                return RespBuilder::Integer(0);
+            auto operands = LoadSetOperands(*cache_, argv, 1);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            return SetMembersReply(set_algebra::UnionParallel(operands.Ranges()));
+        }
 
-            std::string data = value.value();
-            AstraHash hash;
-            size_t pos = 5;// 跳过"hash:"前缀
-            while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
-
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
-
-                if (pos + field_len > data.length()) break;
-                std::string field_name = data.substr(pos, field_len);
-                pos += field_len;
-
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
-
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                if (pos + value_len > data.length()) break;
-                std::string field_value = data.substr(pos, value_len);
-                pos += value_len;
+    // SDIFF key [key ...]
+    class SDiffCommand : public ICommand {
+    public:
+        explicit SDiffCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                hash.HSet(field_name, field_value);
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sdiff' command");
             }
 
-            return RespBuilder::Integer(hash.HExists(field) ? 1 : 0);
+            auto operands = LoadSetOperands(*cache_, argv, 1);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            return SetMembersReply(set_algebra::DiffParallel(operands.Ranges()));
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class HKeysCommand : public ICommand {
+    // SINTERSTORE destination key [key ...]
+    class SInterStoreCommand : public ICommand {
     public:
-        explicit HKeysCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit SInterStoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hkeys'");
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sinterstore' command");
             }
 
-            std::string key = argv[1];
-
-            auto value = cache_->Get(key);
-            if (!value.has_value() || value->substr(0, 5) != "hash:") {
-                return RespBuilder::Array({});
+            auto operands = LoadSetOperands(*cache_, argv, 2);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            return StoreSetResult(*cache_, argv[1], set_algebra::IntersectParallel(operands.Ranges()));
+        }
 
-            std::string data = value.value();
-            AstraHash hash;
-            size_t pos = 5;// 跳过"hash:"前缀
-            while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
+    // SUNIONSTORE destination key [key ...]
+    class SUnionStoreCommand : public ICommand {
+    public:
+        explicit SUnionStoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                if (pos + field_len > data.length()) break;
-                std::string field_name = data.substr(pos, field_len);
-                pos += field_len;
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sunionstore' command");
+            }
 
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
+            auto operands = LoadSetOperands(*cache_, argv, 2);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            return StoreSetResult(*cache_, argv[1], set_algebra::UnionParallel(operands.Ranges()));
+        }
 
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                if (pos + value_len > data.length()) break;
-                std::string field_value = data.substr(pos, value_len);
-                pos += value_len;
+    // SDIFFSTORE destination key [key ...]
+    class SDiffStoreCommand : public ICommand {
+    public:
+        explicit SDiffStoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                hash.HSet(field_name, field_value);
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sdiffstore' command");
             }
 
-            std::vector<std::string> result;
-            auto all_fields = hash.HGetAll();
-            for (const auto &pair: all_fields) {
-                result.push_back(RespBuilder::BulkString(pair.first));
+            auto operands = LoadSetOperands(*cache_, argv, 2);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-
-            return RespBuilder::Array(result);
+            return StoreSetResult(*cache_, argv[1], set_algebra::DiffParallel(operands.Ranges()));
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class HValsCommand : public ICommand {
+    // SINTERCARD numkeys key [key ...] [LIMIT limit]
+    class SInterCardCommand : public ICommand {
     public:
-        explicit HValsCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit SInterCardCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'hvals'");
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'sintercard' command");
             }
 
-            std::string key = argv[1];
-
-            auto value = cache_->Get(key);
-            if (!value.has_value() || value->substr(0, 5) != "hash:") {
-                return RespBuilder::Array({});
+            char *end;
+            errno = 0;
+            long long numkeys = std::strtoll(argv[1].c_str(), &end, 10);
+            if (errno == ERANGE || *end != '\0' || numkeys <= 0) {
+                return RespBuilder::Error("ERR numkeys should be greater than 0");
+            }
+            if (static_cast<size_t>(numkeys) > argv.size() - 2) {
+                return RespBuilder::Error("ERR Number of keys can't be greater than number of args");
             }
 
-            std::string data = value.value();
-            AstraHash hash;
-            size_t pos = 5;// 跳过"hash:"前缀
-            while (pos < data.length()) {
-                // 解析字段名长度
-                size_t field_len_end = data.find(':', pos);
-                if (field_len_end == std::string::npos) break;
-
-                size_t field_len = std::stoull(data.substr(pos, field_len_end - pos));
-                pos = field_len_end + 1;
+            size_t keys_end = 2 + static_cast<size_t>(numkeys);
+            long long limit = 0;
+            if (keys_end < argv.size()) {
+                if (keys_end + 2 != argv.size() || !ICaseCmp(argv[keys_end], "LIMIT")) {
+                    return RespBuilder::Error("ERR syntax error");
+                }
+                errno = 0;
+                limit = std::strtoll(argv[keys_end + 1].c_str(), &end, 10);
+                if (errno == ERANGE || *end != '\0' || limit < 0) {
+                    return RespBuilder::Error("ERR LIMIT can't be negative");
+                }
+            }
 
-                if (pos + field_len > data.length()) break;
-                std::string field_name = data.substr(pos, field_len);
-                pos += field_len;
+            std::vector<std::string> key_args(argv.begin(), argv.begin() + keys_end);
+            auto operands = LoadSetOperands(*cache_, key_args, 2);
+            if (operands.wrong_type) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            auto result = set_algebra::IntersectParallel(operands.Ranges(), static_cast<size_t>(limit));
+            return RespBuilder::Integer(static_cast<int64_t>(result.size()));
+        }
 
-                // 解析值长度
-                size_t value_len_end = data.find(':', pos);
-                if (value_len_end == std::string::npos) break;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                size_t value_len = std::stoull(data.substr(pos, value_len_end - pos));
-                pos = value_len_end + 1;
+    // 增量遍历命令（HSCAN/SSCAN），游标的编码与重新定位见 scan_cursor.hpp
 
-                if (pos + value_len > data.length()) break;
-                std::string field_value = data.substr(pos, value_len);
-                pos += value_len;
+    struct ScanArgs {
+        uint64_t cursor = 0;
+        size_t count = 10;
+        std::optional<std::string> pattern;
+        bool no_values = false;// 仅 HSCAN
+    };
 
-                hash.HSet(field_name, field_value);
-            }
+    inline std::optional<std::string> ParseScanArgs(const std::vector<std::string> &argv, bool allow_no_values, ScanArgs &args) {
+        const std::string &cursor = argv[2];
+        auto [ptr, ec] = std::from_chars(cursor.data(), cursor.data() + cursor.size(), args.cursor);
+        if (cursor.empty() || ec != std::errc() || ptr != cursor.data() + cursor.size()) {
+            return RespBuilder::Error("ERR invalid cursor");
+        }
 
-            std::vector<std::string> result;
-            auto all_fields = hash.HGetAll();
-            for (const auto &pair: all_fields) {
-                result.push_back(RespBuilder::BulkString(pair.second));
+        for (size_t i = 3; i < argv.size(); ++i) {
+            if (ICaseCmp(argv[i], "MATCH") && i + 1 < argv.size()) {
+                args.pattern = argv[++i];
+                if (*args.pattern == "*") args.pattern.reset();// 匹配一切，省掉逐个匹配
+            } else if (ICaseCmp(argv[i], "COUNT") && i + 1 < argv.size()) {
+                int64_t count;
+                if (!ParseInt64(argv[++i], count)) {
+                    return RespBuilder::Error("ERR value is not an integer or out of range");
+                }
+                if (count < 1) return RespBuilder::Error("ERR syntax error");
+                args.count = static_cast<size_t>(count);
+            } else if (allow_no_values && ICaseCmp(argv[i], "NOVALUES")) {
+                args.no_values = true;
+            } else {
+                return RespBuilder::Error("ERR syntax error");
             }
-
-            return RespBuilder::Array(result);
         }
+        return std::nullopt;
+    }
 
-    private:
-        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
-    };
+    inline std::string ScanReply(uint64_t cursor, const std::vector<std::string> &items) {
+        return RespBuilder::Array({RespBuilder::BulkString(std::to_string(cursor)), RespBuilder::Array(items)});
+    }
 
-    // List相关命令实现
-    class LPushCommand : public ICommand {
+    // SSCAN key cursor [MATCH pattern] [COUNT count]
+    class SScanCommand : public ICommand {
     public:
-        explicit LPushCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit SScanCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'lpush' command");
+                return RespBuilder::Error("ERR wrong number of arguments for 'sscan' command");
             }
 
-            std::string key = argv[1];
-            std::vector<std::string> values(argv.begin() + 2, argv.end());
-
-            // 从缓存中获取现有list数据（如果存在）
-            AstraList list;
-            auto existing = cache_->Get(key);
-            if (existing.has_value()) {
-                std::string data = existing.value();
-                if (data.substr(0, 5) == "list:") {
-                    // 解析现有list数据
-                    size_t pos = 5;// 跳过"list:"前缀
-                    while (pos < data.length()) {
-                        size_t len_end = data.find(':', pos);
-                        if (len_end == std::string::npos) break;
-
-                        size_t len = std::stoull(data.substr(pos, len_end - pos));
-                        pos = len_end + 1;
-
-                        if (pos + len > data.length()) break;
-                        std::string value = data.substr(pos, len);
-                        pos += len;
+            ScanArgs args;
+            if (auto error = ParseScanArgs(argv, false, args)) return *error;
 
-                        // 为了简化，我们重新构建list（实际应该在前面插入）
-                        // 这里仅作演示，实际实现需要更复杂的逻辑
-                    }
+            return cache_->Visit(argv[1], [&](const std::string *value) {
+                if (!value) return ScanReply(0, {});
+                if (value->compare(0, 4, "set:") != 0) {
+                    return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
                 }
-            }
-
-            // 对于LPUSH，我们需要在现有元素前插入新元素
-            size_t new_length = list.LPush(values);
-
-            // 序列化list对象并存储到缓存
-            std::ostringstream serialized;
-            serialized << "list:";
-            // 注意：这里简化实现，实际需要正确处理所有元素
-            for (const auto &value: values) {
-                serialized << value.length() << ":" << value;
-            }
-            cache_->Put(key, serialized.str());
 
-            return RespBuilder::Integer(new_length);
+                std::vector<std::string> items;
+                uint64_t next = ScanEncoded<1>(*value, 4, args.cursor, args.count, [&](const auto &record) {
+                    if (!args.pattern || utils::GlobMatch(*args.pattern, record[0])) {
+                        items.push_back(RespBuilder::BulkString(record[0]));
+                    }
+                });
+                return ScanReply(next, items);
+            });
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class RPushCommand : public ICommand {
+    // HSCAN key cursor [MATCH pattern] [COUNT count] [NOVALUES]
+    class HScanCommand : public ICommand {
     public:
-        explicit RPushCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit HScanCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'rpush' command");
-            }
-
-            std::string key = argv[1];
-            std::vector<std::string> values(argv.begin() + 2, argv.end());
-
-            // 从缓存中获取现有list数据（如果存在）
-            AstraList list;
-            auto existing = cache_->Get(key);
-            if (existing.has_value()) {
-                std::string data = existing.value();
-                if (data.substr(0, 5) == "list:") {
-                    // 解析现有list数据
-                    // 简化实现，实际需要正确解析所有元素
-                }
+                return RespBuilder::Error("ERR wrong number of arguments for 'hscan' command");
             }
 
-            size_t new_length = list.RPush(values);
+            ScanArgs args;
+            if (auto error = ParseScanArgs(argv, true, args)) return *error;
 
-            // 序列化list对象并存储到缓存
-            std::ostringstream serialized;
-            serialized << "list:";
-            // 注意：这里简化实现，实际需要正确处理所有元素
-            for (const auto &value: values) {
-                serialized << value.length() << ":" << value;
-            }
-            cache_->Put(key, serialized.str());
+            return VisitHash(*cache_, argv[1], [&](const std::string *encoded) {
+                if (!encoded) return ScanReply(0, {});
 
-            return RespBuilder::Integer(new_length);
+                std::vector<std::string> items;
+                uint64_t next = ScanEncoded<2>(*encoded, AstraHash::kPrefix.size(), args.cursor, args.count,
+                                               [&](const auto &record) {
+                                                   if (args.pattern && !utils::GlobMatch(*args.pattern, record[0])) return;
+                                                   items.push_back(RespBuilder::BulkString(record[0]));
+                                                   if (!args.no_values) items.push_back(RespBuilder::BulkString(record[1]));
+                                               });
+                return ScanReply(next, items);
+            });
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class LPopCommand : public ICommand {
+    // 句柄类值（流、有序集合、JSON 文档）的公共加载逻辑
+    // 本体常驻在各自的注册表中，缓存里只放 "<前缀>@<id>" 句柄；保存快照时句柄换成 "<前缀><编码>"，
+    // 重启后第一次访问时解码、登记并在原位换回句柄（保留 TTL）。只有前缀的旧句柄和对不上注册表的句柄
+    // 说明本体已不存在，按键不存在处理并删除该键。本体的释放由缓存删除回调 ReleaseResidentValue 负责
+
+    enum class ResidentLoadResult {
+        Ok,
+        Missing,
+        WrongType
+    };
+
+    template<typename T, typename Manager, typename Decode>
+    inline ResidentLoadResult LoadResident(AstraCache<LRUCache, std::string, std::string> &cache, const std::string &key,
+                                           Manager &manager, std::string_view prefix, Decode &&decode,
+                                           std::shared_ptr<T> &object) {
+        enum class Found { Missing, WrongType, Stale, Handle, Encoded };
+        return cache.Atomically(key, [&](auto &strategy) {
+            std::optional<T> decoded;
+            Found found = strategy.Visit(key, [&](const std::string *value) {
+                if (!value) return Found::Missing;
+                if (!value->starts_with(prefix)) return Found::WrongType;
+                if (manager.IsHandle(*value)) {
+                    object = manager.Find(key, *value);
+                    return object ? Found::Handle : Found::Stale;
+                }
+                if (value->size() == prefix.size()) return Found::Stale;
+                decoded = decode(std::string_view(*value));
+                return decoded ? Found::Encoded : Found::WrongType;
+            });
+
+            switch (found) {
+                case Found::Handle:
+                    return ResidentLoadResult::Ok;
+                case Found::Encoded:
+                    object = std::make_shared<T>(std::move(*decoded));
+                    strategy.Update(key, [&](std::string &value, bool) {
+                        value = manager.Register(key, object);
+                        return true;
+                    });
+                    return ResidentLoadResult::Ok;
+                case Found::Stale:
+                    strategy.Remove(key);
+                    return ResidentLoadResult::Missing;
+                case Found::WrongType:
+                    return ResidentLoadResult::WrongType;
+                default:
+                    return ResidentLoadResult::Missing;
+            }
+        });
+    }
+
+    // 新建对象（默认为空）并写入句柄；调用方已确认该键不存在
+    template<typename T, typename Manager>
+    inline std::shared_ptr<T> CreateResident(AstraCache<LRUCache, std::string, std::string> &cache,
+                                             const std::string &key, Manager &manager, T initial = T()) {
+        auto object = std::make_shared<T>(std::move(initial));
+        cache.Put(key, manager.Register(key, object));
+        return object;
+    }
+
+    // ZSet相关命令实现
+    // 成员由 ZSetManager 持有，缓存中只保存句柄（见 LoadResident）；与流相同，读写都持有 BlockingManager 中该键的分片锁
+
+    using ZSetLoadResult = ResidentLoadResult;
+
+    inline ZSetLoadResult LoadZSet(AstraCache<LRUCache, std::string, std::string> &cache,
+                                   const std::string &key, std::shared_ptr<AstraZSet> &zset) {
+        return LoadResident(cache, key, *apps::ZSetManager::GetInstance(), AstraZSet::kPrefix,
+                            &AstraZSet::Deserialize, zset);
+    }
+
+    inline std::shared_ptr<AstraZSet> CreateZSet(AstraCache<LRUCache, std::string, std::string> &cache,
+                                                 const std::string &key) {
+        return CreateResident<AstraZSet>(cache, key, *apps::ZSetManager::GetInstance());
+    }
+
+    // 最后一个成员被移除后删除句柄，本体由删除回调释放
+    inline void DropZSetIfEmpty(AstraCache<LRUCache, std::string, std::string> &cache,
+                                const std::string &key, const AstraZSet &zset) {
+        if (zset.ZCard() == 0) {
+            cache.Remove(key);
+        }
+    }
+
+    class ZAddCommand : public ICommand {
     public:
-        explicit LPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit ZAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'lpop' command");
+            if (argv.size() < 4 || argv.size() % 2 != 0) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'zadd' command");
             }
 
             std::string key = argv[1];
+            std::map<std::string, double> members;
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Nil();
+            try {
+                for (size_t i = 2; i < argv.size(); i += 2) {
+                    double score = std::stod(argv[i]);
+                    std::string member = argv[i + 1];
+                    members[member] = score;
+                }
+            } catch (const std::exception &) {
+                return RespBuilder::Error("ERR value is not a valid float");
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "list:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, key, zset);
+            if (loaded == ZSetLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-
-            AstraList list;
-            // 解析list数据
-            // 简化实现
-
-            std::string value = list.LPop();
-            if (value.empty()) {
-                // List为空，删除键
-                cache_->Remove(key);
-                return RespBuilder::Nil();
+            if (loaded == ZSetLoadResult::Missing) {
+                zset = CreateZSet(*cache_, key);
             }
 
-            // 重新序列化并保存更新后的list
-            // 简化实现
-
-            return RespBuilder::BulkString(value);
+            int added = zset->ZAdd(members);
+            return RespBuilder::Integer(added);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class RPopCommand : public ICommand {
+    class ZRemCommand : public ICommand {
     public:
-        explicit RPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit ZRemCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'rpop' command");
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'zrem' command");
             }
 
             std::string key = argv[1];
+            std::vector<std::string> members(argv.begin() + 2, argv.end());
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Nil();
-            }
-
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "list:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, key, zset);
+            if (loaded == ZSetLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-
-            AstraList list;
-            // 解析list数据
-            // 简化实现
-
-            std::string value = list.RPop();
-            if (value.empty()) {
-                // List为空，删除键
-                cache_->Remove(key);
-                return RespBuilder::Nil();
+            if (loaded == ZSetLoadResult::Missing) {
+                return RespBuilder::Integer(0);
             }
 
-            // 重新序列化并保存更新后的list
-            // 简化实现
+            int removed = zset->ZRem(members);
 
-            return RespBuilder::BulkString(value);
+            // 如果有序集合为空，删除键
+            DropZSetIfEmpty(*cache_, key, *zset);
+            return RespBuilder::Integer(removed);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class LLenCommand : public ICommand {
+    class ZCardCommand : public ICommand {
     public:
-        explicit LLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit ZCardCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'llen' command");
-            }
-
-            std::string key = argv[1];
-
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Integer(0);
+                return RespBuilder::Error("ERR wrong number of arguments for 'zcard' command");
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "list:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, argv[1], zset);
+            if (loaded == ZSetLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-
-            AstraList list;
-            // 解析list数据
-            // 简化实现
-
-            size_t length = list.LLen();
-            return RespBuilder::Integer(length);
+            return RespBuilder::Integer(zset ? static_cast<int64_t>(zset->ZCard()) : 0);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class LRangeCommand : public ICommand {
+    class ZRangeCommand : public ICommand {
     public:
-        explicit LRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit ZRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 4) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'lrange' command");
+            if (argv.size() < 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'zrange' command");
             }
 
             std::string key = argv[1];
@@ -1793,51 +4993,83 @@ namespace Astra::proto {
                 return RespBuilder::Error("ERR value is not an integer or out of range");
             }
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, key, zset);
+            if (loaded == ZSetLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ZSetLoadResult::Missing) {
                 return RespBuilder::Array({});
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "list:") {
-                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            // 获取范围内的成员
+            auto members = zset->ZRange(start, stop);
+
+            std::vector<std::string> result;
+            for (const auto &member: members) {
+                result.push_back(RespBuilder::BulkString(member));
             }
 
-            // 解析list数据
-            std::vector<std::string> elements;
-            size_t pos = 5;// 跳过"list:"前缀
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
+            return RespBuilder::Array(result);
+        }
 
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                if (pos + len > data.length()) break;
-                std::string value = data.substr(pos, len);
-                pos += len;
+    class ZRangeByScoreCommand : public ICommand {
+    public:
+        explicit ZRangeByScoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                elements.push_back(value);
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'zrangebyscore' command");
             }
 
-            // 处理负数索引
-            size_t list_size = elements.size();
-            size_t start_idx = (start >= 0) ? start : (list_size + start);
-            size_t stop_idx = (stop >= 0) ? stop : (list_size + stop);
+            std::string key = argv[1];
+            std::string min_str = argv[2];
+            std::string max_str = argv[3];
 
-            // 确保索引在有效范围内
-            start_idx = std::max(start_idx, static_cast<size_t>(0));
-            stop_idx = std::min(stop_idx, static_cast<size_t>(list_size - 1));
+            // 解析最小和最大分数
+            double min, max;
+            if (min_str == "-inf") {
+                min = -std::numeric_limits<double>::infinity();
+            } else {
+                try {
+                    min = std::stod(min_str);
+                } catch (const std::exception &) {
+                    return RespBuilder::Error("ERR min or max is not a float");
+                }
+            }
 
-            // 如果范围无效，返回空数组
-            if (start_idx > stop_idx || start_idx >= list_size) {
+            if (max_str == "+inf") {
+                max = std::numeric_limits<double>::infinity();
+            } else {
+                try {
+                    max = std::stod(max_str);
+                } catch (const std::exception &) {
+                    return RespBuilder::Error("ERR min or max is not a float");
+                }
+            }
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, key, zset);
+            if (loaded == ZSetLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ZSetLoadResult::Missing) {
                 return RespBuilder::Array({});
             }
 
-            // 构建结果数组
+            // 获取范围内的成员
+            auto members = zset->ZRangeByScore(min, max);
+
             std::vector<std::string> result;
-            for (size_t i = start_idx; i <= stop_idx && i < list_size; ++i) {
-                result.push_back(RespBuilder::BulkString(elements[i]));
+            for (const auto &member: members) {
+                result.push_back(RespBuilder::BulkString(member));
             }
 
             return RespBuilder::Array(result);
@@ -1847,712 +5079,1618 @@ namespace Astra::proto {
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class LIndexCommand : public ICommand {
+    // 按 Redis 的方式格式化分数：整数不带小数点，其余去掉尾随的 0
+    inline std::string FormatZSetScore(double score) {
+        if (std::isinf(score)) {
+            return score > 0 ? "inf" : "-inf";
+        }
+        std::ostringstream oss;
+        if (score == (long long) score) {
+            // 整数
+            oss << (long long) score;
+            return oss.str();
+        }
+        // 浮点数
+        oss << std::fixed << std::setprecision(15) << score;
+        // 移除尾随的0
+        std::string str = oss.str();
+        str.erase(str.find_last_not_of('0') + 1, std::string::npos);
+        str.erase(str.find_last_not_of('.') + 1, std::string::npos);
+        return str;
+    }
+
+    class ZScoreCommand : public ICommand {
     public:
-        explicit LIndexCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit ZScoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() != 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'lindex' command");
+                return RespBuilder::Error("ERR wrong number of arguments for 'zscore' command");
             }
 
             std::string key = argv[1];
+            std::string member = argv[2];
 
-            // 解析索引
-            char *end;
-            errno = 0;
-            long long index = std::strtoll(argv[2].c_str(), &end, 10);
-            if (errno == ERANGE || *end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
+            std::pair<bool, double> score;
+            {
+                auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+                std::shared_ptr<AstraZSet> zset;
+                auto loaded = LoadZSet(*cache_, key, zset);
+                if (loaded == ZSetLoadResult::WrongType) {
+                    return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+                }
+                if (loaded == ZSetLoadResult::Missing) {
+                    return RespBuilder::Nil();
+                }
+                score = zset->ZScore(member);
             }
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
+            if (!score.first) {
                 return RespBuilder::Nil();
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "list:") {
+            return RespBuilder::Double(FormatZSetScore(score.second));
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // ZSCAN key cursor [MATCH pattern] [COUNT count]
+    // 游标是成员的加入序号（见 AstraZSet::Scan），每次至多返回 COUNT 个成员，增删成员不会让游标失效
+    class ZScanCommand : public ICommand {
+    public:
+        explicit ZScanCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'zscan' command");
+            }
+
+            ScanArgs args;
+            if (auto error = ParseScanArgs(argv, false, args)) return *error;
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, argv[1], zset);
+            if (loaded == ZSetLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            if (loaded == ZSetLoadResult::Missing) {
+                return ScanReply(0, {});
+            }
 
-            // 解析list数据
-            std::vector<std::string> elements;
-            size_t pos = 5;// 跳过"list:"前缀
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
+            std::vector<std::string> items;
+            uint64_t next = zset->Scan(args.cursor, args.count, [&](const std::string &member, double score) {
+                if (args.pattern && !utils::GlobMatch(*args.pattern, member)) return;
+                items.push_back(RespBuilder::BulkString(member));
+                items.push_back(RespBuilder::BulkString(FormatZSetScore(score)));
+            });
+            return ScanReply(next, items);
+        }
 
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                if (pos + len > data.length()) break;
-                std::string value = data.substr(pos, len);
-                pos += len;
+    // ---------------- GEO（基于有序集合） ----------------
+    // 成员的分数是 52 位 geohash。范围搜索先由 utils::geo::SearchRanges 求出覆盖搜索区域的少数几个分数区间，
+    // 再在有序集合上逐段扫描（每段 O(log N + M)）并按精确距离过滤，不做全量遍历。
+
+    inline bool ParseGeoUnit(const std::string &unit, double &to_meters) {
+        if (ICaseCmp(unit, "m")) {
+            to_meters = 1;
+        } else if (ICaseCmp(unit, "km")) {
+            to_meters = 1000;
+        } else if (ICaseCmp(unit, "ft")) {
+            to_meters = 0.3048;
+        } else if (ICaseCmp(unit, "mi")) {
+            to_meters = 1609.34;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    inline bool ParseGeoNumber(const std::string &text, double &value) {
+        long double parsed;
+        if (!ParseLongDouble(text, parsed) || std::isinf(parsed)) return false;
+        value = static_cast<double>(parsed);
+        return true;
+    }
+
+    inline std::string GeoInvalidPairReply(double lon, double lat) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "ERR invalid longitude,latitude pair %f,%f", lon, lat);
+        return RespBuilder::Error(buf);
+    }
+
+    inline std::string GeoDistanceReply(double meters, double to_meters) {
+        char buf[64];
+        int len = std::snprintf(buf, sizeof(buf), "%.4f", meters / to_meters);
+        return RespBuilder::BulkString(std::string_view(buf, static_cast<size_t>(len)));
+    }
+
+    inline std::string GeoCoordinateReply(double score) {
+        double lon, lat;
+        utils::geo::DecodeCenter(static_cast<uint64_t>(score), lon, lat);
+        std::string lon_text, lat_text;
+        FormatLongDouble(lon, lon_text);
+        FormatLongDouble(lat, lat_text);
+        return RespBuilder::Array({RespBuilder::BulkString(lon_text), RespBuilder::BulkString(lat_text)});
+    }
+
+    // GEOADD key [NX | XX] [CH] longitude latitude member [longitude latitude member ...]
+    class GeoAddCommand : public ICommand {
+    public:
+        explicit GeoAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-                elements.push_back(value);
+        std::string Execute(const std::vector<std::string> &argv) override {
+            bool nx = false, xx = false, ch = false;
+            size_t i = 2;
+            for (; i < argv.size(); ++i) {
+                if (ICaseCmp(argv[i], "NX")) {
+                    nx = true;
+                } else if (ICaseCmp(argv[i], "XX")) {
+                    xx = true;
+                } else if (ICaseCmp(argv[i], "CH")) {
+                    ch = true;
+                } else {
+                    break;
+                }
+            }
+            if (argv.size() < 5 || i >= argv.size() || (argv.size() - i) % 3 != 0) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'geoadd' command");
+            }
+            if (nx && xx) {
+                return RespBuilder::Error("ERR XX and NX options at the same time are not compatible");
             }
 
-            // 处理负数索引
-            size_t list_size = elements.size();
-            size_t actual_index;
-            if (index >= 0) {
-                actual_index = index;
-            } else {
-                actual_index = list_size + index;
+            std::vector<std::pair<const std::string *, double>> points;
+            points.reserve((argv.size() - i) / 3);
+            for (; i < argv.size(); i += 3) {
+                double lon, lat;
+                if (!ParseGeoNumber(argv[i], lon) || !ParseGeoNumber(argv[i + 1], lat)) {
+                    return RespBuilder::Error("ERR value is not a valid float");
+                }
+                if (!utils::geo::ValidCoordinates(lon, lat)) return GeoInvalidPairReply(lon, lat);
+                points.emplace_back(&argv[i + 2], static_cast<double>(utils::geo::Encode(lon, lat)));
             }
 
-            // 检查索引是否在有效范围内
-            if (actual_index >= list_size) {
-                return RespBuilder::Nil();
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, argv[1], zset);
+            if (loaded == ZSetLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ZSetLoadResult::Missing) {
+                if (xx) return RespBuilder::Integer(0);
+                zset = CreateZSet(*cache_, argv[1]);
             }
 
-            return RespBuilder::BulkString(elements[actual_index]);
+            int64_t added = 0, changed = 0;
+            for (const auto &[member, score]: points) {
+                auto current = zset->ZScore(*member);
+                if ((nx && current.first) || (xx && !current.first)) continue;
+                if (current.first && current.second == score) continue;
+                added += zset->ZAdd({{*member, score}});
+                ++changed;
+            }
+            return RespBuilder::Integer(ch ? changed : added);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // Set相关命令实现
-    class SAddCommand : public ICommand {
+    // GEOPOS key [member [member ...]]
+    class GeoPosCommand : public ICommand {
     public:
-        explicit SAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit GeoPosCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'sadd' command");
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'geopos' command");
             }
 
-            std::string key = argv[1];
-            std::vector<std::string> members(argv.begin() + 2, argv.end());
-
-            AstraSet set;
-            auto existing = cache_->Get(key);
-            if (existing.has_value()) {
-                std::string data = existing.value();
-                if (data.substr(0, 4) == "set:") {
-                    // 解析现有set数据
-                    size_t pos = 4;// 跳过"set:"前缀
-                    while (pos < data.length()) {
-                        size_t len_end = data.find(':', pos);
-                        if (len_end == std::string::npos) break;
-
-                        size_t len = std::stoull(data.substr(pos, len_end - pos));
-                        pos = len_end + 1;
-
-                        if (pos + len > data.length()) break;
-                        std::string member = data.substr(pos, len);
-                        pos += len;
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraZSet> zset;
+            if (LoadZSet(*cache_, argv[1], zset) == ZSetLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
 
-                        set.SAdd({member});
-                    }
-                }
+            std::vector<std::string> replies;
+            replies.reserve(argv.size() - 2);
+            for (size_t i = 2; i < argv.size(); ++i) {
+                auto score = zset ? zset->ZScore(argv[i]) : std::pair<bool, double>{false, 0.0};
+                replies.push_back(score.first ? GeoCoordinateReply(score.second) : RespBuilder::NullArray());
             }
+            return RespBuilder::Array(replies);
+        }
 
-            int added = set.SAdd(members);
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-            // 序列化set对象并存储到缓存
-            std::ostringstream serialized;
-            serialized << "set:";
-            auto all_members = set.SMembers();
-            for (const auto &member: all_members) {
-                serialized << member.length() << ":" << member;
+    // GEODIST key member1 member2 [M | KM | FT | MI]
+    class GeoDistCommand : public ICommand {
+    public:
+        explicit GeoDistCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4 && argv.size() != 5) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'geodist' command");
+            }
+            double to_meters = 1;
+            if (argv.size() == 5 && !ParseGeoUnit(argv[4], to_meters)) {
+                return RespBuilder::Error("ERR unsupported unit provided. please use M, KM, FT, MI");
             }
-            cache_->Put(key, serialized.str());
 
-            return RespBuilder::Integer(added);
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, argv[1], zset);
+            if (loaded == ZSetLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == ZSetLoadResult::Missing) return RespBuilder::Nil();
+
+            auto first = zset->ZScore(argv[2]);
+            auto second = zset->ZScore(argv[3]);
+            if (!first.first || !second.first) return RespBuilder::Nil();
+
+            double lon1, lat1, lon2, lat2;
+            utils::geo::DecodeCenter(static_cast<uint64_t>(first.second), lon1, lat1);
+            utils::geo::DecodeCenter(static_cast<uint64_t>(second.second), lon2, lat2);
+            return GeoDistanceReply(utils::geo::Distance(lon1, lat1, lon2, lat2), to_meters);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class SRemCommand : public ICommand {
+    // GEOSEARCH key <FROMMEMBER member | FROMLONLAT longitude latitude>
+    //           <BYRADIUS radius <M | KM | FT | MI> | BYBOX width height <M | KM | FT | MI>>
+    //           [ASC | DESC] [COUNT count [ANY]] [WITHCOORD] [WITHDIST] [WITHHASH]
+    class GeoSearchCommand : public ICommand {
     public:
-        explicit SRemCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit GeoSearchCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'srem' command");
+            if (argv.size() < 6) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'geosearch' command");
             }
 
-            std::string key = argv[1];
-            std::vector<std::string> members(argv.begin() + 2, argv.end());
+            const std::string *from_member = nullptr;
+            bool from_lonlat = false, by_radius = false, by_box = false;
+            bool with_coord = false, with_dist = false, with_hash = false, any = false;
+            int sort = 0;// 0 不排序，1 升序，-1 降序
+            double lon = 0, lat = 0, radius = 0, width = 0, height = 0, to_meters = 1;
+            int64_t count = 0;
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Integer(0);
+            for (size_t i = 2; i < argv.size(); ++i) {
+                const std::string &arg = argv[i];
+                size_t remaining = argv.size() - i - 1;
+                if (ICaseCmp(arg, "FROMMEMBER") && remaining >= 1 && !from_member && !from_lonlat) {
+                    from_member = &argv[++i];
+                } else if (ICaseCmp(arg, "FROMLONLAT") && remaining >= 2 && !from_member && !from_lonlat) {
+                    if (!ParseGeoNumber(argv[i + 1], lon) || !ParseGeoNumber(argv[i + 2], lat)) {
+                        return RespBuilder::Error("ERR value is not a valid float");
+                    }
+                    if (!utils::geo::ValidCoordinates(lon, lat)) return GeoInvalidPairReply(lon, lat);
+                    from_lonlat = true;
+                    i += 2;
+                } else if (ICaseCmp(arg, "BYRADIUS") && remaining >= 2 && !by_radius && !by_box) {
+                    if (!ParseGeoNumber(argv[i + 1], radius) || radius < 0) {
+                        return RespBuilder::Error("ERR radius cannot be negative");
+                    }
+                    if (!ParseGeoUnit(argv[i + 2], to_meters)) {
+                        return RespBuilder::Error("ERR unsupported unit provided. please use M, KM, FT, MI");
+                    }
+                    by_radius = true;
+                    i += 2;
+                } else if (ICaseCmp(arg, "BYBOX") && remaining >= 3 && !by_radius && !by_box) {
+                    if (!ParseGeoNumber(argv[i + 1], width) || !ParseGeoNumber(argv[i + 2], height) || width < 0 || height < 0) {
+                        return RespBuilder::Error("ERR height or width cannot be negative");
+                    }
+                    if (!ParseGeoUnit(argv[i + 3], to_meters)) {
+                        return RespBuilder::Error("ERR unsupported unit provided. please use M, KM, FT, MI");
+                    }
+                    by_box = true;
+                    i += 3;
+                } else if (ICaseCmp(arg, "ASC")) {
+                    sort = 1;
+                } else if (ICaseCmp(arg, "DESC")) {
+                    sort = -1;
+                } else if (ICaseCmp(arg, "COUNT") && remaining >= 1) {
+                    if (!ParseInt64(argv[++i], count) || count <= 0) {
+                        return RespBuilder::Error("ERR COUNT must be > 0");
+                    }
+                } else if (ICaseCmp(arg, "ANY")) {
+                    any = true;
+                } else if (ICaseCmp(arg, "WITHCOORD")) {
+                    with_coord = true;
+                } else if (ICaseCmp(arg, "WITHDIST")) {
+                    with_dist = true;
+                } else if (ICaseCmp(arg, "WITHHASH")) {
+                    with_hash = true;
+                } else {
+                    return RespBuilder::Error("ERR syntax error");
+                }
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 4) != "set:") {
+            if (!from_member && !from_lonlat) {
+                return RespBuilder::Error("ERR exactly one of FROMMEMBER or FROMLONLAT can be specified for geosearch");
+            }
+            if (!by_radius && !by_box) {
+                return RespBuilder::Error("ERR exactly one of BYRADIUS and BYBOX can be specified for geosearch");
+            }
+            if (any && count == 0) {
+                return RespBuilder::Error("ERR the ANY argument requires COUNT argument");
+            }
+            // 与 Redis 一致：只给 COUNT 而不要求 ANY 时按距离升序取最近的 count 个
+            if (count > 0 && !any && sort == 0) sort = 1;
+
+            radius *= to_meters;
+            width *= to_meters;
+            height *= to_meters;
+            if (by_radius) width = height = 2 * radius;
+
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraZSet> zset;
+            auto loaded = LoadZSet(*cache_, argv[1], zset);
+            if (loaded == ZSetLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            if (from_member) {
+                auto score = zset ? zset->ZScore(*from_member) : std::pair<bool, double>{false, 0.0};
+                if (!score.first) return RespBuilder::Error("ERR could not decode requested zset member");
+                utils::geo::DecodeCenter(static_cast<uint64_t>(score.second), lon, lat);
+            }
+            if (!zset) return RespBuilder::Array({});
+
+            struct Hit {
+                const std::string *member;
+                double distance;
+                double score;
+            };
+            std::vector<Hit> hits;
+            auto limit = static_cast<size_t>(count);
+            for (const auto &range: utils::geo::SearchRanges(lon, lat, width, height)) {
+                zset->ForEachByScore(static_cast<double>(range.min), static_cast<double>(range.max - 1),
+                                     [&](double score, const std::string &member) {
+                                         double plon, plat;
+                                         utils::geo::DecodeCenter(static_cast<uint64_t>(score), plon, plat);
+                                         double distance = utils::geo::Distance(lon, lat, plon, plat);
+                                         bool inside = by_radius ? distance <= radius
+                                                                 : utils::geo::InBox(lon, lat, width, height, plon, plat);
+                                         if (inside) hits.push_back({&member, distance, score});
+                                         return !(any && hits.size() >= limit);
+                                     });
+                if (any && hits.size() >= limit) break;
+            }
+
+            if (sort != 0) {
+                auto by_distance = [sort](const Hit &a, const Hit &b) {
+                    return sort > 0 ? a.distance < b.distance : a.distance > b.distance;
+                };
+                if (count > 0 && limit < hits.size()) {
+                    std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(limit), hits.end(), by_distance);
+                } else {
+                    std::sort(hits.begin(), hits.end(), by_distance);
+                }
+            }
+            if (count > 0 && hits.size() > limit) hits.resize(limit);
 
-            AstraSet set;
-            size_t pos = 4;// 跳过"set:"前缀
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
+            std::vector<std::string> replies;
+            replies.reserve(hits.size());
+            for (const auto &hit: hits) {
+                if (!with_coord && !with_dist && !with_hash) {
+                    replies.push_back(RespBuilder::BulkString(*hit.member));
+                    continue;
+                }
+                std::vector<std::string> item{RespBuilder::BulkString(*hit.member)};
+                if (with_dist) item.push_back(GeoDistanceReply(hit.distance, to_meters));
+                if (with_hash) item.push_back(RespBuilder::Integer(static_cast<int64_t>(hit.score)));
+                if (with_coord) item.push_back(GeoCoordinateReply(hit.score));
+                replies.push_back(RespBuilder::Array(item));
+            }
+            return RespBuilder::Array(replies);
+        }
 
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                if (pos + len > data.length()) break;
-                std::string member = data.substr(pos, len);
-                pos += len;
+    // JSON相关命令实现
+    // 解析后的文档树由 JsonManager 持有，缓存中只保存句柄（见 LoadResident）；读写都持有 BlockingManager 中该键的分片锁。
+    // 写入只替换路径所指的节点，读取只序列化所选片段。快照中的编码就是 "json:" 加文档文本。
+
+    using JsonLoadResult = ResidentLoadResult;
+
+    inline JsonLoadResult LoadJson(AstraCache<LRUCache, std::string, std::string> &cache,
+                                   const std::string &key, std::shared_ptr<JsonValue> &document) {
+        auto decode = [](std::string_view encoded) {
+            return JsonValue::Parse(encoded.substr(apps::JsonManager::kPrefix.size()));
+        };
+        return LoadResident(cache, key, *apps::JsonManager::GetInstance(), apps::JsonManager::kPrefix, decode, document);
+    }
+
+    inline std::string InvalidJsonPathReply(const std::string &path) {
+        return RespBuilder::Error("ERR invalid JSON path '" + path + "'");
+    }
+
+    inline std::string JsonTypeMismatchReply(const char *expected, const JsonValue &found) {
+        return RespBuilder::Error(std::string("ERR wrong type of path value - expected ") + expected + " but found " + found.TypeName());
+    }
+
+    // 旧式路径序列化第一个匹配（无匹配返回 false），$ 路径序列化所有匹配组成的数组
+    inline bool AppendJsonMatches(JsonValue &root, const JsonPath &path, std::string &out) {
+        std::vector<JsonValue *> matches;
+        path.Resolve(root, matches);
+        if (path.IsLegacy()) {
+            if (matches.empty()) return false;
+            matches.front()->SerializeTo(out);
+            return true;
+        }
+        out += '[';
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (i > 0) out += ',';
+            matches[i]->SerializeTo(out);
+        }
+        out += ']';
+        return true;
+    }
+
+    // 在路径最后一段所指的位置写入 value，返回写入的节点数
+    inline size_t SetJsonPath(JsonValue &root, const JsonPath &path, const JsonValue &value, bool nx, bool xx) {
+        const auto &last = path.Segments().back();
+        std::vector<JsonValue *> parents;
+        path.Resolve(root, parents, path.Segments().size() - 1);
+
+        size_t updated = 0;
+        for (JsonValue *parent: parents) {
+            switch (last.kind) {
+                case JsonPath::Segment::Kind::Key:
+                    if (!parent->IsObject()) break;
+                    if (JsonValue *child = parent->Find(last.key)) {
+                        if (nx) break;
+                        *child = value;
+                        ++updated;
+                    } else if (!xx) {
+                        parent->AsObject().push_back({last.key, value});
+                        ++updated;
+                    }
+                    break;
+                case JsonPath::Segment::Kind::Index:
+                    if (!parent->IsArray() || nx) break;
+                    if (auto index = JsonPath::NormalizeIndex(last.index, parent->AsArray().size())) {
+                        parent->AsArray()[*index] = value;
+                        ++updated;
+                    }
+                    break;
+                case JsonPath::Segment::Kind::Wildcard:
+                    if (nx) break;
+                    if (parent->IsArray()) {
+                        for (auto &element: parent->AsArray()) element = value;
+                        updated += parent->AsArray().size();
+                    } else if (parent->IsObject()) {
+                        for (auto &member: parent->AsObject()) member.value = value;
+                        updated += parent->AsObject().size();
+                    }
+                    break;
+            }
+        }
+        return updated;
+    }
 
-                set.SAdd({member});
+    // JSON.SET key path value [NX | XX]
+    class JsonSetCommand : public ICommand {
+    public:
+        explicit JsonSetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() != 4 && argv.size() != 5) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'json.set' command");
             }
 
-            int removed = 0;
-            for (const auto &member: members) {
-                if (set.SRem({member})) {
-                    removed++;
+            bool nx = false, xx = false;
+            if (argv.size() == 5) {
+                if (ICaseCmp(argv[4], "NX")) {
+                    nx = true;
+                } else if (ICaseCmp(argv[4], "XX")) {
+                    xx = true;
+                } else {
+                    return RespBuilder::Error("ERR syntax error");
                 }
             }
 
-            // 如果集合为空，删除键
-            if (set.SCard() == 0) {
-                cache_->Remove(key);
-                return RespBuilder::Integer(removed);
+            auto path = JsonPath::Parse(argv[2]);
+            if (!path) return InvalidJsonPathReply(argv[2]);
+
+            std::string error;
+            auto value = JsonValue::Parse(argv[3], &error);
+            if (!value) return RespBuilder::Error("ERR invalid JSON: " + error);
+            if (path->Segments().size() + value->Depth() > JsonValue::kMaxDepth) {
+                return RespBuilder::Error("ERR nesting too deep");
             }
 
-            // 序列化set对象并存储到缓存
-            std::ostringstream serialized;
-            serialized << "set:";
-            auto all_members = set.SMembers();
-            for (const auto &member: all_members) {
-                serialized << member.length() << ":" << member;
+            const std::string &key = argv[1];
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<JsonValue> document;
+            auto loaded = LoadJson(*cache_, key, document);
+            if (loaded == JsonLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-            cache_->Put(key, serialized.str());
 
-            return RespBuilder::Integer(removed);
+            if (path->IsRoot()) {
+                if ((nx && document) || (xx && !document)) return RespBuilder::Nil();
+                if (document) {
+                    // 原位替换整个文档，句柄与 TTL 不变
+                    *document = std::move(*value);
+                } else {
+                    CreateResident(*cache_, key, *apps::JsonManager::GetInstance(), std::move(*value));
+                }
+                return RespBuilder::SimpleString("OK");
+            }
+            if (!document) {
+                return RespBuilder::Error("ERR new objects must be created at the root");
+            }
+
+            if (SetJsonPath(*document, *path, *value, nx, xx) == 0) return RespBuilder::Nil();
+            return RespBuilder::SimpleString("OK");
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class SCardCommand : public ICommand {
+    // JSON.GET key [path [path ...]]
+    // 单个路径直接返回该片段；多个路径返回以路径为键的对象
+    class JsonGetCommand : public ICommand {
     public:
-        explicit SCardCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit JsonGetCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'scard' command");
+            if (argv.size() < 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'json.get' command");
             }
 
-            std::string key = argv[1];
-
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Integer(0);
+            std::vector<JsonPath> paths;
+            for (size_t i = 2; i < argv.size(); ++i) {
+                auto path = JsonPath::Parse(argv[i]);
+                if (!path) return InvalidJsonPathReply(argv[i]);
+                paths.push_back(std::move(*path));
             }
+            if (paths.empty()) paths.push_back(*JsonPath::Parse("."));
 
-            std::string data = existing.value();
-            if (data.substr(0, 4) != "set:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<JsonValue> document;
+            auto loaded = LoadJson(*cache_, argv[1], document);
+            if (loaded == JsonLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            if (!document) return RespBuilder::Nil();
 
-            AstraSet set;
-            size_t pos = 4;// 跳过"set:"前缀
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
-
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
-
-                if (pos + len > data.length()) break;
-                std::string member = data.substr(pos, len);
-                pos += len;
-
-                set.SAdd({member});
+            std::string out;
+            if (paths.size() == 1) {
+                if (!AppendJsonMatches(*document, paths.front(), out)) return RespBuilder::Nil();
+                return RespBuilder::BulkString(out);
             }
 
-            return RespBuilder::Integer(set.SCard());
+            out += '{';
+            for (size_t i = 0; i < paths.size(); ++i) {
+                if (i > 0) out += ',';
+                JsonValue(argv[i + 2]).SerializeTo(out);
+                out += ':';
+                if (!AppendJsonMatches(*document, paths[i], out)) out += "null";
+            }
+            out += '}';
+            return RespBuilder::BulkString(out);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class SMembersCommand : public ICommand {
+    // JSON.NUMINCRBY key path number
+    // 整数加整数保持整数（溢出时转为浮点数）；$ 路径返回所有匹配的新值数组，非数字的匹配为 null
+    class JsonNumIncrByCommand : public ICommand {
     public:
-        explicit SMembersCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit JsonNumIncrByCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'smembers' command");
+            if (argv.size() != 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'json.numincrby' command");
             }
 
-            std::string key = argv[1];
-
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Array({});
+            auto path = JsonPath::Parse(argv[2]);
+            if (!path) return InvalidJsonPathReply(argv[2]);
+            auto delta = JsonValue::Parse(argv[3]);
+            if (!delta || !delta->IsNumeric()) {
+                return RespBuilder::Error("ERR value is not a number");
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 4) != "set:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<JsonValue> document;
+            auto loaded = LoadJson(*cache_, argv[1], document);
+            if (loaded == JsonLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            if (!document) {
+                return RespBuilder::Error("ERR could not perform this operation on a key that doesn't exist");
+            }
 
-            std::vector<std::string> members;
-            size_t pos = 4;// 跳过"set:"前缀
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
-
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
-
-                if (pos + len > data.length()) break;
-                std::string member = data.substr(pos, len);
-                pos += len;
-                members.push_back(member);
+            std::vector<JsonValue *> matches;
+            path->Resolve(*document, matches);
+            if (path->IsLegacy()) {
+                if (matches.empty()) return RespBuilder::Error("ERR path does not exist");
+                if (!matches.front()->IsNumeric()) return JsonTypeMismatchReply("a number", *matches.front());
+                matches.resize(1);
             }
 
-            std::vector<std::string> result;
-            for (const auto &member: members) {
-                result.push_back(RespBuilder::BulkString(member));
+            // 先算出全部结果，任何一个不是有限数时整条命令不生效
+            std::vector<std::optional<JsonValue>> results;
+            results.reserve(matches.size());
+            for (JsonValue *match: matches) {
+                if (!match->IsNumeric()) {
+                    results.emplace_back();
+                    continue;
+                }
+                if (match->GetType() == JsonValue::Type::Integer && delta->GetType() == JsonValue::Type::Integer) {
+                    int64_t current = match->AsInteger(), step = delta->AsInteger();
+                    if ((step <= 0 || current <= INT64_MAX - step) && (step >= 0 || current >= INT64_MIN - step)) {
+                        results.emplace_back(JsonValue(current + step));
+                        continue;
+                    }
+                }
+                double sum = match->AsDouble() + delta->AsDouble();
+                if (!std::isfinite(sum)) {
+                    return RespBuilder::Error("ERR result is not a number or infinity");
+                }
+                results.emplace_back(JsonValue(sum));
             }
 
-            return RespBuilder::Array(result);
+            std::string out;
+            if (!path->IsLegacy()) out += '[';
+            for (size_t i = 0; i < matches.size(); ++i) {
+                if (i > 0) out += ',';
+                if (!results[i]) {
+                    out += "null";
+                    continue;
+                }
+                *matches[i] = std::move(*results[i]);
+                matches[i]->SerializeTo(out);
+            }
+            if (!path->IsLegacy()) out += ']';
+            return RespBuilder::BulkString(out);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class SIsMemberCommand : public ICommand {
+    // JSON.ARRAPPEND key path value [value ...]
+    // 返回追加后的数组长度；$ 路径返回每个匹配的长度，非数组的匹配为 nil
+    class JsonArrAppendCommand : public ICommand {
     public:
-        explicit SIsMemberCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit JsonArrAppendCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'sismember' command");
+            if (argv.size() < 4) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'json.arrappend' command");
             }
 
-            std::string key = argv[1];
-            std::string member = argv[2];
+            auto path = JsonPath::Parse(argv[2]);
+            if (!path) return InvalidJsonPathReply(argv[2]);
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Integer(0);
+            std::vector<JsonValue> values;
+            values.reserve(argv.size() - 3);
+            for (size_t i = 3; i < argv.size(); ++i) {
+                std::string error;
+                auto value = JsonValue::Parse(argv[i], &error);
+                if (!value) return RespBuilder::Error("ERR invalid JSON: " + error);
+                if (path->Segments().size() + 1 + value->Depth() > JsonValue::kMaxDepth) {
+                    return RespBuilder::Error("ERR nesting too deep");
+                }
+                values.push_back(std::move(*value));
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 4) != "set:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<JsonValue> document;
+            auto loaded = LoadJson(*cache_, argv[1], document);
+            if (loaded == JsonLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            if (!document) {
+                return RespBuilder::Error("ERR could not perform this operation on a key that doesn't exist");
+            }
 
-            AstraSet set;
-            size_t pos = 4;// 跳过"set:"前缀
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
-
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
-
-                if (pos + len > data.length()) break;
-                std::string set_member = data.substr(pos, len);
-                pos += len;
+            std::vector<JsonValue *> matches;
+            path->Resolve(*document, matches);
+            auto append = [&](JsonValue &array) {
+                auto &elements = array.AsArray();
+                elements.insert(elements.end(), values.begin(), values.end());
+                return static_cast<int64_t>(elements.size());
+            };
 
-                set.SAdd({set_member});
+            if (path->IsLegacy()) {
+                if (matches.empty()) return RespBuilder::Error("ERR path does not exist");
+                if (!matches.front()->IsArray()) return JsonTypeMismatchReply("array", *matches.front());
+                return RespBuilder::Integer(append(*matches.front()));
             }
 
-            return RespBuilder::Integer(set.SIsMember(member) ? 1 : 0);
+            std::vector<std::string> replies;
+            replies.reserve(matches.size());
+            for (JsonValue *match: matches) {
+                replies.push_back(match->IsArray() ? RespBuilder::Integer(append(*match)) : RespBuilder::Nil());
+            }
+            return RespBuilder::Array(replies);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class SPopCommand : public ICommand {
+    // JSON.DEL key [path]
+    // 删除根路径等同于删除整个键
+    class JsonDelCommand : public ICommand {
     public:
-        explicit SPopCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit JsonDelCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'spop' command");
+            if (argv.size() != 2 && argv.size() != 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'json.del' command");
             }
 
-            std::string key = argv[1];
+            std::optional<JsonPath> path = JsonPath::Parse(argv.size() == 3 ? argv[2] : "$");
+            if (!path) return InvalidJsonPathReply(argv[2]);
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Nil();
+            const std::string &key = argv[1];
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<JsonValue> document;
+            auto loaded = LoadJson(*cache_, key, document);
+            if (loaded == JsonLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            if (!document) return RespBuilder::Integer(0);
 
-            std::string data = existing.value();
-            if (data.substr(0, 4) != "set:") {
-                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            if (path->IsRoot()) {
+                // 文档由删除回调释放
+                cache_->Remove(key);
+                return RespBuilder::Integer(1);
             }
 
-            AstraSet set;
-            size_t pos = 4;// 跳过"set:"前缀
-            std::vector<std::string> members_vector;
-            while (pos < data.length()) {
-                size_t len_end = data.find(':', pos);
-                if (len_end == std::string::npos) break;
+            const auto &last = path->Segments().back();
+            std::vector<JsonValue *> parents;
+            path->Resolve(*document, parents, path->Segments().size() - 1);
 
-                size_t len = std::stoull(data.substr(pos, len_end - pos));
-                pos = len_end + 1;
+            int64_t deleted = 0;
+            for (JsonValue *parent: parents) {
+                if (last.kind == JsonPath::Segment::Kind::Wildcard) {
+                    if (parent->IsArray()) {
+                        deleted += static_cast<int64_t>(parent->AsArray().size());
+                        parent->AsArray().clear();
+                    } else if (parent->IsObject()) {
+                        deleted += static_cast<int64_t>(parent->AsObject().size());
+                        parent->AsObject().clear();
+                    }
+                } else if (last.kind == JsonPath::Segment::Kind::Key && parent->IsObject()) {
+                    auto &members = parent->AsObject();
+                    auto it = std::find_if(members.begin(), members.end(),
+                                           [&](const JsonMember &member) { return member.key == last.key; });
+                    if (it != members.end()) {
+                        members.erase(it);
+                        ++deleted;
+                    }
+                } else if (last.kind == JsonPath::Segment::Kind::Index && parent->IsArray()) {
+                    auto &elements = parent->AsArray();
+                    if (auto index = JsonPath::NormalizeIndex(last.index, elements.size())) {
+                        elements.erase(elements.begin() + static_cast<std::ptrdiff_t>(*index));
+                        ++deleted;
+                    }
+                }
+            }
+            return RespBuilder::Integer(deleted);
+        }
 
-                if (pos + len > data.length()) break;
-                std::string member = data.substr(pos, len);
-                pos += len;
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
 
-                set.SAdd({member});
-                members_vector.push_back(member);
+    // Stream相关命令实现
+    // 条目本体由 StreamManager 持有，缓存中只保存句柄（见 LoadResident）。
+    // 流的内容由 BlockingManager 中该键的分片锁保护：单键命令只锁自己的分片，
+    // XADD 在有等待者时才经 LockKeyForWake 取 Mutex() 去唤醒，多键的 XREAD 取 LockKeys
+
+    using StreamLoadResult = ResidentLoadResult;
+
+    inline StreamLoadResult LoadStream(AstraCache<LRUCache, std::string, std::string> &cache,
+                                       const std::string &key, std::shared_ptr<AstraStream> &stream) {
+        return LoadResident(cache, key, *apps::StreamManager::GetInstance(), AstraStream::kPrefix,
+                            &AstraStream::Deserialize, stream);
+    }
+
+    inline std::shared_ptr<AstraStream> CreateStream(AstraCache<LRUCache, std::string, std::string> &cache,
+                                                     const std::string &key) {
+        return CreateResident<AstraStream>(cache, key, *apps::StreamManager::GetInstance());
+    }
+
+    // XREAD/XREADGROUP 的加锁：单个键只锁它的分片，多个键按 BlockingManager 的约定先取 Mutex()
+    inline apps::KeyLocks LockStreamReadKeys(const std::vector<std::string> &keys) {
+        auto manager = apps::BlockingManager::GetInstance();
+        return keys.size() == 1 ? manager->LockKey(keys.front()) : manager->LockKeys(keys);
+    }
+
+    inline int64_t StreamNowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+    }
+
+    inline std::string StreamEntryReply(const StreamEntry &entry) {
+        std::vector<std::string> fields;
+        fields.reserve(entry.fields.size() * 2);
+        for (const auto &[field, value]: entry.fields) {
+            fields.push_back(RespBuilder::BulkString(field));
+            fields.push_back(RespBuilder::BulkString(value));
+        }
+        return RespBuilder::Array({RespBuilder::BulkString(entry.id.ToString()), RespBuilder::Array(fields)});
+    }
+
+    inline std::string StreamEntriesReply(const std::vector<StreamEntry> &entries) {
+        std::vector<std::string> result;
+        result.reserve(entries.size());
+        for (const auto &entry: entries) {
+            result.push_back(StreamEntryReply(entry));
+        }
+        return RespBuilder::Array(result);
+    }
+
+    // 解析 XRANGE 的边界："-"/"+"、完整 ID、只含毫秒的 ID，以及 "(" 开头的开区间
+    inline bool ParseStreamRangeBound(const std::string &arg, bool is_start, StreamID &id) {
+        if (arg == "-") {
+            id = StreamID::Min();
+            return true;
+        }
+        if (arg == "+") {
+            id = StreamID::Max();
+            return true;
+        }
+
+        bool exclusive = !arg.empty() && arg[0] == '(';
+        auto parsed = StreamID::Parse(std::string_view(arg).substr(exclusive ? 1 : 0),
+                                      is_start ? 0 : std::numeric_limits<uint64_t>::max());
+        if (!parsed) return false;
+        id = *parsed;
+
+        if (exclusive) {
+            if (is_start) {
+                auto next = id.Next();
+                if (!next) return false;
+                id = *next;
+            } else {
+                if (id == StreamID::Min()) return false;
+                id = id.seq > 0 ? StreamID{id.ms, id.seq - 1} : StreamID{id.ms - 1, std::numeric_limits<uint64_t>::max()};
             }
+        }
+        return true;
+    }
 
-            if (members_vector.empty()) {
-                cache_->Remove(key);
-                return RespBuilder::Nil();
+    // XADD key [NOMKSTREAM] [MAXLEN [=|~] threshold] *|id field value [field value ...]
+    class XAddCommand : public ICommand {
+    public:
+        explicit XAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            if (argv.size() < 5) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'xadd' command");
             }
 
-            // 随机选择一个元素
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, members_vector.size() - 1);
-            std::string popped_member = members_vector[dis(gen)];
+            const std::string &key = argv[1];
+            bool nomkstream = false;
+            bool trim = false;
+            bool approximate = false;
+            long long maxlen = 0;
+
+            size_t i = 2;
+            for (; i < argv.size(); ++i) {
+                if (ICaseCmp(argv[i], "NOMKSTREAM")) {
+                    nomkstream = true;
+                } else if (ICaseCmp(argv[i], "MAXLEN")) {
+                    if (i + 1 < argv.size() && (argv[i + 1] == "~" || argv[i + 1] == "=")) {
+                        approximate = argv[i + 1] == "~";
+                        ++i;
+                    }
+                    if (i + 1 >= argv.size()) {
+                        return RespBuilder::Error("ERR syntax error");
+                    }
+                    char *end;
+                    errno = 0;
+                    maxlen = std::strtoll(argv[i + 1].c_str(), &end, 10);
+                    if (errno == ERANGE || *end != '\0' || maxlen < 0) {
+                        return RespBuilder::Error("ERR The MAXLEN argument must be >= 0.");
+                    }
+                    trim = true;
+                    ++i;
+                } else {
+                    break;
+                }
+            }
 
-            // 从集合中移除该元素
-            set.SRem({popped_member});
+            // 剩余参数：ID 加成对的 field value
+            if (i >= argv.size() || (argv.size() - i - 1) == 0 || (argv.size() - i - 1) % 2 != 0) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'xadd' command");
+            }
+            const std::string &id_arg = argv[i];
+
+            StreamFields fields;
+            fields.reserve((argv.size() - i - 1) / 2);
+            for (size_t f = i + 1; f + 1 < argv.size(); f += 2) {
+                fields.emplace_back(argv[f], argv[f + 1]);
+            }
+
+            auto manager = apps::BlockingManager::GetInstance();
+            auto locks = manager->LockKeyForWake(key);
+            std::shared_ptr<AstraStream> stream;
+            auto loaded = LoadStream(*cache_, key, stream);
+            if (loaded == StreamLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+            }
+            if (loaded == StreamLoadResult::Missing) {
+                if (nomkstream) {
+                    return RespBuilder::Nil();
+                }
+                stream = CreateStream(*cache_, key);
+            }
 
-            // 如果集合为空，删除键
-            if (set.SCard() == 0) {
-                cache_->Remove(key);
+            auto &log = stream->Log();
+            StreamID last = log.LastID();
+            StreamID id;
+            if (id_arg == "*") {
+                uint64_t now = static_cast<uint64_t>(StreamNowMs());
+                if (now > last.ms) {
+                    id = {now, 0};
+                } else {
+                    auto next = last.Next();
+                    if (!next) {
+                        return RespBuilder::Error("ERR The stream has exhausted the last possible ID, unable to add more items");
+                    }
+                    id = *next;
+                }
+            } else if (id_arg.size() > 2 && id_arg.compare(id_arg.size() - 2, 2, "-*") == 0) {
+                // "ms-*"：毫秒由客户端指定，序号自动生成
+                auto parsed = StreamID::Parse(std::string_view(id_arg).substr(0, id_arg.size() - 2));
+                if (!parsed) {
+                    return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
+                }
+                id = {parsed->ms, parsed->ms == last.ms ? last.seq + 1 : 0};
             } else {
-                // 序列化set对象并存储到缓存
-                std::ostringstream serialized;
-                serialized << "set:";
-                auto all_members = set.SMembers();
-                for (const auto &member: all_members) {
-                    serialized << member.length() << ":" << member;
+                auto parsed = StreamID::Parse(id_arg);
+                if (!parsed) {
+                    return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
                 }
-                cache_->Put(key, serialized.str());
+                id = *parsed;
             }
 
-            return RespBuilder::BulkString(popped_member);
+            if (id == StreamID::Min()) {
+                return RespBuilder::Error("ERR The ID specified in XADD must be greater than 0-0");
+            }
+            if (!log.Append(id, fields)) {
+                return RespBuilder::Error("ERR The ID specified in XADD is equal or smaller than the target stream top item");
+            }
+            if (trim) {
+                log.Trim(static_cast<size_t>(maxlen), approximate);
+            }
+
+            // 分片上有等待者时 LockKeyForWake 已取得 Mutex()
+            if (manager->HasWaiters(key)) {
+                manager->SignalKeyReady(key);
+            }
+            return RespBuilder::BulkString(id.ToString());
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    // ZSet相关命令实现
-    class ZAddCommand : public ICommand {
+    // XLEN key
+    class XLenCommand : public ICommand {
     public:
-        explicit ZAddCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit XLenCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 4 || argv.size() % 2 != 0) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'zadd' command");
+            if (argv.size() != 2) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'xlen' command");
             }
 
-            std::string key = argv[1];
-            std::map<std::string, double> members;
-
-            try {
-                for (size_t i = 2; i < argv.size(); i += 2) {
-                    double score = std::stod(argv[i]);
-                    std::string member = argv[i + 1];
-                    members[member] = score;
-                }
-            } catch (const std::exception &) {
-                return RespBuilder::Error("ERR value is not a valid float");
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraStream> stream;
+            auto loaded = LoadStream(*cache_, argv[1], stream);
+            if (loaded == StreamLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
+            return RespBuilder::Integer(stream ? static_cast<int64_t>(stream->Log().Size()) : 0);
+        }
 
-            AstraZSet zset;
-            auto existing = cache_->Get(key);
-            if (existing.has_value()) {
-                std::string data = existing.value();
-                if (data.substr(0, 5) == "zset:") {
-                    // 解析现有zset数据
-                    // 简化实现
-                }
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // XRANGE / XREVRANGE 的公共实现
+    inline std::string StreamRangeReply(AstraCache<LRUCache, std::string, std::string> &cache,
+                                        const std::vector<std::string> &argv, bool reverse) {
+        const char *name = reverse ? "xrevrange" : "xrange";
+        if (argv.size() != 4 && argv.size() != 6) {
+            return RespBuilder::Error(std::string("ERR wrong number of arguments for '") + name + "' command");
+        }
+
+        // XREVRANGE 的参数顺序是 end start
+        StreamID start, end;
+        if (!ParseStreamRangeBound(argv[reverse ? 3 : 2], true, start) ||
+            !ParseStreamRangeBound(argv[reverse ? 2 : 3], false, end)) {
+            return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
+        }
+
+        long long count = 0;
+        if (argv.size() == 6) {
+            if (!ICaseCmp(argv[4], "COUNT")) {
+                return RespBuilder::Error("ERR syntax error");
+            }
+            char *endp;
+            errno = 0;
+            count = std::strtoll(argv[5].c_str(), &endp, 10);
+            if (errno == ERANGE || *endp != '\0') {
+                return RespBuilder::Error("ERR value is not an integer or out of range");
             }
+            if (count <= 0) {
+                return RespBuilder::Array({});
+            }
+        }
 
-            int added = zset.ZAdd(members);
+        auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+        std::shared_ptr<AstraStream> stream;
+        auto loaded = LoadStream(cache, argv[1], stream);
+        if (loaded == StreamLoadResult::WrongType) {
+            return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+        }
+        if (!stream) {
+            return RespBuilder::Array({});
+        }
 
-            // 序列化zset对象并存储到缓存
-            // 简化实现
+        auto entries = reverse ? stream->Log().RevRange(end, start, static_cast<size_t>(count))
+                               : stream->Log().Range(start, end, static_cast<size_t>(count));
+        return StreamEntriesReply(entries);
+    }
 
-            return RespBuilder::Integer(added);
+    // XRANGE key start end [COUNT count]
+    class XRangeCommand : public ICommand {
+    public:
+        explicit XRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
+
+        std::string Execute(const std::vector<std::string> &argv) override {
+            return StreamRangeReply(*cache_, argv, false);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class ZRemCommand : public ICommand {
+    // XREVRANGE key end start [COUNT count]
+    class XRevRangeCommand : public ICommand {
     public:
-        explicit ZRemCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit XRevRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() < 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'zrem' command");
+            return StreamRangeReply(*cache_, argv, true);
+        }
+
+    private:
+        std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
+    };
+
+    // XREAD / XREADGROUP 的参数
+    struct StreamReadRequest {
+        std::string command;
+        bool group_mode = false;
+        std::string group;
+        std::string consumer;
+        size_t count = 0;
+        bool block = false;
+        int64_t block_ms = 0;// 0 表示无限等待
+        bool noack = false;
+        std::vector<std::string> keys;
+        std::vector<std::string> ids;
+        // XREAD 的 "$" 在第一次尝试时解析为当时的最后 ID，之后阻塞期间保持不变
+        std::vector<StreamID> resolved;
+    };
+
+    // 解析 XREAD / XREADGROUP，出错时返回错误回复
+    inline std::optional<std::string> ParseStreamReadRequest(const std::vector<std::string> &argv,
+                                                             StreamReadRequest &request) {
+        std::string cmd = argv.empty() ? std::string() : argv[0];
+        std::transform(cmd.begin(), cmd.end(), cmd.begin(), [](unsigned char c) { return std::toupper(c); });
+        request.command = cmd;
+        request.group_mode = cmd == "XREADGROUP";
+        const char *name = request.group_mode ? "xreadgroup" : "xread";
+
+        size_t i = 1;
+        if (request.group_mode) {
+            if (argv.size() < 4 || !ICaseCmp(argv[1], "GROUP")) {
+                return RespBuilder::Error("ERR syntax error");
+            }
+            request.group = argv[2];
+            request.consumer = argv[3];
+            i = 4;
+        }
+
+        size_t streams_pos = 0;
+        for (; i < argv.size(); ++i) {
+            if (ICaseCmp(argv[i], "COUNT") && i + 1 < argv.size()) {
+                char *end;
+                errno = 0;
+                long long count = std::strtoll(argv[++i].c_str(), &end, 10);
+                if (errno == ERANGE || *end != '\0') {
+                    return RespBuilder::Error("ERR value is not an integer or out of range");
+                }
+                request.count = count > 0 ? static_cast<size_t>(count) : 0;
+            } else if (ICaseCmp(argv[i], "BLOCK") && i + 1 < argv.size()) {
+                char *end;
+                errno = 0;
+                long long block_ms = std::strtoll(argv[++i].c_str(), &end, 10);
+                if (errno == ERANGE || *end != '\0') {
+                    return RespBuilder::Error("ERR timeout is not an integer or out of range");
+                }
+                if (block_ms < 0) {
+                    return RespBuilder::Error("ERR timeout is negative");
+                }
+                if (block_ms > kMaxBlockTimeoutMs) {
+                    return RespBuilder::Error("ERR timeout is out of range");
+                }
+                request.block = true;
+                request.block_ms = block_ms;
+            } else if (request.group_mode && ICaseCmp(argv[i], "NOACK")) {
+                request.noack = true;
+            } else if (ICaseCmp(argv[i], "STREAMS")) {
+                streams_pos = i + 1;
+                break;
+            } else {
+                return RespBuilder::Error("ERR syntax error");
             }
+        }
 
-            std::string key = argv[1];
-            std::vector<std::string> members(argv.begin() + 2, argv.end());
+        size_t remaining = streams_pos == 0 ? 0 : argv.size() - streams_pos;
+        if (remaining == 0 || remaining % 2 != 0) {
+            return RespBuilder::Error(std::string("ERR Unbalanced '") + name +
+                                      "' list of streams: for each stream key an ID or '$' must be specified.");
+        }
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Integer(0);
+        size_t n = remaining / 2;
+        request.keys.assign(argv.begin() + streams_pos, argv.begin() + streams_pos + n);
+        request.ids.assign(argv.begin() + streams_pos + n, argv.end());
+        for (const auto &id: request.ids) {
+            if (id == "$" && !request.group_mode) continue;
+            if (id == ">" && request.group_mode) continue;
+            if (!StreamID::Parse(id)) {
+                return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
             }
+        }
+        return std::nullopt;
+    }
+
+    // 执行一次 XREAD/XREADGROUP；没有任何可返回的条目且允许阻塞时返回 nullopt
+    // 调用方需持有 request.keys 各键的分片锁
+    inline std::optional<std::string> TryServeStreamRead(AstraCache<LRUCache, std::string, std::string> &cache,
+                                                         StreamReadRequest &request) {
+        bool first_attempt = request.resolved.empty();
+        if (first_attempt) {
+            request.resolved.resize(request.keys.size());
+        }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "zset:") {
+        std::vector<std::string> result;
+        bool can_block = true;// 读取 PEL 历史的 XREADGROUP 总是立即返回
+        for (size_t k = 0; k < request.keys.size(); ++k) {
+            const std::string &key = request.keys[k];
+            const std::string &id_arg = request.ids[k];
+
+            std::shared_ptr<AstraStream> stream;
+            auto loaded = LoadStream(cache, key, stream);
+            if (loaded == StreamLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
 
-            AstraZSet zset;
-            // 解析zset数据
-            // 简化实现
+            if (!request.group_mode) {
+                if (first_attempt) {
+                    request.resolved[k] = id_arg == "$" ? (stream ? stream->Log().LastID() : StreamID::Min())
+                                                        : *StreamID::Parse(id_arg);
+                }
+                if (!stream) continue;
 
-            int removed = 0;
-            for (const auto &member: members) {
-                if (zset.ZRem({member})) {// 将单个成员包装成vector
-                    removed++;
+                auto start = request.resolved[k].Next();
+                if (!start) continue;
+                auto entries = stream->Log().Range(*start, StreamID::Max(), request.count);
+                if (!entries.empty()) {
+                    result.push_back(RespBuilder::Array({RespBuilder::BulkString(key), StreamEntriesReply(entries)}));
+                }
+                continue;
+            }
+
+            AstraStream::ConsumerGroup *group = stream ? stream->FindGroup(request.group) : nullptr;
+            if (!group) {
+                return RespBuilder::Error("NOGROUP No such key '" + key + "' or consumer group '" + request.group +
+                                          "' in XREADGROUP with GROUP option");
+            }
+            int64_t now = StreamNowMs();
+            group->consumers[request.consumer] = now;
+
+            if (id_arg != ">") {
+                // 读取该消费者的待确认历史
+                can_block = false;
+                StreamID after = *StreamID::Parse(id_arg);
+                std::vector<std::string> history;
+                for (auto it = group->pending.upper_bound(after); it != group->pending.end(); ++it) {
+                    if (it->second.consumer != request.consumer) continue;
+                    auto entries = stream->Log().Range(it->first, it->first);
+                    if (entries.empty()) {
+                        // 条目已被裁剪，按 Redis 的约定返回空字段
+                        history.push_back(RespBuilder::Array({RespBuilder::BulkString(it->first.ToString()), RespBuilder::NullArray()}));
+                    } else {
+                        history.push_back(StreamEntryReply(entries.front()));
+                    }
+                    if (request.count > 0 && history.size() >= request.count) break;
+                }
+                result.push_back(RespBuilder::Array({RespBuilder::BulkString(key), RespBuilder::Array(history)}));
+                continue;
+            }
+
+            auto start = group->last_delivered.Next();
+            if (!start) continue;
+            auto entries = stream->Log().Range(*start, StreamID::Max(), request.count);
+            if (entries.empty()) continue;
+
+            group->last_delivered = entries.back().id;
+            if (!request.noack) {
+                for (const auto &entry: entries) {
+                    auto &pending = group->pending[entry.id];
+                    pending.consumer = request.consumer;
+                    pending.delivery_time_ms = now;
+                    ++pending.delivery_count;
                 }
             }
+            result.push_back(RespBuilder::Array({RespBuilder::BulkString(key), StreamEntriesReply(entries)}));
+        }
 
-            // 如果有序集合为空，删除键
-            if (zset.ZCard() == 0) {
-                cache_->Remove(key);
-                return RespBuilder::Integer(removed);
+        if (result.empty() && can_block) {
+            return std::nullopt;
+        }
+        return RespBuilder::Array(result);
+    }
+
+    // 判断本次调用是否需要在 Session 中挂起等待
+    inline bool IsBlockingInvocation(const std::vector<std::string> &argv) {
+        if (argv.empty()) return false;
+        const std::string &cmd = argv[0];
+        if (ICaseCmp(cmd, "BLPOP") || ICaseCmp(cmd, "BRPOP") || ICaseCmp(cmd, "BLMOVE")) {
+            return true;
+        }
+        if (ICaseCmp(cmd, "XREAD") || ICaseCmp(cmd, "XREADGROUP")) {
+            for (size_t i = 1; i < argv.size(); ++i) {
+                if (ICaseCmp(argv[i], "STREAMS")) break;
+                if (ICaseCmp(argv[i], "BLOCK")) return true;
             }
+        }
+        return false;
+    }
+
+    // XREAD [COUNT count] [BLOCK milliseconds] STREAMS key [key ...] id [id ...]
+    // 经由 Session 执行时 BLOCK 会真正挂起；其他上下文中只做一次立即读取
+    class XReadCommand : public ICommand {
+    public:
+        explicit XReadCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+            : cache_(std::move(cache)) {}
 
-            // 序列化zset对象并存储到缓存
-            // 简化实现
+        std::string Execute(const std::vector<std::string> &argv) override {
+            StreamReadRequest request;
+            if (auto error = ParseStreamReadRequest(argv, request)) {
+                return *error;
+            }
 
-            return RespBuilder::Integer(removed);
+            auto locks = LockStreamReadKeys(request.keys);
+            return TryServeStreamRead(*cache_, request).value_or(RespBuilder::NullArray());
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class ZCardCommand : public ICommand {
+    // XREADGROUP GROUP group consumer [COUNT count] [BLOCK milliseconds] [NOACK] STREAMS key [key ...] id [id ...]
+    class XReadGroupCommand : public ICommand {
     public:
-        explicit ZCardCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit XReadGroupCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 2) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'zcard' command");
-            }
-
-            std::string key = argv[1];
-
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Integer(0);
+            StreamReadRequest request;
+            if (auto error = ParseStreamReadRequest(argv, request)) {
+                return *error;
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "zset:") {
-                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
-            }
-
-            AstraZSet zset;
-            // 解析zset数据
-            // 简化实现
-
-            return RespBuilder::Integer(zset.ZCard());
+            auto locks = LockStreamReadKeys(request.keys);
+            return TryServeStreamRead(*cache_, request).value_or(RespBuilder::NullArray());
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class ZRangeCommand : public ICommand {
+    // XGROUP CREATE key group id|$ [MKSTREAM] | XGROUP DESTROY key group
+    class XGroupCommand : public ICommand {
     public:
-        explicit ZRangeCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit XGroupCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 4) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'zrange' command");
+                return RespBuilder::Error("ERR wrong number of arguments for 'xgroup' command");
             }
 
-            std::string key = argv[1];
+            const std::string &subcmd = argv[1];
+            const std::string &key = argv[2];
+            const std::string &group = argv[3];
 
-            // 解析起始和结束索引
-            char *end;
-            errno = 0;
-            long long start = std::strtoll(argv[2].c_str(), &end, 10);
-            if (errno == ERANGE || *end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+            std::shared_ptr<AstraStream> stream;
+            auto loaded = LoadStream(*cache_, key, stream);
+            if (loaded == StreamLoadResult::WrongType) {
+                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
 
-            errno = 0;
-            long long stop = std::strtoll(argv[3].c_str(), &end, 10);
-            if (errno == ERANGE || *end != '\0') {
-                return RespBuilder::Error("ERR value is not an integer or out of range");
-            }
+            if (ICaseCmp(subcmd, "CREATE")) {
+                if (argv.size() != 5 && argv.size() != 6) {
+                    return RespBuilder::Error("ERR wrong number of arguments for 'xgroup|create' command");
+                }
+                bool mkstream = argv.size() == 6 && ICaseCmp(argv[5], "MKSTREAM");
+                if (argv.size() == 6 && !mkstream) {
+                    return RespBuilder::Error("ERR syntax error");
+                }
 
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Array({});
-            }
+                StreamID last_delivered;
+                if (argv[4] != "$") {
+                    auto parsed = StreamID::Parse(argv[4]);
+                    if (!parsed) {
+                        return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
+                    }
+                    last_delivered = *parsed;
+                }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "zset:") {
-                return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+                if (!stream) {
+                    if (!mkstream) {
+                        return RespBuilder::Error("ERR The XGROUP subcommand requires the key to exist. "
+                                                  "Note that for CREATE you may want to use the MKSTREAM option to create an empty stream automatically.");
+                    }
+                    stream = CreateStream(*cache_, key);
+                }
+                if (argv[4] == "$") {
+                    last_delivered = stream->Log().LastID();
+                }
+                if (!stream->CreateGroup(group, last_delivered)) {
+                    return RespBuilder::Error("BUSYGROUP Consumer Group name already exists");
+                }
+                return RespBuilder::SimpleString("OK");
             }
 
-            AstraZSet zset;
-            // 解析zset数据
-            // 简化实现
-
-            // 获取范围内的成员
-            auto members = zset.ZRange(start, stop);
-
-            std::vector<std::string> result;
-            for (const auto &member: members) {
-                result.push_back(RespBuilder::BulkString(member));
+            if (ICaseCmp(subcmd, "DESTROY")) {
+                if (argv.size() != 4) {
+                    return RespBuilder::Error("ERR wrong number of arguments for 'xgroup|destroy' command");
+                }
+                if (!stream) {
+                    return RespBuilder::Error("ERR The XGROUP subcommand requires the key to exist.");
+                }
+                return RespBuilder::Integer(stream->DestroyGroup(group) ? 1 : 0);
             }
 
-            return RespBuilder::Array(result);
+            return RespBuilder::Error("ERR unknown subcommand '" + subcmd + "'. Try XGROUP HELP.");
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class ZRangeByScoreCommand : public ICommand {
+    // XACK key group id [id ...]
+    class XAckCommand : public ICommand {
     public:
-        explicit ZRangeByScoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit XAckCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
             if (argv.size() < 4) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'zrangebyscore' command");
+                return RespBuilder::Error("ERR wrong number of arguments for 'xack' command");
             }
 
-            std::string key = argv[1];
-            std::string min_str = argv[2];
-            std::string max_str = argv[3];
-
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Array({});
+            std::vector<StreamID> ids;
+            ids.reserve(argv.size() - 3);
+            for (size_t i = 3; i < argv.size(); ++i) {
+                auto parsed = StreamID::Parse(argv[i]);
+                if (!parsed) {
+                    return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
+                }
+                ids.push_back(*parsed);
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "zset:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraStream> stream;
+            auto loaded = LoadStream(*cache_, argv[1], stream);
+            if (loaded == StreamLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-
-            // 解析最小和最大分数
-            double min, max;
-            if (min_str == "-inf") {
-                min = -std::numeric_limits<double>::infinity();
-            } else {
-                try {
-                    min = std::stod(min_str);
-                } catch (const std::exception &) {
-                    return RespBuilder::Error("ERR min or max is not a float");
-                }
-            }
-
-            if (max_str == "+inf") {
-                max = std::numeric_limits<double>::infinity();
-            } else {
-                try {
-                    max = std::stod(max_str);
-                } catch (const std::exception &) {
-                    return RespBuilder::Error("ERR min or max is not a float");
-                }
+            AstraStream::ConsumerGroup *group = stream ? stream->FindGroup(argv[2]) : nullptr;
+            if (!group) {
+                return RespBuilder::Integer(0);
             }
 
-            AstraZSet zset;
-            // 解析zset数据
-            // 简化实现
-
-            // 获取范围内的成员
-            auto members = zset.ZRangeByScore(min, max);
-
-            std::vector<std::string> result;
-            for (const auto &member: members) {
-                result.push_back(RespBuilder::BulkString(member));
+            int64_t acked = 0;
+            for (const auto &id: ids) {
+                acked += static_cast<int64_t>(group->pending.erase(id));
             }
-
-            return RespBuilder::Array(result);
+            return RespBuilder::Integer(acked);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
 
-    class ZScoreCommand : public ICommand {
+    // XPENDING key group [[IDLE min-idle-time] start end count [consumer]]
+    class XPendingCommand : public ICommand {
     public:
-        explicit ZScoreCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
+        explicit XPendingCommand(std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache)
             : cache_(std::move(cache)) {}
 
         std::string Execute(const std::vector<std::string> &argv) override {
-            if (argv.size() != 3) {
-                return RespBuilder::Error("ERR wrong number of arguments for 'zscore' command");
-            }
-
-            std::string key = argv[1];
-            std::string member = argv[2];
-
-            auto existing = cache_->Get(key);
-            if (!existing.has_value()) {
-                return RespBuilder::Nil();
+            if (argv.size() < 3) {
+                return RespBuilder::Error("ERR wrong number of arguments for 'xpending' command");
+            }
+
+            // 扩展形式的参数
+            bool extended = argv.size() > 3;
+            long long min_idle = 0;
+            StreamID start, end;
+            long long count = 0;
+            std::string consumer_filter;
+            if (extended) {
+                size_t i = 3;
+                char *endp;
+                if (ICaseCmp(argv[i], "IDLE")) {
+                    if (i + 1 >= argv.size()) {
+                        return RespBuilder::Error("ERR syntax error");
+                    }
+                    errno = 0;
+                    min_idle = std::strtoll(argv[i + 1].c_str(), &endp, 10);
+                    if (errno == ERANGE || *endp != '\0') {
+                        return RespBuilder::Error("ERR value is not an integer or out of range");
+                    }
+                    i += 2;
+                }
+                if (argv.size() - i != 3 && argv.size() - i != 4) {
+                    return RespBuilder::Error("ERR syntax error");
+                }
+                if (!ParseStreamRangeBound(argv[i], true, start) || !ParseStreamRangeBound(argv[i + 1], false, end)) {
+                    return RespBuilder::Error("ERR Invalid stream ID specified as stream command argument");
+                }
+                errno = 0;
+                count = std::strtoll(argv[i + 2].c_str(), &endp, 10);
+                if (errno == ERANGE || *endp != '\0') {
+                    return RespBuilder::Error("ERR value is not an integer or out of range");
+                }
+                if (argv.size() - i == 4) {
+                    consumer_filter = argv[i + 3];
+                }
             }
 
-            std::string data = existing.value();
-            if (data.substr(0, 5) != "zset:") {
+            auto locks = apps::BlockingManager::GetInstance()->LockKey(argv[1]);
+            std::shared_ptr<AstraStream> stream;
+            auto loaded = LoadStream(*cache_, argv[1], stream);
+            if (loaded == StreamLoadResult::WrongType) {
                 return RespBuilder::Error("WRONGTYPE Operation against a key holding the wrong kind of value");
             }
-
-            AstraZSet zset;
-            // 解析zset数据
-            // 简化实现
-
-            auto score = zset.ZScore(member);
-            if (!score.first) {
-                return RespBuilder::Nil();
+            AstraStream::ConsumerGroup *group = stream ? stream->FindGroup(argv[2]) : nullptr;
+            if (!group) {
+                return RespBuilder::Error("NOGROUP No such key '" + argv[1] + "' or consumer group '" + argv[2] + "'");
             }
 
-            // 将分数转换为字符串，保持Redis的格式化方式
-            std::ostringstream oss;
-            if (score.second == (long long) score.second) {
-                // 整数
-                oss << (long long) score.second;
-            } else {
-                // 浮点数
-                oss << std::fixed << std::setprecision(15) << score.second;
-                // 移除尾随的0
-                std::string str = oss.str();
-                str.erase(str.find_last_not_of('0') + 1, std::string::npos);
-                str.erase(str.find_last_not_of('.') + 1, std::string::npos);
-                return RespBuilder::BulkString(str);
+            if (!extended) {
+                if (group->pending.empty()) {
+                    return RespBuilder::Array({RespBuilder::Integer(0), RespBuilder::Nil(), RespBuilder::Nil(), RespBuilder::NullArray()});
+                }
+                std::map<std::string, int64_t> per_consumer;
+                for (const auto &[id, pending]: group->pending) {
+                    ++per_consumer[pending.consumer];
+                }
+                std::vector<std::string> consumers;
+                for (const auto &[name, n]: per_consumer) {
+                    consumers.push_back(RespBuilder::Array({RespBuilder::BulkString(name), RespBuilder::BulkString(std::to_string(n))}));
+                }
+                return RespBuilder::Array({RespBuilder::Integer(static_cast<int64_t>(group->pending.size())),
+                                           RespBuilder::BulkString(group->pending.begin()->first.ToString()),
+                                           RespBuilder::BulkString(group->pending.rbegin()->first.ToString()),
+                                           RespBuilder::Array(consumers)});
             }
 
-            return RespBuilder::BulkString(oss.str());
+            std::vector<std::string> result;
+            int64_t now = StreamNowMs();
+            for (auto it = group->pending.lower_bound(start); it != group->pending.end() && it->first <= end; ++it) {
+                if (count <= 0 || static_cast<long long>(result.size()) >= count) break;
+                const auto &pending = it->second;
+                if (!consumer_filter.empty() && pending.consumer != consumer_filter) continue;
+                int64_t idle = now - pending.delivery_time_ms;
+                if (idle < min_idle) continue;
+                result.push_back(RespBuilder::Array({RespBuilder::BulkString(it->first.ToString()),
+                                                     RespBuilder::BulkString(pending.consumer),
+                                                     RespBuilder::Integer(idle),
+                                                     RespBuilder::Integer(static_cast<int64_t>(pending.delivery_count))}));
+            }
+            return RespBuilder::Array(result);
         }
 
     private:
         std::shared_ptr<AstraCache<LRUCache, std::string, std::string>> cache_;
     };
+
+    // 句柄类值与缓存/快照之间的转换，由服务器在创建缓存和读写快照时挂上
+
+    // 缓存删除回调：句柄被删除、覆盖、淘汰或过期时释放注册表中的本体。在分区锁内调用，只碰注册表
+    inline void ReleaseResidentValue(const std::string &key, const std::string &value) {
+        if (value.starts_with(AstraStream::kPrefix)) {
+            apps::StreamManager::GetInstance()->Release(key, value);
+        } else if (value.starts_with(AstraZSet::kPrefix)) {
+            apps::ZSetManager::GetInstance()->Release(key, value);
+        } else if (value.starts_with(apps::JsonManager::kPrefix)) {
+            apps::JsonManager::GetInstance()->Release(key, value);
+        }
+    }
+
+    // 保存快照：句柄换成本体的编码（在该键的分片锁内序列化），本体已不存在的句柄不保存
+    inline std::optional<std::string> EncodeResidentValue(const std::string &key, const std::string &value) {
+        auto streams = apps::StreamManager::GetInstance();
+        auto zsets = apps::ZSetManager::GetInstance();
+        auto documents = apps::JsonManager::GetInstance();
+        if (!streams->IsHandle(value) && !zsets->IsHandle(value) && !documents->IsHandle(value)) {
+            return value;
+        }
+
+        auto locks = apps::BlockingManager::GetInstance()->LockKey(key);
+        if (auto stream = streams->Find(key, value)) {
+            return stream->Serialize();
+        }
+        if (auto zset = zsets->Find(key, value)) {
+            return zset->Serialize();
+        }
+        if (auto document = documents->Find(key, value)) {
+            std::string encoded(apps::JsonManager::kPrefix);
+            document->SerializeTo(encoded);
+            return encoded;
+        }
+        return std::nullopt;
+    }
+
+    // 加载快照：旧版本只保存了不带本体的 "stream:"/"zset:"/"json:" 句柄，这样的键已没有内容，直接跳过
+    inline std::optional<std::string> DecodeResidentValue(const std::string &, const std::string &value) {
+        if (value == AstraStream::kPrefix || value == AstraZSet::kPrefix || value == apps::JsonManager::kPrefix) {
+            return std::nullopt;
+        }
+        return value;
+    }
 }// namespace Astra::proto
@@ -3,16 +3,8 @@
 #include "command_parser.hpp"
 #include "resp_builder.hpp"
 #include <algorithm>
-#include <sstream>
 #include <vector>
 
-// 根据平台自动选择 RESP 版本
-#ifdef _WIN32
-#define RESP_V2
-#else
-#define RESP_V3
-#endif
-
 namespace Astra::proto {
 
     class CommandResponseBuilder {
@@ -23,10 +15,7 @@ namespace Astra::proto {
 
     private:
         static std::string BuildFullCommandDetail(const CommandInfo &cmd);
-        static std::string BuildCommandDocEntry_RESP2(const CommandInfo &cmd);
-#ifdef RESP_V3
-        static std::string BuildCommandDocEntry_RESP3(const CommandInfo &cmd);
-#endif
+        static std::string BuildCommandDocEntry(const CommandInfo &cmd);
     };
 
     // 构造原始 COMMAND 响应格式（数组）—— 兼容 V2/V3
@@ -48,78 +37,29 @@ namespace Astra::proto {
         return RespBuilder::Array(fullDetails);
     }
 
-    // 构造 COMMAND DOCS 响应格式：根据平台选择 RESP2 或 RESP3
+    // 构造 COMMAND DOCS 响应格式：命令名到文档的 map，RESP2 连接上为扁平数组
     inline std::string CommandResponseBuilder::BuildCommandDocsResponse(
             const std::vector<CommandInfo> &allCommands,
             const std::vector<std::string> &requestedCommands) {
 
-#ifdef RESP_V3
-        std::ostringstream oss;
-        size_t count = requestedCommands.empty() ? allCommands.size() : requestedCommands.size();
-        oss << "%" << count << "\r\n";
-
-        auto processEntry = [&](const std::string &name, const CommandInfo *cmd) {
-            oss << RespBuilder::BulkString(name);
-            if (cmd) {
-                oss << BuildCommandDocEntry_RESP3(*cmd);
-            } else {
-                oss << "$-1\r\n";// nil
-            }
-        };
-
-        if (requestedCommands.empty()) {
-            for (const auto &cmd: allCommands) {
-                processEntry(cmd.name, &cmd);
-            }
-        } else {
-            for (const auto &reqName: requestedCommands) {
-                auto it = std::find_if(allCommands.begin(), allCommands.end(),
-                                       [&](const CommandInfo &info) { return ICaseCmp(info.name, reqName); });
-
-                if (it != allCommands.end()) {
-                    processEntry(reqName, &(*it));
-                } else {
-                    processEntry(reqName, nullptr);
-                }
-            }
-        }
-
-        return oss.str();
-
-#else// RESP_V2: 使用数组模拟 map
-
-        auto buildEntry = [&](const std::string &name, const std::string &docValue) {
-            std::vector<std::string> pair;
-            pair.push_back(RespBuilder::BulkString(name));
-            pair.push_back(docValue);
-            return RespBuilder::Array(pair);
-        };
-
-        std::vector<std::string> result;
+        std::vector<std::string> entries;
 
         if (requestedCommands.empty()) {
             for (const auto &cmd: allCommands) {
-                std::string doc = BuildCommandDocEntry_RESP2(cmd);
-                result.push_back(buildEntry(cmd.name, doc));
+                entries.push_back(RespBuilder::BulkString(cmd.name));
+                entries.push_back(BuildCommandDocEntry(cmd));
             }
         } else {
             for (const auto &reqName: requestedCommands) {
                 auto it = std::find_if(allCommands.begin(), allCommands.end(),
                                        [&](const CommandInfo &info) { return ICaseCmp(info.name, reqName); });
 
-                std::string doc;
-                if (it != allCommands.end()) {
-                    doc = BuildCommandDocEntry_RESP2(*it);
-                } else {
-                    doc = "$-1\r\n";// nil
-                }
-                result.push_back(buildEntry(reqName, doc));
+                entries.push_back(RespBuilder::BulkString(reqName));
+                entries.push_back(it != allCommands.end() ? BuildCommandDocEntry(*it) : RespBuilder::Nil());
             }
         }
 
-        return RespBuilder::Array(result);
-
-#endif// RESP_V2
+        return RespBuilder::Map(entries);
     }
 
     // 构造单个命令的详情（原始 COMMAND 响应）—— 不变，始终是数组
@@ -149,9 +89,8 @@ namespace Astra::proto {
         return RespBuilder::Array(fields);
     }
 
-    // ==================== RESP2 实现：map 用数组表示 ====================
-
-    inline std::string CommandResponseBuilder::BuildCommandDocEntry_RESP2(const CommandInfo &cmd) {
+    // 单个命令的文档，字段按 Redis 的 COMMAND DOCS 组织
+    inline std::string CommandResponseBuilder::BuildCommandDocEntry(const CommandInfo &cmd) {
         std::vector<std::string> mapElements;
 
         // summary
@@ -172,7 +111,7 @@ namespace Astra::proto {
 
         // doc_flags
         mapElements.push_back(RespBuilder::BulkString("doc_flags"));
-        mapElements.push_back(RespBuilder::Array({}));// empty array
+        mapElements.push_back(RespBuilder::Set({}));// empty set
 
         // history（可选）
         if (!cmd.history.empty()) {
@@ -183,7 +122,7 @@ namespace Astra::proto {
                 historyPair.push_back(RespBuilder::BulkString(entry.version));
                 historyPair.push_back(RespBuilder::BulkString("change"));
                 historyPair.push_back(RespBuilder::BulkString(entry.change));
-                historyElements.push_back(RespBuilder::Array(historyPair));
+                historyElements.push_back(RespBuilder::Map(historyPair));
             }
             mapElements.push_back(RespBuilder::BulkString("history"));
             mapElements.push_back(RespBuilder::Array(historyElements));
@@ -198,78 +137,13 @@ namespace Astra::proto {
                 argPair.push_back(RespBuilder::BulkString(arg.name));
                 argPair.push_back(RespBuilder::BulkString("type"));
                 argPair.push_back(RespBuilder::BulkString(arg.type));
-                argElements.push_back(RespBuilder::Array(argPair));
+                argElements.push_back(RespBuilder::Map(argPair));
             }
             mapElements.push_back(RespBuilder::BulkString("arguments"));
             mapElements.push_back(RespBuilder::Array(argElements));
         }
 
-        return RespBuilder::Array(mapElements);
-    }
-
-    // ==================== RESP3 实现：map 用 % 表示 ====================
-
-#ifdef RESP_V3
-
-    inline std::string CommandResponseBuilder::BuildCommandDocEntry_RESP3(const CommandInfo &cmd) {
-        std::ostringstream oss;
-
-        // 计算字段数量
-        int fieldCount = 5;// summary, since, group, complexity, doc_flags
-        if (!cmd.history.empty()) ++fieldCount;
-        if (!cmd.arguments.empty()) ++fieldCount;
-
-        oss << "%" << fieldCount << "\r\n";
-
-        // summary
-        oss << RespBuilder::BulkString("summary");
-        oss << RespBuilder::BulkString(cmd.summary);
-
-        // since
-        oss << RespBuilder::BulkString("since");
-        oss << RespBuilder::BulkString(cmd.since);
-
-        // group
-        oss << RespBuilder::BulkString("group");
-        oss << RespBuilder::BulkString(cmd.category);
-
-        // complexity
-        oss << RespBuilder::BulkString("complexity");
-        oss << RespBuilder::BulkString(cmd.complexity);
-
-        // doc_flags
-        oss << RespBuilder::BulkString("doc_flags");
-        oss << "*" << 0 << "\r\n";// empty array
-
-        // history
-        if (!cmd.history.empty()) {
-            oss << RespBuilder::BulkString("history");
-            oss << "*" << cmd.history.size() << "\r\n";
-            for (const auto &entry: cmd.history) {
-                oss << "%2\r\n";
-                oss << RespBuilder::BulkString("version");
-                oss << RespBuilder::BulkString(entry.version);
-                oss << RespBuilder::BulkString("change");
-                oss << RespBuilder::BulkString(entry.change);
-            }
-        }
-
-        // arguments
-        if (!cmd.arguments.empty()) {
-            oss << RespBuilder::BulkString("arguments");
-            oss << "*" << cmd.arguments.size() << "\r\n";
-            for (const auto &arg: cmd.arguments) {
-                oss << "%2\r\n";
-                oss << RespBuilder::BulkString("name");
-                oss << RespBuilder::BulkString(arg.name);
-                oss << RespBuilder::BulkString("type");
-                oss << RespBuilder::BulkString(arg.type);
-            }
-        }
-
-        return oss.str();
+        return RespBuilder::Map(mapElements);
     }
 
-#endif// RESP_V3
-
 }// namespace Astra::proto
\ No newline at end of file
@@ -122,6 +122,8 @@ namespace Astra::proto {
             // --- End of conversion ---
 
             // --- Execute the command via ICommand ---
+            // 脚本内部始终按 RESP2 解析命令回复，与调用方连接协商的协议无关
+            RespBuilder::ProtocolScope resp2_scope(RespProtocol::Resp2);
             std::string resp_result_str = it->second->Execute(argv);
             // --- End of execution ---
 
@@ -1,164 +1,184 @@
 #include "ProtocolParser.hpp"
 #include "logger.hpp"
+#include <algorithm>
+#include <cstring>
 #include <utils/logger.hpp>
+#include <utils/resp_scan.hpp>
 
 namespace Astra::proto {
 
-    ProtocolParser::ProtocolParser()
-        : parse_state_(ParseState::ReadingArrayHeader),
-          remaining_args_(0),
-          current_bulk_size_(0) {}
-
-    size_t ProtocolParser::ProcessBuffer(std::string &buffer, std::vector<std::string> &argv) {
-        if (parse_state_ == ParseState::ReadingArrayHeader) {
-            size_t pos = buffer.find("\r\n");
-            if (pos == std::string::npos) return 0;
-
-            std::string line = buffer.substr(0, pos);
-            buffer.erase(0, pos + 2);
-
-            if (!HandleArrayHeader(line, argv, remaining_args_)) {
-                return 0;// Error occurred
-            }
-            return pos + 2;
-        } else if (parse_state_ == ParseState::ReadingBulkHeader) {
-            size_t pos = buffer.find("\r\n");
-            if (pos == std::string::npos) return 0;
-
-            std::string line = buffer.substr(0, pos);
-            buffer.erase(0, pos + 2);
-
-            if (!HandleBulkHeader(line, current_bulk_size_)) {
-                return 0;// Error occurred
-            }
-            return pos + 2;
-        } else if (parse_state_ == ParseState::ReadingBulkContent) {
-            if (current_bulk_size_ < 0 || buffer.size() < static_cast<size_t>(current_bulk_size_ + 2)) {
-                return 0;
-            }
-
-            std::string content;
-            if (!HandleBulkContent(buffer, content, current_bulk_size_)) {
-                return 0;// Error occurred
-            }
-
-            argv.push_back(content);
-            remaining_args_--;
-
-            if (remaining_args_ > 0) {
-                parse_state_ = ParseState::ReadingBulkHeader;
-            } else {
-                parse_state_ = ParseState::ReadingArrayHeader;
-            }
-
-            buffer.erase(0, current_bulk_size_ + 2);
-            return current_bulk_size_ + 2;
+    std::pair<char *, size_t> ReadBuffer::PrepareWrite(size_t min_free) {
+        if (storage_.size() - end_ < min_free && begin_ > 0) {
+            Compact();
         }
-
-        return 0;
+        if (storage_.size() - end_ < min_free) {
+            size_t needed = end_ + min_free;
+            storage_.resize(std::max({needed, storage_.size() * 2, kDefaultCapacity}));
+        }
+        return {storage_.data() + end_, storage_.size() - end_};
     }
 
-    bool ProtocolParser::HandleArrayHeader(const std::string &line, std::vector<std::string> &argv, int &remaining_args) {
-        if (line.empty() || line[0] != '*') {
-            ZEN_LOG_WARN("Protocol error: expected array header");
-            return false;
+    void ReadBuffer::Compact() {
+        if (begin_ == 0) return;
+        size_t remaining = end_ - begin_;
+        if (remaining > 0) {
+            std::memmove(storage_.data(), storage_.data() + begin_, remaining);
         }
-
-        try {
-            int64_t arg_count = std::stoll(line.substr(1));
-            if (arg_count < 0) {
-                throw std::invalid_argument("Negative argument count");
-            }
-
-            remaining_args = static_cast<int>(arg_count);
-            argv.clear();
-            argv.reserve(remaining_args);
-
-            ZEN_LOG_DEBUG("Array header parsed: {} arguments", remaining_args);
-            parse_state_ = ParseState::ReadingBulkHeader;
-            return true;
-        } catch (...) {
-            ZEN_LOG_WARN("Invalid argument count");
-            return false;
+        begin_ = 0;
+        end_ = remaining;
+        if (remaining == 0 && storage_.size() > 4 * kDefaultCapacity) {
+            std::vector<char>(kDefaultCapacity).swap(storage_);
         }
     }
 
-    bool ProtocolParser::HandleBulkHeader(const std::string &line, int &current_bulk_size) {
-        if (line.empty() || line[0] != '$') {
-            ZEN_LOG_WARN("Protocol error: expected bulk header");
-            return false;
+    void ReadBuffer::Clear() {
+        begin_ = end_ = 0;
+        if (storage_.size() > 4 * kDefaultCapacity) {
+            std::vector<char>(kDefaultCapacity).swap(storage_);
         }
+    }
 
-        try {
-            int64_t bulk_size = std::stoll(line.substr(1));
-            if (bulk_size < -1) {
-                throw std::invalid_argument("Invalid bulk size");
-            }
-
-            current_bulk_size = static_cast<int>(bulk_size);
-            ZEN_LOG_DEBUG("Bulk string size: {}", current_bulk_size);
-
-            parse_state_ = ParseState::ReadingBulkContent;
-
-            if (current_bulk_size == -1) {
-                parse_state_ = ParseState::ReadingBulkHeader;
-                return true;
+    ProtocolParser::ProtocolParser()
+        : parse_state_(ParseState::ReadingArrayHeader),
+          cursor_(0),
+          remaining_args_(0),
+          current_bulk_size_(0),
+          large_filled_(0),
+          max_bulk_length_(kMaxBulkLength) {}
+
+    ProtocolParser::Result ProtocolParser::Parse(std::string_view input, std::vector<std::string_view> &argv, size_t &consumed) {
+        while (true) {
+            switch (parse_state_) {
+                case ParseState::ReadingArrayHeader: {
+                    int64_t arg_count;
+                    Result result = ReadHeader(input, '*', arg_count);
+                    if (result != Result::Complete) return result;
+                    if (arg_count > kMaxMultibulkLength) {
+                        return Fail("invalid multibulk length");
+                    }
+
+                    remaining_args_ = arg_count;
+                    spans_.clear();
+                    spans_.reserve(static_cast<size_t>(std::clamp<int64_t>(arg_count, 0, 1024)));
+                    parse_state_ = ParseState::ReadingBulkHeader;
+                    break;
+                }
+                case ParseState::ReadingBulkHeader: {
+                    if (remaining_args_ <= 0) {
+                        // 所有参数就绪（或 *0 / *-1 这类空命令）
+                        argv.clear();
+                        for (const auto &[offset, length]: spans_) {
+                            if (offset == kLargeArgSpan) {
+                                argv.emplace_back(large_args_[length].second);
+                            } else {
+                                argv.emplace_back(input.data() + offset, length);
+                            }
+                        }
+                        consumed = cursor_;
+                        // 移动 vector 不会移动其中的字符串，argv 中的视图保持有效
+                        completed_large_args_ = std::move(large_args_);
+                        Reset();
+                        return Result::Complete;
+                    }
+
+                    int64_t bulk_size;
+                    Result result = ReadHeader(input, '$', bulk_size);
+                    if (result != Result::Complete) return result;
+                    if (bulk_size < 0 || bulk_size > max_bulk_length_) {
+                        return Fail("invalid bulk length");
+                    }
+
+                    current_bulk_size_ = bulk_size;
+                    auto size = static_cast<size_t>(bulk_size);
+                    if (bulk_size >= kLargeBulkThreshold && input.size() - cursor_ < size + 2) {
+                        // 大参数：按最终大小分配一次，已在读缓冲中的前缀拷入，其余由会话直接读入
+                        auto &value = large_args_.emplace_back(spans_.size(), std::string(size, '\0')).second;
+                        large_filled_ = std::min(input.size() - cursor_, size);
+                        std::memcpy(value.data(), input.data() + cursor_, large_filled_);
+                        cursor_ += large_filled_;
+                        parse_state_ = ParseState::ReadingLargeBulk;
+                        break;
+                    }
+                    parse_state_ = ParseState::ReadingBulkContent;
+                    break;
+                }
+                case ParseState::ReadingLargeBulk: {
+                    // 值收全后，结尾的 CRLF 仍从读缓冲读取
+                    if (large_filled_ < static_cast<size_t>(current_bulk_size_)) return Result::NeedMore;
+                    if (input.size() - cursor_ < 2) return Result::NeedMore;
+
+                    spans_.emplace_back(kLargeArgSpan, large_args_.size() - 1);
+                    cursor_ += 2;
+                    --remaining_args_;
+                    parse_state_ = ParseState::ReadingBulkHeader;
+                    break;
+                }
+                case ParseState::ReadingBulkContent: {
+                    auto needed = static_cast<size_t>(current_bulk_size_) + 2;
+                    if (input.size() - cursor_ < needed) return Result::NeedMore;
+
+                    spans_.emplace_back(cursor_, static_cast<size_t>(current_bulk_size_));
+                    cursor_ += needed;
+                    --remaining_args_;
+                    parse_state_ = ParseState::ReadingBulkHeader;
+                    break;
+                }
             }
-
-            return true;
-        } catch (...) {
-            ZEN_LOG_WARN("Invalid bulk length");
-            return false;
         }
     }
 
-    bool ProtocolParser::HandleBulkContent(const std::string &buffer, std::string &content, int current_bulk_size) {
-        if (buffer.size() < static_cast<size_t>(current_bulk_size + 2)) {
-            ZEN_LOG_ERROR("Insufficient data for bulk content");
-            return false;
+    ProtocolParser::Result ProtocolParser::ReadHeader(std::string_view input, char prefix, int64_t &value) {
+        if (cursor_ >= input.size()) return Result::NeedMore;
+        if (input[cursor_] != prefix) {
+            return Fail(std::string("expected '") + prefix + "', got '" + input[cursor_] + "'");
         }
 
-        content = buffer.substr(0, current_bulk_size);
-        ZEN_LOG_DEBUG("Bulk content parsed: {}", content);
-        return true;
-    }
-
-    void ProtocolParser::Reset() {
-        parse_state_ = ParseState::ReadingArrayHeader;
-        remaining_args_ = 0;
-        current_bulk_size_ = 0;
-    }
-
-    ProtocolParser::ParseState ProtocolParser::GetParseState() const {
-        return parse_state_;
-    }
-
-    void ProtocolParser::SetParseState(ParseState state) {
-        parse_state_ = state;
-    }
-
-    int ProtocolParser::GetRemainingArgs() const {
-        return remaining_args_;
-    }
+        auto *begin = input.data() + cursor_;
+        auto *end = input.data() + input.size();
+        auto *cr = utils::resp::FindCR(begin, end);
+        if (cr == nullptr || cr + 1 == end) {
+            if (input.size() - cursor_ > kMaxHeaderLength) {
+                return Fail("too big header");
+            }
+            return Result::NeedMore;
+        }
+        if (cr[1] != '\n') {
+            return Fail("expected CRLF after header");
+        }
 
-    void ProtocolParser::SetRemainingArgs(int count) {
-        remaining_args_ = count;
+        if (!utils::resp::ParseInteger(begin + 1, cr, value)) {
+            return Fail(prefix == '*' ? "invalid multibulk length" : "invalid bulk length");
+        }
+        cursor_ = static_cast<size_t>(cr + 2 - input.data());
+        return Result::Complete;
     }
 
-    int ProtocolParser::GetCurrentBulkSize() const {
-        return current_bulk_size_;
+    ProtocolParser::Result ProtocolParser::Fail(std::string message) {
+        ZEN_LOG_WARN("Protocol error: {}", message);
+        error_ = std::move(message);
+        Reset();
+        return Result::Error;
     }
 
-    void ProtocolParser::SetCurrentBulkSize(int size) {
-        current_bulk_size_ = size;
+    std::pair<char *, size_t> ProtocolParser::LargeBulkWindow() {
+        if (parse_state_ != ParseState::ReadingLargeBulk) return {nullptr, 0};
+        auto &value = large_args_.back().second;
+        return {value.data() + large_filled_, value.size() - large_filled_};
     }
 
-    void ProtocolParser::ClearArgs(std::vector<std::string> &argv) {
-        argv.clear();
+    size_t ProtocolParser::ExpectedBytes() const {
+        if (parse_state_ != ParseState::ReadingBulkContent) return 0;
+        return cursor_ + static_cast<size_t>(current_bulk_size_) + 2;
     }
 
-    void ProtocolParser::ReserveArgs(std::vector<std::string> &argv, size_t count) {
-        argv.reserve(count);
+    void ProtocolParser::Reset() {
+        parse_state_ = ParseState::ReadingArrayHeader;
+        cursor_ = 0;
+        remaining_args_ = 0;
+        current_bulk_size_ = 0;
+        spans_.clear();
+        large_args_.clear();
+        large_filled_ = 0;
     }
 
-}// namespace Astra::proto
\ No newline at end of file
+}// namespace Astra::proto
@@ -1,51 +1,117 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace Astra::proto {
 
+    // 会话的读缓冲：一块连续内存，[begin_, end_) 为尚未解析的数据。
+    // 解析出的命令只推进 begin_，每次读取结束后调用一次 Compact 把剩余的半条命令挪到开头，
+    // 而不是每个 token 都 erase 一次。
+    class ReadBuffer {
+    public:
+        static constexpr size_t kDefaultCapacity = 16 * 1024;
+
+        // 保证尾部至少有 min_free 字节可写，返回可写区域
+        std::pair<char *, size_t> PrepareWrite(size_t min_free);
+
+        // 读取完成后提交写入的字节数
+        void Commit(size_t n) { end_ += n; }
+
+        // 尚未解析的数据
+        std::string_view Data() const { return {storage_.data() + begin_, end_ - begin_}; }
+
+        void Consume(size_t n) { begin_ += n; }
+
+        // 丢弃已解析的前缀；缓冲区为空且曾为大请求扩容时归还内存
+        void Compact();
+
+        void Clear();
+
+    private:
+        std::vector<char> storage_;
+        size_t begin_ = 0;
+        size_t end_ = 0;
+    };
+
+    // 增量 RESP 请求解析器
+    // 在读缓冲上用游标前进，参数以 string_view 给出，不做任何拷贝或 erase；
+    // 命令不完整时记住已解析到的位置和参数区间，下次从断点继续，不会重复扫描。
+    // 不小于 kLargeBulkThreshold 且尚未收全的参数走大参数路径：按声明长度一次分配最终的值，
+    // 会话把后续数据直接读进去（LargeBulkWindow/CommitLargeBulk），不再经过读缓冲扩容和拷贝。
     class ProtocolParser {
     public:
-        // 解析状态枚举
-        enum class ParseState {
-            ReadingArrayHeader,
-            ReadingBulkHeader,
-            ReadingBulkContent
+        enum class Result {
+            Complete,// argv 为一条完整命令，consumed 为其字节数
+            NeedMore,// 数据不足，等待下一次读取
+            Error    // 协议错误，应回复错误并关闭连接
         };
 
+        static constexpr int64_t kMaxMultibulkLength = 1024 * 1024;
+        static constexpr int64_t kMaxBulkLength = 512LL * 1024 * 1024;// proto-max-bulk-len 默认值
+        static constexpr size_t kMaxHeaderLength = 64 * 1024;
+        static constexpr int64_t kLargeBulkThreshold = 32 * 1024;
+
         // 构造函数
         ProtocolParser();
 
-        // 处理缓冲区中的协议数据
-        size_t ProcessBuffer(std::string &buffer, std::vector<std::string> &argv);
+        // 从 input 开头解析一条命令；input 必须以上次未完成命令的起点开头（已解析的部分不能被丢弃）。
+        // 返回 Complete 时 argv 中的视图指向 input，在缓冲区 Consume/Compact 之前有效。
+        Result Parse(std::string_view input, std::vector<std::string_view> &argv, size_t &consumed);
+
+        // 正在等待的批量数据所需的命令总字节数（相对命令起点），用于一次扩容到位；不在读取批量数据时为 0
+        size_t ExpectedBytes() const;
+
+        const std::string &ErrorMessage() const { return error_; }
+
+        // 单个参数的长度上限（proto-max-bulk-len），超过时按协议错误处理，不会为其分配内存
+        void SetMaxBulkLength(int64_t limit) { max_bulk_length_ = limit; }
+        int64_t MaxBulkLength() const { return max_bulk_length_; }
 
-        // 处理数组头（如 *3\r\n）
-        bool HandleArrayHeader(const std::string &line, std::vector<std::string> &argv, int &remaining_args);
+        // 正在直接接收的大参数中尚未填充的区域；不在接收大参数时大小为 0
+        std::pair<char *, size_t> LargeBulkWindow();
 
-        // 处理批量数据头（如 $5\r\n）
-        bool HandleBulkHeader(const std::string &line, int &current_bulk_size);
+        // 直接读入大参数后提交字节数
+        void CommitLargeBulk(size_t n) { large_filled_ += n; }
 
-        // 处理批量数据内容
-        bool HandleBulkContent(const std::string &buffer, std::string &content, int current_bulk_size);
+        // 取走上一条完整命令中直接接收的大参数（参数下标, 值），按下标升序；
+        // Parse 给出的对应视图指向这些值，取走后依然有效
+        std::vector<std::pair<size_t, std::string>> TakeLargeArgs() { return std::move(completed_large_args_); }
 
         // 重置解析器状态
         void Reset();
 
-        // Getter和Setter方法
-        ParseState GetParseState() const;
-        void SetParseState(ParseState state);
-        int GetRemainingArgs() const;
-        void SetRemainingArgs(int count);
-        int GetCurrentBulkSize() const;
-        void SetCurrentBulkSize(int size);
-        void ClearArgs(std::vector<std::string> &argv);
-        void ReserveArgs(std::vector<std::string> &argv, size_t count);
-
     private:
+        // 解析状态枚举
+        enum class ParseState {
+            ReadingArrayHeader,
+            ReadingBulkHeader,
+            ReadingBulkContent,
+            ReadingLargeBulk
+        };
+
+        // spans_ 中大参数的偏移标记，此时长度字段为 large_args_ 的下标
+        static constexpr size_t kLargeArgSpan = static_cast<size_t>(-1);
+
+        // 读取 cursor_ 处以 prefix 开头的一行整数，成功时推进 cursor_
+        Result ReadHeader(std::string_view input, char prefix, int64_t &value);
+
+        Result Fail(std::string message);
+
         ParseState parse_state_;
-        int remaining_args_;
-        int current_bulk_size_;
+        size_t cursor_;// 相对当前命令起点
+        int64_t remaining_args_;
+        int64_t current_bulk_size_;
+        std::vector<std::pair<size_t, size_t>> spans_;// 已解析参数的 (偏移, 长度)
+        std::vector<std::pair<size_t, std::string>> large_args_;// 当前命令的大参数 (参数下标, 值)
+        std::vector<std::pair<size_t, std::string>> completed_large_args_;
+        size_t large_filled_;
+        int64_t max_bulk_length_;
+        std::string error_;
     };
 
-}// namespace Astra::proto
\ No newline at end of file
+}// namespace Astra::proto
@@ -1,5 +1,8 @@
 #pragma once
+#include <charconv>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // 兼容 MSVC 和其他系统
@@ -34,4 +37,11 @@ namespace Astra::proto {
         return true;
     }
 
+    // 整个字符串必须是合法的十进制 int64
+    inline bool ParseInt64(std::string_view text, int64_t &value) {
+        if (text.empty() || text.size() > 20) return false;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc() && ptr == text.data() + text.size();
+    }
+
 }// namespace Astra::proto
\ No newline at end of file
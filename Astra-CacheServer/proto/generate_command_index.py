@@ -16,7 +16,7 @@ def extract_commands(filepath):
         content = f.read()
 
     # 匹配命令注册结构：{"GET", ...}
-    command_pattern = re.compile(r'\{"([A-Z]+)"\s*,', re.MULTILINE)
+    command_pattern = re.compile(r'\{"([A-Z][A-Z.]*)"\s*,', re.MULTILINE)
     command_names = command_pattern.findall(content)
 
     # 去重，保持顺序
@@ -37,8 +37,10 @@ def extract_commands(filepath):
         stem = cls[:-7]  # remove "Command"
         cmd_name = ''.join([c.upper() if c.isupper() or i == 0 else c for i, c in enumerate(stem)])
         cmd_name = re.sub(r'([A-Z])', r'\1', cmd_name).upper()  # 全大写
-        if cmd_name in ordered_commands:
-            command_to_class[cmd_name] = cls
+        # 带点号的模块命令（如 COUNTER.CREATE）对应的类名不含点号
+        for cmd in ordered_commands:
+            if cmd.replace('.', '') == cmd_name:
+                command_to_class[cmd] = cls
 
     result = []
     for cmd in ordered_commands:
@@ -0,0 +1,67 @@
+// hello.hpp
+#pragma once
+#include "command_parser.hpp"
+#include "resp_builder.hpp"
+#include "server/server_status.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Astra::proto {
+
+    // HELLO [protover [AUTH username password] [SETNAME clientname]]
+    // 协议版本是连接状态，由 Session 在 Strand 上切换；这里只做参数校验和回复内容
+    struct HelloRequest {
+        std::optional<RespProtocol> protocol;// 未指定时保持连接当前的版本
+    };
+
+    inline std::optional<std::string> ParseHelloRequest(const std::vector<std::string> &argv, HelloRequest &request) {
+        if (argv.size() >= 2) {
+            int64_t version;
+            if (!ParseInt64(argv[1], version)) {
+                return RespBuilder::Error("Protocol version is not an integer or out of range");
+            }
+            if (version != 2 && version != 3) {
+                return std::string("-NOPROTO unsupported protocol version\r\n");
+            }
+            request.protocol = static_cast<RespProtocol>(version);
+        }
+        for (size_t i = 2; i < argv.size(); ++i) {
+            if (ICaseCmp(argv[i], "AUTH") && i + 2 < argv.size()) {
+                // 服务器不做认证，只有无密码的 default 用户
+                if (argv[i + 1] != "default") {
+                    return std::string("-WRONGPASS invalid username-password pair or user is disabled.\r\n");
+                }
+                i += 2;
+            } else if (ICaseCmp(argv[i], "SETNAME") && i + 1 < argv.size()) {
+                i += 1;
+            } else {
+                return RespBuilder::Error("Syntax error in HELLO option '" + argv[i] + "'");
+            }
+        }
+        return std::nullopt;
+    }
+
+    // 回复格式取决于调用方设置的协议版本：RESP3 为 map，RESP2 为扁平数组
+    inline std::string HelloReply(RespProtocol protocol, uint64_t client_id) {
+        const auto &status = apps::ServerStatusInstance::GetInstance()->getStatus();
+        std::vector<std::string> fields;
+        fields.push_back(RespBuilder::BulkString("server"));
+        fields.push_back(RespBuilder::BulkString(status.server_name.empty() ? "astra" : status.server_name));
+        fields.push_back(RespBuilder::BulkString("version"));
+        fields.push_back(RespBuilder::BulkString(status.version));
+        fields.push_back(RespBuilder::BulkString("proto"));
+        fields.push_back(RespBuilder::Integer(static_cast<int64_t>(protocol)));
+        fields.push_back(RespBuilder::BulkString("id"));
+        fields.push_back(RespBuilder::Integer(static_cast<int64_t>(client_id)));
+        fields.push_back(RespBuilder::BulkString("mode"));
+        fields.push_back(RespBuilder::BulkString(status.mode.empty() ? "standalone" : status.mode));
+        fields.push_back(RespBuilder::BulkString("role"));
+        fields.push_back(RespBuilder::BulkString("master"));
+        fields.push_back(RespBuilder::BulkString("modules"));
+        fields.push_back(RespBuilder::Array({}));
+        return RespBuilder::Map(fields);
+    }
+
+}// namespace Astra::proto
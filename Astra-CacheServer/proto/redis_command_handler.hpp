@@ -59,27 +59,88 @@ namespace Astra::proto {
             if (cmd == "INFO") return std::make_unique<InfoCommand>();
             if (cmd == "GET") return std::make_unique<GetCommand>(cache_);
             if (cmd == "SET") return std::make_unique<SetCommand>(cache_);
+            if (cmd == "SETNX") return std::make_unique<SetNxCommand>(cache_);
+            if (cmd == "SETEX") return std::make_unique<SetExCommand>(cache_);
+            if (cmd == "PSETEX") return std::make_unique<PSetExCommand>(cache_);
+            if (cmd == "MSETNX") return std::make_unique<MSetNxCommand>(cache_);
+            if (cmd == "GETDEL") return std::make_unique<GetDelCommand>(cache_);
+            if (cmd == "GETEX") return std::make_unique<GetExCommand>(cache_);
             if (cmd == "DEL") return std::make_unique<DelCommand>(cache_);
             if (cmd == "PING") return std::make_unique<PingCommand>();
             if (cmd == "KEYS") return std::make_unique<KeysCommand>(cache_);
             if (cmd == "TTL") return std::make_unique<TtlCommand>(cache_);
+            if (cmd == "PTTL") return std::make_unique<PTtlCommand>(cache_);
             if (cmd == "INCR") return std::make_unique<IncrCommand>(cache_);
             if (cmd == "INCRBY") return std::make_unique<IncrByCommand>(cache_);
             if (cmd == "DECR") return std::make_unique<DecrCommand>(cache_);
             if (cmd == "DECRBY") return std::make_unique<DecrByCommand>(cache_);
+            if (cmd == "INCRBYFLOAT") return std::make_unique<IncrByFloatCommand>(cache_);
+            if (cmd == "COUNTER.CREATE") return std::make_unique<CounterCreateCommand>(cache_);
+            if (cmd == "COUNTER.GET") return std::make_unique<CounterGetCommand>(cache_);
+            if (cmd == "COUNTER.DROP") return std::make_unique<CounterDropCommand>(cache_);
             if (cmd == "EXISTS") return std::make_unique<ExistsCommand>(cache_);
             if (cmd == "MGET") return std::make_unique<MGetCommand>(cache_);
             if (cmd == "MSET") return std::make_unique<MSetCommand>(cache_);
+            if (cmd == "APPEND") return std::make_unique<AppendCommand>(cache_);
+            if (cmd == "SETRANGE") return std::make_unique<SetRangeCommand>(cache_);
+            if (cmd == "GETRANGE") return std::make_unique<GetRangeCommand>(cache_);
+            if (cmd == "STRLEN") return std::make_unique<StrLenCommand>(cache_);
+            // Bitmap commands
+            if (cmd == "SETBIT") return std::make_unique<SetBitCommand>(cache_);
+            if (cmd == "GETBIT") return std::make_unique<GetBitCommand>(cache_);
+            if (cmd == "BITCOUNT") return std::make_unique<BitCountCommand>(cache_);
+            if (cmd == "BITPOS") return std::make_unique<BitPosCommand>(cache_);
+            if (cmd == "BITOP") return std::make_unique<BitOpCommand>(cache_);
+            if (cmd == "BITFIELD") return std::make_unique<BitFieldCommand>(cache_);
+
+            // HyperLogLog commands
+            if (cmd == "PFADD") return std::make_unique<PfAddCommand>(cache_);
+            if (cmd == "PFCOUNT") return std::make_unique<PfCountCommand>(cache_);
+            if (cmd == "PFMERGE") return std::make_unique<PfMergeCommand>(cache_);
+            // Bloom filter commands
+            if (cmd == "BF.RESERVE") return std::make_unique<BfReserveCommand>(cache_);
+            if (cmd == "BF.ADD") return std::make_unique<BfAddCommand>(cache_);
+            if (cmd == "BF.MADD") return std::make_unique<BfMAddCommand>(cache_);
+            if (cmd == "BF.EXISTS") return std::make_unique<BfExistsCommand>(cache_);
+            if (cmd == "BF.MEXISTS") return std::make_unique<BfMExistsCommand>(cache_);
+            if (cmd == "BF.INFO") return std::make_unique<BfInfoCommand>(cache_);
+            // Count-Min Sketch / Top-K commands
+            if (cmd == "CMS.INITBYDIM") return std::make_unique<CmsInitByDimCommand>(cache_);
+            if (cmd == "CMS.INITBYPROB") return std::make_unique<CmsInitByProbCommand>(cache_);
+            if (cmd == "CMS.INCRBY") return std::make_unique<CmsIncrByCommand>(cache_);
+            if (cmd == "CMS.QUERY") return std::make_unique<CmsQueryCommand>(cache_);
+            if (cmd == "CMS.INFO") return std::make_unique<CmsInfoCommand>(cache_);
+            if (cmd == "TOPK.RESERVE") return std::make_unique<TopKReserveCommand>(cache_);
+            if (cmd == "TOPK.ADD") return std::make_unique<TopKAddCommand>(cache_);
+            if (cmd == "TOPK.INCRBY") return std::make_unique<TopKIncrByCommand>(cache_);
+            if (cmd == "TOPK.QUERY") return std::make_unique<TopKQueryCommand>(cache_);
+            if (cmd == "TOPK.LIST") return std::make_unique<TopKListCommand>(cache_);
+            if (cmd == "TOPK.INFO") return std::make_unique<TopKInfoCommand>(cache_);
             // Hash commands
             if (cmd == "HSET") return std::make_unique<HSetCommand>(cache_);
             if (cmd == "HGET") return std::make_unique<HGetCommand>(cache_);
             if (cmd == "HGETALL") return std::make_unique<HGetAllCommand>(cache_);
+            if (cmd == "HMSET") return std::make_unique<HMSetCommand>(cache_);
+            if (cmd == "HMGET") return std::make_unique<HMGetCommand>(cache_);
+            if (cmd == "HSETNX") return std::make_unique<HSetNxCommand>(cache_);
+            if (cmd == "HSTRLEN") return std::make_unique<HStrLenCommand>(cache_);
+            if (cmd == "HINCRBY") return std::make_unique<HIncrByCommand>(cache_);
+            if (cmd == "HINCRBYFLOAT") return std::make_unique<HIncrByFloatCommand>(cache_);
+            if (cmd == "HDEL") return std::make_unique<HDelCommand>(cache_);
+            if (cmd == "HLEN") return std::make_unique<HLenCommand>(cache_);
+            if (cmd == "HEXISTS") return std::make_unique<HExistsCommand>(cache_);
+            if (cmd == "HKEYS") return std::make_unique<HKeysCommand>(cache_);
+            if (cmd == "HVALS") return std::make_unique<HValsCommand>(cache_);
+            if (cmd == "HSCAN") return std::make_unique<HScanCommand>(cache_);
 
             // List commands
             if (cmd == "LPUSH") return std::make_unique<LPushCommand>(cache_);
             if (cmd == "RPUSH") return std::make_unique<RPushCommand>(cache_);
             if (cmd == "LPOP") return std::make_unique<LPopCommand>(cache_);
             if (cmd == "RPOP") return std::make_unique<RPopCommand>(cache_);
+            if (cmd == "BLPOP") return std::make_unique<BLPopCommand>(cache_);
+            if (cmd == "BRPOP") return std::make_unique<BRPopCommand>(cache_);
+            if (cmd == "BLMOVE") return std::make_unique<BLMoveCommand>(cache_);
             if (cmd == "LLEN") return std::make_unique<LLenCommand>(cache_);
             if (cmd == "LRANGE") return std::make_unique<LRangeCommand>(cache_);
             if (cmd == "LINDEX") return std::make_unique<LIndexCommand>(cache_);
@@ -89,8 +150,16 @@ namespace Astra::proto {
             if (cmd == "SREM") return std::make_unique<SRemCommand>(cache_);
             if (cmd == "SCARD") return std::make_unique<SCardCommand>(cache_);
             if (cmd == "SMEMBERS") return std::make_unique<SMembersCommand>(cache_);
+            if (cmd == "SSCAN") return std::make_unique<SScanCommand>(cache_);
             if (cmd == "SISMEMBER") return std::make_unique<SIsMemberCommand>(cache_);
             if (cmd == "SPOP") return std::make_unique<SPopCommand>(cache_);
+            if (cmd == "SINTER") return std::make_unique<SInterCommand>(cache_);
+            if (cmd == "SUNION") return std::make_unique<SUnionCommand>(cache_);
+            if (cmd == "SDIFF") return std::make_unique<SDiffCommand>(cache_);
+            if (cmd == "SINTERSTORE") return std::make_unique<SInterStoreCommand>(cache_);
+            if (cmd == "SUNIONSTORE") return std::make_unique<SUnionStoreCommand>(cache_);
+            if (cmd == "SDIFFSTORE") return std::make_unique<SDiffStoreCommand>(cache_);
+            if (cmd == "SINTERCARD") return std::make_unique<SInterCardCommand>(cache_);
 
             // ZSet commands
             if (cmd == "ZADD") return std::make_unique<ZAddCommand>(cache_);
@@ -98,7 +167,29 @@ namespace Astra::proto {
             if (cmd == "ZCARD") return std::make_unique<ZCardCommand>(cache_);
             if (cmd == "ZRANGE") return std::make_unique<ZRangeCommand>(cache_);
             if (cmd == "ZRANGEBYSCORE") return std::make_unique<ZRangeByScoreCommand>(cache_);
+            if (cmd == "ZSCAN") return std::make_unique<ZScanCommand>(cache_);
             if (cmd == "ZSCORE") return std::make_unique<ZScoreCommand>(cache_);
+            // Geo commands
+            if (cmd == "GEOADD") return std::make_unique<GeoAddCommand>(cache_);
+            if (cmd == "GEOPOS") return std::make_unique<GeoPosCommand>(cache_);
+            if (cmd == "GEODIST") return std::make_unique<GeoDistCommand>(cache_);
+            if (cmd == "GEOSEARCH") return std::make_unique<GeoSearchCommand>(cache_);
+            if (cmd == "JSON.SET") return std::make_unique<JsonSetCommand>(cache_);
+            if (cmd == "JSON.GET") return std::make_unique<JsonGetCommand>(cache_);
+            if (cmd == "JSON.NUMINCRBY") return std::make_unique<JsonNumIncrByCommand>(cache_);
+            if (cmd == "JSON.ARRAPPEND") return std::make_unique<JsonArrAppendCommand>(cache_);
+            if (cmd == "JSON.DEL") return std::make_unique<JsonDelCommand>(cache_);
+
+            // Stream commands
+            if (cmd == "XADD") return std::make_unique<XAddCommand>(cache_);
+            if (cmd == "XLEN") return std::make_unique<XLenCommand>(cache_);
+            if (cmd == "XRANGE") return std::make_unique<XRangeCommand>(cache_);
+            if (cmd == "XREVRANGE") return std::make_unique<XRevRangeCommand>(cache_);
+            if (cmd == "XREAD") return std::make_unique<XReadCommand>(cache_);
+            if (cmd == "XREADGROUP") return std::make_unique<XReadGroupCommand>(cache_);
+            if (cmd == "XGROUP") return std::make_unique<XGroupCommand>(cache_);
+            if (cmd == "XACK") return std::make_unique<XAckCommand>(cache_);
+            if (cmd == "XPENDING") return std::make_unique<XPendingCommand>(cache_);
 
             // Pub/Sub 命令（新增逻辑）
             if (cmd == "PUBSUB") {
@@ -130,16 +221,57 @@ namespace Astra::proto {
             // 使用宏来注册所有支持的、构造函数只需要 cache_ 的命令
             REGISTER_LUA_CACHE_COMMAND("get", GetCommand);
             REGISTER_LUA_CACHE_COMMAND("set", SetCommand);
+            REGISTER_LUA_CACHE_COMMAND("setnx", SetNxCommand);
+            REGISTER_LUA_CACHE_COMMAND("setex", SetExCommand);
+            REGISTER_LUA_CACHE_COMMAND("psetex", PSetExCommand);
+            REGISTER_LUA_CACHE_COMMAND("msetnx", MSetNxCommand);
+            REGISTER_LUA_CACHE_COMMAND("getdel", GetDelCommand);
+            REGISTER_LUA_CACHE_COMMAND("getex", GetExCommand);
             REGISTER_LUA_CACHE_COMMAND("del", DelCommand);
             REGISTER_LUA_CACHE_COMMAND("exists", ExistsCommand);
             REGISTER_LUA_CACHE_COMMAND("incr", IncrCommand);
             REGISTER_LUA_CACHE_COMMAND("incrby", IncrByCommand);
             REGISTER_LUA_CACHE_COMMAND("decr", DecrCommand);
             REGISTER_LUA_CACHE_COMMAND("decrby", DecrByCommand);
+            REGISTER_LUA_CACHE_COMMAND("incrbyfloat", IncrByFloatCommand);
+            REGISTER_LUA_CACHE_COMMAND("counter.create", CounterCreateCommand);
+            REGISTER_LUA_CACHE_COMMAND("counter.get", CounterGetCommand);
+            REGISTER_LUA_CACHE_COMMAND("counter.drop", CounterDropCommand);
             REGISTER_LUA_CACHE_COMMAND("ttl", TtlCommand);
+            REGISTER_LUA_CACHE_COMMAND("pttl", PTtlCommand);
             REGISTER_LUA_CACHE_COMMAND("mget", MGetCommand);
             REGISTER_LUA_CACHE_COMMAND("mset", MSetCommand);
+            REGISTER_LUA_CACHE_COMMAND("append", AppendCommand);
+            REGISTER_LUA_CACHE_COMMAND("setrange", SetRangeCommand);
+            REGISTER_LUA_CACHE_COMMAND("getrange", GetRangeCommand);
+            REGISTER_LUA_CACHE_COMMAND("strlen", StrLenCommand);
             REGISTER_LUA_CACHE_COMMAND("keys", KeysCommand);
+            REGISTER_LUA_CACHE_COMMAND("setbit", SetBitCommand);
+            REGISTER_LUA_CACHE_COMMAND("getbit", GetBitCommand);
+            REGISTER_LUA_CACHE_COMMAND("bitcount", BitCountCommand);
+            REGISTER_LUA_CACHE_COMMAND("bitpos", BitPosCommand);
+            REGISTER_LUA_CACHE_COMMAND("bitop", BitOpCommand);
+            REGISTER_LUA_CACHE_COMMAND("bitfield", BitFieldCommand);
+            REGISTER_LUA_CACHE_COMMAND("pfadd", PfAddCommand);
+            REGISTER_LUA_CACHE_COMMAND("pfcount", PfCountCommand);
+            REGISTER_LUA_CACHE_COMMAND("pfmerge", PfMergeCommand);
+            REGISTER_LUA_CACHE_COMMAND("bf.reserve", BfReserveCommand);
+            REGISTER_LUA_CACHE_COMMAND("bf.add", BfAddCommand);
+            REGISTER_LUA_CACHE_COMMAND("bf.madd", BfMAddCommand);
+            REGISTER_LUA_CACHE_COMMAND("bf.exists", BfExistsCommand);
+            REGISTER_LUA_CACHE_COMMAND("bf.mexists", BfMExistsCommand);
+            REGISTER_LUA_CACHE_COMMAND("bf.info", BfInfoCommand);
+            REGISTER_LUA_CACHE_COMMAND("cms.initbydim", CmsInitByDimCommand);
+            REGISTER_LUA_CACHE_COMMAND("cms.initbyprob", CmsInitByProbCommand);
+            REGISTER_LUA_CACHE_COMMAND("cms.incrby", CmsIncrByCommand);
+            REGISTER_LUA_CACHE_COMMAND("cms.query", CmsQueryCommand);
+            REGISTER_LUA_CACHE_COMMAND("cms.info", CmsInfoCommand);
+            REGISTER_LUA_CACHE_COMMAND("topk.reserve", TopKReserveCommand);
+            REGISTER_LUA_CACHE_COMMAND("topk.add", TopKAddCommand);
+            REGISTER_LUA_CACHE_COMMAND("topk.incrby", TopKIncrByCommand);
+            REGISTER_LUA_CACHE_COMMAND("topk.query", TopKQueryCommand);
+            REGISTER_LUA_CACHE_COMMAND("topk.list", TopKListCommand);
+            REGISTER_LUA_CACHE_COMMAND("topk.info", TopKInfoCommand);
             // ... 为其他需要在 Lua 中调用的、只需要 cache_ 的命令添加注册行 ...
 
             // 注册Hash命令
@@ -151,6 +283,13 @@ namespace Astra::proto {
             REGISTER_LUA_CACHE_COMMAND("hexists", HExistsCommand);
             REGISTER_LUA_CACHE_COMMAND("hkeys", HKeysCommand);
             REGISTER_LUA_CACHE_COMMAND("hvals", HValsCommand);
+            REGISTER_LUA_CACHE_COMMAND("hmset", HMSetCommand);
+            REGISTER_LUA_CACHE_COMMAND("hmget", HMGetCommand);
+            REGISTER_LUA_CACHE_COMMAND("hsetnx", HSetNxCommand);
+            REGISTER_LUA_CACHE_COMMAND("hstrlen", HStrLenCommand);
+            REGISTER_LUA_CACHE_COMMAND("hincrby", HIncrByCommand);
+            REGISTER_LUA_CACHE_COMMAND("hincrbyfloat", HIncrByFloatCommand);
+            REGISTER_LUA_CACHE_COMMAND("hscan", HScanCommand);
 
             // 注册List命令
             REGISTER_LUA_CACHE_COMMAND("lpush", LPushCommand);
@@ -158,6 +297,9 @@ namespace Astra::proto {
             REGISTER_LUA_CACHE_COMMAND("lpop", LPopCommand);
             REGISTER_LUA_CACHE_COMMAND("rpop", RPopCommand);
             REGISTER_LUA_CACHE_COMMAND("llen", LLenCommand);
+            REGISTER_LUA_CACHE_COMMAND("blpop", BLPopCommand);
+            REGISTER_LUA_CACHE_COMMAND("brpop", BRPopCommand);
+            REGISTER_LUA_CACHE_COMMAND("blmove", BLMoveCommand);
             REGISTER_LUA_CACHE_COMMAND("lrange", LRangeCommand);
             REGISTER_LUA_CACHE_COMMAND("lindex", LIndexCommand);
 
@@ -166,8 +308,16 @@ namespace Astra::proto {
             REGISTER_LUA_CACHE_COMMAND("srem", SRemCommand);
             REGISTER_LUA_CACHE_COMMAND("scard", SCardCommand);
             REGISTER_LUA_CACHE_COMMAND("smembers", SMembersCommand);
+            REGISTER_LUA_CACHE_COMMAND("sscan", SScanCommand);
             REGISTER_LUA_CACHE_COMMAND("sismember", SIsMemberCommand);
             REGISTER_LUA_CACHE_COMMAND("spop", SPopCommand);
+            REGISTER_LUA_CACHE_COMMAND("sinter", SInterCommand);
+            REGISTER_LUA_CACHE_COMMAND("sunion", SUnionCommand);
+            REGISTER_LUA_CACHE_COMMAND("sdiff", SDiffCommand);
+            REGISTER_LUA_CACHE_COMMAND("sinterstore", SInterStoreCommand);
+            REGISTER_LUA_CACHE_COMMAND("sunionstore", SUnionStoreCommand);
+            REGISTER_LUA_CACHE_COMMAND("sdiffstore", SDiffStoreCommand);
+            REGISTER_LUA_CACHE_COMMAND("sintercard", SInterCardCommand);
 
             // 注册ZSet命令
             REGISTER_LUA_CACHE_COMMAND("zadd", ZAddCommand);
@@ -175,7 +325,26 @@ namespace Astra::proto {
             REGISTER_LUA_CACHE_COMMAND("zcard", ZCardCommand);
             REGISTER_LUA_CACHE_COMMAND("zrange", ZRangeCommand);
             REGISTER_LUA_CACHE_COMMAND("zrangebyscore", ZRangeByScoreCommand);
+            REGISTER_LUA_CACHE_COMMAND("zscan", ZScanCommand);
             REGISTER_LUA_CACHE_COMMAND("zscore", ZScoreCommand);
+            REGISTER_LUA_CACHE_COMMAND("geoadd", GeoAddCommand);
+            REGISTER_LUA_CACHE_COMMAND("geopos", GeoPosCommand);
+            REGISTER_LUA_CACHE_COMMAND("geodist", GeoDistCommand);
+            REGISTER_LUA_CACHE_COMMAND("geosearch", GeoSearchCommand);
+            REGISTER_LUA_CACHE_COMMAND("json.set", JsonSetCommand);
+            REGISTER_LUA_CACHE_COMMAND("json.get", JsonGetCommand);
+            REGISTER_LUA_CACHE_COMMAND("json.numincrby", JsonNumIncrByCommand);
+            REGISTER_LUA_CACHE_COMMAND("json.arrappend", JsonArrAppendCommand);
+            REGISTER_LUA_CACHE_COMMAND("json.del", JsonDelCommand);
+            REGISTER_LUA_CACHE_COMMAND("xadd", XAddCommand);
+            REGISTER_LUA_CACHE_COMMAND("xlen", XLenCommand);
+            REGISTER_LUA_CACHE_COMMAND("xrange", XRangeCommand);
+            REGISTER_LUA_CACHE_COMMAND("xrevrange", XRevRangeCommand);
+            REGISTER_LUA_CACHE_COMMAND("xread", XReadCommand);
+            REGISTER_LUA_CACHE_COMMAND("xreadgroup", XReadGroupCommand);
+            REGISTER_LUA_CACHE_COMMAND("xgroup", XGroupCommand);
+            REGISTER_LUA_CACHE_COMMAND("xack", XAckCommand);
+            REGISTER_LUA_CACHE_COMMAND("xpending", XPendingCommand);
 
             // 使用宏注册需要 channel_manager_ 的命令
             // 注意：SUBSCRIBE/UNSUBSCRIBE/PSUBSCRIBE/PUNSUBSCRIBE 通常不在此注册
@@ -193,6 +362,11 @@ namespace Astra::proto {
     };
 
     // RedisCommandHandler：保持统一接口，自动处理所有命令（包括 Pub/Sub）
+    // 线程安全性：ProcessCommand 只读取工厂中构造后不再修改的成员，每次调用新建命令对象，
+    // 带键命令的状态都在缓存和全局管理器（ZSet/Stream/Json/Blocking/Counter）中，各自加锁，
+    // 因此分片模式下同一会话的带键命令可以在不同核心上并发执行。
+    // 例外是会话内的 Lua 解释器和会话状态（EVAL/EVALSHA、CLIENT、SUBSCRIBE 等），它们不是线程安全的，
+    // 这些命令在命令表中无键，由 ShardRouter 路由为屏障，执行时该会话没有其他命令在途
     class RedisCommandHandler {
     public:
         // 构造函数：传入缓存和频道管理器
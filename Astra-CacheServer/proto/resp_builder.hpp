@@ -1,21 +1,54 @@
 // resp_builder.hpp
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
 
 namespace Astra::proto {
 
+    // 连接协商的协议版本，默认 RESP2，客户端用 HELLO 3 切换
+    enum class RespProtocol : uint8_t {
+        Resp2 = 2,
+        Resp3 = 3
+    };
+
     class RespBuilder {
     public:
-        static std::string BulkString(const std::string &str) noexcept;
+        // 当前线程正在为哪种协议构造回复。命令本身不感知连接，
+        // 由会话在执行命令（以及在别的线程上替它构造回复）时用 ProtocolScope 设置
+        static RespProtocol Protocol() noexcept { return CurrentProtocol(); }
+
+        class ProtocolScope {
+        public:
+            explicit ProtocolScope(RespProtocol protocol) noexcept : saved_(CurrentProtocol()) {
+                CurrentProtocol() = protocol;
+            }
+            ~ProtocolScope() { CurrentProtocol() = saved_; }
+            ProtocolScope(const ProtocolScope &) = delete;
+            ProtocolScope &operator=(const ProtocolScope &) = delete;
+
+        private:
+            RespProtocol saved_;
+        };
+
+        static std::string BulkString(std::string_view str) noexcept;
         static std::string Integer(int64_t value) noexcept;
         static std::string Array(const std::vector<std::string> &elements) noexcept;
         static std::string SimpleString(const std::string &str) noexcept;
         static std::string Nil() noexcept;
+        static std::string NullArray() noexcept;
         static std::string Error(const std::string &str) noexcept;
 
+        // RESP3 类型，RESP2 连接上退化为等价的 RESP2 形式
+        static std::string Map(const std::vector<std::string> &pairs) noexcept;      // 键值交替排列；RESP2 为扁平数组
+        static std::string Set(const std::vector<std::string> &elements) noexcept;   // RESP2 为数组
+        static std::string Double(std::string_view text) noexcept;                  // 已格式化的数值；RESP2 为批量字符串
+        static std::string Push(const std::vector<std::string> &elements) noexcept;  // 带外推送；RESP2 为数组
+        static std::string Attribute(const std::vector<std::string> &pairs) noexcept;// 放在所修饰的回复之前；RESP2 下省略
+
         // PUB/SUB 专用响应构建方法（新增）
         static std::string SubscribeResponse(const std::unordered_set<std::string> &channels) noexcept;
         static std::string UnsubscribeResponse(const std::unordered_set<std::string> &channels) noexcept;
@@ -35,6 +68,14 @@ namespace Astra::proto {
         static std::string PUnsubscribeResponse(
                 const std::unordered_set<std::string> &patterns,
                 size_t remaining) noexcept;
+
+    private:
+        static RespProtocol &CurrentProtocol() noexcept {
+            thread_local RespProtocol protocol = RespProtocol::Resp2;
+            return protocol;
+        }
+
+        static std::string Aggregate(char prefix, size_t count, const std::vector<std::string> &elements) noexcept;
     };
 
     // 实现错误响应格式
@@ -42,8 +83,13 @@ namespace Astra::proto {
         return "-ERR " + str + "\r\n";
     }
 
-    inline std::string RespBuilder::BulkString(const std::string &str) noexcept {
-        return "$" + std::to_string(str.size()) + "\r\n" + str + "\r\n";
+    // 只做一次分配；接受 string_view，调用方可以直接回复值的一个切片
+    inline std::string RespBuilder::BulkString(std::string_view str) noexcept {
+        std::string header = "$" + std::to_string(str.size()) + "\r\n";
+        std::string result;
+        result.reserve(header.size() + str.size() + 2);
+        result.append(header).append(str).append("\r\n");
+        return result;
     }
 
     inline std::string RespBuilder::Integer(int64_t value) noexcept {
@@ -54,19 +100,61 @@ namespace Astra::proto {
         return "+" + str + "\r\n";
     }
 
+    // RESP3 只有一种空值
     inline std::string RespBuilder::Nil() noexcept {
-        return "$-1\r\n";
+        return Protocol() == RespProtocol::Resp3 ? "_\r\n" : "$-1\r\n";
     }
 
-    inline std::string RespBuilder::Array(const std::vector<std::string> &elements) noexcept {
-        std::string result = "*" + std::to_string(elements.size()) + "\r\n";
+    inline std::string RespBuilder::NullArray() noexcept {
+        return Protocol() == RespProtocol::Resp3 ? "_\r\n" : "*-1\r\n";
+    }
+
+    inline std::string RespBuilder::Aggregate(char prefix, size_t count, const std::vector<std::string> &elements) noexcept {
+        std::string result(1, prefix);
+        result += std::to_string(count);
+        result += "\r\n";
         for (const auto &item: elements) {
             result += item;
         }
         return result;
     }
 
-    // PUB/SUB 响应实现（新增）
+    inline std::string RespBuilder::Array(const std::vector<std::string> &elements) noexcept {
+        return Aggregate('*', elements.size(), elements);
+    }
+
+    inline std::string RespBuilder::Map(const std::vector<std::string> &pairs) noexcept {
+        if (Protocol() == RespProtocol::Resp3) {
+            return Aggregate('%', pairs.size() / 2, pairs);
+        }
+        return Array(pairs);
+    }
+
+    inline std::string RespBuilder::Set(const std::vector<std::string> &elements) noexcept {
+        return Aggregate(Protocol() == RespProtocol::Resp3 ? '~' : '*', elements.size(), elements);
+    }
+
+    inline std::string RespBuilder::Double(std::string_view text) noexcept {
+        if (Protocol() == RespProtocol::Resp3) {
+            std::string result = ",";
+            result.append(text).append("\r\n");
+            return result;
+        }
+        return BulkString(text);
+    }
+
+    inline std::string RespBuilder::Push(const std::vector<std::string> &elements) noexcept {
+        return Aggregate(Protocol() == RespProtocol::Resp3 ? '>' : '*', elements.size(), elements);
+    }
+
+    inline std::string RespBuilder::Attribute(const std::vector<std::string> &pairs) noexcept {
+        if (Protocol() == RespProtocol::Resp3) {
+            return Aggregate('|', pairs.size() / 2, pairs);
+        }
+        return {};
+    }
+
+    // PUB/SUB 响应实现（新增）：RESP3 连接上订阅确认和消息都是推送帧，RESP2 下仍为数组
     inline std::string RespBuilder::SubscribeResponse(const std::unordered_set<std::string> &channels) noexcept {
         std::string response;
         // 为每个订阅的频道生成响应
@@ -77,7 +165,7 @@ namespace Astra::proto {
                     BulkString(channel),    // 第二个元素：频道名
                     Integer(channels.size())// 第三个元素：当前订阅总数
             };
-            response += Array(elements);// 拼接数组响应
+            response += Push(elements);// RESP3 下为推送帧
         }
         return response;
     }
@@ -92,7 +180,7 @@ namespace Astra::proto {
                     BulkString(channel),      // 第二个元素：频道名
                     Integer(channels.size())  // 第三个元素：剩余订阅数（取消后的值）
             };
-            response += Array(elements);// 拼接数组响应
+            response += Push(elements);// RESP3 下为推送帧
         }
         return response;
     }
@@ -105,7 +193,7 @@ namespace Astra::proto {
         elements.push_back(BulkString(type));
         elements.push_back(BulkString(channel));
         elements.push_back(BulkString(message));
-        return Array(elements);
+        return Push(elements);
     }
 
     // 模式消息响应 (pmessage类型)
@@ -118,7 +206,7 @@ namespace Astra::proto {
         elements.push_back(BulkString(pattern));
         elements.push_back(BulkString(channel));
         elements.push_back(BulkString(message));
-        return Array(elements);
+        return Push(elements);
     }
 
     // 正确：用当前会话的订阅数作为第3个字段
@@ -135,7 +223,7 @@ namespace Astra::proto {
             elements.push_back(Integer(session_pattern_count));// 当前会话的订阅总数
 
             // 每个模式的响应单独作为一个数组，拼接到最终响应中
-            response += Array(elements);
+            response += Push(elements);
         }
         return response;
     }
@@ -149,7 +237,7 @@ namespace Astra::proto {
             elements.push_back(BulkString("punsubscribe"));
             elements.push_back(BulkString(pattern));// 正确填入被取消的模式
             elements.push_back(Integer(remaining));
-            response += Array(elements);
+            response += Push(elements);
         }
         // 若未传入任何模式（如无参数取消），返回 nil
         if (patterns.empty()) {
@@ -157,7 +245,7 @@ namespace Astra::proto {
             elements.push_back(BulkString("punsubscribe"));
             elements.push_back(Nil());// 无参数时显示 nil
             elements.push_back(Integer(remaining));
-            response += Array(elements);
+            response += Push(elements);
         }
         return response;
     }
@@ -0,0 +1,98 @@
+// scan_cursor.hpp
+#pragma once
+#include "data/redis_types.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+namespace Astra::proto {
+
+    // HSCAN/SSCAN 的游标
+    // 直接在集合的编码上从游标处继续走 COUNT 条记录，每次调用的工作量与 COUNT 成正比，不会一次性物化整个集合。
+    // 游标高 32 位是下一条记录的字节偏移，低 32 位是该记录成员名的指纹：两次调用之间集合没有变动时偏移直接命中；
+    // 变动使偏移失效时，先沿长度头走到偏移处或其后的第一条记录边界，再在边界前后有限的窗口内按指纹找回该成员。
+    // 记录按成员名有序，尚未返回的成员都不小于游标成员，所以在任何位置找回它都不会漏掉记录。
+    // 找不到（游标成员已被删除）时从第一条记录重新开始：之前的删除可能已把未返回的记录移到边界之前，
+    // 宁可重复也不遗漏（SCAN 允许重复返回）。
+
+    // FNV-1a，只用于在同一进程内校验游标
+    inline uint32_t ScanFingerprint(std::string_view member) {
+        uint32_t hash = 2166136261u;
+        for (unsigned char c: member) {
+            hash = (hash ^ c) * 16777619u;
+        }
+        return hash;
+    }
+
+    // 重新定位时在边界前、后各至多检查 COUNT 的这么多倍条记录的指纹
+    inline constexpr size_t kScanRelocateFactor = 4;
+
+    // 从游标处遍历 "长度:内容" 编码，每条记录 Chunks 块（set 为 1，hash 为 2）；
+    // 对至多 count 条记录回调 emit(record)，返回下一次调用的游标，0 表示遍历结束
+    template<size_t Chunks, typename Fn>
+    uint64_t ScanEncoded(std::string_view data, size_t prefix_len, uint64_t cursor, size_t count, Fn &&emit) {
+        std::array<std::string_view, Chunks> record;
+        auto read_record = [&](size_t &pos) {
+            for (auto &chunk: record) {
+                if (!data::ReadChunk(data, pos, chunk)) return false;
+            }
+            return true;
+        };
+
+        size_t pos = prefix_len;
+        if (cursor != 0) {
+            auto offset = static_cast<size_t>(cursor >> 32);
+            auto fingerprint = static_cast<uint32_t>(cursor);
+            size_t probe = offset;
+            if (offset >= prefix_len && offset < data.size() && read_record(probe) &&
+                ScanFingerprint(record[0]) == fingerprint) {
+                pos = offset;
+            } else {
+                // 沿长度头走到 offset 处或其后的第一条记录边界，只跳过内容、不计算指纹；
+                // 途中保留边界前最近 window 条记录的起点
+                size_t window = count * kScanRelocateFactor;
+                std::deque<size_t> before;
+                size_t boundary = prefix_len;
+                while (boundary < offset && boundary < data.size()) {
+                    size_t next = boundary;
+                    if (!read_record(next)) break;
+                    before.push_back(boundary);
+                    if (before.size() > window) before.pop_front();
+                    boundary = next;
+                }
+
+                bool found = false;
+                // 先向前找：常见的变动是之前的成员被删除，原成员随之左移
+                for (auto it = before.rbegin(); it != before.rend() && !found; ++it) {
+                    size_t probe_at = *it;
+                    if (read_record(probe_at) && ScanFingerprint(record[0]) == fingerprint) {
+                        pos = *it;
+                        found = true;
+                    }
+                }
+                // 再向后找：之前插入了新成员，原成员右移
+                size_t scan = boundary;
+                for (size_t checked = 0; !found && checked < window && scan < data.size(); ++checked) {
+                    size_t begin = scan;
+                    if (!read_record(scan)) break;
+                    if (ScanFingerprint(record[0]) == fingerprint) {
+                        pos = begin;
+                        found = true;
+                    }
+                }
+                // 游标成员已被删除：pos 保持在第一条记录
+            }
+        }
+
+        for (size_t visited = 0; pos < data.size() && visited < count; ++visited) {
+            if (!read_record(pos)) return 0;
+            emit(record);
+        }
+
+        size_t next = pos;
+        if (next >= data.size() || !read_record(next)) return 0;
+        return (static_cast<uint64_t>(pos) << 32) | ScanFingerprint(record[0]);
+    }
+
+}// namespace Astra::proto
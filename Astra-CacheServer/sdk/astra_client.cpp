@@ -2,9 +2,11 @@
 // astra_client.cpp
 #include "astra_client.hpp"
 #include "sdk/commands.hpp"
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 #include <string>
+#include <utils/resp_scan.hpp>
 #include <vector>
 
 // Windows平台网络编程头文件
@@ -128,59 +130,116 @@ namespace Astra::Client {
         }
     }
 
-    std::string ReadLine(int sockfd) {
-        std::string line;
-        char c;
+    namespace {
+        constexpr size_t kReadChunk = 16 * 1024;
+
+        int64_t ParseNumber(std::string_view text) {
+            int64_t value = 0;
+            if (!utils::resp::ParseInteger(text.data(), text.data() + text.size(), value)) {
+                throw std::runtime_error("Invalid number in response: " + std::string(text));
+            }
+            return value;
+        }
+    }// namespace
+
+    size_t AstraClient::FillBuffer() {
+        // 已读完的前缀在补充数据前丢弃，缓冲区只保留未解析的部分
+        if (read_pos_ > 0) {
+            read_buffer_.erase(0, read_pos_);
+            read_pos_ = 0;
+        }
+        size_t old_size = read_buffer_.size();
+        read_buffer_.resize(old_size + kReadChunk);
+        ssize_t n = recv(sockfd_, read_buffer_.data() + old_size, static_cast<int>(kReadChunk), 0);
+        if (n <= 0) {
+            read_buffer_.resize(old_size);
+            throw std::runtime_error("Connection closed or read error");
+        }
+        read_buffer_.resize(old_size + static_cast<size_t>(n));
+        return static_cast<size_t>(n);
+    }
+
+    std::string_view AstraClient::ReadLine() {
+        size_t scanned = 0;// 已确认不含行尾的字节数，补充数据后从这里继续扫描
         while (true) {
-            ssize_t n = recv(sockfd, &c, 1, 0);
+            const char *begin = read_buffer_.data() + read_pos_;
+            const char *end = read_buffer_.data() + read_buffer_.size();
+            const char *cr = utils::resp::FindCR(begin + scanned, end);
+            while (cr != nullptr && cr + 1 < end && cr[1] != '\n') {
+                cr = utils::resp::FindCR(cr + 1, end);
+            }
+            if (cr != nullptr && cr + 1 < end) {
+                std::string_view line(begin, static_cast<size_t>(cr - begin));
+                read_pos_ += line.size() + 2;
+                return line;
+            }
+            // 末尾的孤立 '\r' 需要和下一批数据一起判断
+            scanned = static_cast<size_t>((cr != nullptr ? cr : end) - begin);
+            FillBuffer();
+        }
+    }
+
+    void AstraClient::ReadBulk(size_t len, std::string &out) {
+        // 缓冲中已有的部分直接拷贝，剩余部分 recv 到目标字符串，不经过缓冲
+        size_t buffered = std::min(len, read_buffer_.size() - read_pos_);
+        out.assign(read_buffer_, read_pos_, buffered);
+        read_pos_ += buffered;
+        out.resize(len);
+        while (buffered < len) {
+            ssize_t n = recv(sockfd_, out.data() + buffered, static_cast<int>(len - buffered), 0);
             if (n <= 0) {
                 throw std::runtime_error("Connection closed or read error");
             }
-            if (c == '\n') break;
-            if (c != '\r') {// skip \r
-                line += c;
-            }
+            buffered += static_cast<size_t>(n);
         }
-        return line;
+        while (read_buffer_.size() - read_pos_ < 2) {
+            FillBuffer();
+        }
+        if (read_buffer_.compare(read_pos_, 2, "\r\n") != 0) {
+            throw std::runtime_error("Expected CRLF after bulk string");
+        }
+        read_pos_ += 2;
     }
 
     RespValue AstraClient::ReadResponse() {
-        std::string line = ReadLine(sockfd_);
+        std::string_view line = ReadLine();
         if (line.empty()) {
             throw std::runtime_error("Empty response");
         }
 
         char type = line[0];
-        std::string content = line.substr(1);
+        std::string_view content = line.substr(1);
 
         switch (type) {
             case '+': {// Simple String
-                return RespValue{RespType::SimpleString, content, 0, {}};
+                return RespValue{RespType::SimpleString, std::string(content), 0, {}};
             }
             case '$': {// Bulk String
-                int64_t len = std::stoll(content);
-                if (len == -1) {
+                int64_t len = ParseNumber(content);
+                if (len < 0) {
                     return RespValue{RespType::Nil, "", 0, {}};
                 }
-                std::string str(len, '\0');
-                recv(sockfd_, str.data(), len, 0);
-                ReadLine(sockfd_);// consume \r\n
-                return RespValue{RespType::BulkString, str, 0, {}};
+                RespValue bulk{RespType::BulkString, "", 0, {}};
+                ReadBulk(static_cast<size_t>(len), bulk.str);
+                return bulk;
             }
             case ':': {// Integer
-                return RespValue{RespType::Integer, "", std::stoll(content), {}};
+                return RespValue{RespType::Integer, "", ParseNumber(content), {}};
             }
             case '*': {// Array
-                int64_t len = std::stoll(content);
+                int64_t len = ParseNumber(content);
+                if (len < 0) {
+                    return RespValue{RespType::Nil, "", 0, {}};
+                }
                 RespValue arr{RespType::Array, "", 0, {}};
-                arr.array.reserve(len);
+                arr.array.reserve(static_cast<size_t>(len));
                 for (int64_t i = 0; i < len; ++i) {
                     arr.array.push_back(ReadResponse());
                 }
                 return arr;
             }
             case '-': {// Error
-                return RespValue{RespType::Error, content, 0, {}};
+                return RespValue{RespType::Error, std::string(content), 0, {}};
             }
             default:
                 throw std::runtime_error("Unknown response type: " + std::string(1, type));
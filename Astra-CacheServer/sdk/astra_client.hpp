@@ -4,6 +4,7 @@
 #include "core/macros.hpp"
 #include <chrono>// 添加chrono头文件以支持时间相关功能
 #include <string>
+#include <string_view>
 #include <vector>
 namespace Astra::Client {
 
@@ -54,12 +55,19 @@ namespace Astra::Client {
         int sockfd_;
         std::string host_;
         int port_;
+        std::string read_buffer_;
+        size_t read_pos_ = 0;
 
         void Connect();
         void Disconnect();
         void SendRaw(const std::string &data);
         RespValue ReadResponse();
 
+        // 带缓冲的应答读取：一次 recv 读入多条应答，行尾用 utils/resp_scan 的向量化内核查找
+        size_t FillBuffer();
+        std::string_view ReadLine();
+        void ReadBulk(size_t len, std::string &out);
+
         // 内部 RESP 解析逻辑
         RespValue ParseSingleLine(char prefix, const std::string &line);
         RespValue ParseBulkString(const std::string &line);
@@ -0,0 +1,130 @@
+#include "BlockingManager.hpp"
+#include "core/astra.hpp"
+#include "logger.hpp"
+#include <algorithm>
+
+namespace Astra::apps {
+
+    KeyLocks BlockingManager::LockKey(const std::string &key) {
+        KeyLocks locks;
+        locks.keys_.emplace_back(key_mtx_[StripeOf(key)]);
+        return locks;
+    }
+
+    KeyLocks BlockingManager::LockKeyForWake(const std::string &key) {
+        size_t stripe = StripeOf(key);
+        std::unique_lock<std::recursive_mutex> key_lock(key_mtx_[stripe]);
+        KeyLocks locks;
+        if (stripe_waiters_[stripe].load(std::memory_order_acquire) != 0) {
+            // 不能持有分片去等 Mutex()，先放开分片再按层次顺序重新加锁
+            key_lock.unlock();
+            locks.global_ = std::unique_lock<std::recursive_mutex>(mtx_);
+            key_lock.lock();
+        }
+        locks.keys_.push_back(std::move(key_lock));
+        return locks;
+    }
+
+    KeyLocks BlockingManager::LockKeys(const std::vector<std::string> &keys) {
+        KeyLocks locks;
+        locks.global_ = std::unique_lock<std::recursive_mutex>(mtx_);
+        locks.keys_.reserve(keys.size());
+        for (const auto &key: keys) {
+            locks.keys_.emplace_back(key_mtx_[StripeOf(key)]);
+        }
+        return locks;
+    }
+
+    bool BlockingManager::HasWaiters(const std::string &key) const {
+        return stripe_waiters_[StripeOf(key)].load(std::memory_order_acquire) != 0;
+    }
+
+    void BlockingManager::Block(const std::shared_ptr<BlockedClient> &client) {
+        std::lock_guard<std::recursive_mutex> lock(mtx_);
+        if (client->blocked) return;
+
+        client->blocked = true;
+        ++blocked_count_;
+        for (const auto &key: client->keys) {
+            auto &queue = waiters_[key];
+            // 同一个客户端重复等待同一个键时只排一次队
+            if (std::find(queue.begin(), queue.end(), client) == queue.end()) {
+                queue.push_back(client);
+                stripe_waiters_[StripeOf(key)].fetch_add(1, std::memory_order_release);
+            }
+        }
+        ZEN_LOG_DEBUG("Client blocked on {} key(s)", client->keys.size());
+    }
+
+    size_t BlockingManager::Serve(const std::string &key, data::AstraList &list) {
+        std::lock_guard<std::recursive_mutex> lock(mtx_);
+        size_t served = 0;
+
+        // 每轮重新查找：serve 回调可能嵌套推入其他键（BLMOVE），从而修改 waiters_
+        while (list.LLen() > 0) {
+            auto it = waiters_.find(key);
+            if (it == waiters_.end()) break;
+
+            auto client = it->second.front();
+            Unregister(client);
+            if (client->serve && client->serve(key, list)) {
+                ++served;
+            }
+        }
+
+        if (served > 0) {
+            ZEN_LOG_DEBUG("Handed elements of '{}' to {} blocked client(s)", key, served);
+        }
+        return served;
+    }
+
+    size_t BlockingManager::SignalKeyReady(const std::string &key) {
+        std::lock_guard<std::recursive_mutex> lock(mtx_);
+        auto it = waiters_.find(key);
+        if (it == waiters_.end()) return 0;
+
+        // 流的读取不消费数据，所有等待者都可能被满足，先复制一份再逐个回调
+        auto waiters = it->second;
+        size_t served = 0;
+        for (const auto &client: waiters) {
+            if (!client->blocked || !client->on_ready) continue;
+            if (client->on_ready(key)) {
+                Unregister(client);
+                ++served;
+            }
+        }
+        return served;
+    }
+
+    bool BlockingManager::Cancel(const std::shared_ptr<BlockedClient> &client) {
+        std::lock_guard<std::recursive_mutex> lock(mtx_);
+        if (!client->blocked) return false;
+
+        Unregister(client);
+        return true;
+    }
+
+    size_t BlockingManager::BlockedClients() const {
+        std::lock_guard<std::recursive_mutex> lock(mtx_);
+        return blocked_count_;
+    }
+
+    void BlockingManager::Unregister(const std::shared_ptr<BlockedClient> &client) {
+        if (!client->blocked) return;
+
+        client->blocked = false;
+        --blocked_count_;
+        for (const auto &key: client->keys) {
+            auto it = waiters_.find(key);
+            if (it == waiters_.end()) continue;
+
+            if (std::erase(it->second, client) > 0) {
+                stripe_waiters_[StripeOf(key)].fetch_sub(1, std::memory_order_release);
+            }
+            if (it->second.empty()) {
+                waiters_.erase(it);
+            }
+        }
+    }
+
+}// namespace Astra::apps
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "data/redis_types.hpp"
+#include "network/Singleton.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Astra::apps {
+
+    // 被阻塞的客户端（BLPOP/BRPOP/BLMOVE、XREAD/XREADGROUP）：同时等待多个键，任一键先有数据即被唤醒
+    struct BlockedClient {
+        std::vector<std::string> keys;
+        // 推入方在锁内回调：从 list 中取走元素并完成回复；返回 false 表示未消费（如会话已关闭）
+        std::function<bool(const std::string &key, data::AstraList &list)> serve;
+        // 流等待者（XREAD/XREADGROUP BLOCK）：键上有新条目时在锁内回调，返回 true 表示已完成回复
+        std::function<bool(const std::string &key)> on_ready;
+        bool blocked = false;// 由 BlockingManager 的锁保护
+    };
+
+    // 列表/流命令持有的锁：可选的 Mutex() 加上所涉键的分片锁，析构时一并释放
+    class KeyLocks {
+    public:
+        KeyLocks() = default;
+        KeyLocks(KeyLocks &&) = default;
+        KeyLocks &operator=(KeyLocks &&) = default;
+
+    private:
+        friend class BlockingManager;
+
+        std::unique_lock<std::recursive_mutex> global_;
+        std::vector<std::unique_lock<std::recursive_mutex>> keys_;
+    };
+
+    // 阻塞等待者管理：每个键一个 FIFO 队列，推入时直接把元素交给最早的等待者
+    class BlockingManager : public Singleton<BlockingManager> {
+    public:
+        friend class Singleton<BlockingManager>;
+
+        // 锁的层次：键按哈希分到 kKeyStripes 个分片锁，单键的读改写只持有所在分片；
+        // 登记等待、唤醒等待者以及涉及多个键的操作先取 Mutex() 再取各键分片（顺序不限）。
+        // 只持有单个分片的线程不会再等待其他锁，因此不会与持有 Mutex() 的线程死锁。
+        // 唤醒 BLMOVE 时会在锁内继续推入目标键，因此都使用递归锁
+        std::recursive_mutex &Mutex() { return mtx_; }
+
+        // 单键读改写（LPOP/RPOP 等），不会唤醒等待者
+        KeyLocks LockKey(const std::string &key);
+
+        // 可能唤醒等待者的单键写入（LPUSH/RPUSH）：分片上没有等待者时只持分片锁，
+        // 否则改为 Mutex() + 分片，以便在锁内调用 Serve/SignalKeyReady
+        KeyLocks LockKeyForWake(const std::string &key);
+
+        // 登记等待或涉及多个键的操作（BLPOP/BLMOVE）：Mutex() + 所有相关分片
+        KeyLocks LockKeys(const std::vector<std::string> &keys);
+
+        // key 所在分片上是否有等待者；调用方持有该分片时结果只会由真变假（Cancel），不会新增
+        bool HasWaiters(const std::string &key) const;
+
+        // 登记等待；调用方应在同一次持有 LockKeys(client->keys) 期间先尝试取数据，取不到再登记
+        void Block(const std::shared_ptr<BlockedClient> &client);
+
+        // 把 list 中的元素依次交给 key 上最早的等待者，返回被唤醒的客户端数；调用方需持有 Mutex()
+        size_t Serve(const std::string &key, data::AstraList &list);
+
+        // 通知 key 上有新数据（XADD），按 FIFO 顺序让等待者重新尝试读取，返回被唤醒的客户端数
+        size_t SignalKeyReady(const std::string &key);
+
+        // 超时或会话关闭时撤销等待；返回 false 表示该客户端已经被服务
+        bool Cancel(const std::shared_ptr<BlockedClient> &client);
+
+        // 当前阻塞中的客户端数量
+        size_t BlockedClients() const;
+
+    private:
+        static constexpr size_t kKeyStripes = 256;
+
+        BlockingManager() = default;
+
+        size_t StripeOf(const std::string &key) const {
+            return std::hash<std::string>{}(key) % kKeyStripes;
+        }
+
+        void Unregister(const std::shared_ptr<BlockedClient> &client);
+
+        mutable std::recursive_mutex mtx_;
+        std::array<std::recursive_mutex, kKeyStripes> key_mtx_;
+        std::array<std::atomic<uint32_t>, kKeyStripes> stripe_waiters_{};// 各分片上排队中的 (客户端, 键) 数
+        std::unordered_map<std::string, std::deque<std::shared_ptr<BlockedClient>>> waiters_;
+        size_t blocked_count_ = 0;
+    };
+
+}// namespace Astra::apps
@@ -0,0 +1,105 @@
+#include "CounterManager.hpp"
+#include "core/astra.hpp"
+#include "logger.hpp"
+
+namespace Astra::apps {
+
+    namespace {
+        // 每个线程持有一份注册表快照，generation 与注册表一致时无需加锁
+        struct LocalView {
+            const CounterManager *owner = nullptr;
+            uint64_t generation = UINT64_MAX;
+            std::unordered_map<std::string, std::shared_ptr<concurrent::SplitCounter>> counters;
+        };
+
+        thread_local LocalView local_view;
+
+        bool ParseCounterValue(const std::string &text, int64_t &value) {
+            if (text.empty() || text.size() > 20) return false;
+            auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            return ec == std::errc() && ptr == text.data() + text.size();
+        }
+    }// namespace
+
+    std::shared_ptr<concurrent::SplitCounter> CounterManager::Create(const std::string &key, int64_t initial) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto &entry = counters_[key];
+        if (!entry.counter) {
+            entry.counter = std::make_shared<concurrent::SplitCounter>(initial);
+            entry.last_written = std::to_string(initial);
+            count_.store(counters_.size(), std::memory_order_release);
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+        return entry.counter;
+    }
+
+    concurrent::SplitCounter *CounterManager::Find(const std::string &key) {
+        if (Empty()) return nullptr;
+
+        uint64_t generation = generation_.load(std::memory_order_acquire);
+        if (local_view.owner != this || local_view.generation != generation) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            local_view.counters.clear();
+            for (const auto &[name, entry]: counters_) {
+                local_view.counters.emplace(name, entry.counter);
+            }
+            local_view.owner = this;
+            local_view.generation = generation_.load(std::memory_order_relaxed);
+        }
+
+        auto it = local_view.counters.find(key);
+        return it == local_view.counters.end() ? nullptr : it->second.get();
+    }
+
+    bool CounterManager::FoldInto(Cache &cache, const std::string &key, Entry &entry) {
+        return cache.Update(key, [&](std::string &value, bool existed) {
+            if (!existed) return false;// 键已被删除或过期
+
+            if (value != entry.last_written) {
+                // 外部 SET 改写了值：以新值为基准，保留尚未折叠的增量
+                int64_t rebased;
+                if (!ParseCounterValue(value, rebased)) return false;
+                entry.counter->Rebase(rebased);
+            }
+
+            value = std::to_string(entry.counter->Fold());
+            entry.last_written = value;
+            return true;
+        });
+    }
+
+    bool CounterManager::Drop(Cache &cache, const std::string &key) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = counters_.find(key);
+        if (it == counters_.end()) return false;
+
+        // 代数在锁内递增：Drop 返回之后开始的 INCR 必然看到新代数、走普通路径。
+        // 与 Drop 重叠、已取得计数器指针的 INCR 可能落在最后一次折叠之后，视为发生在随后的删除之前
+        FoldInto(cache, key, it->second);
+        counters_.erase(it);
+        count_.store(counters_.size(), std::memory_order_release);
+        generation_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    void CounterManager::FoldAll(Cache &cache) {
+        if (Empty()) return;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        bool changed = false;
+        for (auto it = counters_.begin(); it != counters_.end();) {
+            if (FoldInto(cache, it->first, it->second)) {
+                ++it;
+                continue;
+            }
+            ZEN_LOG_DEBUG("Counter '{}' was deleted or overwritten, leaving split mode", it->first);
+            it = counters_.erase(it);
+            changed = true;
+        }
+        if (changed) {
+            count_.store(counters_.size(), std::memory_order_release);
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+}// namespace Astra::apps
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "caching/AstraCacheStrategy.hpp"
+#include "concurrent/split_counter.hpp"
+#include "datastructures/lru_cache.hpp"
+#include "network/Singleton.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Astra::apps {
+
+    // 分片计数器注册表（COUNTER.CREATE key SPLIT）
+    // 处于 SPLIT 模式的键，INCR 系列命令只写当前线程的计数单元，完全绕开缓存锁；
+    // 缓存中仍保存普通的整数字符串，由 FoldAll 定期把增量折叠回去，GET/持久化/TTL 照常工作。
+    // DEL/GETDEL 在删除前经 Drop 同步退出 SPLIT 模式，之后的 INCR 按普通键重新创建；
+    // 过期或淘汰则在下次折叠时发现键已不存在，该键退出 SPLIT 模式（期间的增量随键一起失效）。
+    // 折叠时发现键被改写为非整数同样退出。
+    class CounterManager : public Singleton<CounterManager> {
+    public:
+        friend class Singleton<CounterManager>;
+
+        using Cache = datastructures::AstraCache<datastructures::LRUCache, std::string, std::string>;
+
+        static constexpr std::chrono::milliseconds kFoldInterval{100};
+
+        // 把 key 切换为 SPLIT 模式，initial 为当前值；已存在时返回原计数器
+        std::shared_ptr<concurrent::SplitCounter> Create(const std::string &key, int64_t initial);
+
+        // 热路径查找：没有任何分片计数器时只有一次原子读；
+        // 否则查当前线程缓存的注册表快照，注册表变化（代数改变）时才加锁刷新。
+        // 返回的指针在当前线程下一次调用 Find 之前有效。
+        concurrent::SplitCounter *Find(const std::string &key);
+
+        // 最终折叠一次并退出 SPLIT 模式，返回是否存在；删除键之前调用，见类注释
+        bool Drop(Cache &cache, const std::string &key);
+
+        // 把所有计数器的增量折叠回缓存
+        void FoldAll(Cache &cache);
+
+        bool Empty() const { return count_.load(std::memory_order_acquire) == 0; }
+
+    private:
+        CounterManager() = default;
+
+        struct Entry {
+            std::shared_ptr<concurrent::SplitCounter> counter;
+            std::string last_written;// 上次折叠写入缓存的值，用于识别外部的 SET
+        };
+
+        // 在缓存锁内折叠单个计数器，返回 false 表示应退出 SPLIT 模式
+        static bool FoldInto(Cache &cache, const std::string &key, Entry &entry);
+
+        mutable std::mutex mtx_;
+        std::unordered_map<std::string, Entry> counters_;
+        std::atomic<size_t> count_{0};
+        std::atomic<uint64_t> generation_{0};
+    };
+
+}// namespace Astra::apps
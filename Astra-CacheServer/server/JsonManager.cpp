@@ -0,0 +1,24 @@
+#include "JsonManager.hpp"
+#include "core/astra.hpp"
+#include "logger.hpp"
+
+namespace Astra::apps {
+
+    std::string JsonManager::Register(const std::string &key, std::shared_ptr<datastructures::JsonValue> document) {
+        return registry_.Register(key, std::move(document));
+    }
+
+    std::shared_ptr<datastructures::JsonValue> JsonManager::Find(const std::string &key, std::string_view handle) const {
+        return registry_.Find(key, handle);
+    }
+
+    void JsonManager::Release(const std::string &key, std::string_view handle) {
+        ZEN_LOG_DEBUG("JSON handle for '{}' is gone, dropping document", key);
+        registry_.Release(key, handle);
+    }
+
+    size_t JsonManager::DocumentCount() const {
+        return registry_.Count();
+    }
+
+}// namespace Astra::apps
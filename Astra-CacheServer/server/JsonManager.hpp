@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ResidentRegistry.hpp"
+#include "datastructures/json_document.hpp"
+#include "network/Singleton.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Astra::apps {
+
+    // JSON 文档注册表
+    // 与 ZSetManager 相同：缓存中只放一个 "json:@<id>" 句柄（参与 EXISTS/DEL/过期），
+    // 解析后的文档树常驻于此，JSON.GET/SET 按路径直接读写节点，不必每次整体解析与序列化。
+    // 句柄被删除、覆盖、淘汰或过期时由缓存的删除回调释放文档；快照中保存为 "json:<文本>"。
+    // 文档的内容由 BlockingManager 中该键的分片锁保护。
+    class JsonManager : public Singleton<JsonManager> {
+    public:
+        friend class Singleton<JsonManager>;
+
+        static constexpr std::string_view kPrefix = "json:";
+
+        bool IsHandle(std::string_view value) const { return registry_.IsHandle(value); }
+
+        // 登记新文档，返回应写入缓存的句柄
+        std::string Register(const std::string &key, std::shared_ptr<datastructures::JsonValue> document);
+
+        // 缓存中的句柄与登记的不一致（旧句柄或手写的字符串）时返回 nullptr
+        std::shared_ptr<datastructures::JsonValue> Find(const std::string &key, std::string_view handle) const;
+
+        void Release(const std::string &key, std::string_view handle);
+
+        size_t DocumentCount() const;
+
+    private:
+        JsonManager() = default;
+
+        ResidentRegistry<datastructures::JsonValue> registry_{kPrefix};
+    };
+
+}// namespace Astra::apps
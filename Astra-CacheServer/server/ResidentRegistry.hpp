@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace Astra::apps {
+
+    // 常驻对象注册表：流、有序集合、JSON 文档的本体放在缓存之外，缓存中只放句柄。
+    // 句柄形如 "<prefix>@<id>"，id 全局递增，同一个键先后创建的对象句柄互不相同，
+    // 因此缓存删除/覆盖/淘汰/过期时按 (键, 旧句柄) 释放，不会误删之后新建的对象；
+    // 用户手写的同名字符串也对不上注册表里的句柄，不会串到别人的本体。
+    // 注册表的锁是叶子锁：持有期间不再获取缓存锁或其他锁，可以在缓存的删除回调里调用。
+    template<typename T>
+    class ResidentRegistry {
+    public:
+        explicit ResidentRegistry(std::string_view prefix) : prefix_(prefix) {}
+
+        bool IsHandle(std::string_view value) const {
+            return value.size() > prefix_.size() && value.starts_with(prefix_) && value[prefix_.size()] == '@';
+        }
+
+        // 为 key 登记新对象（替换旧对象），返回应写入缓存的句柄
+        std::string Register(const std::string &key, std::shared_ptr<T> object) {
+            std::string handle = prefix_ + "@" + std::to_string(next_id_.fetch_add(1, std::memory_order_relaxed));
+            std::lock_guard<std::mutex> lock(mtx_);
+            objects_[key] = {handle, std::move(object)};
+            return handle;
+        }
+
+        // 只有缓存中的句柄与登记时一致才返回对象
+        std::shared_ptr<T> Find(const std::string &key, std::string_view handle) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = objects_.find(key);
+            if (it == objects_.end() || it->second.first != handle) {
+                return nullptr;
+            }
+            return it->second.second;
+        }
+
+        void Release(const std::string &key, std::string_view handle) {
+            std::shared_ptr<T> released;// 对象在锁外析构
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto it = objects_.find(key);
+                if (it == objects_.end() || it->second.first != handle) {
+                    return;
+                }
+                released = std::move(it->second.second);
+                objects_.erase(it);
+            }
+        }
+
+        size_t Count() const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            return objects_.size();
+        }
+
+    private:
+        std::string prefix_;
+        std::atomic<uint64_t> next_id_{1};
+        mutable std::mutex mtx_;
+        std::unordered_map<std::string, std::pair<std::string, std::shared_ptr<T>>> objects_;
+    };
+
+}// namespace Astra::apps
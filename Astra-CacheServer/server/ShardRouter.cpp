@@ -0,0 +1,133 @@
+#include "ShardRouter.hpp"
+#include "core/astra.hpp"
+#include "logger.hpp"
+#include "proto/CommandImpl.hpp"
+#include "utils/resp_scan.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace Astra::apps {
+
+    namespace {
+        thread_local size_t current_core = ShardRouter::npos;
+    }
+
+    ShardRouter::ShardRouter(size_t cores, std::shared_ptr<Cache> cache)
+        : cache_(std::move(cache)) {
+        cores = std::max<size_t>(cores, 1);
+        for (size_t i = 0; i < cores; ++i) {
+            cores_.push_back(std::make_unique<Core>());
+        }
+        for (size_t i = 0; i < cores * cores; ++i) {
+            channels_.push_back(std::make_unique<Channel>());
+        }
+        for (const auto &info: proto::CommandCommand::Table()) {
+            key_specs_[info.name] = KeySpec{info.first_key, info.last_key, info.key_step,
+                                               std::find(info.flags.begin(), info.flags.end(), "movablekeys") != info.flags.end()};
+        }
+    }
+
+    ShardRouter::~ShardRouter() {
+        Stop();
+        // 未被取走的消息
+        for (auto &channel: channels_) {
+            channel->queue.Drain([](Task *task) { delete task; });
+        }
+    }
+
+    void ShardRouter::Start() {
+        for (size_t i = 0; i < cores_.size(); ++i) {
+            auto &core = *cores_[i];
+            core.work.emplace(asio::make_work_guard(core.context));
+            core.thread = std::thread([&core, i]() {
+                current_core = i;
+                core.context.run();
+            });
+        }
+        ZEN_LOG_INFO("Shard mode started with {} cores", cores_.size());
+    }
+
+    void ShardRouter::Stop() {
+        for (auto &core: cores_) {
+            core->work.reset();
+            core->context.stop();
+        }
+        for (auto &core: cores_) {
+            if (core->thread.joinable() && core->thread.get_id() != std::this_thread::get_id()) {
+                core->thread.join();
+            }
+        }
+    }
+
+    size_t ShardRouter::CurrentCore() {
+        return current_core;
+    }
+
+    void ShardRouter::Send(size_t to, Task task) {
+        size_t from = current_core;
+        if (from == npos || from == to) {
+            asio::post(cores_[to]->context, std::move(task));
+            return;
+        }
+
+        ChannelOf(from, to).queue.Push(new Task(std::move(task)));
+        // 接收方在 Drain 开头清除标记，之后入队的消息会触发新的一次 Drain
+        if (!cores_[to]->drain_scheduled.exchange(true)) {
+            asio::post(cores_[to]->context, [this, to]() { Drain(to); });
+        }
+    }
+
+    void ShardRouter::Drain(size_t core) {
+        cores_[core]->drain_scheduled.store(false);
+        for (size_t from = 0; from < cores_.size(); ++from) {
+            if (from == core) continue;
+            ChannelOf(from, core).queue.Drain([core](Task *task) {
+                std::unique_ptr<Task> owned(task);
+                try {
+                    (*owned)();
+                } catch (const std::exception &e) {
+                    ZEN_LOG_ERROR("Error running shard message on core {}: {}", core, e.what());
+                }
+            });
+        }
+    }
+
+    size_t ShardRouter::OwnerOf(const std::vector<std::string> &argv) const {
+        if (argv.empty()) return npos;
+
+        std::string name = argv[0];
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::toupper(c); });
+        auto it = key_specs_.find(name);
+        if (it == key_specs_.end()) return npos;
+
+        const auto &spec = it->second;
+        if (spec.first_key <= 0 || spec.key_step <= 0 || argv.size() <= static_cast<size_t>(spec.first_key)) {
+            return npos;
+        }
+        // last_key 为负数时从末尾倒数（-1 表示最后一个参数）
+        int64_t last = spec.last_key < 0 ? static_cast<int64_t>(argv.size()) + spec.last_key : spec.last_key;
+        last = std::min<int64_t>(last, static_cast<int64_t>(argv.size()) - 1);
+        if (spec.numkeys) {
+            int64_t numkeys = 0;
+            const auto &count = argv[spec.first_key - 1];
+            if (!utils::resp::ParseInteger(count.data(), count.data() + count.size(), numkeys) || numkeys <= 0) {
+                return npos;
+            }
+            // 个数超出参数范围的命令会被拒绝，交给本核心回复错误
+            if (numkeys - 1 > (last - spec.first_key) / spec.key_step) return npos;
+            last = spec.first_key + (numkeys - 1) * spec.key_step;
+        }
+
+        size_t owner = npos;
+        for (int64_t i = spec.first_key; i <= last; i += spec.key_step) {
+            size_t partition = cache_->PartitionOf(argv[i]);
+            if (owner == npos) {
+                owner = partition;
+            } else if (owner != partition) {
+                return npos;
+            }
+        }
+        return owner;
+    }
+
+}// namespace Astra::apps
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "datastructures/lru_cache.hpp"
+#include "datastructures/spsc_channel.hpp"
+#include <asio.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Astra::apps {
+
+    // 分片（thread-per-core）模式的调度器
+    // 每个核心一个 io_context、一个线程，缓存按键哈希分区，分区 i 归核心 i 所有。
+    // 会话固定在某个核心上，键属于本核心的命令在 IO 线程上直接执行；
+    // 属于其他核心的命令经 (发送核心, 接收核心) 一对一的 SPSC 环形通道交给所属核心执行。
+    class ShardRouter {
+    public:
+        using Cache = datastructures::AstraCache<datastructures::LRUCache, std::string, std::string>;
+        using Task = std::function<void()>;
+
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        // cache 的分区数必须等于 cores
+        ShardRouter(size_t cores, std::shared_ptr<Cache> cache);
+        ~ShardRouter();
+
+        size_t CoreCount() const { return cores_.size(); }
+
+        asio::io_context &Context(size_t core) { return cores_[core]->context; }
+
+        // 为每个核心启动一个线程运行其 io_context
+        void Start();
+        void Stop();
+
+        // 当前线程所在的核心，非核心线程返回 npos
+        static size_t CurrentCore();
+
+        // 在核心 to 上执行 task。从核心线程发往其他核心时走 (发送核心, 接收核心) 的 SPSC 通道，
+        // 一次唤醒处理通道中积累的全部消息；环满时消息进入该通道的溢出队列，同一通道内始终按发送顺序执行，
+        // 会话发往同一核心的各段依赖这一点（见 Session::PumpShardRuns）。从非核心线程发送时退回 asio::post，不保证顺序
+        void Send(size_t to, Task task);
+
+        // 命令的所有键都落在同一分区时返回该分区所属的核心；无键命令、键跨分区或未知命令返回 npos。
+        // 键的位置取自命令表（与 COMMAND INFO 相同），必须覆盖命令的全部键，否则跨分区的命令会被当成单分区命令发走。
+        // 返回 npos 的命令在会话所在核心上作为屏障执行，同一会话不会有其他命令与它并发：
+        // 用到会话状态或会话内 Lua 解释器的命令（CLIENT、SUBSCRIBE、EVAL 等）依赖这一点，它们在命令表中必须保持无键
+        size_t OwnerOf(const std::vector<std::string> &argv) const;
+
+    private:
+        static constexpr size_t kChannelCapacity = 1024;
+
+        struct KeySpec {
+            int first_key;
+            int last_key;
+            int key_step;
+            bool numkeys;// movablekeys：first_key 前一个参数是键的个数，之后的参数（如 LIMIT）不是键
+        };
+
+        // 每个核心独占缓存行，drain_scheduled 不与其他核心伪共享
+        struct alignas(64) Core {
+            asio::io_context context{1};
+            std::optional<asio::executor_work_guard<asio::io_context::executor_type>> work;
+            std::thread thread;
+            std::atomic<bool> drain_scheduled{false};// 已投递一次尚未开始的 Drain
+        };
+
+        struct alignas(64) Channel {
+            datastructures::SpscChannel<Task *, kChannelCapacity> queue;
+        };
+
+        // 在核心 core 上取出所有发给它的消息并执行
+        void Drain(size_t core);
+
+        Channel &ChannelOf(size_t from, size_t to) { return *channels_[from * cores_.size() + to]; }
+
+        std::vector<std::unique_ptr<Core>> cores_;
+        std::vector<std::unique_ptr<Channel>> channels_;
+        std::unordered_map<std::string, KeySpec> key_specs_;
+        std::shared_ptr<Cache> cache_;
+    };
+
+}// namespace Astra::apps
@@ -0,0 +1,24 @@
+#include "StreamManager.hpp"
+#include "core/astra.hpp"
+#include "logger.hpp"
+
+namespace Astra::apps {
+
+    std::string StreamManager::Register(const std::string &key, std::shared_ptr<data::AstraStream> stream) {
+        return registry_.Register(key, std::move(stream));
+    }
+
+    std::shared_ptr<data::AstraStream> StreamManager::Find(const std::string &key, std::string_view handle) const {
+        return registry_.Find(key, handle);
+    }
+
+    void StreamManager::Release(const std::string &key, std::string_view handle) {
+        ZEN_LOG_DEBUG("Stream handle for '{}' is gone, dropping stream", key);
+        registry_.Release(key, handle);
+    }
+
+    size_t StreamManager::StreamCount() const {
+        return registry_.Count();
+    }
+
+}// namespace Astra::apps
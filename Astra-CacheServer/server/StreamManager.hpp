@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ResidentRegistry.hpp"
+#include "data/redis_types.hpp"
+#include "network/Singleton.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Astra::apps {
+
+    // 流对象注册表
+    // 缓存只能保存字符串，流若每次 XADD 都整体序列化会退化为 O(N)。
+    // 因此缓存中只放一个 "stream:@<id>" 句柄（参与 TYPE/EXISTS/DEL/过期），条目本体常驻于此。
+    // 句柄被删除、覆盖、淘汰或过期时由缓存的删除回调调用 Release 释放本体；
+    // 保存快照时流被序列化成 "stream:<数据>"，重启后第一次访问再转回句柄。
+    // 流的内容由 BlockingManager 中该键的锁保护。
+    class StreamManager : public Singleton<StreamManager> {
+    public:
+        friend class Singleton<StreamManager>;
+
+        static constexpr const char *kPrefix = "stream:";
+
+        bool IsHandle(std::string_view value) const { return registry_.IsHandle(value); }
+
+        // 登记新的流对象，返回应写入缓存的句柄
+        std::string Register(const std::string &key, std::shared_ptr<data::AstraStream> stream);
+
+        // 缓存中的句柄与登记的不一致（旧句柄或手写的字符串）时返回 nullptr
+        std::shared_ptr<data::AstraStream> Find(const std::string &key, std::string_view handle) const;
+
+        void Release(const std::string &key, std::string_view handle);
+
+        size_t StreamCount() const;
+
+    private:
+        StreamManager() = default;
+
+        ResidentRegistry<data::AstraStream> registry_{kPrefix};
+    };
+
+}// namespace Astra::apps
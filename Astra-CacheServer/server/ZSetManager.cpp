@@ -0,0 +1,24 @@
+#include "ZSetManager.hpp"
+#include "core/astra.hpp"
+#include "logger.hpp"
+
+namespace Astra::apps {
+
+    std::string ZSetManager::Register(const std::string &key, std::shared_ptr<data::AstraZSet> zset) {
+        return registry_.Register(key, std::move(zset));
+    }
+
+    std::shared_ptr<data::AstraZSet> ZSetManager::Find(const std::string &key, std::string_view handle) const {
+        return registry_.Find(key, handle);
+    }
+
+    void ZSetManager::Release(const std::string &key, std::string_view handle) {
+        ZEN_LOG_DEBUG("ZSet handle for '{}' is gone, dropping zset", key);
+        registry_.Release(key, handle);
+    }
+
+    size_t ZSetManager::ZSetCount() const {
+        return registry_.Count();
+    }
+
+}// namespace Astra::apps
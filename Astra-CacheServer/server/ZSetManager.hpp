@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ResidentRegistry.hpp"
+#include "data/redis_types.hpp"
+#include "network/Singleton.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Astra::apps {
+
+    // 有序集合对象注册表
+    // 与 StreamManager 相同：缓存中只放一个 "zset:@<id>" 句柄（参与 TYPE/EXISTS/DEL/过期），
+    // 按分数排序的索引常驻于此，ZADD/GEOADD 是 O(log N)，按分数区间扫描是 O(log N + M)，不必整体序列化。
+    // 句柄被删除、覆盖、淘汰或过期时由缓存的删除回调释放本体；快照中保存为 "zset:<数据>"。
+    // 有序集合的内容由 BlockingManager 中该键的分片锁保护。
+    class ZSetManager : public Singleton<ZSetManager> {
+    public:
+        friend class Singleton<ZSetManager>;
+
+        static constexpr std::string_view kPrefix = data::AstraZSet::kPrefix;
+
+        bool IsHandle(std::string_view value) const { return registry_.IsHandle(value); }
+
+        // 登记新的有序集合，返回应写入缓存的句柄
+        std::string Register(const std::string &key, std::shared_ptr<data::AstraZSet> zset);
+
+        // 缓存中的句柄与登记的不一致（旧句柄或手写的字符串）时返回 nullptr
+        std::shared_ptr<data::AstraZSet> Find(const std::string &key, std::string_view handle) const;
+
+        void Release(const std::string &key, std::string_view handle);
+
+        size_t ZSetCount() const;
+
+    private:
+        ZSetManager() = default;
+
+        ResidentRegistry<data::AstraZSet> registry_{kPrefix};
+    };
+
+}// namespace Astra::apps
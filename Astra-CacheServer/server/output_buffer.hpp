@@ -0,0 +1,95 @@
+#pragma once
+
+#include <asio/buffer.hpp>
+#include <string>
+#include <vector>
+
+namespace Astra::apps {
+
+    // 会话输出缓冲：回复追加到 16KB 的块中，写操作进行中时继续累积，
+    // 写完后把所有块作为一个 scatter-gather 序列一次写出（asio 对多个缓冲使用 sendmsg/writev）。
+    // 小回复只做一次 memcpy，不单独分配；大回复整块挂入，不复制。写完的块回收复用。
+    class OutputBuffer {
+    public:
+        static constexpr size_t kChunkSize = 16 * 1024;
+        static constexpr size_t kAdoptThreshold = 4 * 1024;// 不小于此值的回复直接挂入，不拷贝
+        static constexpr size_t kMaxFreeChunks = 4;
+
+        // 写出批次的缓冲序列视图，拷贝开销与两个指针相同
+        class Segments {
+        public:
+            Segments(const asio::const_buffer *first, const asio::const_buffer *last) : first_(first), last_(last) {}
+            const asio::const_buffer *begin() const { return first_; }
+            const asio::const_buffer *end() const { return last_; }
+
+        private:
+            const asio::const_buffer *first_;
+            const asio::const_buffer *last_;
+        };
+
+        void Append(std::string data) {
+            if (data.empty()) return;
+            pending_bytes_ += data.size();
+
+            if (data.size() >= kAdoptThreshold) {
+                pending_.push_back(std::move(data));
+                tail_open_ = false;
+                return;
+            }
+            if (!tail_open_ || pending_.back().size() + data.size() > kChunkSize) {
+                pending_.push_back(TakeChunk());
+                tail_open_ = true;
+            }
+            pending_.back() += data;
+        }
+
+        bool Empty() const { return pending_bytes_ == 0; }
+
+        size_t PendingBytes() const { return pending_bytes_; }
+
+        // 把已累积的数据转为一个写出批次；返回的序列在 EndFlush 之前保持有效
+        Segments BeginFlush() {
+            flushing_.swap(pending_);
+            pending_.clear();
+            pending_bytes_ = 0;
+            tail_open_ = false;
+
+            iov_.clear();
+            for (const auto &chunk: flushing_) {
+                iov_.emplace_back(chunk.data(), chunk.size());
+            }
+            return {iov_.data(), iov_.data() + iov_.size()};
+        }
+
+        // 写出完成，回收本批次的块
+        void EndFlush() {
+            for (auto &chunk: flushing_) {
+                if (free_.size() < kMaxFreeChunks && chunk.capacity() <= 2 * kChunkSize) {
+                    chunk.clear();
+                    free_.push_back(std::move(chunk));
+                }
+            }
+            flushing_.clear();
+        }
+
+    private:
+        std::string TakeChunk() {
+            if (free_.empty()) {
+                std::string chunk;
+                chunk.reserve(kChunkSize);
+                return chunk;
+            }
+            std::string chunk = std::move(free_.back());
+            free_.pop_back();
+            return chunk;
+        }
+
+        std::vector<std::string> pending_;
+        std::vector<std::string> flushing_;
+        std::vector<std::string> free_;
+        std::vector<asio::const_buffer> iov_;
+        size_t pending_bytes_ = 0;
+        bool tail_open_ = false;// pending_ 的最后一块是可继续追加的拷贝块
+    };
+
+}// namespace Astra::apps
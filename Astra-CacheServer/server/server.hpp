@@ -2,6 +2,9 @@
 
 #include "logger.hpp"
 #include "persistence/persistence.hpp"
+#include "CounterManager.hpp"
+#include "ShardRouter.hpp"
+#include "proto/CommandImpl.hpp"
 #include "session.hpp"
 #include <asio.hpp>
 #include <asio/io_context.hpp>
@@ -25,30 +28,73 @@ namespace Astra::apps {
         explicit AstraCacheServer(asio::io_context &context, size_t cache_size,
                                   const std::string &persistent_file)
             : context_(context),
+              cache_size_(cache_size),
               cache_(std::make_shared<datastructures::AstraCache<datastructures::LRUCache, std::string, std::string>>(cache_size)),
-              acceptor_(context),
               persistence_db_name_(persistent_file),
-              channel_manager_(ChannelManager::GetInstance()) {
+              channel_manager_(ChannelManager::GetInstance()),
+              counter_fold_timer_(context) {
             const int thread_count = std::thread::hardware_concurrency() / 2;
             task_queue_ = std::make_shared<concurrent::TaskQueue>(thread_count);
+            cache_->SetRemovalListener(&proto::ReleaseResidentValue);
         }
 
         void Start(const std::string &bind_address, unsigned short port) {
+            if (reactors_.empty()) {
+                reactors_.push_back(&context_);
+            }
+
+            // 每个 IO 线程一个监听套接字，由内核（SO_REUSEPORT）把新连接分散到各线程；
+            // 平台不支持时只开一个监听套接字，接受后轮流分配到各 IO 线程
             asio::ip::tcp::endpoint endpoint(asio::ip::make_address(bind_address), port);
-            acceptor_.open(endpoint.protocol());
-            acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true));
-            acceptor_.bind(endpoint);
-            acceptor_.listen();
-            ZEN_LOG_INFO("Server listening on {}:{}", bind_address, port);
+            size_t listeners = kReusePortBalancing ? reactors_.size() : 1;
+            if (listeners > 1) {
+                // SO_REUSEPORT 也会让同一用户的另一个实例绑定到同一端口并分走连接，
+                // 先用不带该选项的套接字试绑定，端口已被监听时与单监听套接字一样报地址占用
+                asio::ip::tcp::acceptor probe(context_);
+                probe.open(endpoint.protocol());
+                probe.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+                probe.bind(endpoint);
+            }
+            for (size_t i = 0; i < listeners; ++i) {
+                auto acceptor = std::make_unique<asio::ip::tcp::acceptor>(*reactors_[i]);
+                acceptor->open(endpoint.protocol());
+                acceptor->set_option(asio::ip::tcp::acceptor::reuse_address(true));
+#if defined(__linux__) && defined(SO_REUSEPORT)
+                if (listeners > 1) {
+                    acceptor->set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+                }
+#endif
+                acceptor->bind(endpoint);
+                acceptor->listen();
+                acceptors_.push_back(std::move(acceptor));
+            }
+            ZEN_LOG_INFO("Server listening on {}:{} ({} IO threads, {} listeners)",
+                         bind_address, port, reactors_.size(), acceptors_.size());
 
             LoadCacheFromFile(persistence_db_name_);
-            DoAccept();
+            ScheduleCounterFold();
+            for (size_t i = 0; i < acceptors_.size(); ++i) {
+                DoAccept(i);
+            }
+        }
+
+        // 处理客户端连接的 IO 线程，每个 io_context 应由自己的线程运行；未设置时全部连接落在 context_ 上。
+        // 须在 Start 之前调用；分片模式下由 EnableShardMode 设为各核心的 io_context
+        void SetReactors(std::vector<asio::io_context *> reactors) {
+            if (!shard_router_) {
+                reactors_ = std::move(reactors);
+            }
         }
 
         //todo 正常实现服务器的退出功能
         void Stop() {
             asio::error_code ec;
-            acceptor_.close(ec);
+            for (auto &acceptor: acceptors_) {
+                acceptor->close(ec);
+            }
+            // 保存前把分片计数器的剩余增量折叠回缓存
+            counter_fold_timer_.cancel();
+            CounterManager::GetInstance()->FoldAll(*cache_);
             //保存rdb文件
             SaveToFile(persistence_db_name_);
             return;
@@ -74,6 +120,10 @@ namespace Astra::apps {
 
             task_queue_->Stop();
 
+            if (shard_router_) {
+                shard_router_->Stop();
+            }
+
 
             // 停止集群通信
             if (cluster_communicator_) {
@@ -84,10 +134,11 @@ namespace Astra::apps {
         void SaveToFile(const std::string &filename) {
             if (!enable_persistence_) return;
 
+            // 流等句柄类值换成本体的编码再保存
             if (use_leveldb_) {
-                Astra::Persistence::SaveCacheToLevelDB(*cache_.get(), leveldb_path_);
+                Astra::Persistence::SaveCacheToLevelDB(*cache_.get(), leveldb_path_, &proto::EncodeResidentValue);
             } else {
-                Astra::Persistence::SaveCacheToFile(*cache_.get(), filename);
+                Astra::Persistence::SaveCacheToFile(*cache_.get(), filename, &proto::EncodeResidentValue);
             }
         }
 
@@ -95,12 +146,32 @@ namespace Astra::apps {
             if (!enable_persistence_) return;
 
             if (use_leveldb_) {
-                Astra::Persistence::LoadCacheFromLevelDB(*cache_.get(), leveldb_path_);
+                Astra::Persistence::LoadCacheFromLevelDB(*cache_.get(), leveldb_path_, &proto::DecodeResidentValue);
             } else {
-                Astra::Persistence::LoadCacheFromFile(*cache_.get(), filename);
+                Astra::Persistence::LoadCacheFromFile(*cache_.get(), filename, &proto::DecodeResidentValue);
             }
         }
 
+        // 启用分片（thread-per-core）模式：缓存按键哈希切成 cores 个分区，每个核心一个 io_context 和线程，
+        // 各核心即 IO 线程。须在 Start 之前调用
+        void EnableShardMode(size_t cores) {
+            if (cores == 0) return;
+            cache_ = std::make_shared<datastructures::AstraCache<datastructures::LRUCache, std::string, std::string>>(
+                    datastructures::CachePartitions{cores}, cache_size_);
+            cache_->SetRemovalListener(&proto::ReleaseResidentValue);
+            shard_router_ = std::make_unique<ShardRouter>(cores, cache_);
+            shard_router_->Start();
+            reactors_.clear();
+            for (size_t i = 0; i < cores; ++i) {
+                reactors_.push_back(&shard_router_->Context(i));
+            }
+        }
+
+        // 单个请求参数的长度上限（proto-max-bulk-len），对之后接受的连接生效
+        void SetMaxBulkLength(size_t limit) {
+            max_bulk_length_ = limit;
+        }
+
         void setEnablePersistence(bool enable) {
             enable_persistence_ = enable;
         }
@@ -132,16 +203,36 @@ namespace Astra::apps {
         }
 
     private:
-        void DoAccept() {
-            acceptor_.async_accept(
-                    asio::make_strand(context_),
-                    [this](std::error_code ec, asio::ip::tcp::socket socket) {
+        // 定期把 SPLIT 模式计数器的增量折叠回缓存
+        void ScheduleCounterFold() {
+            counter_fold_timer_.expires_after(CounterManager::kFoldInterval);
+            counter_fold_timer_.async_wait([this](const asio::error_code &ec) {
+                if (ec) return;
+                CounterManager::GetInstance()->FoldAll(*cache_);
+                ScheduleCounterFold();
+            });
+        }
+
+        // 每个 IO 线程自己监听时，连接留在接受它的线程上；只有一个监听套接字时轮流分配。
+        // 套接字直接建在目标 IO 线程的 io_context 上，分片模式下会话的读写和本地命令都在该核心线程上执行
+        void DoAccept(size_t index) {
+            size_t reactor = acceptors_.size() > 1 ? index : next_reactor_++ % reactors_.size();
+            acceptors_[index]->async_accept(
+                    asio::make_strand(*reactors_[reactor]),
+                    [this, index, reactor](std::error_code ec, asio::ip::tcp::socket socket) {
                         if (!ec) {
+                            // 停机时监听套接字可能在别的线程被关闭，取对端地址失败不应抛出
+                            std::error_code endpoint_ec;
+                            auto remote = socket.remote_endpoint(endpoint_ec);
                             ZEN_LOG_INFO("New client accepted from: {}",
-                                         socket.remote_endpoint().address().to_string());
+                                         endpoint_ec ? endpoint_ec.message() : remote.address().to_string());
 
                             auto session = std::make_shared<Session>(
                                     std::move(socket), cache_, task_queue_, channel_manager_);
+                            if (shard_router_) {
+                                session->SetShard(shard_router_.get(), reactor);
+                            }
+                            session->SetMaxBulkLength(max_bulk_length_);
                             {
                                 std::lock_guard<std::mutex> lock(sessions_mutex_);
                                 active_sessions_.push_back(session);
@@ -162,25 +253,37 @@ namespace Astra::apps {
                             ZEN_LOG_WARN("Accept error: {}", ec.message());
                         }
 
-                        if (!acceptor_.is_open()) {
+                        if (!acceptors_[index]->is_open()) {
                             ZEN_LOG_INFO("Acceptor closed, stopping accept loop");
                             return;
                         }
-                        DoAccept();
+                        DoAccept(index);
                     });
         }
 
         std::string persistence_db_name_;
         std::string leveldb_path_;
+#if defined(__linux__) && defined(SO_REUSEPORT)
+        static constexpr bool kReusePortBalancing = true;
+#else
+        static constexpr bool kReusePortBalancing = false;
+#endif
+
         asio::io_context &context_;
-        asio::ip::tcp::acceptor acceptor_;
+        std::vector<asio::io_context *> reactors_;
+        std::vector<std::unique_ptr<asio::ip::tcp::acceptor>> acceptors_;
+        size_t next_reactor_ = 0;
         std::shared_ptr<datastructures::AstraCache<datastructures::LRUCache, std::string, std::string>> cache_;
         std::shared_ptr<concurrent::TaskQueue> task_queue_;
+        size_t cache_size_;
+        size_t max_bulk_length_ = static_cast<size_t>(proto::ProtocolParser::kMaxBulkLength);
+        std::unique_ptr<ShardRouter> shard_router_;
         std::vector<std::shared_ptr<Session>> active_sessions_;
         std::mutex sessions_mutex_;
         bool enable_persistence_ = false;
         bool use_leveldb_ = false;
         std::shared_ptr<ChannelManager> channel_manager_;// 持有ChannelManager实例
+        asio::steady_timer counter_fold_timer_;
         // 集群相关成员
         bool enable_cluster_ = false;
         std::unique_ptr<Astra::cluster::ClusterCommunicator> cluster_communicator_;
@@ -6,6 +6,7 @@
 #define SERVER_INIT_H
 #include "config/ConfigManager.h"
 #include "fmt/color.h"
+#include "network/io_backend.hpp"
 #include "network/io_context_pool.hpp"
 #include "persistence/process.hpp"
 #include "server.hpp"
@@ -197,6 +198,14 @@ inline int startServer(int argc, char *argv[]) noexcept {
     size_t max_lru_size = config_manager->getMaxLRUSize();
     std::string persistence_file = config_manager->getPersistenceFileName();
 
+    // 套接字后端在编译期选定，启动参数只能选择本次构建实际使用的后端
+    std::string io_backend = config_manager->getIOBackend();
+    if (io_backend != "auto" && io_backend != Astra::network::IOBackendName()) {
+        std::cerr << "I/O backend '" << io_backend << "' is not available in this build (using "
+                  << Astra::network::IOBackendName() << "); rebuild with -DASTRA_ENABLE_IO_URING=ON for io_uring" << std::endl;
+        return 1;
+    }
+
     // 初始化服务器状态收集器
     initServerStatus();
 
@@ -226,7 +235,9 @@ inline int startServer(int argc, char *argv[]) noexcept {
 
     try {
         // 创建IO线程池
+        AsioIOServicePool::SetPoolSize(config_manager->getIOThreadCount());
         auto pool = AsioIOServicePool::GetInstance();
+        ZEN_LOG_INFO("Using {} I/O backend with {} IO threads", Astra::network::IOBackendName(), pool->Size());
         asio::io_context &io_context = pool->GetIOService();
         asio::signal_set signals(io_context, SIGINT, SIGTERM);
 
@@ -249,6 +260,19 @@ inline int startServer(int argc, char *argv[]) noexcept {
             ZEN_LOG_INFO("Persistence disabled");
         }
 
+        server->SetMaxBulkLength(config_manager->getProtoMaxBulkLen());
+
+        // 分片（thread-per-core）模式下各核心即 IO 线程，否则连接分散到线程池的每个 io_context
+        if (size_t shards = config_manager->getShardCount(); shards > 0) {
+            server->EnableShardMode(shards);
+        } else {
+            std::vector<asio::io_context *> reactors;
+            for (size_t i = 0; i < pool->Size(); ++i) {
+                reactors.push_back(&pool->GetIOService(i));
+            }
+            server->SetReactors(std::move(reactors));
+        }
+
         // 如果启用集群模式，初始化集群
         if (config_manager->getEnableCluster()) {
             auto cluster_manager = Astra::cluster::ClusterManager::GetInstance();
@@ -5,7 +5,9 @@
 #include "proto/ProtocolParser.hpp"
 #include "proto/redis_command_handler.hpp"
 #include "proto/resp_builder.hpp"
+#include "server/ShardRouter.hpp"
 #include "server/stats_event.h"
+#include <asio/dispatch.hpp>
 #include <asio/post.hpp>
 #include <fmt/format.h>
 #include <utils/uuid_utils.h>
@@ -99,7 +101,8 @@ namespace Astra::apps {
                                                                      redis_handler_(),
                                                                      cluster_session_(std::make_shared<cluster::ClusterSession>(cache)),
                                                                      session_mode_(SessionMode::CacheMode),
-                                                                     stopped_(false) {
+                                                                     stopped_(false),
+                                                                     block_timer_(strand_) {
         // 使用UUID工具类生成session_id_
         auto generator = Astra::utils::UuidUtils::GetInstance().get_generator();
 
@@ -162,6 +165,12 @@ namespace Astra::apps {
             (void) self->socket_.cancel(ec);
             (void) self->socket_.close(ec);
             self->CleanupSubscriptions();// 清理订阅关系
+            self->pending_attempt_ = nullptr;// 闭包持有会话自身，未投递的尝试直接丢弃
+            if (self->blocked_client_) {
+                BlockingManager::GetInstance()->Cancel(self->blocked_client_);
+                self->blocked_client_.reset();
+                self->block_timer_.cancel();
+            }
             ZEN_LOG_INFO("Client disconnected");
         });
     }
@@ -195,7 +204,7 @@ namespace Astra::apps {
             self->session_mode_ = new_mode;
             ZEN_LOG_DEBUG("Session switched to mode: {}",
                           new_mode == SessionMode::CacheMode ? "CacheMode" : "PubSubMode");
-            self->buffer_.clear();
+            self->buffer_.Clear();
             self->argv_.clear();
             self->parser_->Reset();
             if (new_mode == SessionMode::CacheMode) {
@@ -210,22 +219,24 @@ namespace Astra::apps {
     void Session::DoRead() {
         if (stopped_) return;
 
-        asio::async_read_until(socket_, asio::dynamic_buffer(buffer_), "\r\n",
-                               asio::bind_executor(strand_, [this, self = shared_from_this()](std::error_code ec, std::size_t) {
-                                   if (ec) {
-                                       if (ec != asio::error::eof) {
-                                           ZEN_LOG_WARN("Read error: {}", ec.message());
-                                       }
-                                       Stop();
-                                       return;
-                                   }
-
-                                   ProcessBuffer();
-
-                                   if (!stopped_) {
-                                       DoRead();
-                                   }
-                               }));
+        socket_.async_read_some(PrepareRead(),
+                                asio::bind_executor(strand_, [this, self = shared_from_this()](std::error_code ec, std::size_t bytes) {
+                                    if (ec) {
+                                        if (ec != asio::error::eof) {
+                                            ZEN_LOG_WARN("Read error: {}", ec.message());
+                                        }
+                                        Stop();
+                                        return;
+                                    }
+
+                                    CommitRead(bytes);
+                                    ProcessBuffer();
+
+                                    // 被阻塞命令挂起时暂停读取，由 Unpark 恢复
+                                    if (!stopped_ && !parked_ && !closing_) {
+                                        DoRead();
+                                    }
+                                }));
     }
 
     // 读取PubSub模式下的命令
@@ -238,78 +249,398 @@ namespace Astra::apps {
         }
 
         // 再读取新命令
-        asio::async_read_until(socket_, asio::dynamic_buffer(buffer_), "\r\n",
-                               asio::bind_executor(strand_, [this, self = shared_from_this()](asio::error_code ec, size_t) {
-                                   if (ec) {
-                                       ZEN_LOG_WARN("PubSub read error: {}", ec.message());
-                                       CleanupSubscriptions();
-                                       Stop();
-                                       return;
-                                   }
+        socket_.async_read_some(PrepareRead(),
+                                asio::bind_executor(strand_, [this, self = shared_from_this()](asio::error_code ec, size_t bytes) {
+                                    if (ec) {
+                                        ZEN_LOG_WARN("PubSub read error: {}", ec.message());
+                                        CleanupSubscriptions();
+                                        Stop();
+                                        return;
+                                    }
+
+                                    CommitRead(bytes);
+                                    ProcessBuffer();
+                                    if (!closing_) {
+                                        DoReadPubSub();
+                                    }
+                                }));
+    }
 
-                                   ProcessBuffer();
-                                   DoReadPubSub();
-                               }));
+    asio::mutable_buffer Session::PrepareRead() {
+        if (auto [large, remaining] = parser_->LargeBulkWindow(); remaining > 0) {
+            return asio::buffer(large, remaining);
+        }
+        size_t min_free = proto::ReadBuffer::kDefaultCapacity / 2;
+        size_t expected = parser_->ExpectedBytes();
+        size_t buffered = buffer_.Data().size();
+        if (expected > buffered) {
+            min_free = std::max(min_free, expected - buffered);
+        }
+        auto [data, size] = buffer_.PrepareWrite(min_free);
+        return asio::buffer(data, size);
     }
 
-    // 处理缓冲区中的协议数据
+    void Session::CommitRead(size_t bytes) {
+        if (parser_->LargeBulkWindow().second > 0) {
+            parser_->CommitLargeBulk(bytes);
+        } else {
+            buffer_.Commit(bytes);
+        }
+    }
+
+    // 解析缓冲区中所有完整的命令；参数在分发前拷出，已解析的前缀在本次读取结束时统一丢弃
     size_t Session::ProcessBuffer() {
-        size_t processed = parser_->ProcessBuffer(buffer_, argv_);
+        size_t processed = 0;
+        while (!stopped_ && !parked_ && !closing_) {
+            size_t consumed = 0;
+            auto result = parser_->Parse(buffer_.Data(), argv_views_, consumed);
+            if (result == proto::ProtocolParser::Result::NeedMore) {
+                break;
+            }
+            if (result == proto::ProtocolParser::Result::Error) {
+                // 之前解析出的命令照常执行，错误回复排在它们之后；全部写出后再关闭连接
+                FlushBatch();
+                WriteResponse(proto::RespBuilder::Error("Protocol error: " + parser_->ErrorMessage()));
+                buffer_.Clear();
+                closing_ = true;
+                CloseIfDrained();
+                return processed;
+            }
 
-        // Check if parsing is complete and process the request
-        if (parser_->GetParseState() == proto::ProtocolParser::ParseState::ReadingArrayHeader &&
-            parser_->GetRemainingArgs() == 0 && !argv_.empty()) {
-            ProcessRequest();
+            // 直接接收的大参数移入 argv_，其余参数从读缓冲拷出
+            auto large_args = parser_->TakeLargeArgs();
+            size_t next_large = 0;
+            argv_.resize(argv_views_.size());
+            for (size_t i = 0; i < argv_views_.size(); ++i) {
+                if (next_large < large_args.size() && large_args[next_large].first == i) {
+                    argv_[i] = std::move(large_args[next_large++].second);
+                } else {
+                    argv_[i].assign(argv_views_[i]);
+                }
+            }
+            buffer_.Consume(consumed);
+            processed += consumed;
+
+            if (!argv_.empty()) {
+                ProcessRequest();
+            }
         }
 
+        FlushBatch();
+        buffer_.Compact();
         return processed;
     }
 
     // 处理完整请求
     void Session::ProcessRequest() {
-        std::string full_cmd;
-        for (const auto &arg: argv_) {
-            full_cmd += (full_cmd.empty() ? "" : " ") + arg;
+        if (Logger::GetInstance().GetLevel() <= LogLevel::TRACE) {
+            std::string full_cmd;
+            for (const auto &arg: argv_) {
+                full_cmd += (full_cmd.empty() ? "" : " ") + arg;
+            }
+            ZEN_LOG_TRACE("Received command: {}", full_cmd);
         }
-        ZEN_LOG_TRACE("Received command: {}", full_cmd);
 
         const std::string &cmd = argv_[0];
         bool is_pubsub_cmd = (cmd == "SUBSCRIBE" || cmd == "UNSUBSCRIBE" || cmd == "PUBLISH" || cmd == "PSUBSCRIBE" || cmd == "PUNSUBSCRIBE");
+        bool is_blocking_cmd = proto::IsBlockingInvocation(argv_);
+        bool is_hello_cmd = proto::ICaseCmp(cmd, "HELLO");
 
+        if (!is_pubsub_cmd && !(is_blocking_cmd && session_mode_ == SessionMode::CacheMode) && !is_hello_cmd && cmd != "CLUSTER") {
+            // 普通命令攒成一批，本次读取解析完后一起提交（见 FlushBatch）
+            pending_batch_.push_back(std::move(argv_));
+            argv_.clear();
+            return;
+        }
+
+        // 特殊命令在 Strand 上就地处理，先把之前攒下的普通命令提交出去
+        FlushBatch();
         if (is_pubsub_cmd) {
             HandlePubSubCommand();// 直接处理PubSub命令（需 Strand 保护）
-        } else if (cmd == "CLUSTER") {
+        } else if (is_blocking_cmd) {
+            HandleBlockingCommand();
+        } else if (is_hello_cmd) {
+            HandleHello();
+        } else {
             // 处理集群命令
-            std::string response = HandleClusterCommand(argv_);
-            asio::post(strand_, [self = shared_from_this(), response]() {
-                self->WriteResponse(response);
+            WriteResponse(HandleClusterCommand(argv_));
+        }
+
+        // 清空参数向量，为下一次解析做准备
+        argv_.clear();
+    }
+
+    // 一次读取中解析出的普通命令作为一个任务交给工作线程依次执行，回复拼接后一次写出，
+    // 流水线请求不再是每条命令一次任务投递、一次 Strand 投递和一次写操作
+    void Session::FlushBatch() {
+        if (pending_batch_.empty()) return;
+        if (router_) {
+            DispatchToShards();
+            return;
+        }
+
+        queued_batches_.push_back(QueuedBatch{replies_.Reserve(), protocol_, std::move(pending_batch_)});
+        pending_batch_.clear();
+        RunQueuedBatches();
+    }
+
+    // 同一会话同时只有一个任务在执行，后续批次在上一个任务回到 Strand 后一并提交，
+    // 否则两个批次可能在不同工作线程上并发执行，同一连接的命令不再按发送顺序生效
+    void Session::RunQueuedBatches() {
+        if (batch_in_flight_) return;
+        if (queued_batches_.empty()) {
+            RunPendingAttempt();
+            return;
+        }
+
+        batch_in_flight_ = true;
+        std::vector<QueuedBatch> batches(std::make_move_iterator(queued_batches_.begin()),
+                                         std::make_move_iterator(queued_batches_.end()));
+        queued_batches_.clear();
+        task_queue_->Post([self = shared_from_this(), batches = std::move(batches)]() mutable {
+            std::vector<std::pair<uint64_t, std::string>> replies;
+            replies.reserve(batches.size());
+            for (const auto &batch: batches) {
+                replies.emplace_back(batch.seq, self->ExecuteBatch(batch.commands, batch.protocol));
+            }
+            asio::post(self->strand_, [self, replies = std::move(replies)]() mutable {
+                self->batch_in_flight_ = false;
+                for (auto &[seq, responses]: replies) {
+                    self->DeliverReply(seq, std::move(responses));
+                }
+                self->RunQueuedBatches();
             });
-        } else {
-            auto args_copy = argv_;
-            auto self = shared_from_this();
-            // 非PubSub命令提交到任务队列异步处理
-            (void) task_queue_->Submit([self, args_copy]() {
-                try {
-                    std::string response = self->handler_->ProcessCommand(args_copy);
-                    asio::post(self->strand_, [self, response]() {
-                        self->WriteResponse(response);
-                    });
-                } catch (const std::exception &e) {
-                    std::string error_msg = proto::RespBuilder::Error(e.what());
-                    asio::post(self->strand_, [self, error_msg]() {
-                        self->WriteResponse(error_msg);
+        });
+    }
+
+    bool Session::CommandsInFlight() const {
+        return batch_in_flight_ || !queued_batches_.empty() || shard_runs_in_flight_ > 0 || !shard_runs_.empty();
+    }
+
+    void Session::RunPendingAttempt() {
+        if (!pending_attempt_ || CommandsInFlight()) return;
+        task_queue_->Post(std::move(pending_attempt_));
+        pending_attempt_ = nullptr;
+    }
+
+    std::string Session::ExecuteBatch(const std::vector<std::vector<std::string>> &batch, proto::RespProtocol protocol) {
+        proto::RespBuilder::ProtocolScope scope(protocol);
+        std::string responses;
+        for (const auto &args: batch) {
+            try {
+                responses += handler_->ProcessCommand(args);
+            } catch (const std::exception &e) {
+                responses += proto::RespBuilder::Error(e.what());
+                ZEN_LOG_ERROR("Error processing request: {}", e.what());
+            }
+        }
+        return responses;
+    }
+
+    // 分片模式：键属于本核心的命令就在 IO 线程上执行，不经过任务队列；属于其他核心的命令连同回复序号发给所属核心。
+    // 只在本次批量内合并相邻的同核心命令，之前已预留序号的段不再追加，回复顺序与请求顺序一致
+    void Session::DispatchToShards() {
+        size_t first_new = shard_runs_.size();
+        for (auto &args: pending_batch_) {
+            size_t owner = router_->OwnerOf(args);
+            size_t target = owner == ShardRouter::npos ? core_ : owner;
+            if (shard_runs_.size() == first_new || shard_runs_.back().core != target) {
+                shard_runs_.push_back(ShardRun{target, replies_.Reserve(), false, protocol_, {}});
+            }
+            shard_runs_.back().barrier |= owner == ShardRouter::npos;
+            shard_runs_.back().commands.push_back(std::move(args));
+        }
+        pending_batch_.clear();
+        PumpShardRuns();
+    }
+
+    // 只涉及单个分区的段互不相交，可以同时在各自的核心上执行（同一核心的段经 FIFO 通道保持先后）；
+    // 无键或跨分区的命令是屏障：等之前发出的段全部回复后才在本核心执行，其后的段也排在它之后
+    void Session::PumpShardRuns() {
+        while (!shard_runs_.empty()) {
+            ShardRun &run = shard_runs_.front();
+            if (run.barrier && shard_runs_in_flight_ > 0) break;
+            if (run.core == core_) {
+                DeliverReply(run.seq, ExecuteBatch(run.commands, run.protocol));
+                shard_runs_.pop_front();
+                continue;
+            }
+
+            ++shard_runs_in_flight_;
+            router_->Send(run.core, [self = shared_from_this(), seq = run.seq, protocol = run.protocol, commands = std::move(run.commands)]() {
+                std::string responses = self->ExecuteBatch(commands, protocol);
+                self->router_->Send(self->core_, [self, seq, responses = std::move(responses)]() mutable {
+                    asio::dispatch(self->strand_, [self, seq, responses = std::move(responses)]() mutable {
+                        --self->shard_runs_in_flight_;
+                        self->DeliverReply(seq, std::move(responses));
+                        self->PumpShardRuns();
                     });
-                    ZEN_LOG_ERROR("Error processing request: {}", e.what());
-                }
+                });
             });
+            shard_runs_.pop_front();
         }
+        RunPendingAttempt();
+    }
 
-        // 清空参数向量，为下一次解析做准备
-        argv_.clear();
+    // HELLO 之前的命令已由 FlushBatch 按旧版本提交，切换只影响之后的命令；HELLO 本身按新版本回复
+    void Session::HandleHello() {
+        proto::HelloRequest request;
+        if (auto error = proto::ParseHelloRequest(argv_, request)) {
+            WriteResponse(*error);
+            return;
+        }
+        if (request.protocol) {
+            protocol_ = *request.protocol;
+        }
+        proto::RespBuilder::ProtocolScope scope(protocol_);
+        WriteResponse(proto::HelloReply(protocol_, client_id_));
+    }
+
+    // 处理阻塞命令（BLPOP/BRPOP/BLMOVE，以及带 BLOCK 的 XREAD/XREADGROUP）
+    // 回复可能由推入方在其他线程上构造，每个构造回复的闭包都带上本连接的协议版本
+    void Session::HandleBlockingCommand() {
+        proto::RespBuilder::ProtocolScope scope(protocol_);
+        std::weak_ptr<Session> weak_self = shared_from_this();
+        auto client = std::make_shared<BlockedClient>();
+        std::function<std::optional<std::string>()> attempt;
+        std::chrono::milliseconds timeout{0};
+        std::string timeout_reply;
+        std::string cmd;
+        size_t argc = argv_.size() - 1;
+
+        if (proto::ICaseCmp(argv_[0], "XREAD") || proto::ICaseCmp(argv_[0], "XREADGROUP")) {
+            auto request = std::make_shared<proto::StreamReadRequest>();
+            if (auto error = proto::ParseStreamReadRequest(argv_, *request)) {
+                WriteResponse(*error);
+                return;
+            }
+
+            cmd = request->command;
+            client->keys = request->keys;
+            timeout = std::chrono::milliseconds(request->block_ms);
+            timeout_reply = proto::RespBuilder::NullArray();
+            attempt = [cache = cache_, request, protocol = protocol_]() {
+                proto::RespBuilder::ProtocolScope scope(protocol);
+                return proto::TryServeStreamRead(*cache, *request);
+            };
+            // XADD 之后在锁内重试读取；流的读取不消费数据，读不到则继续等待。
+            // XADD 只持有 Mutex() 和它自己那个键的分片，请求涉及的其他键在这里补锁
+            client->on_ready = [weak_self, request, protocol = protocol_](const std::string &) {
+                auto self = weak_self.lock();
+                if (!self) return false;
+
+                auto locks = BlockingManager::GetInstance()->LockKeys(request->keys);
+                proto::RespBuilder::ProtocolScope scope(protocol);
+                auto response = proto::TryServeStreamRead(*self->cache_, *request);
+                if (!response) return false;
+                asio::post(self->strand_, [self, response = *response]() {
+                    self->Unpark(response);
+                });
+                return true;
+            };
+        } else {
+            proto::BlockingListRequest request;
+            if (auto error = proto::ParseBlockingListRequest(argv_, request)) {
+                WriteResponse(*error);
+                return;
+            }
+
+            cmd = request.command;
+            client->keys = request.keys;
+            if (request.timeout > 0) {
+                timeout = std::max(std::chrono::milliseconds(1),
+                                   std::chrono::milliseconds(static_cast<int64_t>(request.timeout * 1000)));
+            }
+            timeout_reply = request.TimeoutReply();
+            attempt = [cache = cache_, request, protocol = protocol_]() {
+                proto::RespBuilder::ProtocolScope scope(protocol);
+                return proto::TryServeBlockingList(*cache, request);
+            };
+            client->serve = [weak_self, request, protocol = protocol_](const std::string &key, data::AstraList &list) {
+                auto self = weak_self.lock();
+                if (!self) return false;// 会话已销毁，元素留给下一个等待者
+
+                proto::RespBuilder::ProtocolScope scope(protocol);
+                std::string response = proto::ServeBlockedListClient(*self->cache_, request, key, list);
+                asio::post(self->strand_, [self, response]() {
+                    self->Unpark(response);
+                });
+                return true;
+            };
+        }
+
+        // 挂起会话：在收到回复之前不再读取后续命令；回复占住当前位置，排在之前提交的命令之后
+        parked_ = true;
+        blocked_client_ = client;
+        blocked_reply_seq_ = replies_.Reserve();
+
+        // 在工作线程上做一次立即尝试；取不到数据时只登记等待，工作线程随即返回。
+        // 尝试排在之前提交的普通命令之后（见 RunPendingAttempt），不与它们并发执行
+        pending_attempt_ = [self = shared_from_this(), client, attempt, timeout, timeout_reply, cmd, argc]() {
+            stats::emitCommandProcessed(cmd, argc);
+
+            std::optional<std::string> response;
+            try {
+                auto manager = BlockingManager::GetInstance();
+                auto locks = manager->LockKeys(client->keys);
+                response = attempt();
+                if (!response) {
+                    manager->Block(client);
+                }
+            } catch (const std::exception &e) {
+                ZEN_LOG_ERROR("Error processing blocking request: {}", e.what());
+                response = proto::RespBuilder::Error(e.what());
+            }
+
+            if (response) {
+                asio::post(self->strand_, [self, response = *response]() {
+                    self->Unpark(response);
+                });
+            } else if (timeout.count() > 0) {
+                asio::post(self->strand_, [self, client, timeout, timeout_reply]() {
+                    self->ArmBlockTimer(client, timeout, timeout_reply);
+                });
+            }
+        };
+        RunPendingAttempt();
+    }
+
+    // 为阻塞中的客户端设置超时
+    void Session::ArmBlockTimer(const std::shared_ptr<BlockedClient> &client, std::chrono::milliseconds timeout,
+                                const std::string &timeout_reply) {
+        // 定时器就绪前客户端可能已被推入方唤醒
+        if (stopped_ || blocked_client_ != client) return;
+
+        block_timer_.expires_after(timeout);
+        block_timer_.async_wait(asio::bind_executor(strand_, [self = shared_from_this(), client, timeout_reply](asio::error_code ec) {
+            if (ec || self->blocked_client_ != client) return;
+
+            // Cancel 失败说明推入方已抢先服务，回复已在路上
+            if (BlockingManager::GetInstance()->Cancel(client)) {
+                self->Unpark(timeout_reply);
+            }
+        }));
+    }
+
+    // 阻塞命令完成：写回复并恢复读取
+    void Session::Unpark(const std::string &response) {
+        if (stopped_ || !parked_) return;
+
+        parked_ = false;
+        blocked_client_.reset();
+        block_timer_.cancel();
+        DeliverReply(blocked_reply_seq_, response);
+
+        // 挂起期间已读入的后续命令先处理掉，再继续读取（协议错误后连接正在关闭，不再读取）
+        ProcessBuffer();
+        if (!stopped_ && !parked_ && !closing_) {
+            DoRead();
+        }
     }
 
     // 处理PubSub命令（SUBSCRIBE/UNSUBSCRIBE/PUBLISH）
     void Session::HandlePubSubCommand() {
+        proto::RespBuilder::ProtocolScope scope(protocol_);
         const std::string &cmd = argv_[0];
         std::string response;
         bool need_switch_mode = false;
@@ -377,9 +708,7 @@ namespace Astra::apps {
                 }
                 SwitchMode(SessionMode::PubSubMode);
                 // 最终响应是所有模式的响应拼接
-                asio::post(strand_, [self = shared_from_this(), response]() {
-                    self->WriteResponse(response);
-                });
+                WriteResponse(response);
             }
         }
         // 处理 PUNSUBSCRIBE 命令
@@ -415,10 +744,8 @@ namespace Astra::apps {
                 SwitchMode(SessionMode::CacheMode);
             }
         }
-        // 提交响应到 Strand 执行
-        asio::post(strand_, [self = shared_from_this(), response]() {
-            self->WriteResponse(response);
-        });
+        // 已在 Strand 上，直接按序交付
+        WriteResponse(response);
     }
 
     // 触发消息写入（PubSub 模式下推送消息）
@@ -454,7 +781,8 @@ namespace Astra::apps {
             return;
         }
 
-        // 构建响应：区分普通消息（message）和模式消息（pmessage）
+        // 构建响应：区分普通消息（message）和模式消息（pmessage）；RESP3 连接上为推送帧
+        proto::RespBuilder::ProtocolScope scope(protocol_);
         std::string response;
         for (const auto &msg: messages) {
             if (msg.pattern.empty()) {
@@ -467,41 +795,65 @@ namespace Astra::apps {
         }
         ZEN_LOG_DEBUG("Built message response ({} bytes)", response.size());
 
-        // 异步写入消息
-        auto self = shared_from_this();
-        auto resp_ptr = std::make_shared<std::string>(response);
-        asio::async_write(socket_, asio::buffer(*resp_ptr),
-                          asio::bind_executor(strand_, [self, resp_ptr](asio::error_code ec, size_t bytes_sent) {
-                              self->is_writing_ = false;
-                              if (ec) {
-                                  ZEN_LOG_ERROR("Failed to send message: {} (sent {} bytes)", ec.message(), bytes_sent);
-                                  self->Stop();
-                              } else {
-                                  ZEN_LOG_DEBUG("Successfully sent {} bytes to subscriber", bytes_sent);
-                                  if (!self->msg_queue_.empty()) {
-                                      self->TriggerMessageWrite();
-                                  }
-                              }
-                          }));
+        // 推送消息不占回复序号，直接进入输出队列
+        QueueOutput(std::move(response));
+        is_writing_ = false;
+        if (!msg_queue_.empty()) {
+            TriggerMessageWrite();
+        }
     }
 
-    // 写入响应到客户端
+    // 写入当前请求的回复（在 Strand 上调用）：就地分配序号并交付，仍排在之前未完成的回复之后
     void Session::WriteResponse(const std::string &response) {
+        DeliverReply(replies_.Reserve(), response);
+    }
+
+    // 回复可能在工作线程上乱序完成；只有从队头开始连续就绪的回复才进入输出队列，保证按请求顺序写出
+    void Session::DeliverReply(uint64_t seq, std::string response) {
+        replies_.Complete(seq, std::move(response));
+        replies_.Drain([this](std::string ready) {
+            QueueOutput(std::move(ready));
+        });
+        CloseIfDrained();
+    }
+
+    // 所有输出都经过这里：写操作进行中时只追加到输出缓冲，同一时刻每个套接字最多一个 async_write
+    void Session::QueueOutput(std::string data) {
         if (stopped_) return;
 
-        auto self = shared_from_this();
-        auto response_copy = std::make_shared<std::string>(response);// 延长响应生命周期
-        asio::async_write(socket_, asio::buffer(*response_copy),
-                          asio::bind_executor(strand_, [self, response_copy](asio::error_code ec, size_t) {
+        output_.Append(std::move(data));
+        if (!write_in_flight_ && !output_.Empty()) {
+            DoWrite();
+        }
+    }
+
+    // 一次写出期间累积的全部回复合并为一个 scatter-gather 写操作
+    void Session::DoWrite() {
+        write_in_flight_ = true;
+        asio::async_write(socket_, output_.BeginFlush(),
+                          asio::bind_executor(strand_, [self = shared_from_this()](asio::error_code ec, size_t bytes_sent) {
+                              self->write_in_flight_ = false;
+                              self->output_.EndFlush();
                               if (ec) {
                                   ZEN_LOG_WARN("Failed to send response: {}", ec.message());
                                   self->Stop();
+                                  return;
+                              }
+                              ZEN_LOG_DEBUG("Sent {} bytes", bytes_sent);
+                              if (!self->stopped_ && !self->output_.Empty()) {
+                                  self->DoWrite();
                               } else {
-                                  ZEN_LOG_DEBUG("Sent response: {}", *response_copy);
+                                  self->CloseIfDrained();
                               }
                           }));
     }
 
+    void Session::CloseIfDrained() {
+        if (closing_ && replies_.Pending() == 0 && !write_in_flight_ && output_.Empty()) {
+            Stop();
+        }
+    }
+
     // 清理所有订阅关系（会话停止时调用）
     void Session::CleanupSubscriptions() {
         auto self = shared_from_this();
@@ -5,11 +5,20 @@
 #include "concurrent/task_queue.hpp"
 #include "datastructures/lockfree_queue.hpp"
 #include "datastructures/lru_cache.hpp"
+#include "datastructures/reorder_ring.hpp"
 #include "logger.hpp"
 #include "proto/ProtocolParser.hpp"
+#include "proto/resp_builder.hpp"
+#include "server/BlockingManager.hpp"
 #include "server/ChannelManager.hpp"
+#include "server/output_buffer.hpp"
 #include <asio.hpp>
+#include <algorithm>
 #include <asio/strand.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <unordered_set>
 #include <vector>
@@ -30,6 +39,8 @@ namespace Astra::cluster {
 }// namespace Astra::cluster
 
 namespace Astra::apps {
+    class ShardRouter;
+
     // 消息结构体，用于存储模式匹配信息
     struct PubSubMessage {
         // 添加默认构造函数（无参数）
@@ -106,26 +117,40 @@ namespace Astra::apps {
             cluster_communicator_ = communicator;
         }
 
-    private:
-        // 解析状态枚举
-        enum class ParseState {
-            ReadingArrayHeader,
-            ReadingBulkHeader,
-            ReadingBulkContent
-        };
+        // 分片模式：会话固定在 core 上，普通命令按键所属核心执行（须在 Start 之前调用）
+        void SetShard(ShardRouter *router, size_t core) {
+            router_ = router;
+            core_ = core;
+        }
+
+        // 单个请求参数的长度上限（须在 Start 之前调用）
+        void SetMaxBulkLength(size_t limit) {
+            parser_->SetMaxBulkLength(static_cast<int64_t>(std::min<size_t>(limit, INT64_MAX)));
+        }
 
+    private:
         // 私有成员变量（仅声明）
         SessionMode session_mode_;
         bool stopped_;
         asio::ip::tcp::socket socket_;
         asio::strand<asio::any_io_executor> strand_;
-        std::string buffer_;
+        proto::ReadBuffer buffer_;
         std::shared_ptr<datastructures::AstraCache<datastructures::LRUCache, std::string, std::string>> cache_;
         std::shared_ptr<proto::ProtocolParser> parser_;
         std::shared_ptr<server::CommandHandler> command_handler_;
         std::shared_ptr<proto::RedisCommandHandler> handler_;
         std::shared_ptr<concurrent::TaskQueue> task_queue_;
         std::vector<std::string> argv_;
+        std::vector<std::string_view> argv_views_;// 解析器输出，指向 buffer_
+        std::vector<std::vector<std::string>> pending_batch_;// 本次读取中待批量执行的普通命令
+        // 已预留回复序号、等待上一个任务完成的批次
+        struct QueuedBatch {
+            uint64_t seq;
+            proto::RespProtocol protocol;
+            std::vector<std::vector<std::string>> commands;
+        };
+        std::deque<QueuedBatch> queued_batches_;
+        bool batch_in_flight_ = false;
         std::shared_ptr<PubSubSession> pubsub_session_;// 依赖注入的PubSubSession
         datastructures::LockFreeQueue<PubSubMessage, 4096, datastructures::OverflowPolicy::RESIZE> msg_queue_;
         datastructures::LockFreeQueue<std::string, 4096, datastructures::OverflowPolicy::RESIZE> cluster_bus_msg_queue_;
@@ -136,15 +161,70 @@ namespace Astra::apps {
         std::shared_ptr<proto::RedisCommandHandler> redis_handler_;
         std::shared_ptr<cluster::ClusterSession> cluster_session_;
         Astra::cluster::ClusterCommunicator *cluster_communicator_;
+        // 阻塞列表命令：挂起期间不再读取新命令，也不占用任务队列的工作线程
+        bool parked_ = false;
+        std::shared_ptr<BlockedClient> blocked_client_;
+        asio::steady_timer block_timer_;
+        uint64_t blocked_reply_seq_ = 0;
+        // 阻塞命令的立即尝试：之前提交的批次（或分片段）全部完成后才投递，保证按发送顺序生效
+        std::function<void()> pending_attempt_;
+        // 协议错误后不再读取，等已提交命令的回复全部写出再关闭连接
+        bool closing_ = false;
+        // 回复按请求顺序交付；输出在写操作进行中时先累积，写完后一次 writev 发出
+        datastructures::ReorderRing<std::string> replies_;
+        OutputBuffer output_;
+        bool write_in_flight_ = false;
+        // HELLO 协商的协议版本，只在 Strand 上读写；提交批次时随批次记录，之后的 HELLO 不影响已提交的命令
+        proto::RespProtocol protocol_ = proto::RespProtocol::Resp2;
+        uint64_t client_id_ = NextClientId();
+        // 分片模式：连续落在同一核心上的命令合成一段，整段在该核心上执行
+        struct ShardRun {
+            size_t core;
+            uint64_t seq;
+            bool barrier;// 含无键或跨分区的命令
+            proto::RespProtocol protocol;
+            std::vector<std::vector<std::string>> commands;
+        };
+        ShardRouter *router_ = nullptr;
+        size_t core_ = 0;
+        std::deque<ShardRun> shard_runs_;
+        size_t shard_runs_in_flight_ = 0;
 
         // 私有成员函数声明
 
         void DoRead();
         void DoReadPubSub();
+        // 预留读缓冲的可写空间：至少一个读取块，正在接收大批量数据时一次扩容到位；
+        // 正在接收大参数时直接返回该参数尚未填充的部分
+        asio::mutable_buffer PrepareRead();
+        void CommitRead(size_t bytes);
         size_t ProcessBuffer();
         void ProcessRequest();
+        // 把攒下的普通命令作为一个任务提交
+        void FlushBatch();
+        void RunQueuedBatches();
+        // 是否还有已提交、尚未回到 Strand 的普通命令
+        bool CommandsInFlight() const;
+        // 没有普通命令在途时投递挂起的阻塞尝试
+        void RunPendingAttempt();
+        // 依次执行一批普通命令，返回拼接后的回复
+        std::string ExecuteBatch(const std::vector<std::vector<std::string>> &batch, proto::RespProtocol protocol);
+        // 分片模式下的 FlushBatch：按所属核心切段后交给 PumpShardRuns
+        void DispatchToShards();
+        void PumpShardRuns();
         // 处理PubSub命令的公共接口
         void HandlePubSubCommand();
+        // 处理 BLPOP/BRPOP/BLMOVE/XREAD BLOCK：能立即服务则直接回复，否则登记等待并挂起会话
+        void HandleBlockingCommand();
+        // 切换本连接的协议版本并回复服务器信息
+        void HandleHello();
+
+        static uint64_t NextClientId() {
+            static std::atomic<uint64_t> next{1};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+        void ArmBlockTimer(const std::shared_ptr<BlockedClient> &client, std::chrono::milliseconds timeout, const std::string &timeout_reply);
+        void Unpark(const std::string &response);
         void TriggerMessageWrite();
         void DoWriteMessages();
 
@@ -155,6 +235,11 @@ namespace Astra::apps {
         std::string HandleClusterCommand(const std::vector<std::string> &argv);
         // 写入响应的公共接口
         void WriteResponse(const std::string &response);
+        void DeliverReply(uint64_t seq, std::string response);
+        void QueueOutput(std::string data);
+        void DoWrite();
+        // 协议错误关闭：回复全部交付且输出写空后停止会话
+        void CloseIfDrained();
         void CleanupSubscriptions();
     };
 
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Astra::concurrent {
+
+    // 分片计数器：写远多于读的热点计数
+    // 每个线程固定落在一个独占缓存行的单元上累加，写路径只有一次无竞争的 relaxed fetch_add；
+    // 读取时汇总所有单元，Fold 把单元中的增量折叠进基准值。
+    class SplitCounter {
+    public:
+        static constexpr size_t kCacheLine = 64;
+
+        explicit SplitCounter(int64_t initial = 0, size_t cells = std::thread::hardware_concurrency())
+            : cell_count_(std::bit_ceil(std::max<size_t>(1, cells))),
+              cells_(std::make_unique<Cell[]>(cell_count_)),
+              base_(initial) {}
+
+        // 累加到当前线程的单元，返回 基准值 + 本单元未折叠的增量（不读其他线程的单元，只是近似值）
+        int64_t Add(int64_t delta) {
+            Cell &cell = cells_[ThreadSlot() & (cell_count_ - 1)];
+            int64_t local = cell.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+            return base_.load(std::memory_order_relaxed) + local;
+        }
+
+        // 精确值：基准值加上所有单元
+        int64_t Read() const {
+            std::lock_guard<std::mutex> lock(fold_mutex_);
+            int64_t total = base_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < cell_count_; ++i) {
+                total += cells_[i].value.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        // 把所有单元清零并累加进基准值，返回折叠后的基准值
+        int64_t Fold() {
+            std::lock_guard<std::mutex> lock(fold_mutex_);
+            int64_t base = base_.load(std::memory_order_relaxed) + DrainCells();
+            base_.store(base, std::memory_order_relaxed);
+            return base;
+        }
+
+        // 以 value 为新的基准值，保留尚未折叠的增量（外部直接改写了计数值时使用）
+        int64_t Rebase(int64_t value) {
+            std::lock_guard<std::mutex> lock(fold_mutex_);
+            int64_t base = value + DrainCells();
+            base_.store(base, std::memory_order_relaxed);
+            return base;
+        }
+
+        size_t CellCount() const { return cell_count_; }
+
+    private:
+        struct alignas(kCacheLine) Cell {
+            std::atomic<int64_t> value{0};
+        };
+
+        // 线程首次使用时分配一个递增的槽位，线程数不超过单元数时互不共享缓存行
+        static size_t ThreadSlot() {
+            static std::atomic<size_t> next_slot{0};
+            thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+
+        int64_t DrainCells() {
+            int64_t sum = 0;
+            for (size_t i = 0; i < cell_count_; ++i) {
+                sum += cells_[i].value.exchange(0, std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        size_t cell_count_;
+        std::unique_ptr<Cell[]> cells_;
+        std::atomic<int64_t> base_;
+        mutable std::mutex fold_mutex_;
+    };
+
+}// namespace Astra::concurrent
@@ -55,6 +55,37 @@ namespace Astra::concurrent {
             }
         }
 
+        // 提交所有任务并阻塞等待全部完成（任务抛出的异常不会阻止计数归零）
+        // 注意：不要在同一个 queue_ 的工作线程上调用，否则可能因线程全部阻塞而死锁
+        void RunAndWait() {
+            if (tasks_.empty()) return;
+
+            struct WaitState {
+                std::mutex mutex;
+                std::condition_variable cv;
+                size_t pending;
+            };
+            auto state = std::make_shared<WaitState>();
+            state->pending = tasks_.size();
+
+            for (auto &task: tasks_) {
+                queue_->Post([task, state]() {
+                    try {
+                        task();
+                    } catch (const std::exception &e) {
+                        ZEN_LOG_ERROR("ParallelWork task failed: {}", e.what());
+                    }
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (--state->pending == 0) {
+                        state->cv.notify_all();
+                    }
+                });
+            }
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait(lock, [&state] { return state->pending == 0; });
+        }
+
     private:
         std::vector<std::function<void()>> tasks_;
         std::shared_ptr<TaskQueue> queue_;
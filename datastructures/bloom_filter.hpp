@@ -0,0 +1,318 @@
+#pragma once
+
+#include "utils/bitops.hpp"
+#include "utils/hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Astra::datastructures {
+
+    namespace bloom_detail {
+
+        // 块内 8 个位置的盐值（奇数，与 Parquet 分块 Bloom 过滤器相同）
+        alignas(32) inline constexpr uint32_t kSalts[8] = {
+                0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+        inline bool ProbeScalar(const uint8_t *block, uint32_t key) {
+            for (int i = 0; i < 8; ++i) {
+                uint64_t word;
+                std::memcpy(&word, block + 8 * i, sizeof(word));
+                if (!((word >> ((key * kSalts[i]) >> 26)) & 1)) return false;
+            }
+            return true;
+        }
+
+        inline void InsertScalar(uint8_t *block, uint32_t key) {
+            for (int i = 0; i < 8; ++i) {
+                uint64_t word;
+                std::memcpy(&word, block + 8 * i, sizeof(word));
+                word |= uint64_t(1) << ((key * kSalts[i]) >> 26);
+                std::memcpy(block + 8 * i, &word, sizeof(word));
+            }
+        }
+
+#if defined(ASTRA_BITOPS_X86)
+        // 8 个 32 位乘法一次算出 8 个位号，再展开成两组 4×64 位掩码，对应块的前后 32 字节
+        ASTRA_TARGET("avx2")
+        inline void MasksAvx2(uint32_t key, __m256i &mask_lo, __m256i &mask_hi) {
+            const __m256i salts = _mm256_load_si256(reinterpret_cast<const __m256i *>(kSalts));
+            __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 26);
+            const __m256i one = _mm256_set1_epi64x(1);
+            mask_lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+            mask_hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+        }
+
+        ASTRA_TARGET("avx2")
+        inline bool ProbeAvx2(const uint8_t *block, uint32_t key) {
+            __m256i mask_lo, mask_hi;
+            MasksAvx2(key, mask_lo, mask_hi);
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+            return _mm256_testc_si256(lo, mask_lo) && _mm256_testc_si256(hi, mask_hi);
+        }
+
+        ASTRA_TARGET("avx2")
+        inline void InsertAvx2(uint8_t *block, uint32_t key) {
+            __m256i mask_lo, mask_hi;
+            MasksAvx2(key, mask_lo, mask_hi);
+            auto *lo = reinterpret_cast<__m256i *>(block);
+            auto *hi = reinterpret_cast<__m256i *>(block + 32);
+            _mm256_storeu_si256(lo, _mm256_or_si256(_mm256_loadu_si256(lo), mask_lo));
+            _mm256_storeu_si256(hi, _mm256_or_si256(_mm256_loadu_si256(hi), mask_hi));
+        }
+#endif
+
+        inline bool Probe(const uint8_t *block, uint32_t key) {
+#if defined(ASTRA_BITOPS_X86)
+            if (utils::bitops::ActiveIsa() == utils::bitops::Isa::Avx2) return ProbeAvx2(block, key);
+#endif
+            return ProbeScalar(block, key);
+        }
+
+        inline void Insert(uint8_t *block, uint32_t key) {
+#if defined(ASTRA_BITOPS_X86)
+            if (utils::bitops::ActiveIsa() == utils::bitops::Isa::Avx2) return InsertAvx2(block, key);
+#endif
+            InsertScalar(block, key);
+        }
+
+        inline void Prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address);
+#elif defined(ASTRA_BITOPS_X86)
+            _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#endif
+        }
+
+    }// namespace bloom_detail
+
+    // 可扩容的分块 Bloom 过滤器（BF.* 命令）。整个过滤器就是一个普通字符串值，命令在缓存锁内原地读写，不做整体拷贝
+    // 布局："bloom:" + 全局头(16) + 若干层，每层 = 层头(32) + blocks × 64 字节
+    //   全局头：版本(1) 标志(1，bit0 = 不扩容) 保留(2) expansion(4) 层数(4) 保留(4)
+    //   层头：  容量(8) 已插入数(8) 误判率(8，double) 块数(8)
+    // 分块：哈希的高 32 位选定一个 64 字节（一条缓存行）的块，低 32 位与 8 个盐值相乘，在块内 8 个 64 位字里各置 1 位，
+    //       一次查询只访问一条缓存行，AVX2 下 8 个位置一次算完并用一条 testc 判断。
+    // 扩容：最后一层满了就追加一层，容量乘以 expansion、误判率减半，总误判率不超过初始设定。
+    class BloomFilter {
+    public:
+        static constexpr std::string_view kMagic = "bloom:";
+        static constexpr size_t kHeaderBytes = 16;
+        static constexpr size_t kLayerHeaderBytes = 32;
+        static constexpr size_t kBlockBytes = 64;
+        static constexpr size_t kMaxBytes = 512ULL * 1024 * 1024;// 与字符串值的上限一致
+        static constexpr double kTighteningRatio = 0.5;
+
+        struct Options {
+            double error_rate = 0.01;
+            uint64_t capacity = 100;
+            uint32_t expansion = 2;
+            bool scaling = true;
+        };
+
+        enum class AddResult { Added,
+                               Exists,
+                               Full };
+
+        struct Info {
+            uint64_t capacity = 0;// 各层容量之和
+            uint64_t items = 0;
+            uint32_t layers = 0;
+            uint32_t expansion = 0;
+            size_t bytes = 0;
+        };
+
+        // 编码一个空过滤器；超过 kMaxBytes 时返回空串
+        static std::string Create(const Options &options) {
+            uint64_t blocks = BlocksFor(options.capacity, options.error_rate);
+            if (blocks > (kMaxBytes - kMagic.size() - kHeaderBytes - kLayerHeaderBytes) / kBlockBytes) return {};
+
+            std::string data(kMagic);
+            data.resize(kMagic.size() + kHeaderBytes, '\0');
+            data[kMagic.size()] = 1;// 版本
+            data[kMagic.size() + 1] = options.scaling ? 0 : 1;
+            Store<uint32_t>(data, kMagic.size() + 4, options.expansion);
+            Store<uint32_t>(data, kMagic.size() + 8, 0);
+            AppendLayer(data, options.capacity, options.error_rate, blocks);
+            return data;
+        }
+
+        // 校验头部与各层长度是否自洽，不合法的值按 WRONGTYPE 处理
+        static bool IsValid(std::string_view data) {
+            if (data.size() < kMagic.size() + kHeaderBytes || data.substr(0, kMagic.size()) != kMagic) return false;
+            if (data[kMagic.size()] != 1) return false;
+
+            uint32_t layers = Load<uint32_t>(data, kMagic.size() + 8);
+            size_t pos = kMagic.size() + kHeaderBytes;
+            for (uint32_t i = 0; i < layers; ++i) {
+                if (data.size() - pos < kLayerHeaderBytes) return false;
+                uint64_t blocks = Load<uint64_t>(data, pos + 24);
+                if (blocks == 0 || blocks > (data.size() - pos - kLayerHeaderBytes) / kBlockBytes) return false;
+                pos += kLayerHeaderBytes + blocks * kBlockBytes;
+            }
+            return layers > 0 && pos == data.size();
+        }
+
+        static uint64_t Hash(std::string_view item) {
+            return utils::MurmurHash64A(item.data(), item.size(), 0x5f3759dfULL);
+        }
+
+        static bool Contains(std::string_view data, uint64_t hash) {
+            bool found = false;
+            ForEachLayer(data, [&](size_t header, uint32_t index) {
+                uint32_t key;
+                const uint8_t *block = Locate(data, header, hash, index, key);
+                found = bloom_detail::Probe(block, key);
+                return !found;
+            });
+            return found;
+        }
+
+        // 批量查询：每 16 个元素先算出块地址并预取，再逐个探测，把缓存未命中重叠起来
+        static void ContainsMany(std::string_view data, std::span<const uint64_t> hashes, std::span<uint8_t> found) {
+            constexpr size_t kBatch = 16;
+            std::fill(found.begin(), found.end(), 0);
+            ForEachLayer(data, [&](size_t header, uint32_t index) {
+                for (size_t begin = 0; begin < hashes.size(); begin += kBatch) {
+                    size_t end = std::min(hashes.size(), begin + kBatch);
+                    const uint8_t *blocks[kBatch];
+                    uint32_t keys[kBatch];
+                    for (size_t i = begin; i < end; ++i) {
+                        blocks[i - begin] = found[i] ? nullptr : Locate(data, header, hashes[i], index, keys[i - begin]);
+                        if (blocks[i - begin]) bloom_detail::Prefetch(blocks[i - begin]);
+                    }
+                    for (size_t i = begin; i < end; ++i) {
+                        if (blocks[i - begin] && bloom_detail::Probe(blocks[i - begin], keys[i - begin])) found[i] = 1;
+                    }
+                }
+                return true;
+            });
+        }
+
+        // 已（可能）存在时返回 Exists 且不修改；最后一层已满且不允许扩容（或扩容后超出上限）时返回 Full
+        static AddResult Add(std::string &data, uint64_t hash) {
+            if (Contains(data, hash)) return AddResult::Exists;
+
+            uint32_t layers = Load<uint32_t>(data, kMagic.size() + 8);
+            size_t last = LastLayer(data);
+            uint64_t capacity = Load<uint64_t>(data, last);
+            if (Load<uint64_t>(data, last + 8) >= capacity) {
+                if (data[kMagic.size() + 1] & 1) return AddResult::Full;
+
+                uint64_t expansion = std::max<uint32_t>(1, Load<uint32_t>(data, kMagic.size() + 4));
+                uint64_t next_capacity = capacity > UINT64_MAX / expansion ? UINT64_MAX : capacity * expansion;
+                double next_error = Load<double>(data, last + 16) * kTighteningRatio;
+                uint64_t blocks = BlocksFor(next_capacity, next_error);
+                if (blocks > (kMaxBytes - data.size() - kLayerHeaderBytes) / kBlockBytes) return AddResult::Full;
+
+                last = data.size();
+                AppendLayer(data, next_capacity, next_error, blocks);
+                ++layers;
+            }
+
+            uint32_t key;
+            auto *block = const_cast<uint8_t *>(Locate(data, last, hash, layers - 1, key));
+            bloom_detail::Insert(block, key);
+            Store<uint64_t>(data, last + 8, Load<uint64_t>(data, last + 8) + 1);
+            return AddResult::Added;
+        }
+
+        static Info GetInfo(std::string_view data) {
+            Info info;
+            info.expansion = Load<uint32_t>(data, kMagic.size() + 4);
+            info.bytes = data.size();
+            ForEachLayer(data, [&](size_t header, uint32_t) {
+                info.capacity += Load<uint64_t>(data, header);
+                info.items += Load<uint64_t>(data, header + 8);
+                ++info.layers;
+                return true;
+            });
+            return info;
+        }
+
+        // 每块平均装入 keys_per_block 个元素时的理论误判率：块负载服从泊松分布，块内 8 个字各置 1 位
+        static double FalsePositiveRate(double keys_per_block) {
+            double probability = std::exp(-keys_per_block);// P(n = 0)
+            double rate = 0.0;
+            auto limit = static_cast<int>(keys_per_block + 12 * std::sqrt(keys_per_block) + 30);
+            for (int n = 0; n <= limit; ++n) {
+                double word_hit = 1.0 - std::pow(63.0 / 64.0, n);
+                rate += probability * std::pow(word_hit, 8);
+                probability *= keys_per_block / (n + 1);
+            }
+            return rate;
+        }
+
+        // 在误判率约束下每块最多能装多少元素（二分），据此得到块数
+        static uint64_t BlocksFor(uint64_t capacity, double error_rate) {
+            double lo = 0.0, hi = kBlockBytes * 8;
+            if (FalsePositiveRate(hi) > error_rate) {
+                for (int i = 0; i < 64; ++i) {
+                    double mid = (lo + hi) / 2;
+                    (FalsePositiveRate(mid) <= error_rate ? lo : hi) = mid;
+                }
+                hi = lo;
+            }
+            double blocks = std::ceil(static_cast<double>(capacity) / std::max(hi, 1e-9));
+            return blocks >= 1e18 ? UINT64_MAX : std::max<uint64_t>(1, static_cast<uint64_t>(blocks));
+        }
+
+    private:
+        // 回调 fn(layer_header_offset, layer_index)，返回 false 时停止
+        template<typename Fn>
+        static void ForEachLayer(std::string_view data, Fn &&fn) {
+            uint32_t layers = Load<uint32_t>(data, kMagic.size() + 8);
+            size_t pos = kMagic.size() + kHeaderBytes;
+            for (uint32_t i = 0; i < layers; ++i) {
+                if (!fn(pos, i)) return;
+                pos += kLayerHeaderBytes + Load<uint64_t>(data, pos + 24) * kBlockBytes;
+            }
+        }
+
+        static size_t LastLayer(std::string_view data) {
+            size_t last = 0;
+            ForEachLayer(data, [&](size_t header, uint32_t) {
+                last = header;
+                return true;
+            });
+            return last;
+        }
+
+        // 各层使用互不相关的哈希，避免同一元素在每层都落在相同的相对位置
+        static const uint8_t *Locate(std::string_view data, size_t header, uint64_t hash, uint32_t index, uint32_t &key) {
+            if (index > 0) hash = utils::Mix64(hash + index * 0x9e3779b97f4a7c15ULL);
+            uint64_t blocks = Load<uint64_t>(data, header + 24);
+            uint64_t block = ((hash >> 32) * blocks) >> 32;// 块数不超过 2^23，乘积不会溢出
+            key = static_cast<uint32_t>(hash);
+            return reinterpret_cast<const uint8_t *>(data.data()) + header + kLayerHeaderBytes + block * kBlockBytes;
+        }
+
+        static void AppendLayer(std::string &data, uint64_t capacity, double error_rate, uint64_t blocks) {
+            size_t header = data.size();
+            data.resize(header + kLayerHeaderBytes + blocks * kBlockBytes, '\0');
+            Store<uint64_t>(data, header, capacity);
+            Store<uint64_t>(data, header + 8, 0);
+            Store<double>(data, header + 16, error_rate);
+            Store<uint64_t>(data, header + 24, blocks);
+            Store<uint32_t>(data, kMagic.size() + 8, Load<uint32_t>(data, kMagic.size() + 8) + 1);
+        }
+
+        template<typename T>
+        static T Load(std::string_view data, size_t offset) {
+            T value;
+            std::memcpy(&value, data.data() + offset, sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        static void Store(std::string &data, size_t offset, T value) {
+            std::memcpy(data.data() + offset, &value, sizeof(T));
+        }
+    };
+
+}// namespace Astra::datastructures
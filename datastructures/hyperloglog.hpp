@@ -0,0 +1,362 @@
+#pragma once
+
+#include "utils/bitops.hpp"
+#include "utils/hash.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Astra::datastructures {
+
+    // HyperLogLog 基数估计，存储格式与 Redis 完全一致，可直接被 GET/SET/DUMP 搬运
+    // 头部 16 字节："HYLL" + 编码(1) + 保留(3) + 缓存的基数(8，小端，最高位置 1 表示失效)
+    // 稀疏编码：ZERO / XZERO / VAL 三种操作码描述寄存器游程，小基数时只占几百字节
+    // 密集编码：16384 个 6 位寄存器紧密排列，固定 12 KB
+    class HyperLogLog {
+    public:
+        static constexpr int kPrecision = 14;
+        static constexpr size_t kRegisters = size_t(1) << kPrecision;
+        static constexpr int kRegisterBits = 6;
+        static constexpr size_t kHeaderBytes = 16;
+        static constexpr size_t kDenseBytes = kHeaderBytes + kRegisters * kRegisterBits / 8;
+        // 稀疏表示超过该大小时转为密集表示（对应 hll-sparse-max-bytes 的默认值）
+        static constexpr size_t kSparseMaxBytes = 3000;
+        // VAL 操作码最多表示 32，更大的寄存器值只能用密集表示
+        static constexpr uint8_t kSparseMaxValue = 32;
+
+        using Registers = std::array<uint8_t, kRegisters>;
+
+        enum class Encoding : uint8_t {
+            Dense = 0,
+            Sparse = 1
+        };
+
+        // 空的 HLL：稀疏编码，一条 XZERO 覆盖全部寄存器
+        HyperLogLog() {
+            bytes_.assign(kHeaderBytes, '\0');
+            std::memcpy(bytes_.data(), "HYLL", 4);
+            bytes_[4] = static_cast<char>(Encoding::Sparse);
+            AppendZeroRun(bytes_, kRegisters);
+        }
+
+        // 校验并接管一个序列化值；不是合法 HLL 时返回 nullopt
+        static std::optional<HyperLogLog> FromBytes(std::string bytes) {
+            if (!IsValid(bytes)) return std::nullopt;
+            HyperLogLog hll(PrivateTag{});
+            hll.bytes_ = std::move(bytes);
+            return hll;
+        }
+
+        static bool IsValid(std::string_view bytes) {
+            if (bytes.size() < kHeaderBytes || bytes.compare(0, 4, "HYLL") != 0) return false;
+            auto encoding = static_cast<uint8_t>(bytes[4]);
+            if (encoding == static_cast<uint8_t>(Encoding::Dense)) return bytes.size() == kDenseBytes;
+            return encoding == static_cast<uint8_t>(Encoding::Sparse);
+        }
+
+        // 由原始寄存器构造：能用稀疏表示就用稀疏，否则密集
+        static HyperLogLog FromRegisters(const Registers &registers) {
+            HyperLogLog hll(PrivateTag{});
+            hll.bytes_.assign(kHeaderBytes, '\0');
+            std::memcpy(hll.bytes_.data(), "HYLL", 4);
+            if (!EncodeSparse(registers, hll.bytes_)) {
+                hll.bytes_.resize(kHeaderBytes);
+                hll.bytes_[4] = static_cast<char>(Encoding::Dense);
+                hll.bytes_.resize(kDenseBytes);
+                PackDense(registers, Payload(hll.bytes_));
+            } else {
+                hll.bytes_[4] = static_cast<char>(Encoding::Sparse);
+            }
+            hll.InvalidateCache();
+            return hll;
+        }
+
+        Encoding GetEncoding() const {
+            return static_cast<Encoding>(bytes_[4]);
+        }
+
+        // 序列化结果；稀疏表示有未落盘的修改时在这里重新编码
+        const std::string &Bytes() {
+            Flush();
+            return bytes_;
+        }
+
+        // 交出序列化结果（先落盘未编码的修改），之后本对象不再可用；用于在缓存值上原地读改写
+        std::string Release() {
+            Flush();
+            return std::move(bytes_);
+        }
+
+        // 添加一个元素，返回是否有寄存器被改变（改变时同时使缓存的基数失效）
+        bool Add(std::string_view element) {
+            auto [index, rank] = HashElement(element);
+            return AddHash(index, rank);
+        }
+
+        // 以 HashElement 的结果添加，调用方可以在加锁前算好哈希
+        bool AddHash(size_t index, uint8_t rank) {
+            if (GetEncoding() == Encoding::Dense) {
+                uint8_t *payload = Payload(bytes_);
+                if (GetDenseRegister(payload, index) >= rank) return false;
+                SetDenseRegister(payload, index, rank);
+                InvalidateCache();
+                return true;
+            }
+
+            // 稀疏表示先解码成寄存器数组，同一批添加复用该数组，最后在 Flush 中统一编码
+            if (!pending_) {
+                pending_ = std::make_unique<Registers>();
+                DecodeSparse(bytes_, *pending_);
+            }
+            if ((*pending_)[index] >= rank) return false;
+            (*pending_)[index] = rank;
+            pending_dirty_ = true;
+            InvalidateCache();
+            return true;
+        }
+
+        // 把自身寄存器按最大值合并进 registers
+        void MergeInto(Registers &registers) {
+            Registers mine;
+            ToRegisters(mine);
+            utils::bitops::MaxBytes(registers.data(), mine.data(), kRegisters);
+        }
+
+        void ToRegisters(Registers &registers) {
+            if (pending_) {
+                registers = *pending_;
+            } else if (GetEncoding() == Encoding::Dense) {
+                UnpackDense(Payload(bytes_), registers);
+            } else {
+                DecodeSparse(bytes_, registers);
+            }
+        }
+
+        bool HasCachedCount() const {
+            return (static_cast<uint8_t>(bytes_[15]) & 0x80) == 0;
+        }
+
+        // 估计基数；缓存有效时直接返回，否则计算后写回头部缓存
+        uint64_t Count() {
+            if (HasCachedCount()) {
+                uint64_t cached = 0;
+                for (int i = 7; i >= 0; --i) {
+                    cached = (cached << 8) | static_cast<uint8_t>(bytes_[8 + i]);
+                }
+                return cached;
+            }
+
+            Registers registers;
+            ToRegisters(registers);
+            uint64_t estimate = Estimate(registers);
+            for (int i = 0; i < 8; ++i) {
+                bytes_[8 + i] = static_cast<char>((estimate >> (8 * i)) & 0xFF);
+            }
+            return estimate;
+        }
+
+        // Ertl 改进的估计算法（与 Redis 5.0 之后的实现相同），无需经验偏差修正表
+        static uint64_t Estimate(const Registers &registers) {
+            constexpr int q = 64 - kPrecision;
+            constexpr double m = static_cast<double>(kRegisters);
+            constexpr double alpha_inf = 0.721347520444481703680;
+
+            std::array<int, 64> histogram{};
+            for (uint8_t value: registers) {
+                ++histogram[value];
+            }
+
+            double z = m * Tau((m - histogram[q + 1]) / m);
+            for (int j = q; j >= 1; --j) {
+                z += histogram[j];
+                z *= 0.5;
+            }
+            z += m * Sigma(histogram[0] / m);
+            return static_cast<uint64_t>(std::llround(alpha_inf * m * m / z));
+        }
+
+        // 元素哈希：低 14 位选寄存器，其余位中第一个 1 出现的位置为寄存器候选值
+        static std::pair<size_t, uint8_t> HashElement(std::string_view element) {
+            uint64_t hash = utils::MurmurHash64A(element.data(), element.size(), 0xadc83b19ULL);
+            size_t index = static_cast<size_t>(hash & (kRegisters - 1));
+            hash >>= kPrecision;
+            hash |= uint64_t(1) << (64 - kPrecision);// 哨兵位，保证计数不超过 q + 1
+            return {index, static_cast<uint8_t>(std::countr_zero(hash) + 1)};
+        }
+
+    private:
+        struct PrivateTag {};
+        explicit HyperLogLog(PrivateTag) {}
+
+        static uint8_t *Payload(std::string &bytes) {
+            return reinterpret_cast<uint8_t *>(bytes.data()) + kHeaderBytes;
+        }
+
+        void InvalidateCache() {
+            bytes_[15] = static_cast<char>(static_cast<uint8_t>(bytes_[15]) | 0x80);
+        }
+
+        // 重新编码稀疏表示的修改；超出稀疏表示能力时转为密集
+        void Flush() {
+            if (!pending_) return;
+            if (pending_dirty_) {
+                std::string encoded(bytes_, 0, kHeaderBytes);
+                if (EncodeSparse(*pending_, encoded)) {
+                    bytes_ = std::move(encoded);
+                } else {
+                    bytes_.resize(kHeaderBytes);
+                    bytes_[4] = static_cast<char>(Encoding::Dense);
+                    bytes_.resize(kDenseBytes);
+                    PackDense(*pending_, Payload(bytes_));
+                }
+            }
+            pending_.reset();
+            pending_dirty_ = false;
+        }
+
+        // 密集寄存器：每 3 个字节 4 个寄存器，低位在前
+        static uint8_t GetDenseRegister(const uint8_t *p, size_t index) {
+            size_t bit = index * kRegisterBits;
+            size_t byte = bit / 8;
+            unsigned shift = bit & 7;
+            unsigned value = p[byte] >> shift;
+            if (shift > 8 - kRegisterBits) value |= p[byte + 1] << (8 - shift);
+            return static_cast<uint8_t>(value & 63);
+        }
+
+        static void SetDenseRegister(uint8_t *p, size_t index, uint8_t value) {
+            size_t bit = index * kRegisterBits;
+            size_t byte = bit / 8;
+            unsigned shift = bit & 7;
+            p[byte] = static_cast<uint8_t>((p[byte] & ~(63u << shift)) | (value << shift));
+            if (shift > 8 - kRegisterBits) {
+                unsigned high = 8 - shift;
+                p[byte + 1] = static_cast<uint8_t>((p[byte + 1] & ~(63u >> high)) | (value >> high));
+            }
+        }
+
+        static void UnpackDense(const uint8_t *p, Registers &registers) {
+            for (size_t r = 0, b = 0; r < kRegisters; r += 4, b += 3) {
+                uint8_t b0 = p[b], b1 = p[b + 1], b2 = p[b + 2];
+                registers[r] = b0 & 63;
+                registers[r + 1] = static_cast<uint8_t>(((b0 >> 6) | (b1 << 2)) & 63);
+                registers[r + 2] = static_cast<uint8_t>(((b1 >> 4) | (b2 << 4)) & 63);
+                registers[r + 3] = b2 >> 2;
+            }
+        }
+
+        static void PackDense(const Registers &registers, uint8_t *p) {
+            for (size_t r = 0, b = 0; r < kRegisters; r += 4, b += 3) {
+                p[b] = static_cast<uint8_t>(registers[r] | (registers[r + 1] << 6));
+                p[b + 1] = static_cast<uint8_t>((registers[r + 1] >> 2) | (registers[r + 2] << 4));
+                p[b + 2] = static_cast<uint8_t>((registers[r + 2] >> 4) | (registers[r + 3] << 2));
+            }
+        }
+
+        // 稀疏操作码：
+        //   ZERO  00xxxxxx           连续 1..64 个 0
+        //   XZERO 01xxxxxx yyyyyyyy  连续 1..16384 个 0
+        //   VAL   1vvvvvxx           连续 1..4 个值为 1..32 的寄存器
+        static void AppendZeroRun(std::string &out, size_t run) {
+            while (run > 0) {
+                size_t len = std::min<size_t>(run, 16384);
+                if (len <= 64) {
+                    out.push_back(static_cast<char>(len - 1));
+                } else {
+                    out.push_back(static_cast<char>(0x40 | ((len - 1) >> 8)));
+                    out.push_back(static_cast<char>((len - 1) & 0xFF));
+                }
+                run -= len;
+            }
+        }
+
+        static void DecodeSparse(const std::string &bytes, Registers &registers) {
+            registers.fill(0);
+            const auto *p = reinterpret_cast<const uint8_t *>(bytes.data()) + kHeaderBytes;
+            const auto *end = reinterpret_cast<const uint8_t *>(bytes.data()) + bytes.size();
+            size_t index = 0;
+            while (p < end && index < kRegisters) {
+                uint8_t op = *p;
+                if ((op & 0xC0) == 0x00) {
+                    index += (op & 0x3F) + 1;
+                    ++p;
+                } else if ((op & 0xC0) == 0x40) {
+                    if (p + 1 >= end) break;
+                    index += (((op & 0x3F) << 8) | p[1]) + 1;
+                    p += 2;
+                } else {
+                    uint8_t value = ((op >> 2) & 0x1F) + 1;
+                    size_t run = (op & 0x03) + 1;
+                    for (size_t i = 0; i < run && index < kRegisters; ++i) {
+                        registers[index++] = value;
+                    }
+                    ++p;
+                }
+            }
+        }
+
+        // 编码为稀疏表示追加到 out；寄存器值过大或结果过长时返回 false
+        static bool EncodeSparse(const Registers &registers, std::string &out) {
+            size_t limit = kHeaderBytes + kSparseMaxBytes;
+            size_t index = 0;
+            while (index < kRegisters) {
+                uint8_t value = registers[index];
+                size_t run = 1;
+                while (index + run < kRegisters && registers[index + run] == value) ++run;
+
+                if (value == 0) {
+                    AppendZeroRun(out, run);
+                } else {
+                    if (value > kSparseMaxValue) return false;
+                    for (size_t left = run; left > 0;) {
+                        size_t len = std::min<size_t>(left, 4);
+                        out.push_back(static_cast<char>(0x80 | ((value - 1) << 2) | (len - 1)));
+                        left -= len;
+                    }
+                }
+                if (out.size() > limit) return false;
+                index += run;
+            }
+            return true;
+        }
+
+        static double Sigma(double x) {
+            if (x == 1.0) return INFINITY;
+            double y = 1.0;
+            double z = x;
+            double previous;
+            do {
+                x *= x;
+                previous = z;
+                z += x * y;
+                y += y;
+            } while (previous != z);
+            return z;
+        }
+
+        static double Tau(double x) {
+            if (x == 0.0 || x == 1.0) return 0.0;
+            double y = 1.0;
+            double z = 1.0 - x;
+            double previous;
+            do {
+                x = std::sqrt(x);
+                previous = z;
+                y *= 0.5;
+                z -= (1.0 - x) * (1.0 - x) * y;
+            } while (previous != z);
+            return z / 3.0;
+        }
+
+        std::string bytes_;
+        std::unique_ptr<Registers> pending_;// 稀疏表示的解码缓存
+        bool pending_dirty_ = false;
+    };
+
+}// namespace Astra::datastructures
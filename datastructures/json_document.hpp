@@ -0,0 +1,611 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Astra::datastructures {
+
+    // JSON 文档树（JSON.* 命令）
+    // 文档只在写入时解析一次，之后按路径直接读写节点；读取单个路径只序列化该片段。
+    // 对象成员用 vector 保存并保持插入顺序，每个节点就是一个 variant，没有额外的指针层。
+
+    struct JsonMember;
+
+    class JsonValue {
+    public:
+        enum class Type : uint8_t {
+            Null,
+            Boolean,
+            Integer,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        using Array = std::vector<JsonValue>;
+        using Object = std::vector<JsonMember>;
+
+        static constexpr size_t kMaxDepth = 128;
+
+        JsonValue() = default;
+        explicit JsonValue(bool value) : data_(value) {}
+        explicit JsonValue(int64_t value) : data_(value) {}
+        explicit JsonValue(double value) : data_(value) {}
+        explicit JsonValue(std::string value) : data_(std::move(value)) {}
+        explicit JsonValue(Array value) : data_(std::move(value)) {}
+        explicit JsonValue(Object value) : data_(std::move(value)) {}
+
+        Type GetType() const { return static_cast<Type>(data_.index()); }
+
+        const char *TypeName() const {
+            static constexpr const char *kNames[] = {"null", "boolean", "integer", "number", "string", "array", "object"};
+            return kNames[data_.index()];
+        }
+
+        bool IsNumeric() const { return GetType() == Type::Integer || GetType() == Type::Number; }
+        bool IsArray() const { return GetType() == Type::Array; }
+        bool IsObject() const { return GetType() == Type::Object; }
+
+        int64_t AsInteger() const { return std::get<int64_t>(data_); }
+        double AsDouble() const { return GetType() == Type::Integer ? static_cast<double>(AsInteger()) : std::get<double>(data_); }
+        Array &AsArray() { return std::get<Array>(data_); }
+        const Array &AsArray() const { return std::get<Array>(data_); }
+        Object &AsObject() { return std::get<Object>(data_); }
+        const Object &AsObject() const { return std::get<Object>(data_); }
+
+        // 对象成员查找，非对象或不存在时返回 nullptr
+        JsonValue *Find(std::string_view key);
+
+        // 嵌套深度：标量为 1
+        size_t Depth() const;
+
+        // 解析失败返回 nullopt，error 中给出原因
+        static std::optional<JsonValue> Parse(std::string_view text, std::string *error = nullptr);
+
+        void SerializeTo(std::string &out) const;
+
+        std::string Serialize() const {
+            std::string out;
+            SerializeTo(out);
+            return out;
+        }
+
+    private:
+        std::variant<std::monostate, bool, int64_t, double, std::string, Array, Object> data_;
+    };
+
+    struct JsonMember {
+        std::string key;
+        JsonValue value;
+    };
+
+    namespace json_detail {
+
+        class Parser {
+        public:
+            explicit Parser(std::string_view text) : text_(text) {}
+
+            std::optional<JsonValue> Run(std::string *error) {
+                JsonValue value;
+                SkipSpace();
+                bool ok = ParseValue(value, 1);
+                SkipSpace();
+                if (ok && pos_ != text_.size()) ok = Fail("trailing characters");
+                if (!ok) {
+                    if (error) *error = error_ + " at offset " + std::to_string(pos_);
+                    return std::nullopt;
+                }
+                return value;
+            }
+
+        private:
+            bool Fail(const char *message) {
+                if (error_.empty()) error_ = message;
+                return false;
+            }
+
+            void SkipSpace() {
+                while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) ++pos_;
+            }
+
+            bool Consume(std::string_view literal) {
+                if (text_.substr(pos_, literal.size()) != literal) return false;
+                pos_ += literal.size();
+                return true;
+            }
+
+            bool ParseValue(JsonValue &out, size_t depth) {
+                if (depth > JsonValue::kMaxDepth) return Fail("nesting too deep");
+                if (pos_ >= text_.size()) return Fail("unexpected end of input");
+
+                switch (text_[pos_]) {
+                    case '{':
+                        return ParseObject(out, depth);
+                    case '[':
+                        return ParseArray(out, depth);
+                    case '"': {
+                        std::string text;
+                        if (!ParseString(text)) return false;
+                        out = JsonValue(std::move(text));
+                        return true;
+                    }
+                    case 't':
+                        if (!Consume("true")) return Fail("invalid literal");
+                        out = JsonValue(true);
+                        return true;
+                    case 'f':
+                        if (!Consume("false")) return Fail("invalid literal");
+                        out = JsonValue(false);
+                        return true;
+                    case 'n':
+                        if (!Consume("null")) return Fail("invalid literal");
+                        out = JsonValue();
+                        return true;
+                    default:
+                        return ParseNumber(out);
+                }
+            }
+
+            bool ParseObject(JsonValue &out, size_t depth) {
+                ++pos_;
+                JsonValue::Object members;
+                SkipSpace();
+                if (pos_ < text_.size() && text_[pos_] == '}') {
+                    ++pos_;
+                    out = JsonValue(std::move(members));
+                    return true;
+                }
+                while (true) {
+                    SkipSpace();
+                    if (pos_ >= text_.size() || text_[pos_] != '"') return Fail("expected object key");
+                    JsonMember member;
+                    if (!ParseString(member.key)) return false;
+                    SkipSpace();
+                    if (pos_ >= text_.size() || text_[pos_] != ':') return Fail("expected ':'");
+                    ++pos_;
+                    SkipSpace();
+                    if (!ParseValue(member.value, depth + 1)) return false;
+
+                    // 重复的键以最后一次出现为准
+                    bool replaced = false;
+                    for (auto &existing: members) {
+                        if (existing.key == member.key) {
+                            existing.value = std::move(member.value);
+                            replaced = true;
+                            break;
+                        }
+                    }
+                    if (!replaced) members.push_back(std::move(member));
+
+                    SkipSpace();
+                    if (pos_ < text_.size() && text_[pos_] == ',') {
+                        ++pos_;
+                        continue;
+                    }
+                    if (pos_ < text_.size() && text_[pos_] == '}') {
+                        ++pos_;
+                        out = JsonValue(std::move(members));
+                        return true;
+                    }
+                    return Fail("expected ',' or '}'");
+                }
+            }
+
+            bool ParseArray(JsonValue &out, size_t depth) {
+                ++pos_;
+                JsonValue::Array elements;
+                SkipSpace();
+                if (pos_ < text_.size() && text_[pos_] == ']') {
+                    ++pos_;
+                    out = JsonValue(std::move(elements));
+                    return true;
+                }
+                while (true) {
+                    SkipSpace();
+                    elements.emplace_back();
+                    if (!ParseValue(elements.back(), depth + 1)) return false;
+                    SkipSpace();
+                    if (pos_ < text_.size() && text_[pos_] == ',') {
+                        ++pos_;
+                        continue;
+                    }
+                    if (pos_ < text_.size() && text_[pos_] == ']') {
+                        ++pos_;
+                        out = JsonValue(std::move(elements));
+                        return true;
+                    }
+                    return Fail("expected ',' or ']'");
+                }
+            }
+
+            bool ParseHex4(uint32_t &value) {
+                if (text_.size() - pos_ < 4) return Fail("invalid unicode escape");
+                auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, value, 16);
+                if (ec != std::errc() || ptr != text_.data() + pos_ + 4) return Fail("invalid unicode escape");
+                pos_ += 4;
+                return true;
+            }
+
+            static void AppendUtf8(std::string &out, uint32_t cp) {
+                if (cp < 0x80) {
+                    out += static_cast<char>(cp);
+                } else if (cp < 0x800) {
+                    out += static_cast<char>(0xC0 | (cp >> 6));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    out += static_cast<char>(0xE0 | (cp >> 12));
+                    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                } else {
+                    out += static_cast<char>(0xF0 | (cp >> 18));
+                    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+            }
+
+            bool ParseString(std::string &out) {
+                ++pos_;
+                while (true) {
+                    // 整段复制不含转义的部分
+                    size_t start = pos_;
+                    while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\' &&
+                           static_cast<unsigned char>(text_[pos_]) >= 0x20) {
+                        ++pos_;
+                    }
+                    out.append(text_.data() + start, pos_ - start);
+                    if (pos_ >= text_.size()) return Fail("unterminated string");
+
+                    char c = text_[pos_++];
+                    if (c == '"') return true;
+                    if (c != '\\') return Fail("control character in string");
+                    if (pos_ >= text_.size()) return Fail("unterminated string");
+
+                    char escape = text_[pos_++];
+                    switch (escape) {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            out += escape;
+                            break;
+                        case 'b':
+                            out += '\b';
+                            break;
+                        case 'f':
+                            out += '\f';
+                            break;
+                        case 'n':
+                            out += '\n';
+                            break;
+                        case 'r':
+                            out += '\r';
+                            break;
+                        case 't':
+                            out += '\t';
+                            break;
+                        case 'u': {
+                            uint32_t cp;
+                            if (!ParseHex4(cp)) return false;
+                            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                                uint32_t low;
+                                if (!Consume("\\u") || !ParseHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                                    return Fail("invalid surrogate pair");
+                                }
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                                return Fail("invalid surrogate pair");
+                            }
+                            AppendUtf8(out, cp);
+                            break;
+                        }
+                        default:
+                            return Fail("invalid escape");
+                    }
+                }
+            }
+
+            bool ParseNumber(JsonValue &out) {
+                size_t start = pos_;
+                auto digits = [&] {
+                    size_t begin = pos_;
+                    while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') ++pos_;
+                    return pos_ - begin;
+                };
+
+                if (pos_ < text_.size() && text_[pos_] == '-') ++pos_;
+                size_t int_start = pos_;
+                if (digits() == 0) return Fail("invalid value");
+                if (text_[int_start] == '0' && pos_ - int_start > 1) return Fail("leading zero in number");
+
+                bool integral = true;
+                if (pos_ < text_.size() && text_[pos_] == '.') {
+                    ++pos_;
+                    if (digits() == 0) return Fail("invalid number");
+                    integral = false;
+                }
+                if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+                    ++pos_;
+                    if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) ++pos_;
+                    if (digits() == 0) return Fail("invalid number");
+                    integral = false;
+                }
+
+                const char *first = text_.data() + start;
+                const char *last = text_.data() + pos_;
+                if (integral) {
+                    int64_t value;
+                    auto [ptr, ec] = std::from_chars(first, last, value);
+                    if (ec == std::errc() && ptr == last) {
+                        out = JsonValue(value);
+                        return true;
+                    }
+                }
+                // 超出 int64 的整数与浮点数一样按 double 保存
+                double value;
+                auto [ptr, ec] = std::from_chars(first, last, value);
+                if (ec != std::errc() || ptr != last) return Fail("number out of range");
+                out = JsonValue(value);
+                return true;
+            }
+
+            std::string_view text_;
+            size_t pos_ = 0;
+            std::string error_;
+        };
+
+        inline void AppendEscaped(std::string &out, std::string_view text) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            out += '"';
+            size_t start = 0;
+            for (size_t i = 0; i < text.size(); ++i) {
+                auto c = static_cast<unsigned char>(text[i]);
+                if (c >= 0x20 && c != '"' && c != '\\') continue;
+                out.append(text.data() + start, i - start);
+                start = i + 1;
+                switch (c) {
+                    case '"':
+                        out += "\\\"";
+                        break;
+                    case '\\':
+                        out += "\\\\";
+                        break;
+                    case '\n':
+                        out += "\\n";
+                        break;
+                    case '\r':
+                        out += "\\r";
+                        break;
+                    case '\t':
+                        out += "\\t";
+                        break;
+                    case '\b':
+                        out += "\\b";
+                        break;
+                    case '\f':
+                        out += "\\f";
+                        break;
+                    default:
+                        out += "\\u00";
+                        out += kHex[c >> 4];
+                        out += kHex[c & 0xF];
+                }
+            }
+            out.append(text.data() + start, text.size() - start);
+            out += '"';
+        }
+
+    }// namespace json_detail
+
+    inline JsonValue *JsonValue::Find(std::string_view key) {
+        if (!IsObject()) return nullptr;
+        for (auto &member: AsObject()) {
+            if (member.key == key) return &member.value;
+        }
+        return nullptr;
+    }
+
+    inline size_t JsonValue::Depth() const {
+        size_t children = 0;
+        if (IsArray()) {
+            for (const auto &element: AsArray()) children = std::max(children, element.Depth());
+        } else if (IsObject()) {
+            for (const auto &member: AsObject()) children = std::max(children, member.value.Depth());
+        }
+        return children + 1;
+    }
+
+    inline std::optional<JsonValue> JsonValue::Parse(std::string_view text, std::string *error) {
+        return json_detail::Parser(text).Run(error);
+    }
+
+    inline void JsonValue::SerializeTo(std::string &out) const {
+        switch (GetType()) {
+            case Type::Null:
+                out += "null";
+                break;
+            case Type::Boolean:
+                out += std::get<bool>(data_) ? "true" : "false";
+                break;
+            case Type::Integer: {
+                char buf[24];
+                auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), AsInteger());
+                out.append(buf, ptr);
+                break;
+            }
+            case Type::Number: {
+                // 最短的可往返表示；整数值的浮点数保留 ".0"，以便再次解析后仍是浮点数
+                char buf[32];
+                auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), std::get<double>(data_));
+                std::string_view text(buf, static_cast<size_t>(ptr - buf));
+                out += text;
+                if (text.find_first_of(".e") == std::string_view::npos) out += ".0";
+                break;
+            }
+            case Type::String:
+                json_detail::AppendEscaped(out, std::get<std::string>(data_));
+                break;
+            case Type::Array: {
+                out += '[';
+                bool first = true;
+                for (const auto &element: AsArray()) {
+                    if (!first) out += ',';
+                    first = false;
+                    element.SerializeTo(out);
+                }
+                out += ']';
+                break;
+            }
+            case Type::Object: {
+                out += '{';
+                bool first = true;
+                for (const auto &member: AsObject()) {
+                    if (!first) out += ',';
+                    first = false;
+                    json_detail::AppendEscaped(out, member.key);
+                    out += ':';
+                    member.value.SerializeTo(out);
+                }
+                out += '}';
+                break;
+            }
+        }
+    }
+
+    // JSON 路径：支持 JSONPath 子集（$、.key、['key']、[index]、.* 与 [*]）以及旧式路径（"."、"a.b[0]"）。
+    // 以 $ 开头的路径可能匹配多个节点，命令按数组回复；旧式路径只取第一个匹配。
+    class JsonPath {
+    public:
+        struct Segment {
+            enum class Kind : uint8_t {
+                Key,
+                Index,
+                Wildcard
+            };
+            Kind kind = Kind::Key;
+            std::string key;
+            int64_t index = 0;
+        };
+
+        static std::optional<JsonPath> Parse(std::string_view text) {
+            JsonPath path;
+            size_t pos = 0;
+            if (!text.empty() && text[0] == '$') {
+                path.legacy_ = false;
+                pos = 1;
+            } else if (text == ".") {
+                return path;
+            } else if (!text.empty() && text[0] != '.' && text[0] != '[') {
+                // 旧式路径允许省略开头的点
+                if (!ReadName(text, pos, path)) return std::nullopt;
+            }
+
+            while (pos < text.size()) {
+                char c = text[pos];
+                if (c == '.') {
+                    ++pos;
+                    if (pos < text.size() && text[pos] == '*') {
+                        path.segments_.push_back({Segment::Kind::Wildcard, {}, 0});
+                        ++pos;
+                    } else if (!ReadName(text, pos, path)) {
+                        return std::nullopt;// 也拒绝递归下降 ".."
+                    }
+                } else if (c == '[') {
+                    ++pos;
+                    if (pos >= text.size()) return std::nullopt;
+                    if (text[pos] == '*') {
+                        path.segments_.push_back({Segment::Kind::Wildcard, {}, 0});
+                        ++pos;
+                    } else if (text[pos] == '\'' || text[pos] == '"') {
+                        char quote = text[pos++];
+                        std::string key;
+                        while (pos < text.size() && text[pos] != quote) {
+                            if (text[pos] == '\\' && pos + 1 < text.size()) ++pos;
+                            key += text[pos++];
+                        }
+                        if (pos >= text.size()) return std::nullopt;
+                        ++pos;
+                        path.segments_.push_back({Segment::Kind::Key, std::move(key), 0});
+                    } else {
+                        size_t end = text.find(']', pos);
+                        if (end == std::string_view::npos) return std::nullopt;
+                        int64_t index;
+                        auto [ptr, ec] = std::from_chars(text.data() + pos, text.data() + end, index);
+                        if (ec != std::errc() || ptr != text.data() + end) return std::nullopt;
+                        path.segments_.push_back({Segment::Kind::Index, {}, index});
+                        pos = end;
+                    }
+                    if (pos >= text.size() || text[pos] != ']') return std::nullopt;
+                    ++pos;
+                } else {
+                    return std::nullopt;
+                }
+            }
+            return path;
+        }
+
+        bool IsLegacy() const { return legacy_; }
+        bool IsRoot() const { return segments_.empty(); }
+        const std::vector<Segment> &Segments() const { return segments_; }
+
+        // 收集所有匹配节点；limit 为要应用的段数（默认全部），用于先定位父节点
+        void Resolve(JsonValue &root, std::vector<JsonValue *> &out, size_t limit = SIZE_MAX) const {
+            Walk(root, 0, std::min(limit, segments_.size()), out);
+        }
+
+        // 数组下标规范化（支持负数），越界返回 nullopt
+        static std::optional<size_t> NormalizeIndex(int64_t index, size_t size) {
+            if (index < 0) index += static_cast<int64_t>(size);
+            if (index < 0 || static_cast<uint64_t>(index) >= size) return std::nullopt;
+            return static_cast<size_t>(index);
+        }
+
+    private:
+        static bool ReadName(std::string_view text, size_t &pos, JsonPath &path) {
+            size_t end = pos;
+            while (end < text.size() && text[end] != '.' && text[end] != '[') ++end;
+            if (end == pos) return false;
+            path.segments_.push_back({Segment::Kind::Key, std::string(text.substr(pos, end - pos)), 0});
+            pos = end;
+            return true;
+        }
+
+        void Walk(JsonValue &node, size_t depth, size_t limit, std::vector<JsonValue *> &out) const {
+            if (depth == limit) {
+                out.push_back(&node);
+                return;
+            }
+            const Segment &segment = segments_[depth];
+            switch (segment.kind) {
+                case Segment::Kind::Key:
+                    if (JsonValue *child = node.Find(segment.key)) Walk(*child, depth + 1, limit, out);
+                    break;
+                case Segment::Kind::Index:
+                    if (node.IsArray()) {
+                        auto &elements = node.AsArray();
+                        if (auto index = NormalizeIndex(segment.index, elements.size())) Walk(elements[*index], depth + 1, limit, out);
+                    }
+                    break;
+                case Segment::Kind::Wildcard:
+                    if (node.IsArray()) {
+                        for (auto &element: node.AsArray()) Walk(element, depth + 1, limit, out);
+                    } else if (node.IsObject()) {
+                        for (auto &member: node.AsObject()) Walk(member.value, depth + 1, limit, out);
+                    }
+                    break;
+            }
+        }
+
+        std::vector<Segment> segments_;
+        bool legacy_ = true;
+    };
+
+}// namespace Astra::datastructures
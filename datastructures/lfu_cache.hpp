@@ -78,7 +78,7 @@ namespace Astra::datastructures {
         }
 
         // 插入元素
-        void Put(const Key &key, const Value &value, duration ttl = duration::zero()) {
+        void Put(const Key &key, const Value &value, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
             ApplyDecay();// 应用频率衰减
 
             if (capacity_ == 0) {
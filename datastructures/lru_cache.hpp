@@ -3,6 +3,7 @@
 #include "Astra-CacheServer/caching/AstraCacheStrategy.hpp"
 #include "concurrent/task_queue.hpp"
 #include <chrono>
+#include <functional>
 #include <list>
 #include <optional>
 #include <unordered_map>
@@ -18,7 +19,7 @@ namespace Astra::datastructures {
         using clock_type = std::chrono::steady_clock;
         using time_point = std::chrono::time_point<clock_type>;
 
-        explicit LRUCache(size_t capacity, size_t hot_key_threshold = 100, std::chrono::seconds ttl = std::chrono::seconds::zero())
+        explicit LRUCache(size_t capacity, size_t hot_key_threshold = 100, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero())
             : capacity_(capacity), hot_key_threshold_(hot_key_threshold), ttl_(ttl) {}
 
         // 获取缓存中的值
@@ -39,6 +40,24 @@ namespace Astra::datastructures {
             return std::make_optional(it->second->second);
         }
 
+        // 原地只读访问：fn(const Value *value) 直接读取缓存中的值（不存在或已过期时为 nullptr），
+        // 用于只需要值的一部分（长度、切片）的命令，避免像 Get 那样复制整个值
+        template<typename Fn>
+        auto Visit(const Key &key, Fn &&fn) {
+            auto it = cache_.find(key);
+            if (it == cache_.end()) {
+                return fn(static_cast<const Value *>(nullptr));
+            }
+            if (IsExpired(it)) {
+                Remove(key);
+                return fn(static_cast<const Value *>(nullptr));
+            }
+
+            MoveToFront(it);
+            UpdateHotKey(it->second, key);
+            return fn(static_cast<const Value *>(&it->second->second));
+        }
+
         // 批量获取缓存中的值
         // 返回与输入keys顺序一致的values，不存在或过期的key对应的值为std::nullopt
         std::vector<std::optional<Value>> BatchGet(const std::vector<Key> &keys) {
@@ -72,7 +91,7 @@ namespace Astra::datastructures {
         }
 
         // 插入或更新缓存项
-        void Put(const Key &key, const Value &value, std::chrono::seconds ttl = std::chrono::seconds::zero()) {
+        void Put(const Key &key, const Value &value, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
             if (capacity_ == 0) {
                 Clear();
                 return;
@@ -81,6 +100,7 @@ namespace Astra::datastructures {
             auto it = cache_.find(key);
             if (it != cache_.end()) {
                 // 存在时删除旧元素
+                NotifyRemoval(*it->second);
                 usage_.erase(it->second);
                 cache_.erase(it);
             }
@@ -97,10 +117,45 @@ namespace Astra::datastructures {
             SetExpiration(key, ttl);
         }
 
+        // 原地读改写：只做一次查找，fn(Value &value, bool existed) 直接修改缓存中的值，不改变过期时间
+        // 键不存在时先插入默认值再调用 fn；若 fn 返回后该值仍为默认值则撤销插入
+        template<typename Fn>
+        auto Update(const Key &key, Fn &&fn) {
+            if (capacity_ == 0) {
+                Value scratch{};
+                return fn(scratch, false);
+            }
+
+            auto it = cache_.find(key);
+            if (it != cache_.end() && IsExpired(it)) {
+                Remove(key);
+                it = cache_.end();
+            }
+
+            bool existed = it != cache_.end();
+            if (existed) {
+                MoveToFront(it);
+            } else {
+                EnsureCapacity(1);
+                usage_.emplace_front(key, Value{});
+                cache_[key] = usage_.begin();
+                SetExpiration(key, std::chrono::milliseconds::zero());
+            }
+
+            auto entry = usage_.begin();
+            auto result = fn(entry->second, existed);
+            if (!existed && entry->second == Value{}) {
+                Remove(key);
+            } else {
+                UpdateHotKey(entry, key);
+            }
+            return result;
+        }
+
         // 批量插入或更新缓存项
         // 注意：keys和values的大小必须相同
         void BatchPut(const std::vector<Key> &keys, const std::vector<Value> &values,
-                      std::chrono::seconds ttl = std::chrono::seconds::zero()) {
+                      std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) {
             if (keys.size() != values.size()) {
                 throw std::invalid_argument("keys and values must have the same size");
             }
@@ -129,6 +184,7 @@ namespace Astra::datastructures {
 
                 auto it = cache_.find(key);
                 if (it != cache_.end()) {
+                    NotifyRemoval(*it->second);
                     usage_.erase(it->second);
                     cache_.erase(it);
                 }
@@ -184,6 +240,9 @@ namespace Astra::datastructures {
 
         // 清空缓存
         void Clear() {
+            for (const auto &entry: usage_) {
+                NotifyRemoval(entry);
+            }
             usage_.clear();
             cache_.clear();
             access_count_.clear();
@@ -199,6 +258,7 @@ namespace Astra::datastructures {
             }
 
             // 从 usage_ 和 cache_ 中删除
+            NotifyRemoval(*it->second);
             usage_.erase(it->second);
             cache_.erase(it);
 
@@ -245,14 +305,34 @@ namespace Astra::datastructures {
             return !IsExpired(it);
         }
 
-        // 获取某个键的过期时间（如果存在）
-        std::optional<std::chrono::seconds> GetExpiryTime(const Key &key) const {
+        // 获取某个键的剩余存活时间（毫秒精度，如果存在）
+        std::optional<std::chrono::milliseconds> GetExpiryTime(const Key &key) const {
             auto exp_it = expiration_times_.find(key);
             if (exp_it == expiration_times_.end()) return std::nullopt;
 
             auto now = std::chrono::steady_clock::now();
-            auto remaining = std::chrono::duration_cast<std::chrono::seconds>(exp_it->second - now);
-            return (remaining > std::chrono::seconds::zero()) ? std::make_optional(remaining) : std::nullopt;
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(exp_it->second - now);
+            return (remaining > std::chrono::milliseconds::zero()) ? std::make_optional(remaining) : std::nullopt;
+        }
+
+        // 为已存在的键重新设置存活时间，键不存在或已过期时返回 false
+        bool Expire(const Key &key, std::chrono::milliseconds ttl) {
+            if (!HasKey(key)) return false;
+            expiration_times_[key] = clock_type::now() + ttl;
+            return true;
+        }
+
+        // 去掉键的过期时间，键不存在或本来就没有过期时间时返回 false
+        bool Persist(const Key &key) {
+            if (!HasKey(key)) return false;
+            return expiration_times_.erase(key) > 0;
+        }
+
+        // 缓存项被删除、覆盖、淘汰、过期或清空时回调 listener(key, old_value)，
+        // 用于释放只在缓存中放句柄的值（流、有序集合等）在缓存外的本体。
+        // 回调在修改缓存的过程中调用，不能再访问本缓存
+        void SetRemovalListener(std::function<void(const Key &, const Value &)> listener) {
+            removal_listener_ = std::move(listener);
         }
 
     protected:
@@ -269,6 +349,7 @@ namespace Astra::datastructures {
             if (usage_.empty()) return;
 
             const auto &lru_entry = usage_.back();
+            NotifyRemoval(lru_entry);
             cache_.erase(lru_entry.first);
             expiration_times_.erase(lru_entry.first);
             access_count_.erase(lru_entry.first);
@@ -285,6 +366,7 @@ namespace Astra::datastructures {
 
             for (size_t i = 0; i < evict_count; ++i) {
                 const auto &lru_entry = usage_.back();
+                NotifyRemoval(lru_entry);
                 cache_.erase(lru_entry.first);
                 expiration_times_.erase(lru_entry.first);
                 access_count_.erase(lru_entry.first);
@@ -302,10 +384,10 @@ namespace Astra::datastructures {
         }
 
         // 设置过期时间
-        void SetExpiration(const Key &key, std::chrono::seconds ttl) {
+        void SetExpiration(const Key &key, std::chrono::milliseconds ttl) {
             if (ttl.count() > 0) {
                 expiration_times_[key] = clock_type::now() + ttl;
-            } else if (ttl_ > std::chrono::seconds::zero()) {
+            } else if (ttl_ > std::chrono::milliseconds::zero()) {
                 expiration_times_[key] = clock_type::now() + ttl_;
             } else {
                 expiration_times_.erase(key);
@@ -341,12 +423,20 @@ namespace Astra::datastructures {
             return false;
         }
 
-        // 清理过期项
+        void NotifyRemoval(const std::pair<Key, Value> &entry) const {
+            if (removal_listener_) {
+                removal_listener_(entry.first, entry.second);
+            }
+        }
+
+        // 清理过期项（Remove 会同时擦除 expiration_times_ 中的项，先前移迭代器再删除）
         void CleanUpExpiredItems() {
+            auto now = clock_type::now();
             for (auto it = expiration_times_.begin(); it != expiration_times_.end();) {
-                if (it->second <= clock_type::now()) {
-                    Remove(it->first);
-                    it = expiration_times_.erase(it);
+                if (it->second <= now) {
+                    Key key = it->first;
+                    ++it;
+                    Remove(key);
                 } else {
                     ++it;
                 }
@@ -368,8 +458,9 @@ namespace Astra::datastructures {
         std::atomic<bool> eviction_active_{true};
         size_t capacity_;
         size_t hot_key_threshold_;
-        std::chrono::seconds ttl_;
+        std::chrono::milliseconds ttl_;
         concurrent::TaskQueue *eviction_task_queue_ = nullptr;
+        std::function<void(const Key &, const Value &)> removal_listener_;
         std::unordered_map<Key, time_point> expiration_times_;
         std::list<std::pair<Key, Value>> usage_;
         std::unordered_map<Key, iterator> cache_;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Astra::datastructures {
+
+    // 乱序完成、按序交付的重排环（非线程安全，由调用方串行访问，例如会话的 strand）
+    // 发起请求时 Reserve 取得递增序号，结果以任意顺序 Complete，
+    // Drain 只交付从队头开始连续就绪的结果。槽位按序号取模复用，未完成的请求超过容量时翻倍扩容。
+    template<typename T>
+    class ReorderRing {
+    public:
+        explicit ReorderRing(size_t capacity = 16) : slots_(RoundUp(capacity)) {}
+
+        // 为新请求分配序号
+        uint64_t Reserve() {
+            if (next_ - head_ == slots_.size()) {
+                Grow();
+            }
+            return next_++;
+        }
+
+        // 写入 seq 的结果；seq 必须由 Reserve 分配且尚未完成
+        void Complete(uint64_t seq, T value) {
+            assert(seq >= head_ && seq < next_);
+            auto &slot = slots_[seq & (slots_.size() - 1)];
+            assert(!slot.has_value());
+            slot.emplace(std::move(value));
+        }
+
+        // 按序交付队头连续就绪的结果，返回交付个数
+        template<typename F>
+        size_t Drain(F &&fn) {
+            size_t delivered = 0;
+            while (head_ != next_) {
+                auto &slot = slots_[head_ & (slots_.size() - 1)];
+                if (!slot.has_value()) break;
+                T value = std::move(*slot);
+                slot.reset();
+                ++head_;
+                ++delivered;
+                fn(std::move(value));
+            }
+            return delivered;
+        }
+
+        // 已分配但尚未交付的请求数
+        size_t Pending() const { return static_cast<size_t>(next_ - head_); }
+
+        size_t Capacity() const { return slots_.size(); }
+
+    private:
+        static size_t RoundUp(size_t n) {
+            size_t capacity = 1;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+        void Grow() {
+            std::vector<std::optional<T>> slots(slots_.size() * 2);
+            for (uint64_t seq = head_; seq != next_; ++seq) {
+                slots[seq & (slots.size() - 1)] = std::move(slots_[seq & (slots_.size() - 1)]);
+            }
+            slots_.swap(slots);
+        }
+
+        std::vector<std::optional<T>> slots_;
+        uint64_t head_ = 0;// 下一个待交付的序号
+        uint64_t next_ = 0;// 下一个待分配的序号
+    };
+
+}// namespace Astra::datastructures
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "concurrent/task_flow.hpp"
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Astra::datastructures::set_algebra {
+
+    // 集合代数内核：所有输入都必须是升序且无重复的区间，输出同样有序
+    // 小集合在前：交集从最小的集合开始逐个探测，一旦为空立即结束
+
+    // 两个集合大小相差超过该倍数时，用 galloping 查找代替线性归并
+    inline constexpr size_t kGallopRatio = 16;
+    // 驱动集合元素数超过该阈值时，按值域切分后交给 ParallelWork 并行执行
+    inline constexpr size_t kParallelThreshold = 1 << 17;
+
+    template<typename T>
+    using Range = std::span<const T>;
+
+    // 从 from 开始做指数查找，返回第一个 >= value 的位置
+    template<typename T>
+    size_t GallopLowerBound(Range<T> range, size_t from, const T &value) {
+        const size_t n = range.size();
+        if (from >= n || !(range[from] < value)) return from;
+
+        size_t lo = from;// 不变式：range[lo] < value
+        size_t step = 1;
+        size_t hi = lo + step;
+        while (hi < n && range[hi] < value) {
+            lo = hi;
+            step <<= 1;
+            hi = lo + step;
+        }
+        hi = std::min(hi, n);
+        return std::lower_bound(range.begin() + lo + 1, range.begin() + hi, value) - range.begin();
+    }
+
+    // 两集合求交：大小悬殊时用小集合去 gallop 大集合，否则线性归并；
+    // limit 非 0 时追加满 limit 个元素即停止
+    template<typename T>
+    void IntersectTwo(Range<T> a, Range<T> b, std::vector<T> &out, size_t limit = 0) {
+        if (a.size() > b.size()) std::swap(a, b);
+        if (a.empty()) return;
+
+        const size_t stop = limit > 0 ? out.size() + limit : static_cast<size_t>(-1);
+        if (b.size() / a.size() >= kGallopRatio) {
+            size_t j = 0;
+            for (const auto &x: a) {
+                j = GallopLowerBound(b, j, x);
+                if (j == b.size()) break;
+                if (!(x < b[j])) {
+                    out.push_back(x);
+                    if (out.size() == stop) return;
+                    ++j;
+                }
+            }
+        } else {
+            size_t i = 0, j = 0;
+            while (i < a.size() && j < b.size()) {
+                if (a[i] < b[j]) {
+                    ++i;
+                } else if (b[j] < a[i]) {
+                    ++j;
+                } else {
+                    out.push_back(a[i]);
+                    if (out.size() == stop) return;
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+    }
+
+    // 两集合求差 a - b：b 远大于 a 时对 b 做 gallop
+    template<typename T>
+    void DiffTwo(Range<T> a, Range<T> b, std::vector<T> &out) {
+        if (b.empty()) {
+            out.insert(out.end(), a.begin(), a.end());
+            return;
+        }
+
+        if (!a.empty() && b.size() / a.size() >= kGallopRatio) {
+            size_t j = 0;
+            for (const auto &x: a) {
+                j = GallopLowerBound(b, j, x);
+                if (j == b.size() || x < b[j]) {
+                    out.push_back(x);
+                }
+            }
+        } else {
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+        }
+    }
+
+    // 多集合交集（串行）。limit 非 0 时（SINTERCARD LIMIT）得到 limit 个元素即停止：
+    // 两个集合直接交给 IntersectTwo；更多集合时逐个取最小集合的元素，到其余集合中 gallop 探测，
+    // 不再先求出完整的中间结果
+    template<typename T>
+    std::vector<T> Intersect(std::vector<Range<T>> inputs, size_t limit = 0) {
+        std::vector<T> result;
+        if (inputs.empty()) return result;
+
+        std::sort(inputs.begin(), inputs.end(), [](const Range<T> &l, const Range<T> &r) {
+            return l.size() < r.size();
+        });
+        if (inputs.front().empty()) return result;
+
+        if (inputs.size() == 1) {
+            const auto &only = inputs.front();
+            size_t n = limit > 0 ? std::min(limit, only.size()) : only.size();
+            result.assign(only.begin(), only.begin() + n);
+        } else if (inputs.size() == 2 || limit == 0) {
+            IntersectTwo(inputs[0], inputs[1], result, inputs.size() == 2 ? limit : 0);
+            std::vector<T> scratch;
+            for (size_t i = 2; i < inputs.size() && !result.empty(); ++i) {
+                scratch.clear();
+                IntersectTwo(Range<T>(result), inputs[i], scratch);
+                result.swap(scratch);
+            }
+        } else {
+            std::vector<size_t> cursors(inputs.size(), 0);
+            for (const auto &x: inputs[0]) {
+                bool everywhere = true;
+                for (size_t i = 1; i < inputs.size(); ++i) {
+                    cursors[i] = GallopLowerBound(inputs[i], cursors[i], x);
+                    if (cursors[i] == inputs[i].size()) return result;// 某个集合已走完，之后不会再有交集
+                    if (x < inputs[i][cursors[i]]) {
+                        everywhere = false;
+                        break;
+                    }
+                }
+                if (everywhere) {
+                    result.push_back(x);
+                    if (result.size() == limit) break;
+                }
+            }
+        }
+        return result;
+    }
+
+    // 多集合并集（串行，从小到大两两归并）
+    template<typename T>
+    std::vector<T> Union(std::vector<Range<T>> inputs) {
+        std::vector<T> result;
+        std::sort(inputs.begin(), inputs.end(), [](const Range<T> &l, const Range<T> &r) {
+            return l.size() < r.size();
+        });
+
+        std::vector<T> scratch;
+        for (const auto &input: inputs) {
+            if (input.empty()) continue;
+            scratch.clear();
+            scratch.reserve(result.size() + input.size());
+            std::set_union(result.begin(), result.end(), input.begin(), input.end(), std::back_inserter(scratch));
+            result.swap(scratch);
+        }
+        return result;
+    }
+
+    // 多集合差集：inputs[0] 依次减去其余集合
+    template<typename T>
+    std::vector<T> Diff(const std::vector<Range<T>> &inputs) {
+        std::vector<T> result;
+        if (inputs.empty()) return result;
+
+        result.assign(inputs[0].begin(), inputs[0].end());
+        std::vector<T> scratch;
+        for (size_t i = 1; i < inputs.size() && !result.empty(); ++i) {
+            scratch.clear();
+            DiffTwo(Range<T>(result), inputs[i], scratch);
+            result.swap(scratch);
+        }
+        return result;
+    }
+
+    // 按值域把所有输入切成 partitions 段，每段独立运行 kernel，最后按序拼接。
+    // 分割点取自 inputs[pivot]，因为各段值域互不重叠，拼接结果依旧有序。
+    template<typename T, typename Kernel>
+    std::vector<T> RunPartitioned(const std::vector<Range<T>> &inputs, size_t pivot, size_t partitions,
+                                  const std::shared_ptr<concurrent::TaskQueue> &queue, Kernel kernel) {
+        const Range<T> source = inputs[pivot];
+        partitions = std::max<size_t>(1, std::min(partitions, source.size()));
+
+        // 分割点：source 中等距采样的元素，第 p 段覆盖 [splitters[p-1], splitters[p])
+        std::vector<T> splitters;
+        splitters.reserve(partitions - 1);
+        for (size_t p = 1; p < partitions; ++p) {
+            splitters.push_back(source[p * source.size() / partitions]);
+        }
+
+        std::vector<std::vector<T>> partial(partitions);
+        concurrent::ParallelWork work(queue);
+        for (size_t p = 0; p < partitions; ++p) {
+            work.Add([&, p]() {
+                std::vector<Range<T>> slices;
+                slices.reserve(inputs.size());
+                for (const auto &input: inputs) {
+                    auto first = p == 0 ? input.begin()
+                                        : std::lower_bound(input.begin(), input.end(), splitters[p - 1]);
+                    auto last = p + 1 == partitions ? input.end()
+                                                    : std::lower_bound(input.begin(), input.end(), splitters[p]);
+                    slices.emplace_back(first, last);
+                }
+                partial[p] = kernel(std::move(slices));
+            });
+        }
+        work.RunAndWait();
+
+        size_t total = 0;
+        for (const auto &part: partial) total += part.size();
+        std::vector<T> result;
+        result.reserve(total);
+        for (auto &part: partial) {
+            std::move(part.begin(), part.end(), std::back_inserter(result));
+        }
+        return result;
+    }
+
+    // 集合代数专用的计算线程池：与命令执行线程池隔离，避免在工作线程上等待自身而死锁
+    inline std::shared_ptr<concurrent::TaskQueue> ComputeQueue() {
+        static auto queue = concurrent::TaskQueue::Create(std::max(2u, std::thread::hardware_concurrency() / 2));
+        return queue;
+    }
+
+    inline size_t ParallelPartitions() {
+        return std::max(2u, std::thread::hardware_concurrency());
+    }
+
+    // 带并行分派的入口：驱动集合超过 kParallelThreshold 时切分执行
+    template<typename T>
+    std::vector<T> IntersectParallel(const std::vector<Range<T>> &inputs, size_t limit = 0) {
+        if (inputs.empty()) return {};
+        size_t smallest = 0;
+        for (size_t i = 1; i < inputs.size(); ++i) {
+            if (inputs[i].size() < inputs[smallest].size()) smallest = i;
+        }
+        // 带 limit 时串行执行即可提前结束，切分反而要把每一段都算完
+        if (limit > 0 || inputs.size() < 2 || inputs[smallest].size() < kParallelThreshold) {
+            return Intersect(inputs, limit);
+        }
+
+        return RunPartitioned<T>(inputs, smallest, ParallelPartitions(), ComputeQueue(),
+                                 [](std::vector<Range<T>> slices) { return Intersect(std::move(slices)); });
+    }
+
+    template<typename T>
+    std::vector<T> UnionParallel(const std::vector<Range<T>> &inputs) {
+        size_t largest = 0;
+        size_t total = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            total += inputs[i].size();
+            if (inputs[i].size() > inputs[largest].size()) largest = i;
+        }
+        if (inputs.size() < 2 || total < kParallelThreshold) {
+            return Union(inputs);
+        }
+
+        return RunPartitioned<T>(inputs, largest, ParallelPartitions(), ComputeQueue(),
+                                 [](std::vector<Range<T>> slices) { return Union(std::move(slices)); });
+    }
+
+    template<typename T>
+    std::vector<T> DiffParallel(const std::vector<Range<T>> &inputs) {
+        if (inputs.size() < 2 || inputs[0].size() < kParallelThreshold) {
+            return Diff(inputs);
+        }
+
+        return RunPartitioned<T>(inputs, 0, ParallelPartitions(), ComputeQueue(),
+                                 [](std::vector<Range<T>> slices) { return Diff(slices); });
+    }
+
+}// namespace Astra::datastructures::set_algebra
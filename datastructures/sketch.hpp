@@ -0,0 +1,335 @@
+#pragma once
+
+#include "utils/hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Astra::datastructures {
+
+    // 计数草图（CMS.* / TOPK.* 共用）：depth 行 × width 列的 32 位计数器矩阵，
+    // 每个元素只算一次 64 位哈希，用双重哈希 h1 + i*h2 派生出每一行的列号。
+    // 与 BloomFilter 一样，整个结构就是一个普通字符串值，命令在缓存锁内原地读写。
+    namespace sketch {
+
+        inline constexpr size_t kMaxBytes = 512ULL * 1024 * 1024;// 与字符串值的上限一致
+
+        inline uint64_t Hash(std::string_view item) {
+            return utils::MurmurHash64A(item.data(), item.size(), 0x2545f4914f6cdd1dULL);
+        }
+
+        template<typename T>
+        T Load(std::string_view data, size_t offset) {
+            T value;
+            std::memcpy(&value, data.data() + offset, sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        void Store(std::string &data, size_t offset, T value) {
+            std::memcpy(data.data() + offset, &value, sizeof(T));
+        }
+
+        // 计数器矩阵的视图，data 从 offset 开始存放 depth × width 个 uint32
+        class CounterMatrix {
+        public:
+            CounterMatrix(std::string_view data, size_t offset, uint32_t width, uint32_t depth)
+                : base_(data.data() + offset), width_(width), depth_(depth) {}
+
+            static size_t Bytes(uint32_t width, uint32_t depth) {
+                return static_cast<size_t>(width) * depth * sizeof(uint32_t);
+            }
+
+            // 各行计数器的最小值，即该元素出现次数的上界估计
+            uint32_t Estimate(uint64_t hash) const {
+                uint32_t estimate = UINT32_MAX;
+                ForEachCell(hash, [&](size_t cell) { estimate = std::min(estimate, Get(cell)); });
+                return estimate;
+            }
+
+            // 任一行会溢出时不做修改并返回 false
+            bool Add(std::string &data, size_t offset, uint64_t hash, uint32_t increment) const {
+                bool overflow = false;
+                ForEachCell(hash, [&](size_t cell) { overflow |= Get(cell) > UINT32_MAX - increment; });
+                if (overflow) return false;
+                ForEachCell(hash, [&](size_t cell) {
+                    Store<uint32_t>(data, offset + cell * sizeof(uint32_t), Get(cell) + increment);
+                });
+                return true;
+            }
+
+            // 饱和累加：用于 Top-K，计数达到上限后保持不变
+            void AddSaturating(std::string &data, size_t offset, uint64_t hash, uint32_t increment) const {
+                ForEachCell(hash, [&](size_t cell) {
+                    uint32_t current = Get(cell);
+                    uint32_t next = current > UINT32_MAX - increment ? UINT32_MAX : current + increment;
+                    Store<uint32_t>(data, offset + cell * sizeof(uint32_t), next);
+                });
+            }
+
+        private:
+            template<typename Fn>
+            void ForEachCell(uint64_t hash, Fn &&fn) const {
+                uint64_t step = utils::Mix64(hash) | 1;
+                for (uint32_t row = 0; row < depth_; ++row, hash += step) {
+                    uint64_t column = ((hash >> 32) * width_) >> 32;
+                    fn(static_cast<size_t>(row) * width_ + column);
+                }
+            }
+
+            uint32_t Get(size_t cell) const {
+                uint32_t value;
+                std::memcpy(&value, base_ + cell * sizeof(uint32_t), sizeof(value));
+                return value;
+            }
+
+            const char *base_;
+            uint32_t width_;
+            uint32_t depth_;
+        };
+
+    }// namespace sketch
+
+    // Count-Min Sketch
+    // 布局："cms:" + 头部(16) + 计数器矩阵；头部：width(4) depth(4) 累计增量(8)
+    class CountMinSketch {
+    public:
+        static constexpr std::string_view kMagic = "cms:";
+        static constexpr size_t kHeaderBytes = 16;
+
+        struct Info {
+            uint32_t width = 0;
+            uint32_t depth = 0;
+            uint64_t count = 0;
+        };
+
+        // width/depth 为 0 或超过大小上限时返回空串
+        static std::string Create(uint32_t width, uint32_t depth) {
+            if (width == 0 || depth == 0 ||
+                static_cast<uint64_t>(width) * depth > (sketch::kMaxBytes - kMagic.size() - kHeaderBytes) / sizeof(uint32_t)) {
+                return {};
+            }
+            std::string data(kMagic);
+            data.resize(kMagic.size() + kHeaderBytes + sketch::CounterMatrix::Bytes(width, depth), '\0');
+            sketch::Store<uint32_t>(data, kMagic.size(), width);
+            sketch::Store<uint32_t>(data, kMagic.size() + 4, depth);
+            return data;
+        }
+
+        // 按误差与置信度确定尺寸：误差 ε 对应 width = ⌈2/ε⌉，失败概率 δ 对应 depth = ⌈log₂(1/δ)⌉
+        static std::string CreateByProbability(double error, double probability) {
+            double width = std::ceil(2.0 / error);
+            double depth = std::ceil(std::log2(1.0 / probability));
+            if (!(width >= 1 && width <= UINT32_MAX && depth >= 1 && depth <= UINT32_MAX)) return {};
+            return Create(static_cast<uint32_t>(width), static_cast<uint32_t>(depth));
+        }
+
+        static bool IsValid(std::string_view data) {
+            if (data.size() < kMagic.size() + kHeaderBytes || data.substr(0, kMagic.size()) != kMagic) return false;
+            auto info = GetInfo(data);
+            return info.width > 0 && info.depth > 0 &&
+                   data.size() == kMagic.size() + kHeaderBytes + sketch::CounterMatrix::Bytes(info.width, info.depth);
+        }
+
+        static Info GetInfo(std::string_view data) {
+            return {sketch::Load<uint32_t>(data, kMagic.size()), sketch::Load<uint32_t>(data, kMagic.size() + 4),
+                    sketch::Load<uint64_t>(data, kMagic.size() + 8)};
+        }
+
+        // 增加后返回新的估计值；计数器会溢出时返回 nullopt 且不修改
+        static std::optional<uint32_t> IncrBy(std::string &data, uint64_t hash, uint32_t increment) {
+            auto info = GetInfo(data);
+            auto matrix = Matrix(data, info);
+            if (!matrix.Add(data, kMatrixOffset, hash, increment)) return std::nullopt;
+            sketch::Store<uint64_t>(data, kMagic.size() + 8, info.count + increment);
+            return matrix.Estimate(hash);
+        }
+
+        static uint32_t Query(std::string_view data, uint64_t hash) {
+            return Matrix(data, GetInfo(data)).Estimate(hash);
+        }
+
+    private:
+        static constexpr size_t kMatrixOffset = kMagic.size() + kHeaderBytes;
+
+        static sketch::CounterMatrix Matrix(std::string_view data, const Info &info) {
+            return {data, kMatrixOffset, info.width, info.depth};
+        }
+    };
+
+    // Top-K：计数器矩阵负责估计频次，另存最多 k 个候选元素及其估计值。
+    // 新元素的估计值超过候选中的最小值时替换之，被挤出的元素返回给调用方。
+    // 布局："topk:" + 头部(16) + 计数器矩阵 + 候选记录；头部：k(4) width(4) depth(4) 候选数(4)
+    //       候选记录：估计值(8) 长度(4) 元素字节，顺序无意义
+    class TopK {
+    public:
+        static constexpr std::string_view kMagic = "topk:";
+        static constexpr size_t kHeaderBytes = 16;
+        static constexpr uint32_t kMaxK = 100000;
+
+        struct Info {
+            uint32_t k = 0;
+            uint32_t width = 0;
+            uint32_t depth = 0;
+        };
+
+        struct Candidate {
+            std::string item;
+            uint64_t count = 0;
+        };
+
+        static std::string Create(uint32_t k, uint32_t width, uint32_t depth) {
+            if (k == 0 || k > kMaxK || width == 0 || depth == 0 ||
+                static_cast<uint64_t>(width) * depth > (sketch::kMaxBytes - kMagic.size() - kHeaderBytes) / sizeof(uint32_t)) {
+                return {};
+            }
+            std::string data(kMagic);
+            data.resize(kMagic.size() + kHeaderBytes + sketch::CounterMatrix::Bytes(width, depth), '\0');
+            sketch::Store<uint32_t>(data, kMagic.size(), k);
+            sketch::Store<uint32_t>(data, kMagic.size() + 4, width);
+            sketch::Store<uint32_t>(data, kMagic.size() + 8, depth);
+            return data;
+        }
+
+        static bool IsValid(std::string_view data) {
+            if (data.size() < kMagic.size() + kHeaderBytes || data.substr(0, kMagic.size()) != kMagic) return false;
+            auto info = GetInfo(data);
+            uint32_t candidates = sketch::Load<uint32_t>(data, kMagic.size() + 12);
+            if (info.k == 0 || info.width == 0 || info.depth == 0 || candidates > info.k) return false;
+
+            size_t pos = CandidatesOffset(info);
+            for (uint32_t i = 0; i < candidates; ++i) {
+                if (pos > data.size() || data.size() - pos < 12) return false;
+                uint32_t length = sketch::Load<uint32_t>(data, pos + 8);
+                if (data.size() - pos - 12 < length) return false;
+                pos += 12 + length;
+            }
+            return pos == data.size();
+        }
+
+        static Info GetInfo(std::string_view data) {
+            return {sketch::Load<uint32_t>(data, kMagic.size()), sketch::Load<uint32_t>(data, kMagic.size() + 4),
+                    sketch::Load<uint32_t>(data, kMagic.size() + 8)};
+        }
+
+        // 一批元素只解析、重写一次候选列表；expelled[i] 为第 i 个元素挤出的候选（没有则为空）
+        static void IncrBy(std::string &data, std::span<const std::pair<std::string_view, uint32_t>> items,
+                           std::vector<std::optional<std::string>> &expelled) {
+            auto info = GetInfo(data);
+            size_t offset = kMagic.size() + kHeaderBytes;
+            sketch::CounterMatrix matrix(data, offset, info.width, info.depth);
+
+            // 先预留 k 个位置再填充：之后 push_back 不会搬移元素，index 中指向候选字符串的 string_view 保持有效
+            std::vector<Candidate> candidates;
+            candidates.reserve(info.k);
+            ForEachCandidate(data, [&](std::string_view item, uint64_t count) {
+                candidates.push_back({std::string(item), count});
+            });
+            std::unordered_map<std::string_view, size_t> index;
+            for (size_t i = 0; i < candidates.size(); ++i) index.emplace(candidates[i].item, i);
+
+            // 候选中的最小估计值，只有被替换或最小者自身增长时才重新扫描
+            size_t min_index = 0;
+            bool min_dirty = true;
+            auto minimum = [&]() -> size_t {
+                if (min_dirty) {
+                    min_index = 0;
+                    for (size_t i = 1; i < candidates.size(); ++i) {
+                        if (candidates[i].count < candidates[min_index].count) min_index = i;
+                    }
+                    min_dirty = false;
+                }
+                return min_index;
+            };
+
+            expelled.clear();
+            expelled.reserve(items.size());
+            for (const auto &[item, increment]: items) {
+                uint64_t hash = sketch::Hash(item);
+                matrix.AddSaturating(data, offset, hash, increment);
+                uint32_t estimate = matrix.Estimate(hash);
+                expelled.emplace_back();
+
+                if (auto it = index.find(item); it != index.end()) {
+                    candidates[it->second].count = estimate;
+                    if (it->second == min_index) min_dirty = true;
+                } else if (candidates.size() < info.k) {
+                    candidates.push_back({std::string(item), estimate});
+                    index.emplace(candidates.back().item, candidates.size() - 1);
+                    min_dirty = true;
+                } else if (size_t victim = minimum(); estimate > candidates[victim].count) {
+                    index.erase(candidates[victim].item);
+                    expelled.back() = std::move(candidates[victim].item);
+                    candidates[victim] = {std::string(item), estimate};
+                    index.emplace(candidates[victim].item, victim);
+                    min_dirty = true;
+                }
+            }
+
+            // 按新的候选列表重写尾部
+            data.resize(CandidatesOffset(info));
+            sketch::Store<uint32_t>(data, kMagic.size() + 12, static_cast<uint32_t>(candidates.size()));
+            for (const auto &candidate: candidates) {
+                char record[12];
+                auto length = static_cast<uint32_t>(candidate.item.size());
+                std::memcpy(record, &candidate.count, 8);
+                std::memcpy(record + 8, &length, 4);
+                data.append(record, sizeof(record));
+                data.append(candidate.item);
+            }
+        }
+
+        // 候选列表，按估计值从高到低排序
+        static std::vector<Candidate> List(std::string_view data) {
+            auto candidates = Candidates(data);
+            std::stable_sort(candidates.begin(), candidates.end(),
+                             [](const Candidate &a, const Candidate &b) { return a.count > b.count; });
+            return candidates;
+        }
+
+        static bool Contains(std::string_view data, std::string_view item) {
+            bool found = false;
+            ForEachCandidate(data, [&](std::string_view candidate, uint64_t) { found |= candidate == item; });
+            return found;
+        }
+
+        static uint32_t Estimate(std::string_view data, std::string_view item) {
+            auto info = GetInfo(data);
+            return sketch::CounterMatrix(data, kMagic.size() + kHeaderBytes, info.width, info.depth).Estimate(sketch::Hash(item));
+        }
+
+    private:
+        static size_t CandidatesOffset(const Info &info) {
+            return kMagic.size() + kHeaderBytes + sketch::CounterMatrix::Bytes(info.width, info.depth);
+        }
+
+        template<typename Fn>
+        static void ForEachCandidate(std::string_view data, Fn &&fn) {
+            uint32_t count = sketch::Load<uint32_t>(data, kMagic.size() + 12);
+            size_t pos = CandidatesOffset(GetInfo(data));
+            for (uint32_t i = 0; i < count; ++i) {
+                uint64_t estimate = sketch::Load<uint64_t>(data, pos);
+                uint32_t length = sketch::Load<uint32_t>(data, pos + 8);
+                fn(data.substr(pos + 12, length), estimate);
+                pos += 12 + length;
+            }
+        }
+
+        static std::vector<Candidate> Candidates(std::string_view data) {
+            std::vector<Candidate> candidates;
+            ForEachCandidate(data, [&](std::string_view item, uint64_t count) {
+                candidates.push_back({std::string(item), count});
+            });
+            return candidates;
+        }
+    };
+
+}// namespace Astra::datastructures
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ring_buffer.hpp"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace Astra::datastructures {
+
+    // 单生产者单消费者的有序通道：平时走无锁环形缓冲，环满时溢出到带锁的队列。
+    // 溢出队列非空期间生产者的新消息一律追加到溢出队列，不会插到更早的消息前面；
+    // 消费者先取完环中的消息再取溢出队列，整体保持发送顺序。
+    template<typename T, size_t Capacity = 1024>
+    class SpscChannel {
+    public:
+        // 生产者调用
+        void Push(T item) {
+            if (!overflowed_.load(std::memory_order_acquire) && ring_.Push(item)) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mtx_);
+            overflow_.push_back(std::move(item));
+            overflowed_.store(true, std::memory_order_release);
+        }
+
+        // 消费者调用：按发送顺序取出当前已有的全部消息。
+        // 看到溢出标记后要再取一次环：第一次取空之后生产者可能又把环写满才溢出，这些消息在溢出队列之前。
+        // 溢出队列整体取出后才清除标记，生产者随后写入环中的消息排在这一批之后，由下一次 Drain 取走
+        template<typename Fn>
+        void Drain(Fn &&fn) {
+            T item;
+            while (ring_.Pop(item)) {
+                fn(std::move(item));
+            }
+            if (!overflowed_.load(std::memory_order_acquire)) {
+                return;
+            }
+            while (ring_.Pop(item)) {
+                fn(std::move(item));
+            }
+            std::deque<T> batch;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                batch.swap(overflow_);
+                overflowed_.store(false, std::memory_order_release);
+            }
+            for (auto &pending: batch) {
+                fn(std::move(pending));
+            }
+        }
+
+    private:
+        RingBuffer<T, Capacity> ring_;
+        std::atomic<bool> overflowed_{false};
+        std::mutex mtx_;
+        std::deque<T> overflow_;
+    };
+
+}// namespace Astra::datastructures
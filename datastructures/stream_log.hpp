@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Astra::datastructures {
+
+    // 流条目 ID：毫秒时间戳 + 序号，按字典序单调递增
+    struct StreamID {
+        uint64_t ms = 0;
+        uint64_t seq = 0;
+
+        auto operator<=>(const StreamID &) const = default;
+
+        static constexpr StreamID Min() { return {0, 0}; }
+        static constexpr StreamID Max() {
+            return {std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max()};
+        }
+
+        std::string ToString() const {
+            return std::to_string(ms) + "-" + std::to_string(seq);
+        }
+
+        // 下一个可用 ID（序号溢出时进位到毫秒）；Max() 没有后继
+        std::optional<StreamID> Next() const {
+            if (seq != std::numeric_limits<uint64_t>::max()) return StreamID{ms, seq + 1};
+            if (ms != std::numeric_limits<uint64_t>::max()) return StreamID{ms + 1, 0};
+            return std::nullopt;
+        }
+
+        // 解析 "ms-seq"；只给出 "ms" 时序号取 default_seq
+        static std::optional<StreamID> Parse(std::string_view text, uint64_t default_seq = 0) {
+            StreamID id;
+            size_t dash = text.find('-');
+            std::string_view ms_part = text.substr(0, dash);
+            if (ms_part.empty()) return std::nullopt;
+
+            auto [ptr, ec] = std::from_chars(ms_part.data(), ms_part.data() + ms_part.size(), id.ms);
+            if (ec != std::errc() || ptr != ms_part.data() + ms_part.size()) return std::nullopt;
+
+            if (dash == std::string_view::npos) {
+                id.seq = default_seq;
+                return id;
+            }
+
+            std::string_view seq_part = text.substr(dash + 1);
+            if (seq_part.empty()) return std::nullopt;
+            auto [seq_ptr, seq_ec] = std::from_chars(seq_part.data(), seq_part.data() + seq_part.size(), id.seq);
+            if (seq_ec != std::errc() || seq_ptr != seq_part.data() + seq_part.size()) return std::nullopt;
+            return id;
+        }
+    };
+
+    using StreamFields = std::vector<std::pair<std::string, std::string>>;
+
+    struct StreamEntry {
+        StreamID id;
+        StreamFields fields;
+    };
+
+    // 只追加的流日志：条目按 ID 顺序打包进紧凑的块中
+    // 每个块记录首尾 ID，块内条目以相对块首 ID 的 varint 增量编码，字段以 长度+字节 紧排。
+    // 追加只写尾块，O(1)；查找先按块尾 ID 二分定位块，再在块内顺序解码；
+    // 近似裁剪（MAXLEN ~）整块丢弃头部，不需要重新编码。
+    class StreamLog {
+    public:
+        static constexpr size_t kDefaultBlockEntries = 128;
+        static constexpr size_t kDefaultBlockBytes = 4096;
+
+        explicit StreamLog(size_t block_entries = kDefaultBlockEntries, size_t block_bytes = kDefaultBlockBytes)
+            : block_entries_(std::max<size_t>(1, block_entries)), block_bytes_(block_bytes) {}
+
+        // 追加条目，id 必须大于当前最后 ID
+        bool Append(const StreamID &id, const StreamFields &fields) {
+            if (has_last_id_ && id <= last_id_) return false;
+
+            if (blocks_.empty() || blocks_.back().count >= block_entries_ ||
+                blocks_.back().data.size() >= block_bytes_) {
+                blocks_.emplace_back();
+                blocks_.back().first = id;
+            }
+
+            Block &block = blocks_.back();
+            EncodeEntry(block, id, fields);
+            block.last = id;
+            ++block.count;
+            ++size_;
+            last_id_ = id;
+            has_last_id_ = true;
+            return true;
+        }
+
+        size_t Size() const { return size_; }
+        bool Empty() const { return size_ == 0; }
+        size_t BlockCount() const { return blocks_.size(); }
+
+        // 最后生成过的 ID（即使条目已被裁剪也保留，用于保证 ID 单调）
+        StreamID LastID() const { return last_id_; }
+
+        // 恢复快照时把最后 ID 调回保存时的值（条目已被裁剪时它大于最后一条的 ID），只会调大
+        void RestoreLastID(const StreamID &id) {
+            if (id <= last_id_) return;
+            last_id_ = id;
+            has_last_id_ = true;
+        }
+
+        std::optional<StreamID> FirstID() const {
+            if (blocks_.empty()) return std::nullopt;
+            return blocks_.front().first;
+        }
+
+        // 升序返回 [start, end] 内的条目，count 为 0 表示不限
+        std::vector<StreamEntry> Range(const StreamID &start, const StreamID &end, size_t count = 0) const {
+            std::vector<StreamEntry> result;
+            if (start > end) return result;
+
+            auto it = std::partition_point(blocks_.begin(), blocks_.end(),
+                                           [&start](const Block &b) { return b.last < start; });
+            for (; it != blocks_.end() && it->first <= end; ++it) {
+                const char *p = it->data.data();
+                const char *limit = p + it->data.size();
+                while (p < limit) {
+                    StreamEntry entry;
+                    DecodeEntry(*it, p, entry);
+                    if (entry.id < start) continue;
+                    if (entry.id > end) return result;
+                    result.push_back(std::move(entry));
+                    if (count > 0 && result.size() >= count) return result;
+                }
+            }
+            return result;
+        }
+
+        // 降序返回 [start, end] 内的条目
+        std::vector<StreamEntry> RevRange(const StreamID &end, const StreamID &start, size_t count = 0) const {
+            std::vector<StreamEntry> result;
+            if (start > end) return result;
+
+            auto it = std::partition_point(blocks_.begin(), blocks_.end(),
+                                           [&end](const Block &b) { return b.first <= end; });
+            std::vector<StreamEntry> decoded;
+            while (it != blocks_.begin()) {
+                --it;
+                if (it->last < start) break;
+
+                decoded.clear();
+                decoded.reserve(it->count);
+                const char *p = it->data.data();
+                const char *limit = p + it->data.size();
+                while (p < limit) {
+                    decoded.emplace_back();
+                    DecodeEntry(*it, p, decoded.back());
+                }
+                for (auto rit = decoded.rbegin(); rit != decoded.rend(); ++rit) {
+                    if (rit->id > end) continue;
+                    if (rit->id < start) return result;
+                    result.push_back(std::move(*rit));
+                    if (count > 0 && result.size() >= count) return result;
+                }
+            }
+            return result;
+        }
+
+        // 裁剪到 maxlen 条，返回删除的条目数
+        // approximate 为 true 时只整块丢弃，结果可能略多于 maxlen（对应 MAXLEN ~）
+        size_t Trim(size_t maxlen, bool approximate) {
+            size_t removed = 0;
+            while (!blocks_.empty() && size_ - blocks_.front().count >= maxlen) {
+                size_ -= blocks_.front().count;
+                removed += blocks_.front().count;
+                blocks_.pop_front();
+            }
+            if (approximate || size_ <= maxlen) return removed;
+
+            // 精确裁剪：重新编码头块中保留的部分
+            size_t drop = size_ - maxlen;
+            Block &head = blocks_.front();
+            Block rebuilt;
+            const char *p = head.data.data();
+            const char *limit = p + head.data.size();
+            size_t index = 0;
+            while (p < limit) {
+                StreamEntry entry;
+                DecodeEntry(head, p, entry);
+                if (index++ < drop) continue;
+                if (rebuilt.count == 0) rebuilt.first = entry.id;
+                EncodeEntry(rebuilt, entry.id, entry.fields);
+                rebuilt.last = entry.id;
+                ++rebuilt.count;
+            }
+            head = std::move(rebuilt);
+            size_ -= drop;
+            return removed + drop;
+        }
+
+        // 编码后的近似内存占用
+        size_t MemoryUsage() const {
+            size_t bytes = sizeof(*this);
+            for (const auto &block: blocks_) {
+                bytes += sizeof(Block) + block.data.capacity();
+            }
+            return bytes;
+        }
+
+    private:
+        struct Block {
+            StreamID first;
+            StreamID last;
+            uint32_t count = 0;
+            std::string data;
+        };
+
+        static void PutVarint(std::string &out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        static uint64_t GetVarint(const char *&p) {
+            uint64_t value = 0;
+            int shift = 0;
+            while (true) {
+                auto byte = static_cast<uint8_t>(*p++);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+                shift += 7;
+            }
+        }
+
+        static void PutString(std::string &out, const std::string &value) {
+            PutVarint(out, value.size());
+            out.append(value);
+        }
+
+        static std::string GetString(const char *&p) {
+            size_t len = GetVarint(p);
+            std::string value(p, len);
+            p += len;
+            return value;
+        }
+
+        // 条目布局：varint(ms - 块首 ms) varint(seq) varint(字段数) {varint(len) bytes}*
+        static void EncodeEntry(Block &block, const StreamID &id, const StreamFields &fields) {
+            PutVarint(block.data, id.ms - block.first.ms);
+            PutVarint(block.data, id.seq);
+            PutVarint(block.data, fields.size());
+            for (const auto &[field, value]: fields) {
+                PutString(block.data, field);
+                PutString(block.data, value);
+            }
+        }
+
+        static void DecodeEntry(const Block &block, const char *&p, StreamEntry &entry) {
+            entry.id.ms = block.first.ms + GetVarint(p);
+            entry.id.seq = GetVarint(p);
+            size_t n = GetVarint(p);
+            entry.fields.clear();
+            entry.fields.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                std::string field = GetString(p);
+                std::string value = GetString(p);
+                entry.fields.emplace_back(std::move(field), std::move(value));
+            }
+        }
+
+        std::deque<Block> blocks_;
+        size_t size_ = 0;
+        StreamID last_id_;
+        bool has_last_id_ = false;
+        size_t block_entries_;
+        size_t block_bytes_;
+    };
+
+}// namespace Astra::datastructures
@@ -0,0 +1,89 @@
+#include "core/astra.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <utils/bitops.hpp>
+
+using namespace Astra::utils::bitops;
+
+namespace {
+    std::vector<uint8_t> RandomBytes(size_t n, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::vector<uint8_t> bytes(n);
+        for (auto &b: bytes) b = static_cast<uint8_t>(rng());
+        return bytes;
+    }
+
+    size_t NaivePopCount(const std::vector<uint8_t> &bytes) {
+        size_t count = 0;
+        for (auto b: bytes) {
+            for (int i = 0; i < 8; ++i) count += (b >> i) & 1;
+        }
+        return count;
+    }
+}// namespace
+
+TEST(BitOpsTest, PopCountMatchesNaive) {
+    // 覆盖各种长度，确保向量主循环与尾部处理都被执行
+    for (size_t n: {0u, 1u, 7u, 31u, 32u, 33u, 1000u, 4096u + 13u, 100000u}) {
+        auto bytes = RandomBytes(n, static_cast<uint32_t>(n));
+        EXPECT_EQ(PopCount(bytes.data(), bytes.size()), NaivePopCount(bytes)) << "len=" << n;
+        EXPECT_EQ(detail::PopCountScalar(bytes.data(), bytes.size()), NaivePopCount(bytes)) << "len=" << n;
+    }
+}
+
+TEST(BitOpsTest, CombinePadsShorterSources) {
+    std::vector<uint8_t> a = {0xFF, 0x0F, 0xF0};
+    std::vector<uint8_t> b = {0x0F};
+    std::vector<std::span<const uint8_t>> sources = {a, b};
+    std::vector<uint8_t> dst(3);
+
+    Combine(BitOp::And, dst, sources);
+    EXPECT_EQ(dst, (std::vector<uint8_t>{0x0F, 0x00, 0x00}));
+
+    Combine(BitOp::Or, dst, sources);
+    EXPECT_EQ(dst, (std::vector<uint8_t>{0xFF, 0x0F, 0xF0}));
+
+    Combine(BitOp::Xor, dst, sources);
+    EXPECT_EQ(dst, (std::vector<uint8_t>{0xF0, 0x0F, 0xF0}));
+
+    std::vector<std::span<const uint8_t>> single = {a};
+    Combine(BitOp::Not, dst, single);
+    EXPECT_EQ(dst, (std::vector<uint8_t>{0x00, 0xF0, 0x0F}));
+}
+
+TEST(BitOpsTest, CombineLargeMatchesScalar) {
+    auto a = RandomBytes(10000, 1);
+    auto b = RandomBytes(9000, 2);
+    auto c = RandomBytes(10000, 3);
+    std::vector<std::span<const uint8_t>> sources = {a, b, c};
+
+    std::vector<uint8_t> dst(a.size());
+    Combine(BitOp::Or, dst, sources);
+    for (size_t i = 0; i < dst.size(); ++i) {
+        uint8_t expected = a[i] | (i < b.size() ? b[i] : 0) | c[i];
+        ASSERT_EQ(dst[i], expected) << "offset " << i;
+    }
+}
+
+TEST(BitOpsTest, FindBit) {
+    std::vector<uint8_t> bytes(100, 0);
+    bytes[50] = 0x10;// 第 50*8+3 位
+    EXPECT_EQ(FindBit(bytes.data(), bytes.size(), true, 0, UINT64_MAX), 50 * 8 + 3);
+    EXPECT_EQ(FindBit(bytes.data(), bytes.size(), true, 50 * 8 + 4, UINT64_MAX), -1);
+    EXPECT_EQ(FindBit(bytes.data(), bytes.size(), false, 0, UINT64_MAX), 0);
+
+    std::vector<uint8_t> ones(16, 0xFF);
+    EXPECT_EQ(FindBit(ones.data(), ones.size(), false, 0, UINT64_MAX), -1);
+    ones[9] = 0xFE;
+    EXPECT_EQ(FindBit(ones.data(), ones.size(), false, 0, UINT64_MAX), 9 * 8 + 7);
+}
+
+TEST(BitOpsTest, MaxBytes) {
+    auto a = RandomBytes(16384 + 5, 7);
+    auto b = RandomBytes(16384 + 5, 8);
+    auto expected = a;
+    for (size_t i = 0; i < a.size(); ++i) expected[i] = std::max(a[i], b[i]);
+
+    MaxBytes(a.data(), b.data(), a.size());
+    EXPECT_EQ(a, expected);
+}
@@ -0,0 +1,123 @@
+#include "core/astra.hpp"
+#include <datastructures/bloom_filter.hpp>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Astra::datastructures;
+
+namespace {
+    std::string MakeFilter(uint64_t capacity, double error_rate, bool scaling = true) {
+        BloomFilter::Options options;
+        options.capacity = capacity;
+        options.error_rate = error_rate;
+        options.scaling = scaling;
+        return BloomFilter::Create(options);
+    }
+
+    uint64_t Key(int i) {
+        return BloomFilter::Hash("item:" + std::to_string(i));
+    }
+}// namespace
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+    std::string filter = MakeFilter(10000, 0.01);
+    ASSERT_TRUE(BloomFilter::IsValid(filter));
+    uint64_t added = 0;
+    for (int i = 0; i < 10000; ++i) {
+        auto result = BloomFilter::Add(filter, Key(i));
+        EXPECT_NE(result, BloomFilter::AddResult::Full) << i;
+        added += result == BloomFilter::AddResult::Added;
+    }
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(BloomFilter::Contains(filter, Key(i))) << i;
+    }
+    EXPECT_EQ(BloomFilter::Add(filter, Key(42)), BloomFilter::AddResult::Exists);
+    EXPECT_EQ(BloomFilter::GetInfo(filter).items, added);
+}
+
+TEST(BloomFilterTest, FalsePositiveRateNearTarget) {
+    std::string filter = MakeFilter(20000, 0.01);
+    int added = 0;
+    for (int i = 0; i < 20000; ++i) {
+        added += BloomFilter::Add(filter, Key(i)) == BloomFilter::AddResult::Added;
+    }
+    EXPECT_EQ(BloomFilter::GetInfo(filter).layers, 1u);
+
+    int false_positives = 0;
+    const int probes = 100000;
+    for (int i = 0; i < probes; ++i) {
+        false_positives += BloomFilter::Contains(filter, BloomFilter::Hash("other:" + std::to_string(i)));
+    }
+    EXPECT_LT(static_cast<double>(false_positives) / probes, 0.015);
+    EXPECT_GT(added, 19700);// 插入过程中的误判（视为已存在）也应在误判率以内
+}
+
+TEST(BloomFilterTest, ScalingAppendsLayers) {
+    std::string filter = MakeFilter(100, 0.01);
+    for (int i = 0; i < 1000; ++i) BloomFilter::Add(filter, Key(i));
+
+    auto info = BloomFilter::GetInfo(filter);
+    EXPECT_GE(info.layers, 3u);
+    EXPECT_GE(info.capacity, info.items);
+    EXPECT_EQ(info.bytes, filter.size());
+    EXPECT_TRUE(BloomFilter::IsValid(filter));
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(BloomFilter::Contains(filter, Key(i))) << i;
+    }
+}
+
+TEST(BloomFilterTest, NonScalingFilterReportsFull) {
+    std::string filter = MakeFilter(10, 0.01, false);
+    int added = 0;
+    BloomFilter::AddResult last = BloomFilter::AddResult::Added;
+    for (int i = 0; i < 100 && last != BloomFilter::AddResult::Full; ++i) {
+        last = BloomFilter::Add(filter, Key(i));
+        added += last == BloomFilter::AddResult::Added;
+    }
+    EXPECT_EQ(last, BloomFilter::AddResult::Full);
+    EXPECT_EQ(added, 10);
+    EXPECT_EQ(BloomFilter::GetInfo(filter).layers, 1u);
+}
+
+TEST(BloomFilterTest, ContainsManyMatchesContains) {
+    std::string filter = MakeFilter(50, 0.001);
+    for (int i = 0; i < 300; i += 2) BloomFilter::Add(filter, Key(i));
+
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < 300; ++i) hashes.push_back(Key(i));
+    std::vector<uint8_t> found(hashes.size());
+    BloomFilter::ContainsMany(filter, hashes, found);
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        EXPECT_EQ(found[i] != 0, BloomFilter::Contains(filter, hashes[i])) << i;
+    }
+}
+
+TEST(BloomFilterTest, KernelsAgree) {
+    std::mt19937_64 rng(7);
+    alignas(64) uint8_t scalar[64] = {};
+    for (int i = 0; i < 20; ++i) bloom_detail::InsertScalar(scalar, static_cast<uint32_t>(rng()));
+#if defined(ASTRA_BITOPS_X86)
+    if (Astra::utils::bitops::ActiveIsa() == Astra::utils::bitops::Isa::Avx2) {
+        rng.seed(7);
+        alignas(64) uint8_t avx2[64] = {};
+        for (int i = 0; i < 20; ++i) bloom_detail::InsertAvx2(avx2, static_cast<uint32_t>(rng()));
+        EXPECT_EQ(std::memcmp(scalar, avx2, sizeof(scalar)), 0);
+        for (int i = 0; i < 1000; ++i) {
+            auto key = static_cast<uint32_t>(rng());
+            EXPECT_EQ(bloom_detail::ProbeScalar(scalar, key), bloom_detail::ProbeAvx2(scalar, key));
+        }
+    }
+#endif
+}
+
+TEST(BloomFilterTest, RejectsMalformedValues) {
+    EXPECT_FALSE(BloomFilter::IsValid(""));
+    EXPECT_FALSE(BloomFilter::IsValid("bloom:"));
+    EXPECT_FALSE(BloomFilter::IsValid("hello world"));
+
+    std::string filter = MakeFilter(100, 0.01);
+    EXPECT_FALSE(BloomFilter::IsValid(filter.substr(0, filter.size() - 1)));
+    EXPECT_FALSE(BloomFilter::IsValid(filter + "x"));
+    EXPECT_TRUE(BloomFilter::Create({0.01, UINT64_MAX / 2, 2, true}).empty());
+}
@@ -0,0 +1,73 @@
+#include "core/astra.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <utils/geohash.hpp>
+
+using namespace Astra::utils::geo;
+
+namespace {
+    bool Covered(const std::vector<ScoreRange> &ranges, uint64_t score) {
+        for (const auto &range: ranges) {
+            if (score >= range.min && score < range.max) return true;
+        }
+        return false;
+    }
+}// namespace
+
+TEST(GeoHashTest, EncodeDecodeRoundTrip) {
+    // Redis 文档中的示例：Palermo
+    uint64_t palermo = Encode(13.361389, 38.115556);
+    EXPECT_EQ(palermo, 3479099956230698ULL);
+
+    double lon, lat;
+    DecodeCenter(palermo, lon, lat);
+    EXPECT_NEAR(lon, 13.361389, 1e-5);
+    EXPECT_NEAR(lat, 38.115556, 1e-5);
+
+    Area area = Decode(palermo);
+    EXPECT_LE(area.lon_min, 13.361389);
+    EXPECT_GE(area.lon_max, 13.361389);
+    EXPECT_LT(palermo, uint64_t(1) << 52);
+}
+
+TEST(GeoHashTest, DistanceMatchesReference) {
+    // Palermo - Catania，Redis GEODIST 返回 166274.1516 米
+    EXPECT_NEAR(Distance(13.361389, 38.115556, 15.087269, 37.502669), 166274.15, 1.0);
+    EXPECT_DOUBLE_EQ(Distance(1, 2, 1, 2), 0.0);
+    EXPECT_TRUE(InBox(0, 0, 2000, 2000, 0.005, 0.005));
+    EXPECT_FALSE(InBox(0, 0, 2000, 2000, 0.02, 0));
+}
+
+TEST(GeoHashTest, RangesCoverEveryPointInsideTheArea) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> lon_dist(-180, 180), lat_dist(-80, 80), offset(-1, 1);
+    for (int trial = 0; trial < 200; ++trial) {
+        double lon = lon_dist(rng), lat = lat_dist(rng);
+        double radius = std::pow(10.0, 1 + trial % 6);// 10 米到 1000 公里
+        auto ranges = SearchRanges(lon, lat, 2 * radius, 2 * radius);
+        ASSERT_FALSE(ranges.empty());
+        ASSERT_LE(ranges.size(), 9u);
+
+        for (int i = 0; i < 50; ++i) {
+            double plon = lon + offset(rng) * radius / 50000;
+            double plat = std::clamp(lat + offset(rng) * radius / 111000, kLatMin, kLatMax);
+            if (plon < kLonMin || plon > kLonMax || Distance(lon, lat, plon, plat) > radius) continue;
+            EXPECT_TRUE(Covered(ranges, Encode(plon, plat))) << lon << "," << lat << " r=" << radius;
+        }
+    }
+}
+
+TEST(GeoHashTest, RangesWrapAroundTheAntimeridian) {
+    auto ranges = SearchRanges(179.999, 0, 20000, 20000);
+    EXPECT_TRUE(Covered(ranges, Encode(-179.999, 0)));
+    EXPECT_TRUE(Covered(ranges, Encode(179.999, 0.001)));
+}
+
+TEST(GeoHashTest, SmallRadiusScansFewRanges) {
+    auto ranges = SearchRanges(13.361389, 38.115556, 200, 200);
+    uint64_t span = 0;
+    for (const auto &range: ranges) span += range.max - range.min;
+    EXPECT_LT(span, uint64_t(1) << 32);// 远小于整个 52 位空间
+    EXPECT_EQ(EstimateStep(0, 0), kStepMax);
+    EXPECT_EQ(EstimateStep(1e8, 0), 1);
+}
@@ -0,0 +1,45 @@
+#include "core/astra.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <utils/glob.hpp>
+
+using Astra::utils::GlobMatch;
+
+TEST(GlobTest, LiteralsAndWildcards) {
+    EXPECT_TRUE(GlobMatch("", ""));
+    EXPECT_TRUE(GlobMatch("*", ""));
+    EXPECT_TRUE(GlobMatch("*", "anything"));
+    EXPECT_TRUE(GlobMatch("user:*", "user:42"));
+    EXPECT_FALSE(GlobMatch("user:*", "session:42"));
+    EXPECT_TRUE(GlobMatch("h?llo", "hello"));
+    EXPECT_FALSE(GlobMatch("h?llo", "hllo"));
+    EXPECT_TRUE(GlobMatch("*:*:end", "a:b:c:end"));
+    EXPECT_FALSE(GlobMatch("*:*:end", "a:end"));
+    EXPECT_TRUE(GlobMatch("a*b*c", "aXXbYYbZZc"));
+    EXPECT_FALSE(GlobMatch("a*b*c", "aXXbYY"));
+}
+
+TEST(GlobTest, CharacterClasses) {
+    EXPECT_TRUE(GlobMatch("h[ae]llo", "hallo"));
+    EXPECT_FALSE(GlobMatch("h[ae]llo", "hillo"));
+    EXPECT_TRUE(GlobMatch("h[^e]llo", "hallo"));
+    EXPECT_FALSE(GlobMatch("h[^e]llo", "hello"));
+    EXPECT_TRUE(GlobMatch("id[0-9]", "id7"));
+    EXPECT_TRUE(GlobMatch("id[9-0]", "id7"));
+    EXPECT_FALSE(GlobMatch("id[0-9]", "idx"));
+    EXPECT_TRUE(GlobMatch("[\\]]", "]"));
+}
+
+TEST(GlobTest, EscapesAndCase) {
+    EXPECT_TRUE(GlobMatch("a\\*b", "a*b"));
+    EXPECT_FALSE(GlobMatch("a\\*b", "axb"));
+    EXPECT_TRUE(GlobMatch("a\\?", "a?"));
+    EXPECT_FALSE(GlobMatch("HELLO", "hello"));
+    EXPECT_TRUE(GlobMatch("HELLO", "hello", true));
+    EXPECT_TRUE(GlobMatch("[A-C]x", "bx", true));
+}
+
+TEST(GlobTest, PathologicalPatternStaysLinearish) {
+    std::string text(5000, 'a');
+    EXPECT_FALSE(GlobMatch("*a*a*a*a*a*a*a*a*a*a*b", text));
+}
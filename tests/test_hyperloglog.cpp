@@ -0,0 +1,108 @@
+#include "core/astra.hpp"
+#include <datastructures/hyperloglog.hpp>
+#include <gtest/gtest.h>
+
+using namespace Astra::datastructures;
+
+namespace {
+    void AddRange(HyperLogLog &hll, int from, int to) {
+        for (int i = from; i < to; ++i) {
+            hll.Add("element:" + std::to_string(i));
+        }
+    }
+
+    double RelativeError(uint64_t estimate, uint64_t actual) {
+        return std::abs(static_cast<double>(estimate) - static_cast<double>(actual)) / static_cast<double>(actual);
+    }
+}// namespace
+
+TEST(HyperLogLogTest, EmptyIsSparseWithZeroCount) {
+    HyperLogLog hll;
+    EXPECT_EQ(hll.GetEncoding(), HyperLogLog::Encoding::Sparse);
+    EXPECT_EQ(hll.Count(), 0u);
+    EXPECT_TRUE(HyperLogLog::IsValid(hll.Bytes()));
+    EXPECT_LT(hll.Bytes().size(), 32u);
+}
+
+TEST(HyperLogLogTest, AddReportsRegisterChanges) {
+    HyperLogLog hll;
+    EXPECT_TRUE(hll.Add("a"));
+    EXPECT_FALSE(hll.Add("a"));
+    EXPECT_EQ(hll.Count(), 1u);
+    EXPECT_TRUE(hll.HasCachedCount());
+
+    hll.Add("b");
+    EXPECT_FALSE(hll.HasCachedCount());
+    EXPECT_EQ(hll.Count(), 2u);
+}
+
+TEST(HyperLogLogTest, ReleaseFlushesPendingSparseChanges) {
+    HyperLogLog hll;
+    auto [index, rank] = HyperLogLog::HashElement("a");
+    EXPECT_TRUE(hll.AddHash(index, rank));
+    EXPECT_FALSE(hll.Add("a"));
+
+    auto restored = HyperLogLog::FromBytes(hll.Release());
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_FALSE(restored->Add("a"));
+    EXPECT_EQ(restored->Count(), 1u);
+}
+
+TEST(HyperLogLogTest, SmallSetsStaySparseAndRoundTrip) {
+    HyperLogLog hll;
+    AddRange(hll, 0, 100);
+    uint64_t count = hll.Count();
+    EXPECT_LT(RelativeError(count, 100), 0.02);
+    const std::string bytes = hll.Bytes();
+    EXPECT_EQ(hll.GetEncoding(), HyperLogLog::Encoding::Sparse);
+
+    auto restored = HyperLogLog::FromBytes(bytes);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->Count(), count);
+    EXPECT_FALSE(restored->Add("element:5"));
+}
+
+TEST(HyperLogLogTest, PromotesToDenseAndStaysAccurate) {
+    HyperLogLog hll;
+    AddRange(hll, 0, 100000);
+    EXPECT_EQ(hll.Bytes().size(), HyperLogLog::kDenseBytes);
+    EXPECT_EQ(hll.GetEncoding(), HyperLogLog::Encoding::Dense);
+    EXPECT_LT(RelativeError(hll.Count(), 100000), 0.02);
+
+    auto restored = HyperLogLog::FromBytes(hll.Bytes());
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->Count(), hll.Count());
+}
+
+TEST(HyperLogLogTest, MergeMatchesUnion) {
+    HyperLogLog a, b, both;
+    AddRange(a, 0, 30000);
+    AddRange(b, 20000, 50000);
+    AddRange(both, 0, 50000);
+
+    HyperLogLog::Registers registers{};
+    a.MergeInto(registers);
+    b.MergeInto(registers);
+    auto merged = HyperLogLog::FromRegisters(registers);
+    EXPECT_EQ(merged.Count(), both.Count());
+}
+
+TEST(HyperLogLogTest, DenseRegistersPackAndUnpack) {
+    HyperLogLog::Registers registers{};
+    for (size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = static_cast<uint8_t>((i * 7) % 52);
+    }
+    auto hll = HyperLogLog::FromRegisters(registers);
+    EXPECT_EQ(hll.GetEncoding(), HyperLogLog::Encoding::Dense);
+
+    HyperLogLog::Registers unpacked{};
+    hll.ToRegisters(unpacked);
+    EXPECT_EQ(unpacked, registers);
+}
+
+TEST(HyperLogLogTest, RejectsInvalidPayloads) {
+    EXPECT_FALSE(HyperLogLog::FromBytes("not a hll").has_value());
+    std::string truncated_dense = "HYLL";
+    truncated_dense.append(12, '\0');
+    EXPECT_FALSE(HyperLogLog::IsValid(truncated_dense));
+}
@@ -0,0 +1,97 @@
+#include "core/astra.hpp"
+#include <datastructures/json_document.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Astra::datastructures;
+
+namespace {
+    JsonValue ParseOrDie(std::string_view text) {
+        std::string error;
+        auto value = JsonValue::Parse(text, &error);
+        EXPECT_TRUE(value.has_value()) << error;
+        return value ? std::move(*value) : JsonValue();
+    }
+
+    std::vector<std::string> Select(JsonValue &root, std::string_view path_text) {
+        auto path = JsonPath::Parse(path_text);
+        EXPECT_TRUE(path.has_value()) << path_text;
+        std::vector<JsonValue *> matches;
+        if (path) path->Resolve(root, matches);
+        std::vector<std::string> out;
+        for (auto *match: matches) out.push_back(match->Serialize());
+        return out;
+    }
+}// namespace
+
+TEST(JsonDocumentTest, RoundTripsCompactForm) {
+    const char *text = R"( { "a" : 1, "b" : [true, false, null, -0.5, 1e3, "x\"y"], "c" : {} , "d": [] } )";
+    JsonValue value = ParseOrDie(text);
+    EXPECT_EQ(value.Serialize(), R"({"a":1,"b":[true,false,null,-0.5,1000.0,"x\"y"],"c":{},"d":[]})");
+    EXPECT_EQ(ParseOrDie(value.Serialize()).Serialize(), value.Serialize());
+}
+
+TEST(JsonDocumentTest, NumbersKeepIntegerAndFloatKinds) {
+    EXPECT_EQ(ParseOrDie("42").GetType(), JsonValue::Type::Integer);
+    EXPECT_EQ(ParseOrDie("-9223372036854775808").AsInteger(), INT64_MIN);
+    EXPECT_EQ(ParseOrDie("9223372036854775808").GetType(), JsonValue::Type::Number);
+    EXPECT_EQ(ParseOrDie("2.0").Serialize(), "2.0");
+    EXPECT_EQ(ParseOrDie("0.1").Serialize(), "0.1");
+}
+
+TEST(JsonDocumentTest, DecodesEscapes) {
+    JsonValue value = ParseOrDie(R"("\u00e9\ud83d\ude00\n\t\/")");
+    EXPECT_EQ(value.Serialize(), "\"\xC3\xA9\xF0\x9F\x98\x80\\n\\t/\"");
+    EXPECT_EQ(ParseOrDie("\"\\u0001\"").Serialize(), "\"\\u0001\"");
+}
+
+TEST(JsonDocumentTest, RejectsMalformedInput) {
+    for (const char *text: {"", "{", "[1,]", "{\"a\" 1}", "01", "1.", "-", "tru", "\"abc", "\"\\ud800\"",
+                            "\"\\x\"", "[1] 2", "{\"a\":1,}", "\"a\nb\""}) {
+        EXPECT_FALSE(JsonValue::Parse(text).has_value()) << text;
+    }
+    std::string deep(JsonValue::kMaxDepth + 1, '[');
+    deep.append(JsonValue::kMaxDepth + 1, ']');
+    std::string error;
+    EXPECT_FALSE(JsonValue::Parse(deep, &error).has_value());
+    EXPECT_NE(error.find("nesting"), std::string::npos);
+    EXPECT_TRUE(JsonValue::Parse(deep.substr(1, deep.size() - 2)).has_value());
+}
+
+TEST(JsonDocumentTest, DuplicateKeysKeepLastValue) {
+    JsonValue value = ParseOrDie(R"({"a":1,"b":2,"a":3})");
+    EXPECT_EQ(value.Serialize(), R"({"a":3,"b":2})");
+}
+
+TEST(JsonDocumentTest, PathsSelectNodes) {
+    JsonValue root = ParseOrDie(R"({"a":{"b":[10,20,30]},"c":{"b":5},"k.x":true})");
+    EXPECT_EQ(Select(root, "$"), std::vector<std::string>{root.Serialize()});
+    EXPECT_EQ(Select(root, "."), std::vector<std::string>{root.Serialize()});
+    EXPECT_EQ(Select(root, "$.a.b[1]"), std::vector<std::string>{"20"});
+    EXPECT_EQ(Select(root, "a.b[-1]"), std::vector<std::string>{"30"});
+    EXPECT_EQ(Select(root, ".a['b'][0]"), std::vector<std::string>{"10"});
+    EXPECT_EQ(Select(root, "$.*.b"), (std::vector<std::string>{"[10,20,30]", "5"}));
+    EXPECT_EQ(Select(root, "$.a.b[*]"), (std::vector<std::string>{"10", "20", "30"}));
+    EXPECT_EQ(Select(root, "$['k.x']"), std::vector<std::string>{"true"});
+    EXPECT_TRUE(Select(root, "$.missing").empty());
+    EXPECT_TRUE(Select(root, "$.a.b[3]").empty());
+
+    EXPECT_TRUE(JsonPath::Parse("$.a")->IsLegacy() == false);
+    EXPECT_TRUE(JsonPath::Parse(".a")->IsLegacy());
+    for (const char *bad: {"$..a", "$.", "$[", "$[1", "$['a'", "$[x]", "$a"}) {
+        EXPECT_FALSE(JsonPath::Parse(bad).has_value()) << bad;
+    }
+}
+
+TEST(JsonDocumentTest, ResolveWithLimitReturnsParents) {
+    JsonValue root = ParseOrDie(R"({"a":[{"n":1},{"n":2}]})");
+    auto path = JsonPath::Parse("$.a[*].n");
+    ASSERT_TRUE(path.has_value());
+    std::vector<JsonValue *> parents;
+    path->Resolve(root, parents, path->Segments().size() - 1);
+    ASSERT_EQ(parents.size(), 2u);
+    for (auto *parent: parents) *parent->Find("n") = JsonValue(int64_t(7));
+    EXPECT_EQ(root.Serialize(), R"({"a":[{"n":7},{"n":7}]})");
+    EXPECT_EQ(root.Depth(), 4u);
+}
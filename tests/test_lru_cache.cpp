@@ -218,4 +218,163 @@ TEST(LRUCacheTest, TTLUpdateOnGet) {
 
     // 应该过期
     EXPECT_FALSE(cache.Get(1).has_value());
-}
\ No newline at end of file
+}
+TEST(LRUCacheTest, UpdateInPlace) {
+    LRUCache<std::string, std::string> cache(2);
+
+    // 不存在的键：插入后交给 fn 填值
+    auto created = cache.Update("n", [](std::string &value, bool existed) {
+        EXPECT_FALSE(existed);
+        value = "1";
+        return value.size();
+    });
+    EXPECT_EQ(created, 1u);
+    EXPECT_EQ(cache.Get("n").value(), "1");
+
+    cache.Update("n", [](std::string &value, bool existed) {
+        EXPECT_TRUE(existed);
+        value += "0";
+        return 0;
+    });
+    EXPECT_EQ(cache.Get("n").value(), "10");
+
+    // fn 未写入值时撤销插入
+    cache.Update("missing", [](std::string &, bool) { return 0; });
+    EXPECT_FALSE(cache.Contains("missing"));
+}
+
+TEST(LRUCacheTest, UpdateKeepsTTL) {
+    LRUCache<std::string, std::string> cache(2);
+    cache.Put("k", "v", std::chrono::seconds(100));
+    cache.Update("k", [](std::string &value, bool) {
+        value = "w";
+        return 0;
+    });
+    ASSERT_TRUE(cache.GetExpiryTime("k").has_value());
+    EXPECT_GT(cache.GetExpiryTime("k")->count(), 0);
+}
+
+TEST(LRUCacheTest, VisitReadsInPlace) {
+    LRUCache<std::string, std::string> cache(2);
+    cache.Put("a", "hello");
+    cache.Put("b", "world");
+
+    auto length = cache.Visit("a", [](const std::string *value) {
+        return value ? value->size() : 0;
+    });
+    EXPECT_EQ(length, 5u);
+    EXPECT_FALSE(cache.Visit("missing", [](const std::string *value) { return value != nullptr; }));
+
+    // Visit 与 Get 一样刷新 LRU 顺序
+    cache.Put("c", "!");
+    EXPECT_TRUE(cache.Contains("a"));
+    EXPECT_FALSE(cache.Contains("b"));
+}
+
+TEST(LRUCacheTest, MillisecondTTLAndPersist) {
+    LRUCache<std::string, std::string> cache(4);
+    cache.Put("short", "v", std::chrono::milliseconds(50));
+    ASSERT_TRUE(cache.GetExpiryTime("short").has_value());
+    EXPECT_LE(cache.GetExpiryTime("short")->count(), 50);
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_FALSE(cache.Get("short").has_value());
+
+    cache.Put("k", "v");
+    EXPECT_FALSE(cache.Persist("k"));
+    EXPECT_TRUE(cache.Expire("k", std::chrono::milliseconds(10000)));
+    EXPECT_GT(cache.GetExpiryTime("k")->count(), 9000);
+    EXPECT_TRUE(cache.Persist("k"));
+    EXPECT_FALSE(cache.GetExpiryTime("k").has_value());
+    EXPECT_FALSE(cache.Expire("missing", std::chrono::milliseconds(10)));
+}
+
+TEST(LRUCacheTest, PartitionedCacheRoutesKeysByHashSlot) {
+    AstraCache<LRUCache, std::string, std::string> cache(CachePartitions{4}, 1000);
+    EXPECT_EQ(cache.PartitionCount(), 4u);
+    EXPECT_EQ(cache.Capacity(), 1000u);
+    // 哈希标签相同的键落在同一分区
+    EXPECT_EQ(cache.PartitionOf("{user:1}:name"), cache.PartitionOf("{user:1}:age"));
+
+    for (int i = 0; i < 100; ++i) {
+        cache.Put("key" + std::to_string(i), std::to_string(i));
+    }
+    EXPECT_EQ(cache.Size(), 100u);
+    EXPECT_EQ(cache.GetKeys().size(), 100u);
+    EXPECT_EQ(cache.GetAllEntries().size(), 100u);
+    EXPECT_EQ(cache.Get("key42").value(), "42");
+
+    auto values = cache.BatchGet({"key1", "missing", "key2"});
+    EXPECT_EQ(values[0].value(), "1");
+    EXPECT_FALSE(values[1].has_value());
+    EXPECT_EQ(cache.BatchRemove({"key1", "key2", "missing"}), 2u);
+
+    cache.BatchPut({"a", "b", "c"}, {"1", "2", "3"});
+    EXPECT_EQ(cache.Get("c").value(), "3");
+
+    // 跨分区的"先判断再写"
+    bool written = cache.Atomically([](auto &strategy) {
+        if (strategy.HasKey("a") || strategy.HasKey("zz")) return false;
+        strategy.Put("zz", "x");
+        return true;
+    });
+    EXPECT_FALSE(written);
+    EXPECT_FALSE(cache.Contains("zz"));
+
+    auto old = cache.Atomically("a", [](auto &strategy) {
+        auto current = strategy.Get("a");
+        strategy.Remove("a");
+        return current;
+    });
+    EXPECT_EQ(old.value(), "1");
+    EXPECT_FALSE(cache.Get("a").has_value());
+
+    cache.Clear();
+    EXPECT_EQ(cache.Size(), 0u);
+}
+
+TEST(LRUCacheTest, RemovalListenerSeesEveryDroppedValue) {
+    std::vector<std::pair<std::string, std::string>> removed;
+    LRUCache<std::string, std::string> cache(2);
+    cache.SetRemovalListener([&removed](const std::string &key, const std::string &value) {
+        removed.emplace_back(key, value);
+    });
+
+    cache.Put("a", "1");
+    cache.Put("a", "2");// 覆盖
+    ASSERT_EQ(removed.size(), 1u);
+    EXPECT_EQ(removed.back(), std::make_pair(std::string("a"), std::string("1")));
+
+    cache.Put("b", "3");
+    cache.Put("c", "4");// 淘汰最久未使用的 a
+    ASSERT_EQ(removed.size(), 2u);
+    EXPECT_EQ(removed.back(), std::make_pair(std::string("a"), std::string("2")));
+
+    EXPECT_TRUE(cache.Remove("b"));
+    EXPECT_EQ(removed.back(), std::make_pair(std::string("b"), std::string("3")));
+
+    cache.Put("short", "5", std::chrono::milliseconds(20));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.Get("short").has_value());// 访问时过期
+    EXPECT_EQ(removed.back(), std::make_pair(std::string("short"), std::string("5")));
+
+    // 原地修改不算删除
+    size_t before = removed.size();
+    cache.Update("c", [](std::string &value, bool) { value += "!"; return true; });
+    EXPECT_EQ(removed.size(), before);
+
+    cache.Clear();
+    EXPECT_EQ(removed.back(), std::make_pair(std::string("c"), std::string("4!")));
+}
+
+TEST(LRUCacheTest, PartitionedCacheForwardsRemovalListener) {
+    AstraCache<LRUCache, std::string, std::string> cache(CachePartitions{4}, 100);
+    size_t removed = 0;
+    cache.SetRemovalListener([&removed](const std::string &, const std::string &) { ++removed; });
+    for (int i = 0; i < 20; ++i) {
+        cache.Put("key" + std::to_string(i), "v");
+    }
+    EXPECT_EQ(cache.BatchRemove({"key1", "key2", "key3"}), 3u);
+    EXPECT_EQ(removed, 3u);
+    cache.Clear();
+    EXPECT_EQ(removed, 20u);
+}
@@ -0,0 +1,36 @@
+#include "core/astra.hpp"
+#include "proto/CommandImpl.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Astra::proto;
+
+namespace {
+
+    // 记录执行时看到的协议版本，回复用 RespBuilder 按当前版本构造
+    class ProtocolProbeCommand : public ICommand {
+    public:
+        std::string Execute(const std::vector<std::string> &) override {
+            seen = RespBuilder::Protocol();
+            return RespBuilder::Nil();
+        }
+        RespProtocol seen = RespProtocol::Resp3;
+    };
+
+}// namespace
+
+TEST(LuaScopeTest, RedisCallAlwaysSeesResp2) {
+    LuaExecutor executor(nullptr);
+    auto probe = std::make_shared<ProtocolProbeCommand>();
+    executor.RegisterCommandHandler("probe", probe);
+
+    RespBuilder::ProtocolScope scope(RespProtocol::Resp3);
+    // 脚本内的命令按 RESP2 回复，"$-1" 转成 Lua 的 nil
+    EXPECT_EQ(executor.Execute("return redis.call('probe') == nil", 0, {}), ":1\r\n");
+    EXPECT_EQ(probe->seen, RespProtocol::Resp2);
+    // 脚本结束后恢复调用方的协议，最终结果按 RESP3 编码
+    EXPECT_EQ(RespBuilder::Protocol(), RespProtocol::Resp3);
+    EXPECT_EQ(executor.Execute("return nil", 0, {}), "_\r\n");
+}
@@ -0,0 +1,61 @@
+#include "core/astra.hpp"
+#include <algorithm>
+#include <datastructures/reorder_ring.hpp>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Astra::datastructures;
+
+TEST(ReorderRingTest, DeliversInReserveOrder) {
+    ReorderRing<std::string> ring(4);
+    uint64_t a = ring.Reserve(), b = ring.Reserve(), c = ring.Reserve();
+
+    std::vector<std::string> out;
+    auto collect = [&](std::string value) { out.push_back(std::move(value)); };
+
+    ring.Complete(c, "c");
+    EXPECT_EQ(ring.Drain(collect), 0u);
+    ring.Complete(a, "a");
+    EXPECT_EQ(ring.Drain(collect), 1u);
+    ring.Complete(b, "b");
+    EXPECT_EQ(ring.Drain(collect), 2u);
+
+    EXPECT_EQ(out, (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(ring.Pending(), 0u);
+}
+
+TEST(ReorderRingTest, GrowsWhenOutstandingExceedsCapacity) {
+    ReorderRing<int> ring(2);
+    std::vector<uint64_t> seqs;
+    for (int i = 0; i < 100; ++i) seqs.push_back(ring.Reserve());
+    EXPECT_GE(ring.Capacity(), 100u);
+    EXPECT_EQ(ring.Pending(), 100u);
+
+    std::mt19937 rng(3);
+    std::shuffle(seqs.begin(), seqs.end(), rng);
+    std::vector<int> out;
+    for (uint64_t seq: seqs) {
+        ring.Complete(seq, static_cast<int>(seq));
+        ring.Drain([&](int value) { out.push_back(value); });
+    }
+
+    ASSERT_EQ(out.size(), 100u);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(out[i], i);
+}
+
+TEST(ReorderRingTest, SlotsAreReusedAcrossWraparound) {
+    ReorderRing<int> ring(4);
+    std::vector<int> out;
+    for (int round = 0; round < 50; ++round) {
+        uint64_t first = ring.Reserve();
+        uint64_t second = ring.Reserve();
+        ring.Complete(second, round * 2 + 1);
+        ring.Complete(first, round * 2);
+        ring.Drain([&](int value) { out.push_back(value); });
+    }
+    EXPECT_EQ(ring.Capacity(), 4u);
+    ASSERT_EQ(out.size(), 100u);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(out[i], i);
+}
@@ -0,0 +1,110 @@
+#include "core/astra.hpp"
+#include "proto/hello.hpp"
+#include "proto/resp_builder.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Astra::proto;
+
+TEST(RespBuilderTest, DefaultsToResp2Encoding) {
+    EXPECT_EQ(RespBuilder::Protocol(), RespProtocol::Resp2);
+    EXPECT_EQ(RespBuilder::Nil(), "$-1\r\n");
+    EXPECT_EQ(RespBuilder::NullArray(), "*-1\r\n");
+    EXPECT_EQ(RespBuilder::Map({RespBuilder::BulkString("k"), RespBuilder::Integer(1)}), "*2\r\n$1\r\nk\r\n:1\r\n");
+    EXPECT_EQ(RespBuilder::Set({RespBuilder::BulkString("a")}), "*1\r\n$1\r\na\r\n");
+    EXPECT_EQ(RespBuilder::Double("1.5"), "$3\r\n1.5\r\n");
+    EXPECT_EQ(RespBuilder::Push({RespBuilder::BulkString("m")}), "*1\r\n$1\r\nm\r\n");
+    EXPECT_EQ(RespBuilder::Attribute({RespBuilder::BulkString("k"), RespBuilder::Integer(1)}), "");
+}
+
+TEST(RespBuilderTest, Resp3ScopeSwitchesEncoding) {
+    RespBuilder::ProtocolScope scope(RespProtocol::Resp3);
+    EXPECT_EQ(RespBuilder::Nil(), "_\r\n");
+    EXPECT_EQ(RespBuilder::NullArray(), "_\r\n");
+    EXPECT_EQ(RespBuilder::Map({RespBuilder::BulkString("k"), RespBuilder::Integer(1)}), "%1\r\n$1\r\nk\r\n:1\r\n");
+    EXPECT_EQ(RespBuilder::Set({RespBuilder::BulkString("a")}), "~1\r\n$1\r\na\r\n");
+    EXPECT_EQ(RespBuilder::Double("1.5"), ",1.5\r\n");
+    EXPECT_EQ(RespBuilder::Push({RespBuilder::BulkString("m")}), ">1\r\n$1\r\nm\r\n");
+    EXPECT_EQ(RespBuilder::Attribute({RespBuilder::BulkString("k"), RespBuilder::Integer(1)}), "|1\r\n$1\r\nk\r\n:1\r\n");
+    // 两种协议下相同的类型
+    EXPECT_EQ(RespBuilder::Integer(-7), ":-7\r\n");
+    EXPECT_EQ(RespBuilder::BulkString(""), "$0\r\n\r\n");
+}
+
+TEST(RespBuilderTest, ScopesNestAndStayOnTheirThread) {
+    {
+        RespBuilder::ProtocolScope outer(RespProtocol::Resp3);
+        {
+            RespBuilder::ProtocolScope inner(RespProtocol::Resp2);
+            EXPECT_EQ(RespBuilder::Nil(), "$-1\r\n");
+        }
+        EXPECT_EQ(RespBuilder::Nil(), "_\r\n");
+
+        // 协议版本是线程局部的，其他线程不受影响
+        RespProtocol other = RespProtocol::Resp3;
+        std::thread([&other]() { other = RespBuilder::Protocol(); }).join();
+        EXPECT_EQ(other, RespProtocol::Resp2);
+    }
+    EXPECT_EQ(RespBuilder::Protocol(), RespProtocol::Resp2);
+}
+
+TEST(HelloTest, ParsesProtocolVersion) {
+    HelloRequest request;
+    EXPECT_FALSE(ParseHelloRequest({"HELLO"}, request).has_value());
+    EXPECT_FALSE(request.protocol.has_value());
+
+    for (auto [arg, expected]: {std::pair{"2", RespProtocol::Resp2}, std::pair{"3", RespProtocol::Resp3}}) {
+        HelloRequest versioned;
+        EXPECT_FALSE(ParseHelloRequest({"HELLO", arg}, versioned).has_value()) << arg;
+        ASSERT_TRUE(versioned.protocol.has_value()) << arg;
+        EXPECT_EQ(*versioned.protocol, expected);
+    }
+
+    HelloRequest rejected;
+    auto noproto = ParseHelloRequest({"HELLO", "4"}, rejected);
+    ASSERT_TRUE(noproto.has_value());
+    EXPECT_EQ(noproto->rfind("-NOPROTO", 0), 0u);
+    EXPECT_FALSE(rejected.protocol.has_value());
+
+    auto not_integer = ParseHelloRequest({"HELLO", "three"}, rejected);
+    ASSERT_TRUE(not_integer.has_value());
+    EXPECT_EQ(not_integer->rfind("-ERR", 0), 0u);
+}
+
+TEST(HelloTest, ParsesAuthAndSetName) {
+    HelloRequest request;
+    EXPECT_FALSE(ParseHelloRequest({"HELLO", "3", "AUTH", "default", "secret"}, request).has_value());
+    EXPECT_FALSE(ParseHelloRequest({"HELLO", "3", "setname", "worker-1"}, request).has_value());
+    EXPECT_FALSE(ParseHelloRequest({"HELLO", "2", "AUTH", "default", "", "SETNAME", "x"}, request).has_value());
+
+    auto wrongpass = ParseHelloRequest({"HELLO", "3", "AUTH", "admin", "secret"}, request);
+    ASSERT_TRUE(wrongpass.has_value());
+    EXPECT_EQ(wrongpass->rfind("-WRONGPASS", 0), 0u);
+
+    // 选项缺少参数或未知时按语法错误处理
+    for (const auto &argv: std::vector<std::vector<std::string>>{{"HELLO", "3", "SETNAME"},
+                                                                  {"HELLO", "3", "AUTH", "default"},
+                                                                  {"HELLO", "3", "NOSUCHOPT"}}) {
+        auto error = ParseHelloRequest(argv, request);
+        ASSERT_TRUE(error.has_value()) << argv.back();
+        EXPECT_NE(error->find("Syntax error"), std::string::npos) << *error;
+    }
+}
+
+TEST(HelloTest, ReplyFollowsNegotiatedProtocol) {
+    {
+        RespBuilder::ProtocolScope scope(RespProtocol::Resp2);
+        std::string reply = HelloReply(RespProtocol::Resp2, 42);
+        EXPECT_EQ(reply.rfind("*14\r\n", 0), 0u);
+        EXPECT_NE(reply.find("$5\r\nproto\r\n:2\r\n"), std::string::npos);
+        EXPECT_NE(reply.find("$2\r\nid\r\n:42\r\n"), std::string::npos);
+    }
+    {
+        RespBuilder::ProtocolScope scope(RespProtocol::Resp3);
+        std::string reply = HelloReply(RespProtocol::Resp3, 42);
+        EXPECT_EQ(reply.rfind("%7\r\n", 0), 0u);
+        EXPECT_NE(reply.find("$5\r\nproto\r\n:3\r\n"), std::string::npos);
+    }
+}
@@ -0,0 +1,52 @@
+#include "core/astra.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <utils/resp_scan.hpp>
+
+using namespace Astra::utils::resp;
+
+TEST(RespScanTest, FindsFirstCarriageReturnAtEveryOffset) {
+    // 覆盖 SIMD 块内、块边界和标量尾部的所有位置
+    for (size_t len: {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 100u}) {
+        std::string text(len, 'x');
+        EXPECT_EQ(FindCR(text.data(), text.data() + text.size()), nullptr) << len;
+        for (size_t pos = 0; pos < len; ++pos) {
+            std::string probe = text;
+            probe[pos] = '\r';
+            if (pos + 1 < len) probe[len - 1] = '\r';
+            EXPECT_EQ(FindCR(probe.data(), probe.data() + probe.size()), probe.data() + pos) << len << "/" << pos;
+        }
+    }
+}
+
+TEST(RespScanTest, FindMatchesAllKernels) {
+    std::string text(200, 'a');
+    text[77] = '\r';
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+    EXPECT_EQ(detail::FindCRScalar(begin, end), begin + 77);
+#if defined(ASTRA_RESP_SSE2)
+    EXPECT_EQ(detail::FindCRSse2(begin, end), begin + 77);
+    if (Astra::utils::bitops::ActiveIsa() == Astra::utils::bitops::Isa::Avx2) {
+        EXPECT_EQ(detail::FindCRAvx2(begin, end), begin + 77);
+    }
+#endif
+    // 只在给定范围内查找，不越过 end
+    EXPECT_EQ(FindCR(begin, begin + 77), nullptr);
+}
+
+TEST(RespScanTest, ParsesWholeIntegersOnly) {
+    auto parse = [](std::string_view text, int64_t &value) {
+        return ParseInteger(text.data(), text.data() + text.size(), value);
+    };
+    int64_t value = 0;
+    EXPECT_TRUE(parse("42", value));
+    EXPECT_EQ(value, 42);
+    EXPECT_TRUE(parse("-1", value));
+    EXPECT_EQ(value, -1);
+    EXPECT_TRUE(parse("-9223372036854775808", value));
+    EXPECT_EQ(value, INT64_MIN);
+    for (const char *bad: {"", "-", "+1", "12a", " 1", "1 ", "9223372036854775808"}) {
+        EXPECT_FALSE(parse(bad, value)) << bad;
+    }
+}
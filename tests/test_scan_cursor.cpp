@@ -0,0 +1,75 @@
+#include "core/astra.hpp"
+#include "proto/scan_cursor.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Astra::proto;
+using Astra::data::AstraSet;
+
+namespace {
+    std::string EncodeSet(std::vector<std::string> members) {
+        std::sort(members.begin(), members.end());
+        return AstraSet::SerializeMembers(members);
+    }
+
+    // 扫描一批，把成员追加到 out
+    uint64_t ScanSet(const std::string &encoded, uint64_t cursor, size_t count, std::vector<std::string> &out) {
+        return ScanEncoded<1>(encoded, 4, cursor, count, [&](const auto &record) { out.emplace_back(record[0]); });
+    }
+}// namespace
+
+TEST(ScanCursorTest, UnchangedSetVisitsEachMemberOnce) {
+    std::vector<std::string> members;
+    for (int i = 0; i < 37; ++i) members.push_back("m" + std::to_string(i));
+    std::string encoded = EncodeSet(members);
+
+    std::vector<std::string> seen;
+    uint64_t cursor = 0;
+    do {
+        cursor = ScanSet(encoded, cursor, 5, seen);
+    } while (cursor != 0);
+    std::sort(members.begin(), members.end());
+    EXPECT_EQ(seen, members);
+}
+
+TEST(ScanCursorTest, DeletedCursorMemberDoesNotSkipShiftedRecords) {
+    std::vector<std::string> seen;
+    uint64_t cursor = ScanSet(EncodeSet({"a", "b", "c", "d", "e"}), 0, 2, seen);
+    ASSERT_NE(cursor, 0u);
+
+    // 删掉已返回的 a 和游标所指的 c：d 左移到游标偏移之前，仍必须返回
+    std::string changed = EncodeSet({"b", "d", "e"});
+    while (cursor != 0) {
+        cursor = ScanSet(changed, cursor, 2, seen);
+    }
+    for (const char *member: {"a", "b", "d", "e"}) {
+        EXPECT_NE(std::find(seen.begin(), seen.end(), member), seen.end()) << member;
+    }
+}
+
+TEST(ScanCursorTest, RelocatesShiftedCursorMemberWithoutDuplicates) {
+    std::vector<std::string> seen;
+    uint64_t cursor = ScanSet(EncodeSet({"b", "c", "d", "e", "f"}), 0, 2, seen);
+
+    // 之前插入的成员让 d 右移，删除的成员让它左移，两种情况都按指纹找回
+    std::string inserted = EncodeSet({"a", "aa", "b", "c", "d", "e", "f"});
+    cursor = ScanSet(inserted, cursor, 1, seen);
+    EXPECT_EQ(seen.back(), "d");
+    std::string removed = EncodeSet({"c", "e", "f"});
+    while (cursor != 0) {
+        cursor = ScanSet(removed, cursor, 2, seen);
+    }
+    EXPECT_EQ(seen, (std::vector<std::string>{"b", "c", "d", "e", "f"}));
+}
+
+TEST(ScanCursorTest, HashRecordsCarryValues) {
+    std::string encoded = "hash:1:a1:11:b1:2";
+    std::vector<std::string> fields;
+    uint64_t cursor = ScanEncoded<2>(encoded, 5, 0, 10, [&](const auto &record) {
+        fields.emplace_back(std::string(record[0]) + "=" + std::string(record[1]));
+    });
+    EXPECT_EQ(cursor, 0u);
+    EXPECT_EQ(fields, (std::vector<std::string>{"a=1", "b=2"}));
+}
@@ -0,0 +1,83 @@
+#include "core/astra.hpp"
+#include <datastructures/set_algebra.hpp>
+#include <gtest/gtest.h>
+
+using namespace Astra::datastructures::set_algebra;
+
+namespace {
+    std::vector<int> Sequence(int from, int to, int step = 1) {
+        std::vector<int> v;
+        for (int i = from; i < to; i += step) v.push_back(i);
+        return v;
+    }
+}// namespace
+
+TEST(SetAlgebraTest, GallopLowerBound) {
+    auto v = Sequence(0, 1000, 2);
+    Range<int> r(v);
+
+    EXPECT_EQ(GallopLowerBound(r, 0, 0), 0u);
+    EXPECT_EQ(GallopLowerBound(r, 0, 1), 1u);
+    EXPECT_EQ(GallopLowerBound(r, 10, 500), 250u);
+    EXPECT_EQ(GallopLowerBound(r, 0, 5000), v.size());
+}
+
+TEST(SetAlgebraTest, IntersectSmallAndSkewed) {
+    auto a = Sequence(0, 100000);
+    std::vector<int> b = {3, 500, 99999, 100001};
+    std::vector<int> c = {1, 3, 500, 700};
+
+    auto result = Intersect<int>({a, b, c});
+    EXPECT_EQ(result, (std::vector<int>{3, 500}));
+
+    auto limited = Intersect<int>({a, b}, 2);
+    EXPECT_EQ(limited, (std::vector<int>{3, 500}));
+
+    std::vector<int> empty;
+    EXPECT_TRUE(Intersect<int>({a, empty}).empty());
+}
+
+TEST(SetAlgebraTest, IntersectLimitStopsEarly) {
+    auto a = Sequence(0, 1000);
+    auto b = Sequence(0, 1000, 2);
+    auto c = Sequence(0, 1000, 3);
+
+    // 线性归并、gallop、多集合探测三条路径都只取前 limit 个交集元素
+    EXPECT_EQ(Intersect<int>({a, b}, 3), (std::vector<int>{0, 2, 4}));
+    EXPECT_EQ(Intersect<int>({a, std::vector<int>{5, 7, 900}}, 2), (std::vector<int>{5, 7}));
+    EXPECT_EQ(Intersect<int>({a, b, c}, 3), (std::vector<int>{0, 6, 12}));
+    EXPECT_EQ(Intersect<int>({a}, 2), (std::vector<int>{0, 1}));
+
+    // limit 大于交集时与不带 limit 相同
+    EXPECT_EQ(Intersect<int>({a, b, c}, 10000), Intersect<int>({a, b, c}));
+    EXPECT_EQ(Intersect<int>({b, c, std::vector<int>{1, 6, 997, 1002}}, 5), (std::vector<int>{6}));
+}
+
+TEST(SetAlgebraTest, UnionAndDiff) {
+    std::vector<int> a = {1, 3, 5, 7};
+    std::vector<int> b = {2, 3, 4};
+    std::vector<int> c = {7, 8};
+
+    EXPECT_EQ(Union<int>({a, b, c}), (std::vector<int>{1, 2, 3, 4, 5, 7, 8}));
+    EXPECT_EQ(Diff<int>({a, b, c}), (std::vector<int>{1, 5}));
+}
+
+TEST(SetAlgebraTest, StringViewMembers) {
+    std::vector<std::string_view> a = {"a", "b", "c"};
+    std::vector<std::string_view> b = {"b", "c", "d"};
+
+    EXPECT_EQ(Intersect<std::string_view>({a, b}), (std::vector<std::string_view>{"b", "c"}));
+    EXPECT_EQ(Diff<std::string_view>({a, b}), (std::vector<std::string_view>{"a"}));
+}
+
+TEST(SetAlgebraTest, ParallelMatchesSerial) {
+    auto a = Sequence(0, static_cast<int>(kParallelThreshold) * 3);
+    auto b = Sequence(0, static_cast<int>(kParallelThreshold) * 6, 2);
+    auto c = Sequence(0, static_cast<int>(kParallelThreshold) * 4, 3);
+    std::vector<Range<int>> inputs = {a, b, c};
+
+    EXPECT_EQ(IntersectParallel(inputs), Intersect(inputs));
+    EXPECT_EQ(UnionParallel(inputs), Union(inputs));
+    EXPECT_EQ(DiffParallel(inputs), Diff(inputs));
+    EXPECT_EQ(IntersectParallel(inputs, 10), (std::vector<int>{0, 6, 12, 18, 24, 30, 36, 42, 48, 54}));
+}
@@ -0,0 +1,109 @@
+#include "core/astra.hpp"
+#include <datastructures/sketch.hpp>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Astra::datastructures;
+
+TEST(CountMinSketchTest, NeverUnderestimates) {
+    std::string cms = CountMinSketch::Create(2000, 5);
+    ASSERT_TRUE(CountMinSketch::IsValid(cms));
+
+    std::vector<uint32_t> actual(500);
+    std::mt19937 rng(1);
+    for (int i = 0; i < 20000; ++i) {
+        uint32_t item = rng() % actual.size();
+        actual[item]++;
+        ASSERT_TRUE(CountMinSketch::IncrBy(cms, sketch::Hash("item:" + std::to_string(item)), 1));
+    }
+
+    uint64_t total_error = 0;
+    for (size_t i = 0; i < actual.size(); ++i) {
+        uint32_t estimate = CountMinSketch::Query(cms, sketch::Hash("item:" + std::to_string(i)));
+        EXPECT_GE(estimate, actual[i]) << i;
+        total_error += estimate - actual[i];
+    }
+    EXPECT_LT(total_error, 20000u / 10);
+    EXPECT_EQ(CountMinSketch::GetInfo(cms).count, 20000u);
+}
+
+TEST(CountMinSketchTest, OverflowLeavesCountersUntouched) {
+    std::string cms = CountMinSketch::Create(10, 3);
+    uint64_t hash = sketch::Hash("hot");
+    EXPECT_EQ(CountMinSketch::IncrBy(cms, hash, UINT32_MAX - 1), UINT32_MAX - 1);
+    EXPECT_FALSE(CountMinSketch::IncrBy(cms, hash, 2).has_value());
+    EXPECT_EQ(CountMinSketch::Query(cms, hash), UINT32_MAX - 1);
+}
+
+TEST(CountMinSketchTest, SizingAndValidation) {
+    auto info = CountMinSketch::GetInfo(CountMinSketch::CreateByProbability(0.001, 0.01));
+    EXPECT_EQ(info.width, 2000u);
+    EXPECT_EQ(info.depth, 7u);
+    EXPECT_TRUE(CountMinSketch::Create(0, 5).empty());
+    EXPECT_TRUE(CountMinSketch::Create(UINT32_MAX, UINT32_MAX).empty());
+    EXPECT_FALSE(CountMinSketch::IsValid("cms:"));
+    EXPECT_FALSE(CountMinSketch::IsValid(CountMinSketch::Create(10, 3) + "x"));
+}
+
+TEST(TopKTest, FindsHeavyHittersInSkewedStream) {
+    std::string topk = TopK::Create(10, 1000, 5);
+    ASSERT_TRUE(TopK::IsValid(topk));
+
+    // 10 个重元素各 1000 次，夹杂 5000 个只出现一次的噪声元素
+    std::vector<std::string> events;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 1000; ++j) events.push_back("heavy:" + std::to_string(i));
+    }
+    for (int i = 0; i < 5000; ++i) events.push_back("noise:" + std::to_string(i));
+    std::shuffle(events.begin(), events.end(), std::mt19937(3));
+
+    std::vector<std::pair<std::string_view, uint32_t>> batch;
+    std::vector<std::optional<std::string>> expelled;
+    for (size_t begin = 0; begin < events.size(); begin += 1000) {
+        batch.clear();
+        for (size_t i = begin; i < std::min(events.size(), begin + 1000); ++i) batch.emplace_back(events[i], 1);
+        TopK::IncrBy(topk, batch, expelled);
+        ASSERT_EQ(expelled.size(), batch.size());
+    }
+    ASSERT_TRUE(TopK::IsValid(topk));
+
+    auto list = TopK::List(topk);
+    ASSERT_EQ(list.size(), 10u);
+    for (const auto &candidate: list) {
+        EXPECT_EQ(candidate.item.rfind("heavy:", 0), 0u) << candidate.item;
+        EXPECT_GE(candidate.count, 1000u);
+    }
+    EXPECT_TRUE(TopK::Contains(topk, "heavy:3"));
+    EXPECT_FALSE(TopK::Contains(topk, "noise:3"));
+    EXPECT_GE(TopK::Estimate(topk, "heavy:3"), 1000u);
+}
+
+TEST(TopKTest, ReportsExpelledItems) {
+    std::string topk = TopK::Create(2, 100, 4);
+    std::vector<std::optional<std::string>> expelled;
+    std::vector<std::pair<std::string_view, uint32_t>> batch = {{"a", 5}, {"b", 3}, {"c", 1}, {"c", 4}};
+    TopK::IncrBy(topk, batch, expelled);
+
+    ASSERT_EQ(expelled.size(), 4u);
+    EXPECT_FALSE(expelled[0] || expelled[1] || expelled[2]);
+    EXPECT_EQ(expelled[3], "b");
+
+    auto list = TopK::List(topk);
+    ASSERT_EQ(list.size(), 2u);
+    EXPECT_EQ(list[0].item, "a");
+    EXPECT_EQ(list[1].item, "c");
+    EXPECT_EQ(list[1].count, 5u);
+}
+
+TEST(TopKTest, RejectsMalformedValues) {
+    EXPECT_TRUE(TopK::Create(0, 10, 3).empty());
+    EXPECT_FALSE(TopK::IsValid("topk:"));
+    std::string topk = TopK::Create(3, 10, 3);
+    std::vector<std::optional<std::string>> expelled;
+    std::vector<std::pair<std::string_view, uint32_t>> batch = {{"x", 1}};
+    TopK::IncrBy(topk, batch, expelled);
+    EXPECT_TRUE(TopK::IsValid(topk));
+    EXPECT_FALSE(TopK::IsValid(topk.substr(0, topk.size() - 1)));
+}
@@ -0,0 +1,54 @@
+#include "core/astra.hpp"
+#include <concurrent/split_counter.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace Astra::concurrent;
+
+TEST(SplitCounterTest, CellCountRoundsUpToPowerOfTwo) {
+    SplitCounter counter(0, 6);
+    EXPECT_EQ(counter.CellCount(), 8u);
+}
+
+TEST(SplitCounterTest, ReadIncludesUnfoldedDeltas) {
+    SplitCounter counter(10);
+    EXPECT_EQ(counter.Add(5), 15);
+    EXPECT_EQ(counter.Add(-2), 13);
+    EXPECT_EQ(counter.Read(), 13);
+    EXPECT_EQ(counter.Fold(), 13);
+    EXPECT_EQ(counter.Read(), 13);
+}
+
+TEST(SplitCounterTest, RebaseKeepsPendingDeltas) {
+    SplitCounter counter(100);
+    counter.Add(7);
+    EXPECT_EQ(counter.Rebase(1000), 1007);
+    EXPECT_EQ(counter.Read(), 1007);
+}
+
+TEST(SplitCounterTest, ConcurrentAddsAreNotLost) {
+    SplitCounter counter;
+    constexpr int kThreads = 8;
+    constexpr int kIterations = 100000;
+
+    std::atomic<bool> stop{false};
+    std::thread folder([&] {
+        while (!stop.load()) {
+            counter.Fold();
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kIterations; ++i) counter.Add(1);
+        });
+    }
+    for (auto &thread: threads) thread.join();
+    stop = true;
+    folder.join();
+
+    EXPECT_EQ(counter.Read(), int64_t(kThreads) * kIterations);
+}
@@ -0,0 +1,64 @@
+#include "core/astra.hpp"
+#include <atomic>
+#include <datastructures/spsc_channel.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace Astra::datastructures;
+
+TEST(SpscChannelTest, OverflowKeepsSendOrder) {
+    SpscChannel<int, 4> channel;// 环中最多 3 条
+    std::vector<int> received;
+    auto collect = [&](int value) { received.push_back(value); };
+
+    for (int i = 0; i < 5; ++i) channel.Push(i);// 3、4 溢出
+    channel.Drain(collect);
+    EXPECT_EQ(received, (std::vector<int>{0, 1, 2, 3, 4}));
+
+    // 全部取走后通道回到走环的状态
+    received.clear();
+    channel.Push(5);
+    channel.Drain(collect);
+    EXPECT_EQ(received, (std::vector<int>{5}));
+}
+
+TEST(SpscChannelTest, OverflowWhileConsumerHasQueuedWork) {
+    SpscChannel<int, 4> channel;
+    std::vector<int> received;
+    auto collect = [&](int value) { received.push_back(value); };
+
+    // 环满后 1 进入溢出队列；消费者取环时环已有空位，此时到达的 2 也不能越过 1
+    for (int i = -3; i < 0; ++i) channel.Push(i);
+    channel.Push(1);
+    channel.Drain([&](int value) {
+        received.push_back(value);
+        if (value == -1) channel.Push(2);
+    });
+    channel.Drain(collect);
+    EXPECT_EQ(received, (std::vector<int>{-3, -2, -1, 1, 2}));
+}
+
+TEST(SpscChannelTest, ConcurrentProducerConsumerStayInOrder) {
+    SpscChannel<int, 8> channel;
+    constexpr int kCount = 200000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kCount; ++i) channel.Push(i);
+        done.store(true);
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    auto check = [&](int value) {
+        ordered &= value == expected;
+        ++expected;
+    };
+    while (!done.load()) channel.Drain(check);
+    producer.join();
+    channel.Drain(check);
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(expected, kCount);
+}
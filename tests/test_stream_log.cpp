@@ -0,0 +1,133 @@
+#include "core/astra.hpp"
+#include "data/redis_types.hpp"
+#include <datastructures/stream_log.hpp>
+#include <gtest/gtest.h>
+
+using namespace Astra::datastructures;
+
+namespace {
+    StreamFields Fields(const std::string &value) {
+        return {{"field", value}};
+    }
+}// namespace
+
+TEST(StreamLogTest, ParseAndFormatID) {
+    auto id = StreamID::Parse("1526919030474-55");
+    ASSERT_TRUE(id.has_value());
+    EXPECT_EQ(id->ms, 1526919030474u);
+    EXPECT_EQ(id->seq, 55u);
+    EXPECT_EQ(id->ToString(), "1526919030474-55");
+
+    EXPECT_EQ(StreamID::Parse("42")->seq, 0u);
+    EXPECT_EQ(StreamID::Parse("42", 7)->seq, 7u);
+    EXPECT_FALSE(StreamID::Parse("").has_value());
+    EXPECT_FALSE(StreamID::Parse("1-").has_value());
+    EXPECT_FALSE(StreamID::Parse("abc").has_value());
+    EXPECT_EQ(*StreamID({1, UINT64_MAX}).Next(), StreamID({2, 0}));
+}
+
+TEST(StreamLogTest, AppendRequiresIncreasingIDs) {
+    StreamLog log;
+    EXPECT_TRUE(log.Append({1, 0}, Fields("a")));
+    EXPECT_TRUE(log.Append({1, 1}, Fields("b")));
+    EXPECT_FALSE(log.Append({1, 1}, Fields("c")));
+    EXPECT_FALSE(log.Append({0, 5}, Fields("c")));
+    EXPECT_EQ(log.Size(), 2u);
+    EXPECT_EQ(log.LastID(), StreamID({1, 1}));
+}
+
+TEST(StreamLogTest, RangeAcrossBlocks) {
+    StreamLog log(4);
+    for (uint64_t i = 1; i <= 20; ++i) {
+        ASSERT_TRUE(log.Append({i * 10, 0}, Fields(std::to_string(i))));
+    }
+    EXPECT_EQ(log.BlockCount(), 5u);
+
+    auto all = log.Range(StreamID::Min(), StreamID::Max());
+    ASSERT_EQ(all.size(), 20u);
+    EXPECT_EQ(all.front().fields[0].second, "1");
+    EXPECT_EQ(all.back().id, StreamID({200, 0}));
+
+    auto middle = log.Range({35, 0}, {95, 0});
+    ASSERT_EQ(middle.size(), 6u);
+    EXPECT_EQ(middle.front().id, StreamID({40, 0}));
+    EXPECT_EQ(middle.back().id, StreamID({90, 0}));
+
+    auto limited = log.Range({35, 0}, StreamID::Max(), 3);
+    EXPECT_EQ(limited.size(), 3u);
+
+    auto reversed = log.RevRange({95, 0}, {35, 0}, 2);
+    ASSERT_EQ(reversed.size(), 2u);
+    EXPECT_EQ(reversed[0].id, StreamID({90, 0}));
+    EXPECT_EQ(reversed[1].id, StreamID({80, 0}));
+}
+
+TEST(StreamLogTest, TrimExactAndApproximate) {
+    StreamLog log(4);
+    for (uint64_t i = 1; i <= 10; ++i) {
+        log.Append({i, 0}, Fields(std::to_string(i)));
+    }
+
+    // 近似裁剪只丢整块：10 条中保留 >= 5 条
+    log.Trim(5, true);
+    EXPECT_EQ(log.Size(), 6u);
+    EXPECT_EQ(*log.FirstID(), StreamID({5, 0}));
+
+    log.Trim(3, false);
+    EXPECT_EQ(log.Size(), 3u);
+    auto rest = log.Range(StreamID::Min(), StreamID::Max());
+    ASSERT_EQ(rest.size(), 3u);
+    EXPECT_EQ(rest.front().id, StreamID({8, 0}));
+
+    // 裁剪不影响 ID 单调性
+    EXPECT_FALSE(log.Append({5, 0}, Fields("x")));
+}
+
+TEST(StreamLogTest, RestoreLastIDKeepsTrimmedIDsMonotonic) {
+    StreamLog log;
+    log.Append({1, 0}, Fields("a"));
+    log.RestoreLastID({9, 0});
+    EXPECT_EQ(log.LastID(), StreamID({9, 0}));
+    EXPECT_FALSE(log.Append({5, 0}, Fields("b")));
+    EXPECT_TRUE(log.Append({9, 1}, Fields("c")));
+
+    // 只会调大
+    log.RestoreLastID({2, 0});
+    EXPECT_EQ(log.LastID(), StreamID({9, 1}));
+
+    StreamLog empty;
+    empty.RestoreLastID({3, 0});
+    EXPECT_TRUE(empty.Empty());
+    EXPECT_FALSE(empty.Append({3, 0}, Fields("d")));
+}
+
+TEST(StreamLogTest, StreamSnapshotRoundTrip) {
+    Astra::data::AstraStream stream;
+    for (uint64_t i = 1; i <= 5; ++i) {
+        stream.Log().Append({i, 0}, {{"k", "v " + std::to_string(i)}, {"", "1:x"}});
+    }
+    stream.Log().Trim(3, false);
+    stream.CreateGroup("g", {4, 0});
+    auto *group = stream.FindGroup("g");
+    group->pending[{4, 0}] = {"alice", 1000, 2};
+    group->consumers["alice"] = 1000;
+
+    std::string encoded = stream.Serialize();
+    auto restored = Astra::data::AstraStream::Deserialize(encoded);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->Serialize(), encoded);
+    EXPECT_EQ(restored->Log().Size(), 3u);
+    EXPECT_EQ(restored->Log().LastID(), StreamID({5, 0}));
+    auto entries = restored->Log().Range(StreamID::Min(), StreamID::Max());
+    EXPECT_EQ(entries.front().fields[0].second, "v 3");
+    EXPECT_EQ(entries.front().fields[1].second, "1:x");
+    auto *restored_group = restored->FindGroup("g");
+    ASSERT_NE(restored_group, nullptr);
+    EXPECT_EQ(restored_group->last_delivered, StreamID({4, 0}));
+    EXPECT_EQ(restored_group->pending.at({4, 0}).delivery_count, 2u);
+
+    // 损坏或截断的编码不会被当成流
+    EXPECT_FALSE(Astra::data::AstraStream::Deserialize("stream:").has_value());
+    EXPECT_FALSE(Astra::data::AstraStream::Deserialize(encoded.substr(0, encoded.size() - 1)).has_value());
+    EXPECT_FALSE(Astra::data::AstraStream::Deserialize(encoded + "x").has_value());
+}
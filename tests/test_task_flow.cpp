@@ -258,4 +258,23 @@ TEST(TaskFlowTest, TaskPipeline_SharedContext) {
 
     // 验证最终结果是否正确
     EXPECT_EQ(final_value.load(), 20);// (0 + 10) * 2 = 20
-}
\ No newline at end of file
+}
+// ======================
+// 12. 并发任务组阻塞等待全部完成
+// ======================
+TEST(TaskFlowTest, ParallelWork_RunAndWait) {
+    auto queue = std::make_shared<TaskQueue>(4);
+    ParallelWork pw(queue);
+
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 16; ++i) {
+        pw.Add([&count] {
+            std::this_thread::sleep_for(10ms);
+            count.fetch_add(1);
+        });
+    }
+    pw.Add([] { throw std::runtime_error("task failed"); });
+
+    pw.RunAndWait();
+    EXPECT_EQ(count.load(), 16);
+}
@@ -0,0 +1,96 @@
+#include "core/astra.hpp"
+#include "data/redis_types.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using Astra::data::AstraZSet;
+
+namespace {
+    // 从头到尾走完 ZSCAN，返回按回调顺序收集到的成员
+    std::vector<std::string> ScanAll(const AstraZSet &zset, size_t count) {
+        std::vector<std::string> members;
+        uint64_t cursor = 0;
+        do {
+            cursor = zset.Scan(cursor, count, [&](const std::string &member, double) { members.push_back(member); });
+        } while (cursor != 0);
+        return members;
+    }
+}// namespace
+
+TEST(ZSetTest, SnapshotRoundTrip) {
+    AstraZSet zset;
+    zset.ZAdd({{"a", 1.5}, {"b", -2}, {"c:1", 0.1}, {"", 1e300}, {"inf", std::numeric_limits<double>::infinity()}});
+
+    std::string encoded = zset.Serialize();
+    auto restored = AstraZSet::Deserialize(encoded);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->Serialize(), encoded);
+    EXPECT_EQ(restored->ZCard(), 5u);
+    // 分数按最短十进制保存，能精确还原
+    EXPECT_EQ(restored->ZScore("c:1").second, 0.1);
+    EXPECT_EQ(restored->ZScore("").second, 1e300);
+    EXPECT_EQ(restored->ZScore("inf").second, std::numeric_limits<double>::infinity());
+
+    // 损坏、截断或成员重复的编码不会被当成有序集合
+    EXPECT_FALSE(AstraZSet::Deserialize("hash:").has_value());
+    EXPECT_FALSE(AstraZSet::Deserialize(encoded.substr(0, encoded.size() - 1)).has_value());
+    EXPECT_FALSE(AstraZSet::Deserialize("zset:1:a3:nan").has_value());
+    EXPECT_FALSE(AstraZSet::Deserialize("zset:1:a1:11:a1:2").has_value());
+}
+
+TEST(ZSetTest, ScanStaysWithinCountEvenWhenAllScoresTie) {
+    AstraZSet zset;
+    std::map<std::string, double> members;
+    for (int i = 0; i < 1000; ++i) {
+        members["m" + std::to_string(i)] = 0;// 全部同分（按字典序使用的有序集合）
+    }
+    zset.ZAdd(members);
+
+    for (size_t count: {1u, 7u, 10u, 5000u}) {
+        std::set<std::string> seen;
+        uint64_t cursor = 0;
+        do {
+            size_t batch = 0;
+            cursor = zset.Scan(cursor, count, [&](const std::string &member, double score) {
+                EXPECT_TRUE(seen.insert(member).second) << member;
+                EXPECT_EQ(score, 0);
+                ++batch;
+            });
+            EXPECT_LE(batch, count);
+        } while (cursor != 0);
+        EXPECT_EQ(seen.size(), members.size()) << count;
+    }
+}
+
+TEST(ZSetTest, ScanCursorSurvivesConcurrentChanges) {
+    AstraZSet zset;
+    zset.ZAdd({{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}});
+
+    std::vector<std::string> seen;
+    auto collect = [&](const std::string &member, double) { seen.push_back(member); };
+    uint64_t cursor = zset.Scan(0, 2, collect);
+    ASSERT_NE(cursor, 0u);
+    // 删除成员（包括游标所指的成员）、改分数、插入新成员，都不影响其余成员各返回一次
+    zset.ZRem({"a", "c"});
+    zset.ZAdd({{"d", -1}, {"e", 0}});
+    while (cursor != 0) {
+        cursor = zset.Scan(cursor, 2, collect);
+    }
+    EXPECT_EQ(seen, (std::vector<std::string>{"a", "b", "d", "e"}));
+
+    // 超出范围的游标直接结束
+    EXPECT_EQ(zset.Scan(~uint64_t{0}, 10, collect), 0u);
+}
+
+TEST(ZSetTest, ScanCoversDeserializedMembers) {
+    AstraZSet zset;
+    zset.ZAdd({{"x", 2}, {"y", 1}});
+    auto restored = AstraZSet::Deserialize(zset.Serialize());
+    ASSERT_TRUE(restored.has_value());
+    auto members = ScanAll(*restored, 1);
+    EXPECT_EQ(members.size(), 2u);
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ASTRA_BITOPS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ASTRA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ASTRA_TARGET(isa)
+#endif
+
+namespace Astra::utils::bitops {
+
+    // 位图内核：BITCOUNT 的 popcount 与 BITOP 的按位运算
+    // 启动时检测一次 CPU 能力，按 AVX2 → POPCNT → 标量 的顺序选择实现；
+    // 不依赖编译选项，同一个二进制在老 CPU 上自动退回标量路径。
+
+    enum class Isa {
+        Scalar,
+        Popcnt,
+        Avx2
+    };
+
+    inline Isa DetectIsa() {
+#if defined(ASTRA_BITOPS_X86)
+#if defined(_MSC_VER)
+        int info[4] = {0};
+        __cpuid(info, 1);
+        bool popcnt = (info[2] & (1 << 23)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx2 = false;
+        if (osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        bool popcnt = __builtin_cpu_supports("popcnt");
+        bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2 && popcnt) return Isa::Avx2;
+        if (popcnt) return Isa::Popcnt;
+#endif
+        return Isa::Scalar;
+    }
+
+    inline Isa ActiveIsa() {
+        static const Isa isa = DetectIsa();
+        return isa;
+    }
+
+    inline const char *IsaName(Isa isa) {
+        switch (isa) {
+            case Isa::Avx2:
+                return "avx2";
+            case Isa::Popcnt:
+                return "popcnt";
+            default:
+                return "scalar";
+        }
+    }
+
+    namespace detail {
+
+        inline uint64_t LoadWord(const uint8_t *p) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            return word;
+        }
+
+        inline void StoreWord(uint8_t *p, uint64_t word) {
+            std::memcpy(p, &word, sizeof(word));
+        }
+
+        // SWAR popcount，不依赖任何指令集扩展
+        inline uint64_t PopCountWordScalar(uint64_t x) {
+            x = x - ((x >> 1) & 0x5555555555555555ULL);
+            x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return (x * 0x0101010101010101ULL) >> 56;
+        }
+
+        inline size_t PopCountScalar(const uint8_t *data, size_t len) {
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 8 <= len; i += 8) {
+                count += PopCountWordScalar(LoadWord(data + i));
+            }
+            for (; i < len; ++i) {
+                count += PopCountWordScalar(data[i]);
+            }
+            return count;
+        }
+
+#if defined(ASTRA_BITOPS_X86) && (defined(__x86_64__) || defined(_M_X64))
+        ASTRA_TARGET("popcnt")
+        inline size_t PopCountPopcnt(const uint8_t *data, size_t len) {
+            // 四路累加，打断 popcnt 的依赖链
+            uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32) {
+                c0 += _mm_popcnt_u64(LoadWord(data + i));
+                c1 += _mm_popcnt_u64(LoadWord(data + i + 8));
+                c2 += _mm_popcnt_u64(LoadWord(data + i + 16));
+                c3 += _mm_popcnt_u64(LoadWord(data + i + 24));
+            }
+            for (; i + 8 <= len; i += 8) {
+                c0 += _mm_popcnt_u64(LoadWord(data + i));
+            }
+            for (; i < len; ++i) {
+                c0 += _mm_popcnt_u32(data[i]);
+            }
+            return static_cast<size_t>(c0 + c1 + c2 + c3);
+        }
+
+        // Mula 的 nibble 查表法：vpshufb 查 4 位的 popcount，vpsadbw 横向累加
+        ASTRA_TARGET("avx2,popcnt")
+        inline size_t PopCountAvx2(const uint8_t *data, size_t len) {
+            const __m256i lookup = _mm256_setr_epi8(
+                    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i low_mask = _mm256_set1_epi8(0x0F);
+            __m256i total = _mm256_setzero_si256();
+
+            size_t i = 0;
+            while (i + 32 <= len) {
+                // 每个字节最多累加 8，最多 31 轮后必须用 sad 展宽，避免溢出
+                __m256i local = _mm256_setzero_si256();
+                size_t rounds = std::min<size_t>((len - i) / 32, 31);
+                for (size_t r = 0; r < rounds; ++r, i += 32) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                    __m256i lo = _mm256_and_si256(v, low_mask);
+                    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+                    local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, lo));
+                    local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, hi));
+                }
+                total = _mm256_add_epi64(total, _mm256_sad_epu8(local, _mm256_setzero_si256()));
+            }
+
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), total);
+            size_t count = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+            return count + PopCountPopcnt(data + i, len - i);
+        }
+#endif
+
+        enum class Op {
+            And,
+            Or,
+            Xor,
+            Max// 按字节取无符号最大值，用于 HyperLogLog 寄存器合并
+        };
+
+        // dst[i] = dst[i] op src[i]
+        template<Op op>
+        inline void ApplyScalar(uint8_t *dst, const uint8_t *src, size_t len) {
+            size_t i = 0;
+            if constexpr (op != Op::Max) {
+                for (; i + 8 <= len; i += 8) {
+                    uint64_t a = LoadWord(dst + i);
+                    uint64_t b = LoadWord(src + i);
+                    if constexpr (op == Op::And) a &= b;
+                    if constexpr (op == Op::Or) a |= b;
+                    if constexpr (op == Op::Xor) a ^= b;
+                    StoreWord(dst + i, a);
+                }
+            }
+            for (; i < len; ++i) {
+                if constexpr (op == Op::And) dst[i] &= src[i];
+                if constexpr (op == Op::Or) dst[i] |= src[i];
+                if constexpr (op == Op::Xor) dst[i] ^= src[i];
+                if constexpr (op == Op::Max) dst[i] = std::max(dst[i], src[i]);
+            }
+        }
+
+        inline void NotScalar(uint8_t *dst, size_t len) {
+            size_t i = 0;
+            for (; i + 8 <= len; i += 8) {
+                StoreWord(dst + i, ~LoadWord(dst + i));
+            }
+            for (; i < len; ++i) {
+                dst[i] = static_cast<uint8_t>(~dst[i]);
+            }
+        }
+
+#if defined(ASTRA_BITOPS_X86)
+        template<Op op>
+        ASTRA_TARGET("avx2")
+        inline void ApplyAvx2(uint8_t *dst, const uint8_t *src, size_t len) {
+            size_t i = 0;
+            // 每轮处理 128 字节，给乱序执行留出足够的独立加载
+            for (; i + 128 <= len; i += 128) {
+                for (size_t k = 0; k < 128; k += 32) {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i + k));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + k));
+                    if constexpr (op == Op::And) a = _mm256_and_si256(a, b);
+                    if constexpr (op == Op::Or) a = _mm256_or_si256(a, b);
+                    if constexpr (op == Op::Xor) a = _mm256_xor_si256(a, b);
+                    if constexpr (op == Op::Max) a = _mm256_max_epu8(a, b);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + k), a);
+                }
+            }
+            for (; i + 32 <= len; i += 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                if constexpr (op == Op::And) a = _mm256_and_si256(a, b);
+                if constexpr (op == Op::Or) a = _mm256_or_si256(a, b);
+                if constexpr (op == Op::Xor) a = _mm256_xor_si256(a, b);
+                if constexpr (op == Op::Max) a = _mm256_max_epu8(a, b);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), a);
+            }
+            ApplyScalar<op>(dst + i, src + i, len - i);
+        }
+
+        ASTRA_TARGET("avx2")
+        inline void NotAvx2(uint8_t *dst, size_t len) {
+            const __m256i ones = _mm256_set1_epi8(static_cast<char>(0xFF));
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_xor_si256(a, ones));
+            }
+            NotScalar(dst + i, len - i);
+        }
+#endif
+
+        template<Op op>
+        inline void Apply(uint8_t *dst, const uint8_t *src, size_t len) {
+#if defined(ASTRA_BITOPS_X86)
+            if (ActiveIsa() == Isa::Avx2) {
+                ApplyAvx2<op>(dst, src, len);
+                return;
+            }
+#endif
+            ApplyScalar<op>(dst, src, len);
+        }
+
+    }// namespace detail
+
+    // 统计 data 中置位的比特数
+    inline size_t PopCount(const uint8_t *data, size_t len) {
+#if defined(ASTRA_BITOPS_X86) && (defined(__x86_64__) || defined(_M_X64))
+        switch (ActiveIsa()) {
+            case Isa::Avx2:
+                return detail::PopCountAvx2(data, len);
+            case Isa::Popcnt:
+                return detail::PopCountPopcnt(data, len);
+            default:
+                break;
+        }
+#endif
+        return detail::PopCountScalar(data, len);
+    }
+
+    enum class BitOp {
+        And,
+        Or,
+        Xor,
+        Not
+    };
+
+    // 对多个源做按位运算写入 dst，dst.size() 为结果长度；较短的源视为以 0 补齐（与 Redis 一致）
+    // NOT 只接受一个源
+    inline void Combine(BitOp op, std::span<uint8_t> dst, std::span<const std::span<const uint8_t>> sources) {
+        std::fill(dst.begin(), dst.end(), 0);
+        if (sources.empty()) return;
+
+        const auto &first = sources[0];
+        std::memcpy(dst.data(), first.data(), std::min(first.size(), dst.size()));
+
+        if (op == BitOp::Not) {
+#if defined(ASTRA_BITOPS_X86)
+            if (ActiveIsa() == Isa::Avx2) {
+                detail::NotAvx2(dst.data(), dst.size());
+                return;
+            }
+#endif
+            detail::NotScalar(dst.data(), dst.size());
+            return;
+        }
+
+        for (size_t s = 1; s < sources.size(); ++s) {
+            const auto &src = sources[s];
+            size_t overlap = std::min(src.size(), dst.size());
+            switch (op) {
+                case BitOp::And:
+                    detail::Apply<detail::Op::And>(dst.data(), src.data(), overlap);
+                    // 超出该源长度的部分与 0 相与
+                    std::fill(dst.begin() + overlap, dst.end(), 0);
+                    break;
+                case BitOp::Or:
+                    detail::Apply<detail::Op::Or>(dst.data(), src.data(), overlap);
+                    break;
+                case BitOp::Xor:
+                    detail::Apply<detail::Op::Xor>(dst.data(), src.data(), overlap);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // dst[i] = max(dst[i], src[i])，逐字节无符号比较
+    inline void MaxBytes(uint8_t *dst, const uint8_t *src, size_t len) {
+        detail::Apply<detail::Op::Max>(dst, src, len);
+    }
+
+    // 在 [begin_bit, end_bit) 中查找第一个值为 bit 的位置，找不到返回 -1
+    inline int64_t FindBit(const uint8_t *data, size_t len, bool bit, uint64_t begin_bit, uint64_t end_bit) {
+        end_bit = std::min<uint64_t>(end_bit, static_cast<uint64_t>(len) * 8);
+        uint64_t pos = begin_bit;
+        const uint8_t skip = bit ? 0x00 : 0xFF;// 整字节都不含目标位时跳过
+
+        while (pos < end_bit) {
+            if (pos % 8 == 0) {
+                // 按 64 位字跳过
+                while (pos + 64 <= end_bit && detail::LoadWord(data + pos / 8) == (bit ? 0ULL : ~0ULL)) {
+                    pos += 64;
+                }
+                while (pos + 8 <= end_bit && data[pos / 8] == skip) {
+                    pos += 8;
+                }
+                if (pos >= end_bit) break;
+            }
+            bool value = (data[pos / 8] >> (7 - pos % 8)) & 1;
+            if (value == bit) return static_cast<int64_t>(pos);
+            ++pos;
+        }
+        return -1;
+    }
+
+}// namespace Astra::utils::bitops
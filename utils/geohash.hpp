@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Astra::utils::geo {
+
+    // GEO 命令使用的 52 位 geohash（与 Redis 相同）：
+    // 纬度限制在 Web 墨卡托可表示的范围内，经纬度各量化为 26 位，纬度位放在偶数位、经度位放在奇数位交织。
+    // 交织后的整数直接作为有序集合的分数，同一个 geohash 前缀的点在分数上连续，
+    // 因此一次范围查询只需扫描少数几个分数区间。
+
+    inline constexpr double kLonMin = -180.0;
+    inline constexpr double kLonMax = 180.0;
+    inline constexpr double kLatMin = -85.05112878;
+    inline constexpr double kLatMax = 85.05112878;
+    inline constexpr int kStepMax = 26;// 每个维度的位数，52 位 = 2 × 26
+    inline constexpr double kEarthRadius = 6372797.560856;
+    inline constexpr double kMercatorMax = 20037726.37;
+    inline constexpr double kPi = 3.14159265358979323846;
+
+    struct Area {
+        double lon_min, lon_max;
+        double lat_min, lat_max;
+    };
+
+    // 分数区间 [min, max)
+    struct ScoreRange {
+        uint64_t min;
+        uint64_t max;
+    };
+
+    inline bool ValidCoordinates(double lon, double lat) {
+        return lon >= kLonMin && lon <= kLonMax && lat >= kLatMin && lat <= kLatMax;
+    }
+
+    inline double ToRadians(double degrees) {
+        return degrees * kPi / 180.0;
+    }
+
+    inline double ToDegrees(double radians) {
+        return radians * 180.0 / kPi;
+    }
+
+    namespace detail {
+        // 把 32 位整数的每一位分散到偶数位上
+        inline uint64_t Spread(uint32_t value) {
+            uint64_t x = value;
+            x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+            x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+            x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | (x << 2)) & 0x3333333333333333ULL;
+            x = (x | (x << 1)) & 0x5555555555555555ULL;
+            return x;
+        }
+
+        inline uint32_t Squash(uint64_t x) {
+            x &= 0x5555555555555555ULL;
+            x = (x | (x >> 1)) & 0x3333333333333333ULL;
+            x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+            x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+            x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+            return static_cast<uint32_t>(x);
+        }
+
+        inline uint32_t Quantize(double value, double min, double max, int step) {
+            double offset = (value - min) / (max - min) * static_cast<double>(uint64_t(1) << step);
+            auto cells = uint64_t(1) << step;
+            return static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(offset), cells - 1));
+        }
+    }// namespace detail
+
+    // 返回 2*step 位的 geohash；调用方应先用 ValidCoordinates 检查
+    inline uint64_t Encode(double lon, double lat, int step = kStepMax) {
+        uint32_t lat_bits = detail::Quantize(lat, kLatMin, kLatMax, step);
+        uint32_t lon_bits = detail::Quantize(lon, kLonMin, kLonMax, step);
+        return detail::Spread(lat_bits) | (detail::Spread(lon_bits) << 1);
+    }
+
+    // geohash 对应的网格
+    inline Area Decode(uint64_t hash, int step = kStepMax) {
+        double cells = static_cast<double>(uint64_t(1) << step);
+        uint32_t lat_bits = detail::Squash(hash);
+        uint32_t lon_bits = detail::Squash(hash >> 1);
+        double lat_unit = (kLatMax - kLatMin) / cells;
+        double lon_unit = (kLonMax - kLonMin) / cells;
+        return {kLonMin + lon_bits * lon_unit, kLonMin + (lon_bits + 1.0) * lon_unit,
+                kLatMin + lat_bits * lat_unit, kLatMin + (lat_bits + 1.0) * lat_unit};
+    }
+
+    // 网格中心作为还原出的坐标
+    inline void DecodeCenter(uint64_t hash, double &lon, double &lat, int step = kStepMax) {
+        Area area = Decode(hash, step);
+        lon = std::clamp((area.lon_min + area.lon_max) / 2, kLonMin, kLonMax);
+        lat = std::clamp((area.lat_min + area.lat_max) / 2, kLatMin, kLatMax);
+    }
+
+    // 球面距离（haversine），单位米
+    inline double Distance(double lon1, double lat1, double lon2, double lat2) {
+        double lat1r = ToRadians(lat1), lat2r = ToRadians(lat2);
+        double u = std::sin((lat2r - lat1r) / 2);
+        double v = std::sin(ToRadians(lon2 - lon1) / 2);
+        return 2.0 * kEarthRadius * std::asin(std::sqrt(u * u + std::cos(lat1r) * std::cos(lat2r) * v * v));
+    }
+
+    // 以 (lon1, lat1) 为中心、宽 width 高 height（米）的矩形是否包含 (lon2, lat2)
+    inline bool InBox(double lon1, double lat1, double width, double height, double lon2, double lat2) {
+        if (Distance(lon2, lat2, lon2, lat1) > height / 2) return false;
+        return Distance(lon2, lat2, lon1, lat2) <= width / 2;
+    }
+
+    // 网格边长不小于搜索半径的最精细层级：半径每翻一倍少用一级，高纬度经线收窄再退一到两级
+    inline int EstimateStep(double radius, double lat) {
+        if (radius <= 0) return kStepMax;
+        int step = 1;
+        while (radius < kMercatorMax) {
+            radius *= 2;
+            ++step;
+        }
+        step -= 2;
+        if (lat > 66 || lat < -66) {
+            --step;
+            if (lat > 80 || lat < -80) --step;
+        }
+        return std::clamp(step, 1, kStepMax);
+    }
+
+    // 以 (lon, lat) 为中心、宽 width 高 height（米）的搜索区域的外接经纬度框；半径搜索传 2r × 2r
+    inline Area BoundingBox(double lon, double lat, double width, double height) {
+        double lat_delta = ToDegrees(height / 2 / kEarthRadius);
+        double lon_delta_top = ToDegrees(width / 2 / kEarthRadius / std::cos(ToRadians(lat + lat_delta)));
+        double lon_delta_bottom = ToDegrees(width / 2 / kEarthRadius / std::cos(ToRadians(lat - lat_delta)));
+        double lon_delta = std::max(lon_delta_top, lon_delta_bottom);
+        return {lon - lon_delta, lon + lon_delta, lat - lat_delta, lat + lat_delta};
+    }
+
+    // 覆盖搜索区域所需的最少 52 位分数区间：取中心所在网格及其 8 个邻格（层级保证 3×3 覆盖外接框），
+    // 丢掉与外接框不相交的邻格，再把分数相邻的区间合并。最多 9 个区间，多数情况下只有 2~4 个。
+    inline std::vector<ScoreRange> SearchRanges(double lon, double lat, double width, double height) {
+        Area box = BoundingBox(lon, lat, width, height);
+        int step = EstimateStep(std::sqrt(width * width + height * height) / 2, lat);
+
+        uint32_t lat_cell = 0, lon_cell = 0;
+        double lat_unit = 0, lon_unit = 0;
+        for (;; --step) {
+            double cells = static_cast<double>(uint64_t(1) << step);
+            lat_unit = (kLatMax - kLatMin) / cells;
+            lon_unit = (kLonMax - kLonMin) / cells;
+            lat_cell = detail::Quantize(std::clamp(lat, kLatMin, kLatMax), kLatMin, kLatMax, step);
+            lon_cell = detail::Quantize(lon, kLonMin, kLonMax, step);
+
+            double cell_lat_min = kLatMin + lat_cell * lat_unit;
+            double cell_lon_min = kLonMin + lon_cell * lon_unit;
+            bool covered = box.lat_min >= cell_lat_min - lat_unit && box.lat_max <= cell_lat_min + 2 * lat_unit &&
+                           box.lon_min >= cell_lon_min - lon_unit && box.lon_max <= cell_lon_min + 2 * lon_unit;
+            if (covered || step == 1) break;
+        }
+
+        auto cells = int64_t(1) << step;
+        int shift = 2 * (kStepMax - step);
+        std::vector<ScoreRange> ranges;
+        for (int dlat = -1; dlat <= 1; ++dlat) {
+            int64_t y = static_cast<int64_t>(lat_cell) + dlat;
+            if (y < 0 || y >= cells) continue;
+            double cell_lat_min = kLatMin + y * lat_unit;
+            if (cell_lat_min > box.lat_max || cell_lat_min + lat_unit < box.lat_min) continue;
+
+            for (int dlon = -1; dlon <= 1; ++dlon) {
+                int64_t x = static_cast<int64_t>(lon_cell) + dlon;
+                double cell_lon_min = kLonMin + x * lon_unit;// 越过 ±180° 前先按未回绕的位置判断是否相交
+                if (cell_lon_min > box.lon_max || cell_lon_min + lon_unit < box.lon_min) continue;
+                x = (x + cells) % cells;
+
+                uint64_t hash = detail::Spread(static_cast<uint32_t>(y)) | (detail::Spread(static_cast<uint32_t>(x)) << 1);
+                ranges.push_back({hash << shift, (hash + 1) << shift});
+            }
+        }
+
+        std::sort(ranges.begin(), ranges.end(), [](const ScoreRange &a, const ScoreRange &b) { return a.min < b.min; });
+        std::vector<ScoreRange> merged;
+        for (const auto &range: ranges) {
+            if (!merged.empty() && range.min <= merged.back().max) {
+                merged.back().max = std::max(merged.back().max, range.max);
+            } else {
+                merged.push_back(range);
+            }
+        }
+        return merged;
+    }
+
+}// namespace Astra::utils::geo
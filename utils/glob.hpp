@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace Astra::utils {
+
+    // Redis 风格的 glob 匹配（SCAN MATCH / KEYS 使用的语法）：
+    // * 任意长度、? 单个字符、[abc] [a-z] [^...] 字符集、\ 转义下一个字符。
+    // 采用“记住最近一个 * 的位置”的回溯方式，最坏 O(模式长度 × 文本长度)，不会像递归实现那样指数爆炸。
+
+    namespace detail {
+        inline bool GlobCharEq(char a, char b, bool nocase) {
+            if (nocase) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            }
+            return a == b;
+        }
+
+        // 从 pattern[p]（'[' 之后）开始匹配一个字符集，p 前进到 ']' 之后
+        inline bool GlobMatchClass(std::string_view pattern, size_t &p, char c, bool nocase) {
+            bool negate = p < pattern.size() && pattern[p] == '^';
+            if (negate) ++p;
+
+            bool matched = false;
+            while (p < pattern.size() && pattern[p] != ']') {
+                if (pattern[p] == '\\' && p + 1 < pattern.size()) {
+                    ++p;
+                    matched |= GlobCharEq(pattern[p], c, nocase);
+                    ++p;
+                } else if (p + 2 < pattern.size() && pattern[p + 1] == '-' && pattern[p + 2] != ']') {
+                    auto lo = static_cast<unsigned char>(pattern[p]);
+                    auto hi = static_cast<unsigned char>(pattern[p + 2]);
+                    auto ch = static_cast<unsigned char>(c);
+                    if (lo > hi) std::swap(lo, hi);
+                    if (nocase) {
+                        lo = static_cast<unsigned char>(std::tolower(lo));
+                        hi = static_cast<unsigned char>(std::tolower(hi));
+                        ch = static_cast<unsigned char>(std::tolower(ch));
+                    }
+                    matched |= ch >= lo && ch <= hi;
+                    p += 3;
+                } else {
+                    matched |= GlobCharEq(pattern[p], c, nocase);
+                    ++p;
+                }
+            }
+            if (p < pattern.size()) ++p;// 跳过 ']'；未闭合的字符集与 Redis 一样视为到模式末尾
+            return matched != negate;
+        }
+    }// namespace detail
+
+    inline bool GlobMatch(std::string_view pattern, std::string_view text, bool nocase = false) {
+        size_t p = 0, t = 0;
+        size_t star_p = std::string_view::npos, star_t = 0;
+
+        while (t < text.size()) {
+            if (p < pattern.size()) {
+                char pc = pattern[p];
+                if (pc == '*') {
+                    while (p < pattern.size() && pattern[p] == '*') ++p;
+                    if (p == pattern.size()) return true;
+                    star_p = p;
+                    star_t = t;
+                    continue;
+                }
+
+                size_t next = p + 1;
+                bool matched;
+                if (pc == '?') {
+                    matched = true;
+                } else if (pc == '[') {
+                    matched = detail::GlobMatchClass(pattern, next, text[t], nocase);
+                } else if (pc == '\\' && p + 1 < pattern.size()) {
+                    matched = detail::GlobCharEq(pattern[p + 1], text[t], nocase);
+                    next = p + 2;
+                } else {
+                    matched = detail::GlobCharEq(pc, text[t], nocase);
+                }
+
+                if (matched) {
+                    p = next;
+                    ++t;
+                    continue;
+                }
+            }
+
+            // 失配：回到最近的 *，让它多吞一个字符
+            if (star_p == std::string_view::npos) return false;
+            p = star_p;
+            t = ++star_t;
+        }
+
+        while (p < pattern.size() && pattern[p] == '*') ++p;
+        return p == pattern.size();
+    }
+
+}// namespace Astra::utils
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Astra::utils {
+
+    // MurmurHash64A，与 Redis 的 HLL 实现使用相同的算法；HyperLogLog、Bloom 等概率结构共用
+    inline uint64_t MurmurHash64A(const void *key, size_t len, uint64_t seed) {
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        const int r = 47;
+        uint64_t h = seed ^ (len * m);
+        const auto *data = static_cast<const uint8_t *>(key);
+        const uint8_t *end = data + (len - (len & 7));
+
+        for (; data != end; data += 8) {
+            uint64_t k;
+            std::memcpy(&k, data, sizeof(k));
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+
+        switch (len & 7) {
+            case 7:
+                h ^= uint64_t(data[6]) << 48;
+                [[fallthrough]];
+            case 6:
+                h ^= uint64_t(data[5]) << 40;
+                [[fallthrough]];
+            case 5:
+                h ^= uint64_t(data[4]) << 32;
+                [[fallthrough]];
+            case 4:
+                h ^= uint64_t(data[3]) << 24;
+                [[fallthrough]];
+            case 3:
+                h ^= uint64_t(data[2]) << 16;
+                [[fallthrough]];
+            case 2:
+                h ^= uint64_t(data[1]) << 8;
+                [[fallthrough]];
+            case 1:
+                h ^= uint64_t(data[0]);
+                h *= m;
+        }
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+
+    // splitmix64 的终结函数：从一个 64 位哈希派生出互不相关的新哈希
+    inline uint64_t Mix64(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+}// namespace Astra::utils
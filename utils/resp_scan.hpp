@@ -0,0 +1,68 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utils/bitops.hpp>
+
+namespace Astra::utils::resp {
+
+    // RESP 行扫描内核：服务端请求解析器与 SDK 应答解析共用
+    // 查找 '\r' 按 AVX2 → SSE2 → memchr 的顺序选择实现，CPU 能力复用 bitops 的启动期检测；
+    // 长度/整数字段用 from_chars 就地解析，不构造子串，也不抛异常。
+
+    namespace detail {
+
+        inline const char *FindCRScalar(const char *p, const char *end) {
+            if (p >= end) return nullptr;
+            return static_cast<const char *>(std::memchr(p, '\r', static_cast<size_t>(end - p)));
+        }
+
+#if defined(ASTRA_BITOPS_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ASTRA_RESP_SSE2 1
+        inline const char *FindCRSse2(const char *p, const char *end) {
+            const __m128i cr = _mm_set1_epi8('\r');
+            for (; end - p >= 16; p += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, cr)));
+                if (mask != 0) return p + std::countr_zero(mask);
+            }
+            return FindCRScalar(p, end);
+        }
+
+        ASTRA_TARGET("avx2")
+        inline const char *FindCRAvx2(const char *p, const char *end) {
+            const __m256i cr = _mm256_set1_epi8('\r');
+            for (; end - p >= 32; p += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, cr)));
+                if (mask != 0) return p + std::countr_zero(mask);
+            }
+            return FindCRSse2(p, end);
+        }
+#endif
+
+    }// namespace detail
+
+    // 返回 [begin, end) 中第一个 '\r'，没有则返回 nullptr
+    inline const char *FindCR(const char *begin, const char *end) {
+#if defined(ASTRA_RESP_SSE2)
+        if (bitops::ActiveIsa() == bitops::Isa::Avx2) {
+            return detail::FindCRAvx2(begin, end);
+        }
+        return detail::FindCRSse2(begin, end);
+#else
+        return detail::FindCRScalar(begin, end);
+#endif
+    }
+
+    // 把 [begin, end) 整段解析为十进制整数（允许前导 '-'），有多余字符或溢出时返回 false
+    inline bool ParseInteger(const char *begin, const char *end, int64_t &value) {
+        if (begin == end) return false;
+        auto [ptr, ec] = std::from_chars(begin, end, value);
+        return ec == std::errc() && ptr == end;
+    }
+
+}// namespace Astra::utils::resp